@@ -0,0 +1,40 @@
+#!/bin/bash
+
+# Бенчмарк профилей параметров сокета (--net-profile):
+# задержка - среднее время короткого задания (1 вектор),
+# пропускная способность - время и скорость большого задания.
+# Требует запущенный сервер (server/run.sh).
+
+CLIENT="../client/build/client"
+FILER="../filer/build/filer"
+CONF="../client/build/config/vclient.conf"
+PORT="${PORT:-33333}"
+COUNT="${COUNT:-200000}"
+RUNS="${RUNS:-50}"
+SMALL="/tmp/bench_profiles_small.txt"
+LARGE="/tmp/bench_profiles_large.txt"
+OUTPUT="/tmp/bench_profiles_out.bin"
+
+# Генерация входных данных
+$FILER -dt int16_t -ft txt -n 1 -s 3 -p $SMALL > /dev/null || exit 1
+$FILER -dt int16_t -ft txt -n $COUNT -s 3 -p $LARGE > /dev/null || exit 1
+
+for PROFILE in default latency throughput; do
+  echo "== профиль $PROFILE"
+
+  # Задержка: среднее время выполнения короткого задания
+  start=$(date +%s.%N)
+  for ((i = 0; i < RUNS; i++)); do
+    $CLIENT -p $PORT -i $SMALL -o $OUTPUT -c $CONF --net-profile=$PROFILE > /dev/null || exit 1
+  done
+  end=$(date +%s.%N)
+  echo "  latency: $(echo "scale=3; ($end - $start) * 1000 / $RUNS" | bc) ms/job"
+
+  # Пропускная способность: время большого задания
+  start=$(date +%s.%N)
+  $CLIENT -p $PORT -i $LARGE -o $OUTPUT -c $CONF --net-profile=$PROFILE | grep -E "^Window:" | sed 's/^/  /'
+  end=$(date +%s.%N)
+  echo "  throughput: $(echo "scale=0; $COUNT / ($end - $start)" | bc) vectors/s"
+done
+
+rm -f $SMALL $LARGE $OUTPUT
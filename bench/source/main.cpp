@@ -0,0 +1,185 @@
+/**
+ * @file main.cpp
+ * @brief Микробенчмарк кодирования протокола NetMan.
+ * @details Измеряет время кодирования пакетов WireCodec и передачи через NetMan::calc() по встроенному
+ * серверу LoopbackTransport, то есть затраты клиента на протокол без ядра и сети, для векторов
+ * разного размера в сыром и компактном режимах. С параметром -a те же задания передаются реальному
+ * серверу, и разница показывает затраты ядра и сервера.
+ * Запуск: bench [-n векторов] [-r повторов] [-a адрес -p порт -c конфигурация]
+ * @date 19.10.2026
+ * @version 1.0
+ * @authorsa Ягольницкий Р. С.
+ */
+
+#include "../../client/source/modules/netman.h"
+#include "../../client/source/modules/loopback.h"
+#include "../../client/source/modules/wirecodec.h"
+#include "../../client/source/modules/ioman.h"
+#include "../../client/source/modules/vecgen.h"
+#include "../../client/source/modules/errors.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// Количество векторов задания и повторов измерения по умолчанию
+static const size_t DEFAULT_COUNT = 100000;
+static const int DEFAULT_ROUNDS = 5;
+
+// Размеры векторов
+static const size_t SIZES[] = {1, 4, 16, 64, 256};
+
+/**
+ * @brief Вспомогательная функция для измерения лучшего времени из нескольких повторов.
+ * @param rounds Количество повторов.
+ * @param body Измеряемая функция.
+ * @return Наименьшее время выполнения в секундах.
+ */
+static double best(int rounds, const function<void()> &body)
+{
+    double result = 0;
+    for (int i = 0; i < rounds; ++i)
+    {
+        auto start = chrono::steady_clock::now();
+        body();
+        chrono::duration<double> elapsed = chrono::steady_clock::now() - start;
+        if (i == 0 || elapsed.count() < result)
+            result = elapsed.count();
+    }
+    return result;
+}
+
+/**
+ * @brief Вспомогательная функция для измерения передачи задания через NetMan.
+ * @param net_man Настроенный NetMan.
+ * @param data Векторы задания.
+ * @param rounds Количество повторов.
+ * @param login Логин.
+ * @param password Пароль.
+ * @return Наименьшее время передачи в секундах.
+ */
+static double transfer(NetMan &net_man, const vector<vector<int16_t>> &data, int rounds,
+                       const string &login, const string &password)
+{
+    vector<int16_t> results(data.size());
+    net_man.setVerbose(false);
+    net_man.conn();
+    net_man.auth(login, password);
+    double seconds = best(rounds, [&]()
+                          { net_man.calc(data, results, 0, function<void(size_t, size_t)>()); });
+    net_man.close();
+    return seconds;
+}
+
+/**
+ * @brief Главная функция микробенчмарка.
+ * @param argc Количество аргументов командной строки.
+ * @param argv Аргументы командной строки.
+ * @return Код завершения программы. 0 - успешное завершение, 1 - ошибка.
+ */
+int main(int argc, char *argv[])
+{
+    size_t count = DEFAULT_COUNT;
+    int rounds = DEFAULT_ROUNDS;
+    string address;
+    uint16_t port = 33333;
+    string conf = "./config/vclient.conf";
+    for (int i = 1; i + 1 < argc; i += 2)
+    {
+        if (!strcmp(argv[i], "-n"))
+            count = strtoul(argv[i + 1], nullptr, 10);
+        else if (!strcmp(argv[i], "-r"))
+            rounds = atoi(argv[i + 1]);
+        else if (!strcmp(argv[i], "-a"))
+            address = argv[i + 1];
+        else if (!strcmp(argv[i], "-p"))
+            port = atoi(argv[i + 1]);
+        else if (!strcmp(argv[i], "-c"))
+            conf = argv[i + 1];
+    }
+    if (count == 0 || rounds <= 0)
+    {
+        cerr << "Usage: bench [-n vectors] [-r rounds] [-a address -p port -c config]\n";
+        return 1;
+    }
+
+    try
+    {
+        // Встроенный сервер не проверяет учетные данные, реальному нужны данные конфигурации
+        string login = "user";
+        string password = "P@ssW0rd";
+        if (!address.empty())
+        {
+            IOMan io_man(conf, "", "");
+            auto credentials = io_man.conf();
+            login = credentials[0];
+            password = credentials[1];
+        }
+
+        cout << "Vectors: " << count << ", rounds: " << rounds << " (best of), ns per vector\n";
+        printf("%6s %8s %10s %10s %10s %12s", "size", "data", "encode", "raw", "compact", "wire B/vec");
+        if (!address.empty())
+            printf(" %10s %10s", "net raw", "net comp");
+        printf("\n");
+
+        VecGen gen(1);
+        for (size_t size : SIZES)
+        {
+            // Случайные значения почти не сжимаются, плавные кодируются короткими разностями
+            for (int smooth = 0; smooth < 2; ++smooth)
+            {
+                vector<vector<int16_t>> data(count, vector<int16_t>(size));
+                for (size_t i = 0; i < count; ++i)
+                {
+                    if (smooth)
+                        for (size_t j = 0; j < size; ++j)
+                            data[i][j] = int16_t((i + j) % 64);
+                    else
+                        gen.fill(data[i]);
+                }
+
+                WireCodec codec;
+                vector<uint8_t> frame;
+                double encode = best(rounds, [&]()
+                                     { codec.encode(data, 0, count, frame); });
+
+                double modes[2];
+                const char *names[] = {"raw", "compact"};
+                for (int m = 0; m < 2; ++m)
+                {
+                    NetMan net_man("loopback", 0);
+                    net_man.setWireMode(names[m]);
+                    net_man.setConnector([]()
+                                         { return new LoopbackTransport(); });
+                    modes[m] = transfer(net_man, data, rounds, login, password);
+                }
+                printf("%6zu %8s %10.1f %10.1f %10.1f %12.2f", size, smooth ? "smooth" : "random",
+                       encode * 1e9 / count, modes[0] * 1e9 / count, modes[1] * 1e9 / count,
+                       double(frame.size()) / count);
+
+                if (!address.empty())
+                {
+                    for (int m = 0; m < 2; ++m)
+                    {
+                        NetMan net_man(address, port);
+                        net_man.setWireMode(names[m]);
+                        printf(" %10.1f", transfer(net_man, data, rounds, login, password) * 1e9 / count);
+                    }
+                }
+                printf("\n");
+            }
+        }
+    }
+    catch (const BasicClientError &e)
+    {
+        cerr << e.what() << "\n";
+        return 1;
+    }
+    return 0;
+}
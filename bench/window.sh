@@ -0,0 +1,43 @@
+#!/bin/bash
+
+# Бенчмарк адаптивного окна передачи NetMan.calc():
+# сравнивает адаптивное и фиксированное окно на loopback и на канале,
+# ограниченном через tc/netem. Требует запущенный сервер (server/run.sh)
+# и права root для tc.
+
+CLIENT="../client/build/client"
+FILER="../filer/build/filer"
+CONF="../client/build/config/vclient.conf"
+PORT="${PORT:-33333}"
+COUNT="${COUNT:-200000}"
+DELAY="${DELAY:-20ms}"
+RATE="${RATE:-100mbit}"
+INPUT="/tmp/bench_window_input.txt"
+OUTPUT="/tmp/bench_window_out.bin"
+
+# Генерация входных данных
+$FILER -dt int16_t -ft txt -n $COUNT -s 3 -p $INPUT > /dev/null || exit 1
+
+# Запуск клиента с выводом выбранного окна и времени выполнения
+run() {
+  local start end
+  start=$(date +%s.%N)
+  $CLIENT -p $PORT -i $INPUT -o $OUTPUT -c $CONF "$@" | grep -E "^Window:"
+  end=$(date +%s.%N)
+  echo "  time: $(echo "$end - $start" | bc) s"
+}
+
+echo "== loopback, адаптивное окно"
+run
+echo "== loopback, фиксированное окно 16"
+run --window 16
+
+echo "== netem: задержка $DELAY, скорость $RATE"
+tc qdisc add dev lo root netem delay $DELAY rate $RATE || exit 1
+trap "tc qdisc del dev lo root" EXIT
+echo "-- адаптивное окно"
+run
+echo "-- фиксированное окно 16"
+run --window 16
+
+rm -f $INPUT $OUTPUT
@@ -0,0 +1,85 @@
+#include "affinity.h"
+#include "errors.h"
+#include <cstdlib>
+#include <pthread.h>
+#include <sched.h>
+#include <dirent.h>
+#include <cstring>
+
+// Метод для разбора списка процессоров
+std::vector<int> Affinity::parse(const std::string &spec)
+{
+    std::vector<int> cpus;
+    size_t pos = 0;
+    while (pos <= spec.size())
+    {
+        size_t comma = spec.find(',', pos);
+        if (comma == std::string::npos)
+            comma = spec.size();
+        std::string item = spec.substr(pos, comma - pos);
+        pos = comma + 1;
+
+        // Элемент - номер процессора или диапазон "first-last"
+        char *end = nullptr;
+        long first = std::strtol(item.c_str(), &end, 10);
+        long last = first;
+        if (end != item.c_str() && *end == '-')
+            last = std::strtol(end + 1, &end, 10);
+        if (item.empty() || *end != '\0' || first < 0 || last < first || last >= CPU_SETSIZE)
+            throw ArgsDecodeError("Invalid CPU list: " + spec, "Affinity.parse()");
+        for (long cpu = first; cpu <= last; ++cpu)
+            cpus.push_back(cpu);
+    }
+    return cpus;
+}
+
+// Метод для проверки, что процессор доступен процессу
+bool Affinity::available(int cpu)
+{
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    if (cpu < 0 || cpu >= CPU_SETSIZE || sched_getaffinity(0, sizeof(set), &set) != 0)
+        return false;
+    return CPU_ISSET(cpu, &set);
+}
+
+// Метод для привязки текущего потока к процессору
+bool Affinity::pin(int cpu)
+{
+    if (cpu < 0 || cpu >= CPU_SETSIZE)
+        return false;
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+}
+
+// Метод для привязки текущего потока к процессору из списка по кругу
+int Affinity::pin(const std::vector<int> &cpus, size_t index)
+{
+    if (cpus.empty())
+        return -1;
+    int cpu = cpus[index % cpus.size()];
+    return Affinity::pin(cpu) ? cpu : -1;
+}
+
+// Метод для определения узла NUMA процессора
+int Affinity::node(int cpu)
+{
+    // Каталог процессора в sysfs содержит ссылку nodeN на его узел
+    std::string path = "/sys/devices/system/cpu/cpu" + std::to_string(cpu);
+    DIR *dir = opendir(path.c_str());
+    if (!dir)
+        return -1;
+    int result = -1;
+    while (struct dirent *entry = readdir(dir))
+    {
+        if (std::strncmp(entry->d_name, "node", 4) == 0 && entry->d_name[4] >= '0' && entry->d_name[4] <= '9')
+        {
+            result = std::atoi(entry->d_name + 4);
+            break;
+        }
+    }
+    closedir(dir);
+    return result;
+}
@@ -0,0 +1,63 @@
+#ifndef AFFINITY_H
+#define AFFINITY_H
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+/**
+* @file affinity.h
+* @brief Определение класса для привязки потоков к процессорам.
+* @details Этот файл содержит разбор списка процессоров (--cpus) и привязку потоков клиента к ним.
+* Память размещается на узле NUMA потока, который первым записывает в страницу, поэтому поток
+* привязывается до выделения своих буферов: тогда буферы оказываются на узле его процессора.
+* @date 19.10.2026
+* @version 1.0
+* @authorsa Ягольницкий Р. С.
+*/
+
+/**
+* @brief Класс для привязки потоков к процессорам.
+*/
+class Affinity
+{
+public:
+    /**
+    * @brief Статический метод для разбора списка процессоров.
+    * @param spec Список номеров и диапазонов через запятую, например "0-3,8,10-11".
+    * @return Номера процессоров в порядке перечисления.
+    * @throw ArgsDecodeError Если список пуст или содержит некорректный элемент.
+    */
+    static std::vector<int> parse(const std::string &spec);
+
+    /**
+    * @brief Статический метод для проверки, что процессор доступен процессу.
+    * @param cpu Номер процессора.
+    * @return true, если процессор входит в маску процесса.
+    */
+    static bool available(int cpu);
+
+    /**
+    * @brief Статический метод для привязки текущего потока к процессору.
+    * @param cpu Номер процессора.
+    * @return true, если привязка выполнена.
+    */
+    static bool pin(int cpu);
+
+    /**
+    * @brief Статический метод для привязки текущего потока к процессору из списка по кругу.
+    * @param cpus Список процессоров (пустой список - без привязки).
+    * @param index Номер потока.
+    * @return Номер процессора или -1, если привязка не выполнялась.
+    */
+    static int pin(const std::vector<int> &cpus, size_t index);
+
+    /**
+    * @brief Статический метод для определения узла NUMA процессора.
+    * @param cpu Номер процессора.
+    * @return Номер узла или -1, если он неизвестен.
+    */
+    static int node(int cpu);
+};
+
+#endif // AFFINITY_H
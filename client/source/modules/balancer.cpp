@@ -0,0 +1,390 @@
+#include "balancer.h"
+#include "errors.h"
+#include <algorithm>
+#include <cstdlib>
+#include <thread>
+
+const size_t Balancer::CHUNK = 4096;
+const size_t Balancer::DEPTH = 2;
+
+// Префикс адреса Unix-сокета
+static const char UNIX_PREFIX[] = "unix:";
+// Количество ошибок подряд, после которого сервер исключается
+static const int EJECT_FAILURES = 2;
+// Начальная и максимальная длительность исключения в секундах
+static const double BACKOFF_BASE = 1.0;
+static const double BACKOFF_MAX = 30.0;
+// Сервер, который медленнее самого быстрого в SLOW_FACTOR раз, исключается как неисправный
+static const double SLOW_FACTOR = 8.0;
+// Количество частей, после которого скорость сервера считается измеренной
+static const uint64_t MIN_SAMPLES = 4;
+// Коэффициент сглаживания скорости
+static const double RATE_ALPHA = 0.3;
+
+// Конструктор
+Balancer::Balancer(
+    const std::vector<Endpoint> &endpoints,
+    const std::function<NetMan *(const Endpoint &)> &make_net,
+    const std::string &login,
+    const std::string &password,
+    int retries,
+    size_t chunk)
+    : endpoints(endpoints),
+      make_net(make_net),
+      login(login),
+      password(password),
+      retries(std::max(0, retries)),
+      chunk(std::max<size_t>(1, chunk)),
+      connected(endpoints.size(), 0),
+      queues(endpoints.size()),
+      prefix(0),
+      remaining(0),
+      stopping(false)
+{
+    for (const auto &endpoint : this->endpoints)
+    {
+        this->nets.emplace_back(this->make_net(endpoint));
+        this->nets.back()->setVerbose(false);
+
+        EndpointStats stats = {};
+        stats.name = endpoint.address.compare(0, sizeof(UNIX_PREFIX) - 1, UNIX_PREFIX) == 0
+                         ? endpoint.address
+                         : endpoint.address + ":" + std::to_string(endpoint.port);
+        stats.backoff = BACKOFF_BASE;
+        this->stats.push_back(stats);
+    }
+}
+
+// Деструктор
+Balancer::~Balancer()
+{
+    for (auto &net : this->nets)
+        net->close();
+}
+
+std::vector<EndpointStats> &Balancer::getStats()
+{
+    return this->stats;
+};
+
+// Метод для разбора списка серверов
+std::vector<Endpoint> Balancer::parse(const std::string &spec, uint16_t default_port)
+{
+    std::vector<Endpoint> endpoints;
+    size_t pos = 0;
+    while (pos <= spec.size())
+    {
+        size_t comma = spec.find(',', pos);
+        if (comma == std::string::npos)
+            comma = spec.size();
+        std::string item = spec.substr(pos, comma - pos);
+        pos = comma + 1;
+
+        Endpoint endpoint = {item, default_port};
+        size_t colon = item.rfind(':');
+        if (item.compare(0, sizeof(UNIX_PREFIX) - 1, UNIX_PREFIX) != 0 && colon != std::string::npos)
+        {
+            // Порт после последнего двоеточия
+            endpoint.address = item.substr(0, colon);
+            std::string port = item.substr(colon + 1);
+            char *end = nullptr;
+            long value = std::strtol(port.c_str(), &end, 10);
+            if (port.empty() || *end != '\0' || value <= 0 || value > 65535)
+                throw ArgsDecodeError("Invalid port in address: " + item, "Balancer.parse()");
+            endpoint.port = value;
+        }
+        if (endpoint.address.empty())
+            throw ArgsDecodeError("Empty server address in \"" + spec + "\"", "Balancer.parse()");
+        endpoints.push_back(endpoint);
+    }
+    return endpoints;
+}
+
+// Метод для выбора сервера для части
+int Balancer::pick(uint64_t bytes)
+{
+    // Сервер без измерений считается не медленнее самого быстрого, чтобы он получил работу
+    double known = 0.0;
+    for (const auto &stats : this->stats)
+        if (!stats.ejected)
+            known = std::max(known, stats.rate);
+    if (known <= 0.0)
+        known = 1.0;
+
+    int best = -1;
+    double best_cost = 0.0;
+    for (size_t i = 0; i < this->stats.size(); ++i)
+    {
+        const EndpointStats &stats = this->stats[i];
+        if (stats.ejected || this->queues[i].size() >= DEPTH)
+            continue;
+        double rate = stats.rate > 0.0 ? stats.rate : known;
+        double cost = (stats.outstanding_bytes + bytes) / rate;
+        if (best < 0 || cost < best_cost)
+        {
+            best = i;
+            best_cost = cost;
+        }
+    }
+    return best;
+}
+
+// Метод для возвращения серверов, время исключения которых истекло
+std::chrono::steady_clock::time_point Balancer::reinstate()
+{
+    auto now = std::chrono::steady_clock::now();
+    auto next = std::chrono::steady_clock::time_point::max();
+    for (auto &stats : this->stats)
+    {
+        if (!stats.ejected)
+            continue;
+        if (stats.until <= now)
+        {
+            // Скорость измеряется заново, поэтому сервер сразу получает пробную часть
+            stats.ejected = false;
+            stats.failures = 0;
+            stats.rate = 0.0;
+        }
+        else
+            next = std::min(next, stats.until);
+    }
+    return next;
+}
+
+// Метод для исключения сервера из пула
+void Balancer::eject(size_t id)
+{
+    EndpointStats &stats = this->stats[id];
+    stats.ejected = true;
+    ++stats.ejections;
+    stats.until = std::chrono::steady_clock::now() +
+                  std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(stats.backoff));
+    stats.backoff = std::min(BACKOFF_MAX, stats.backoff * 2);
+
+    // Части из очереди сервера возвращаются в общую очередь в прежнем порядке
+    std::deque<size_t> &queue = this->queues[id];
+    for (auto it = queue.rbegin(); it != queue.rend(); ++it)
+    {
+        stats.outstanding_vectors -= this->bounds[*it + 1] - this->bounds[*it];
+        stats.outstanding_bytes -= this->chunk_bytes[*it];
+        this->pending.push_front(*it);
+    }
+    queue.clear();
+}
+
+// Метод для обработки векторов серверами пула
+void Balancer::calc(
+    const std::vector<std::vector<int16_t>> &data,
+    std::vector<int16_t> &results,
+    size_t first,
+    const std::function<void(size_t, size_t)> &commit)
+{
+    if (first >= data.size())
+        return;
+
+    // Деление задания на части и их размеры в формате протокола
+    this->bounds.clear();
+    this->chunk_bytes.clear();
+    for (size_t begin = first; begin < data.size(); begin += this->chunk)
+    {
+        size_t end = std::min(begin + this->chunk, data.size());
+        uint64_t bytes = 0;
+        for (size_t i = begin; i < end; ++i)
+            bytes += sizeof(uint32_t) + data[i].size() * sizeof(int16_t);
+        this->bounds.push_back(begin);
+        this->chunk_bytes.push_back(bytes);
+    }
+    this->bounds.push_back(data.size());
+
+    size_t chunks = this->chunk_bytes.size();
+    this->attempts.assign(chunks, 0);
+    this->finished.assign(chunks, false);
+    this->pending.clear();
+    for (size_t i = 0; i < chunks; ++i)
+        this->pending.push_back(i);
+    this->prefix = 0;
+    this->remaining = chunks;
+    this->stopping = false;
+    this->error = nullptr;
+
+    std::vector<std::thread> workers;
+    for (size_t id = 0; id < this->endpoints.size(); ++id)
+        workers.emplace_back(&Balancer::work, this, id, std::cref(data), std::ref(results), std::cref(commit));
+
+    // Части назначаются по одной по мере освобождения мест в очередях серверов
+    {
+        std::unique_lock<std::mutex> lock(this->mutex);
+        while (this->remaining > 0 && !this->error)
+        {
+            auto wake = this->reinstate();
+            int id = this->pending.empty() ? -1 : this->pick(this->chunk_bytes[this->pending.front()]);
+            if (id < 0)
+            {
+                if (wake == std::chrono::steady_clock::time_point::max())
+                    this->cv.wait(lock);
+                else
+                    this->cv.wait_until(lock, wake);
+                continue;
+            }
+            size_t index = this->pending.front();
+            this->pending.pop_front();
+            this->queues[id].push_back(index);
+            this->stats[id].outstanding_vectors += this->bounds[index + 1] - this->bounds[index];
+            this->stats[id].outstanding_bytes += this->chunk_bytes[index];
+            this->cv.notify_all();
+        }
+        this->stopping = true;
+        this->cv.notify_all();
+    }
+    for (auto &worker : workers)
+        worker.join();
+
+    if (this->error)
+        std::rethrow_exception(this->error);
+}
+
+// Метод рабочего потока сервера
+void Balancer::work(
+    size_t id,
+    const std::vector<std::vector<int16_t>> &data,
+    std::vector<int16_t> &results,
+    const std::function<void(size_t, size_t)> &commit)
+{
+    NetMan &net_man = *this->nets[id];
+    size_t max_attempts = this->endpoints.size() * (this->retries + 1);
+
+    std::unique_lock<std::mutex> lock(this->mutex);
+    for (;;)
+    {
+        this->cv.wait(lock, [this, id]()
+                      { return this->stopping || !this->queues[id].empty(); });
+        if (this->queues[id].empty() || this->error)
+            break;
+        size_t index = this->queues[id].front();
+        this->queues[id].pop_front();
+        lock.unlock();
+
+        // Часть обрабатывается без блокировки; сетевые ошибки переносят ее на другой сервер
+        bool ok = false;
+        std::exception_ptr fatal;
+        auto start = std::chrono::steady_clock::now();
+        try
+        {
+            if (!this->connected[id])
+            {
+                net_man.close();
+                net_man.conn();
+                net_man.auth(this->login, this->password);
+                this->connected[id] = 1;
+            }
+            net_man.calcRange(data, results, this->bounds[index], this->bounds[index + 1]);
+            ok = true;
+        }
+        catch (const DeadlineError &)
+        {
+            // Срок и отмена относятся ко всему заданию, другой сервер их не исправит
+            fatal = std::current_exception();
+        }
+        catch (const CancelledError &)
+        {
+            fatal = std::current_exception();
+        }
+        catch (const NetworkError &)
+        {
+        }
+        catch (const AuthError &)
+        {
+        }
+        catch (...)
+        {
+            fatal = std::current_exception();
+        }
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+        lock.lock();
+        EndpointStats &stats = this->stats[id];
+        uint64_t count = this->bounds[index + 1] - this->bounds[index];
+        stats.outstanding_vectors -= count;
+        stats.outstanding_bytes -= this->chunk_bytes[index];
+        if (fatal)
+        {
+            if (!this->error)
+                this->error = fatal;
+        }
+        else if (ok)
+        {
+            ++stats.chunks;
+            stats.vectors += count;
+            stats.bytes += this->chunk_bytes[index];
+            stats.busy += elapsed.count();
+            double rate = this->chunk_bytes[index] / std::max(elapsed.count(), 1e-9);
+            stats.rate = stats.rate > 0.0 ? stats.rate + RATE_ALPHA * (rate - stats.rate) : rate;
+            stats.failures = 0;
+            stats.backoff = std::max(BACKOFF_BASE, stats.backoff / 2);
+
+            // Подтверждается непрерывный префикс обработанных частей
+            this->finished[index] = true;
+            --this->remaining;
+            size_t old = this->prefix;
+            while (this->prefix < this->finished.size() && this->finished[this->prefix])
+                ++this->prefix;
+            if (commit && this->prefix > old)
+            {
+                try
+                {
+                    commit(this->bounds[old], this->bounds[this->prefix]);
+                }
+                catch (...)
+                {
+                    if (!this->error)
+                        this->error = std::current_exception();
+                }
+            }
+
+            // Аномально медленный сервер исключается, если в пуле есть другие доступные серверы
+            double fastest = 0.0;
+            for (size_t i = 0; i < this->stats.size(); ++i)
+                if (i != id && !this->stats[i].ejected && this->stats[i].chunks >= MIN_SAMPLES)
+                    fastest = std::max(fastest, this->stats[i].rate);
+            if (stats.chunks >= MIN_SAMPLES && stats.rate * SLOW_FACTOR < fastest)
+                this->eject(id);
+        }
+        else
+        {
+            ++stats.errors;
+            ++stats.failures;
+            this->connected[id] = 0;
+            this->pending.push_front(index);
+            if (size_t(++this->attempts[index]) >= max_attempts)
+            {
+                if (!this->error)
+                    this->error = std::make_exception_ptr(NetworkError(
+                        "Vectors " + std::to_string(this->bounds[index]) + "-" + std::to_string(this->bounds[index + 1]) +
+                            " failed on all servers",
+                        "Balancer.calc()"));
+            }
+            else if (stats.failures >= EJECT_FAILURES)
+                this->eject(id);
+        }
+        this->cv.notify_all();
+    }
+}
+
+// Метод для вывода распределения работы и состояния серверов
+void Balancer::report(std::ostream &out)
+{
+    std::lock_guard<std::mutex> lock(this->mutex);
+    uint64_t total = 0;
+    for (const auto &stats : this->stats)
+        total += stats.vectors;
+
+    out << "Log: \"Balancer.report()\"\n";
+    for (const auto &stats : this->stats)
+    {
+        out << "Endpoint " << stats.name << ": " << stats.chunks << " chunks, " << stats.vectors
+            << " vectors (" << (total ? 100.0 * stats.vectors / total : 0.0) << "%), "
+            << (stats.busy > 0.0 ? stats.bytes / stats.busy / 1e6 : 0.0) << " MB/s, errors "
+            << stats.errors << ", ejected " << stats.ejections << " times"
+            << (stats.ejected ? " (ejected now)" : "") << "\n";
+    }
+}
@@ -0,0 +1,187 @@
+#ifndef BALANCER_H
+#define BALANCER_H
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <vector>
+#include "netman.h"
+
+/**
+* @file balancer.h
+* @brief Определение класса распределения векторов между несколькими серверами.
+* @details Этот файл содержит разбор списка серверов и балансировщик, который делит задание на части
+* и направляет каждую часть серверу с наименьшим ожидаемым временем выполнения накопленной работы.
+* Состояние серверов отслеживается пассивно по ошибкам и скорости обработки: отказавшие и аномально
+* медленные серверы исключаются на время, которое удваивается при повторных исключениях.
+* @date 19.10.2026
+* @version 1.0
+* @authorsa Ягольницкий Р. С.
+*/
+
+/**
+* @brief Адрес сервера.
+*/
+struct Endpoint
+{
+    std::string address; ///< Адрес сервера или unix:/path.
+    uint16_t port; ///< Порт сервера.
+};
+
+/**
+* @brief Состояние и счетчики сервера.
+*/
+struct EndpointStats
+{
+    std::string name; ///< Адрес и порт для отчета.
+    uint64_t outstanding_vectors; ///< Векторы, назначенные серверу и еще не обработанные.
+    uint64_t outstanding_bytes; ///< Байты назначенных и еще не обработанных векторов.
+    uint64_t chunks; ///< Количество обработанных частей.
+    uint64_t vectors; ///< Количество обработанных векторов.
+    uint64_t bytes; ///< Количество обработанных байт.
+    uint64_t errors; ///< Количество неудачных частей.
+    uint64_t ejections; ///< Количество исключений из пула.
+    double rate; ///< Сглаженная скорость обработки в байтах в секунду (0 - нет измерений).
+    double busy; ///< Суммарное время обработки частей в секундах.
+    int failures; ///< Количество ошибок подряд.
+    bool ejected; ///< Флаг исключения из пула.
+    double backoff; ///< Длительность следующего исключения в секундах.
+    std::chrono::steady_clock::time_point until; ///< Время возвращения в пул.
+};
+
+/**
+* @brief Класс распределения векторов между несколькими серверами.
+* @details Задание делится на части по CHUNK векторов. Каждый сервер обслуживается отдельным потоком
+* с собственным подключением и очередью не более DEPTH частей. Очередная часть назначается
+* доступному серверу с наименьшим значением (назначенные байты + байты части) / скорость сервера,
+* поэтому доля работы сервера пропорциональна его скорости. Часть, завершившаяся ошибкой,
+* возвращается в общую очередь и отправляется другому серверу.
+*/
+class Balancer
+{
+public:
+    static const size_t CHUNK; ///< Количество векторов в части по умолчанию.
+    static const size_t DEPTH; ///< Наибольшее количество частей в очереди сервера.
+
+    /**
+    * @brief Конструктор класса Balancer.
+    * @param endpoints Список серверов.
+    * @param make_net Функция, создающая настроенный NetMan для сервера.
+    * @param login Логин.
+    * @param password Пароль.
+    * @param retries Количество повторных отправок части на каждый сервер пула.
+    * @param chunk Количество векторов в части.
+    */
+    Balancer(
+        const std::vector<Endpoint> &endpoints,
+        const std::function<NetMan *(const Endpoint &)> &make_net,
+        const std::string &login,
+        const std::string &password,
+        int retries = 3,
+        size_t chunk = CHUNK);
+
+    /**
+    * @brief Деструктор класса Balancer. Закрывает подключения к серверам.
+    */
+    ~Balancer();
+
+    /**
+    * @brief Статический метод для разбора списка серверов.
+    * @param spec Адреса через запятую в виде host, host:port или unix:/path.
+    * @param default_port Порт для адресов без порта.
+    * @return Список серверов.
+    * @throw ArgsDecodeError Если адрес пуст или порт некорректен.
+    */
+    static std::vector<Endpoint> parse(const std::string &spec, uint16_t default_port);
+
+    /**
+    * @brief Метод для обработки векторов серверами пула.
+    * @param data Данные для обработки.
+    * @param results Буфер результатов размером data.size().
+    * @param first Индекс первого необработанного вектора.
+    * @param commit Функция, вызываемая с границами [begin, end) обработанного подряд диапазона
+    * (части завершаются в произвольном порядке, подтверждается только непрерывный префикс).
+    * @throw NetworkError Если часть не удалось обработать ни на одном сервере.
+    */
+    void calc(
+        const std::vector<std::vector<int16_t>> &data,
+        std::vector<int16_t> &results,
+        size_t first,
+        const std::function<void(size_t, size_t)> &commit);
+
+    /**
+    * @brief Метод для получения состояния серверов.
+    * @return Состояние серверов в порядке списка.
+    */
+    std::vector<EndpointStats> &getStats();
+
+    /**
+    * @brief Метод для вывода распределения работы и состояния серверов.
+    * @param out Поток вывода.
+    */
+    void report(std::ostream &out);
+
+private:
+    std::vector<Endpoint> endpoints; ///< Список серверов.
+    std::function<NetMan *(const Endpoint &)> make_net; ///< Функция создания NetMan.
+    std::string login; ///< Логин.
+    std::string password; ///< Пароль.
+    int retries; ///< Количество повторных отправок части на каждый сервер.
+    size_t chunk; ///< Количество векторов в части.
+    std::vector<std::unique_ptr<NetMan>> nets; ///< Подключения к серверам.
+    std::vector<char> connected; ///< Флаги установленных подключений (не vector<bool>: изменяются разными потоками).
+    std::vector<EndpointStats> stats; ///< Состояние серверов.
+    std::vector<std::deque<size_t>> queues; ///< Очереди частей серверов.
+    std::deque<size_t> pending; ///< Части, еще не назначенные серверу.
+    std::vector<size_t> bounds; ///< Границы частей.
+    std::vector<uint64_t> chunk_bytes; ///< Размер частей в байтах.
+    std::vector<int> attempts; ///< Количество неудачных попыток частей.
+    std::vector<bool> finished; ///< Флаги обработанных частей.
+    size_t prefix; ///< Количество частей, обработанных подряд с начала.
+    size_t remaining; ///< Количество необработанных частей.
+    bool stopping; ///< Флаг завершения рабочих потоков.
+    std::exception_ptr error; ///< Ошибка, прервавшая задание.
+    std::mutex mutex; ///< Мьютекс состояния.
+    std::condition_variable cv; ///< Условная переменная изменений состояния.
+
+    /**
+    * @brief Вспомогательный метод для выбора сервера для части.
+    * @param bytes Размер части в байтах.
+    * @return Номер сервера или -1, если доступных серверов с местом в очереди нет.
+    */
+    int pick(uint64_t bytes);
+
+    /**
+    * @brief Вспомогательный метод для возвращения серверов, время исключения которых истекло.
+    * @return Ближайшее время возвращения еще исключенного сервера (max(), если таких нет).
+    */
+    std::chrono::steady_clock::time_point reinstate();
+
+    /**
+    * @brief Вспомогательный метод для исключения сервера из пула.
+    * @param id Номер сервера.
+    */
+    void eject(size_t id);
+
+    /**
+    * @brief Метод рабочего потока сервера.
+    * @param id Номер сервера.
+    * @param data Данные для обработки.
+    * @param results Буфер результатов.
+    * @param commit Функция подтверждения.
+    */
+    void work(
+        size_t id,
+        const std::vector<std::vector<int16_t>> &data,
+        std::vector<int16_t> &results,
+        const std::function<void(size_t, size_t)> &commit);
+};
+
+#endif // BALANCER_H
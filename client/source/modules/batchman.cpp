@@ -0,0 +1,324 @@
+#include "batchman.h"
+#include "ioman.h"
+#include "latency.h"
+#include "affinity.h"
+#include "hugemem.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <thread>
+#include <dirent.h>
+#include <glob.h>
+#include <sys/stat.h>
+
+// Служебные файлы рядом с входными: индексы смещений и контрольные точки
+static const char *const SIDECAR_SUFFIXES[] = {".idx", ".ckpt", ".ckpt.tmp"};
+
+// Функция для проверки, что файл служебный и не является входным
+static bool isSidecar(const std::string &path)
+{
+    for (const char *suffix : SIDECAR_SUFFIXES)
+    {
+        size_t len = std::strlen(suffix);
+        if (path.size() > len && path.compare(path.size() - len, len, suffix) == 0)
+            return true;
+    }
+    return false;
+}
+
+// Конструктор
+BatchMan::BatchMan(const std::string &config_path, const std::string &io_backend)
+    : config_path(config_path), io_backend(io_backend), vectors(0), completed(0), deadline(0), cancelled(false) {}
+
+std::vector<BatchJob> &BatchMan::getJobs()
+{
+    return this->jobs;
+};
+uint64_t &BatchMan::getVectors()
+{
+    return this->vectors;
+};
+size_t &BatchMan::getCompleted()
+{
+    return this->completed;
+};
+
+// Метод для получения пути выходного файла
+std::string BatchMan::outputPath(const std::string &input, const std::string &out_dir)
+{
+    size_t slash = input.find_last_of('/');
+    std::string name = slash == std::string::npos ? input : input.substr(slash + 1);
+    return out_dir + "/" + name + ".out";
+}
+
+// Метод для составления списка заданий
+void BatchMan::collect(const std::string &spec, const std::string &out_dir)
+{
+    this->jobs.clear();
+    struct stat st;
+    bool is_dir = ::stat(spec.c_str(), &st) == 0 && S_ISDIR(st.st_mode);
+    bool is_glob = !is_dir && spec.find_first_of("*?[") != std::string::npos;
+
+    if (is_dir || is_glob)
+    {
+        if (out_dir.empty())
+        {
+            throw ArgsDecodeError(
+                "Missing output directory for batch \"" + spec + "\"",
+                "BatchMan.collect()");
+        }
+
+        std::vector<std::string> inputs;
+        if (is_dir)
+        {
+            DIR *dir = opendir(spec.c_str());
+            if (dir == nullptr)
+            {
+                throw FileNotFoundError(
+                    "Failed to open input directory \"" + spec + "\"",
+                    "BatchMan.collect()");
+            }
+            while (struct dirent *entry = readdir(dir))
+            {
+                std::string path = spec + "/" + entry->d_name;
+                if (!isSidecar(path) && ::stat(path.c_str(), &st) == 0 && S_ISREG(st.st_mode))
+                    inputs.push_back(path);
+            }
+            closedir(dir);
+        }
+        else
+        {
+            glob_t matches;
+            if (glob(spec.c_str(), 0, nullptr, &matches) == 0)
+            {
+                for (size_t i = 0; i < matches.gl_pathc; ++i)
+                    if (!isSidecar(matches.gl_pathv[i]) && ::stat(matches.gl_pathv[i], &st) == 0 && S_ISREG(st.st_mode))
+                        inputs.push_back(matches.gl_pathv[i]);
+            }
+            globfree(&matches);
+        }
+
+        // Порядок заданий не зависит от порядка записей в каталоге
+        std::sort(inputs.begin(), inputs.end());
+        for (const auto &input : inputs)
+            this->jobs.push_back({input, outputPath(input, out_dir)});
+        checkOutputs();
+        return;
+    }
+
+    // Манифест: пары путей "вход выход" по одной на строку
+    std::ifstream manifest(spec);
+    if (!manifest.is_open())
+    {
+        throw FileNotFoundError(
+            "Failed to open batch manifest \"" + spec + "\"",
+            "BatchMan.collect()");
+    }
+    std::string line;
+    size_t line_no = 0;
+    while (std::getline(manifest, line))
+    {
+        ++line_no;
+        std::istringstream iss(line);
+        BatchJob job;
+        if (!(iss >> job.input) || job.input[0] == '#')
+            continue;
+        if (!(iss >> job.output))
+        {
+            throw ArgsDecodeError(
+                "Missing output path in manifest line " + std::to_string(line_no),
+                "BatchMan.collect()");
+        }
+        this->jobs.push_back(job);
+    }
+    checkOutputs();
+}
+
+// Метод для проверки, что выходные файлы заданий не совпадают
+void BatchMan::checkOutputs() const
+{
+    std::map<std::string, const BatchJob *> outputs;
+    for (const auto &job : this->jobs)
+    {
+        auto inserted = outputs.emplace(job.output, &job);
+        if (!inserted.second)
+        {
+            throw ArgsDecodeError(
+                "Output path \"" + job.output + "\" is shared by \"" + inserted.first->second->input +
+                    "\" and \"" + job.input + "\"",
+                "BatchMan.collect()");
+        }
+    }
+}
+
+void BatchMan::setCpus(const std::vector<int> &cpus)
+{
+    this->cpus = cpus;
+}
+
+void BatchMan::setDeadline(double seconds)
+{
+    this->deadline = seconds;
+}
+
+// Метод для отмены пакета из другого потока
+void BatchMan::cancel()
+{
+    this->cancelled = true;
+    std::lock_guard<std::mutex> lock(this->nets_mutex);
+    for (NetMan *net_man : this->nets)
+        net_man->cancel();
+}
+
+// Метод для выполнения заданий
+size_t BatchMan::run(size_t concurrency, const std::function<NetMan *()> &make_net)
+{
+    // Учетные данные читаются один раз для всех рабочих потоков
+    IOMan conf_man(this->config_path, "", "");
+    std::array<std::string, 2> credentials = conf_man.conf();
+
+    concurrency = std::max<size_t>(1, std::min(concurrency, this->jobs.size()));
+    std::atomic<size_t> next(0);
+    std::atomic<uint64_t> vectors(0);
+    std::atomic<uint64_t> bytes(0);
+    std::atomic<size_t> completed(0);
+    std::mutex failures_mutex;
+    std::vector<std::string> failures;
+
+    auto start = std::chrono::steady_clock::now();
+    auto worker = [&](size_t id)
+    {
+        Affinity::pin(this->cpus, id);
+        std::unique_ptr<NetMan> net_man;
+        std::string net_error;
+        try
+        {
+            net_man.reset(make_net());
+            if (!net_man)
+                net_error = "Failed to create connection";
+        }
+        catch (const std::exception &e)
+        {
+            net_error = e.what();
+        }
+        if (!net_error.empty())
+        {
+            // Без подключения поток забирает задания из очереди и отмечает их ошибкой,
+            // чтобы исключение не покинуло поток
+            for (size_t i = next++; i < this->jobs.size(); i = next++)
+            {
+                std::lock_guard<std::mutex> lock(failures_mutex);
+                failures.push_back(this->jobs[i].input + ": " + net_error);
+            }
+            return;
+        }
+        net_man->setVerbose(false);
+        bool connected = false;
+        {
+            // Подключение регистрируется для cancel(); отмена до регистрации применяется сразу
+            std::lock_guard<std::mutex> lock(this->nets_mutex);
+            this->nets.push_back(net_man.get());
+            if (this->cancelled)
+                net_man->cancel();
+        }
+
+        // Буферы векторов и результатов переиспользуются между заданиями потока
+        std::vector<std::vector<int16_t>> data;
+        std::vector<int16_t> results;
+
+        for (size_t i = next++; i < this->jobs.size(); i = next++)
+        {
+            const BatchJob &job = this->jobs[i];
+            if (this->cancelled)
+            {
+                std::lock_guard<std::mutex> lock(failures_mutex);
+                failures.push_back(job.input + ": cancelled");
+                continue;
+            }
+            auto job_start = std::chrono::steady_clock::now();
+            net_man->setDeadline(this->deadline > 0
+                                     ? job_start + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                                                       std::chrono::duration<double>(this->deadline))
+                                     : std::chrono::steady_clock::time_point::max());
+            try
+            {
+                // Подключение устанавливается один раз и восстанавливается после сетевой ошибки
+                if (!connected)
+                {
+                    net_man->close();
+                    net_man->conn();
+                    net_man->auth(credentials[0], credentials[1]);
+                    connected = true;
+                }
+
+                IOMan io_man(this->config_path, job.input, job.output);
+                io_man.setBackend(this->io_backend);
+                io_man.setVerbose(false);
+                size_t count = 0;
+                if (io_man.loadIndex() && io_man.getIndex().format() == VecIndex::FORMAT_BINARY && net_man->canSendFile())
+                {
+                    // Двоичный файл с индексом передается из файла в сокет без разбора векторов
+                    count = io_man.getIndex().count();
+                    HugeMem::resize(results, count);
+                    net_man->calcFile(job.input, io_man.getIndex(), results, 0, std::function<void(size_t, size_t)>());
+                }
+                else
+                {
+                    io_man.read(data);
+                    count = data.size();
+                    HugeMem::resize(results, count);
+                    net_man->calc(data, results, 0, std::function<void(size_t, size_t)>());
+                }
+                io_man.write(results);
+
+                struct stat st;
+                if (::stat(job.input.c_str(), &st) == 0)
+                    bytes += st.st_size;
+                vectors += count;
+                ++completed;
+                LatencyStats::record(LatencyStats::JOB, std::chrono::steady_clock::now() - job_start);
+            }
+            catch (const std::exception &e)
+            {
+                if (dynamic_cast<const NetworkError *>(&e) || dynamic_cast<const AuthError *>(&e))
+                    connected = false;
+                std::lock_guard<std::mutex> lock(failures_mutex);
+                failures.push_back(job.input + ": " + e.what());
+            }
+        }
+        net_man->close();
+        std::lock_guard<std::mutex> lock(this->nets_mutex);
+        this->nets.erase(std::find(this->nets.begin(), this->nets.end(), net_man.get()));
+    };
+
+    std::vector<std::thread> workers;
+    for (size_t i = 0; i < concurrency; ++i)
+        workers.emplace_back(worker, i);
+    for (auto &thread : workers)
+        thread.join();
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    this->vectors = vectors;
+    this->completed = completed;
+
+    // Сводка по пакету
+    for (const auto &failure : failures)
+        std::cout << "Failed: " << failure << "\n";
+    double seconds = std::max(elapsed.count(), 1e-9);
+    std::cout << "Log: \"BatchMan.run()\"\n";
+    std::cout << "Batch: " << this->completed << "/" << this->jobs.size() << " files ("
+              << failures.size() << " failed) with " << concurrency << " connections in "
+              << elapsed.count() << " s\n";
+    std::cout << "Throughput: " << this->completed / seconds << " files/s, "
+              << this->vectors / seconds << " vectors/s, "
+              << bytes / seconds / 1e6 << " MB/s of input\n";
+
+    return failures.size();
+}
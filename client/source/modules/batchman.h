@@ -0,0 +1,147 @@
+#ifndef BATCH_MANAGER_H
+#define BATCH_MANAGER_H
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <functional>
+#include <atomic>
+#include <mutex>
+#include "netman.h"
+#include "errors.h"
+
+/**
+* @file batchman.h
+* @brief Определение класса для пакетной обработки множества файлов.
+* @details Этот файл содержит определения методов для составления списка заданий из каталога,
+* шаблона имен или файла-манифеста и их выполнения пулом рабочих потоков, каждый из которых
+* использует собственное аутентифицированное подключение.
+* @date 19.10.2026
+* @version 1.0
+* @authorsa Ягольницкий Р. С.
+*/
+
+/**
+* @brief Задание пакетной обработки: пара входного и выходного файлов.
+*/
+struct BatchJob
+{
+    std::string input; ///< Путь к входному файлу.
+    std::string output; ///< Путь к выходному файлу.
+};
+
+/**
+* @brief Класс для пакетной обработки файлов пулом рабочих потоков.
+*/
+class BatchMan
+{
+public:
+    /**
+    * @brief Конструктор класса BatchMan.
+    * @param config_path Путь к файлу конфигурации с учетными данными.
+    * @param io_backend Механизм ввода-вывода для чтения и записи файлов.
+    */
+    BatchMan(const std::string &config_path, const std::string &io_backend);
+
+    /**
+    * @brief Метод для составления списка заданий.
+    * @details Источник заданий определяется по виду параметра:
+    * каталог - все обычные файлы каталога, кроме индексов (.idx) и контрольных точек (.ckpt);
+    * строка с символами *, ? или [ - файлы, подходящие под шаблон (также без служебных файлов);
+    * иначе - манифест, каждая строка которого содержит пути входного и выходного файлов
+    * (пустые строки и строки, начинающиеся с #, пропускаются).
+    * Для каталога и шаблона выходной файл размещается в out_dir с именем входного файла и суффиксом .out.
+    * @param spec Каталог, шаблон имен или путь к манифесту.
+    * @param out_dir Каталог для выходных файлов (не используется для манифеста).
+    * @throw FileNotFoundError Если не удалось открыть каталог или манифест.
+    * @throw ArgsDecodeError Если не задан каталог для выходных файлов, строка манифеста некорректна
+    * или у двух заданий совпадает выходной файл.
+    */
+    void collect(const std::string &spec, const std::string &out_dir);
+
+    /**
+    * @brief Метод для получения списка заданий.
+    * @return Список заданий.
+    */
+    std::vector<BatchJob> &getJobs();
+
+    /**
+    * @brief Метод для выполнения заданий.
+    * @details Каждый рабочий поток создает собственный NetMan, подключается и аутентифицируется один раз
+    * и обрабатывает задания из общей очереди. Ошибка задания не прерывает остальные; после сетевой
+    * ошибки поток переподключается перед следующим заданием. Если make_net выбрасывает исключение,
+    * задания этого потока отмечаются ошибкой. В конце выводится сводка по пропускной способности.
+    * @param concurrency Максимальное количество одновременных подключений.
+    * @param make_net Функция, создающая настроенный NetMan для рабочего потока.
+    * @return Количество заданий, завершившихся ошибкой.
+    * @throw FileNotFoundError Если не удалось открыть файл конфигурации.
+    * @throw InvalidDataFormatError Если в конфигурации отсутствуют логин или пароль.
+    */
+    size_t run(size_t concurrency, const std::function<NetMan *()> &make_net);
+
+    /**
+    * @brief Метод для установки процессоров рабочих потоков.
+    * @details Рабочие потоки привязываются к процессорам списка по кругу до выделения своих буферов,
+    * поэтому буферы размещаются на узле NUMA процессора потока.
+    * @param cpus Список процессоров (пустой список - без привязки).
+    */
+    void setCpus(const std::vector<int> &cpus);
+
+    /**
+    * @brief Метод для установки срока каждого задания.
+    * @details Срок отсчитывается от начала обработки файла; задание, не завершенное за это время,
+    * завершается DeadlineError, а рабочий поток освобождается для следующего файла.
+    * @param seconds Срок в секундах (0 - без срока).
+    */
+    void setDeadline(double seconds);
+
+    /**
+    * @brief Метод для отмены пакета из другого потока.
+    * @details Прерывает текущие задания рабочих потоков (CancelledError); оставшиеся задания
+    * не запускаются и учитываются как завершившиеся ошибкой.
+    */
+    void cancel();
+
+    /**
+    * @brief Метод для получения количества обработанных векторов.
+    * @return Количество векторов во всех успешно обработанных файлах.
+    */
+    uint64_t &getVectors();
+
+    /**
+    * @brief Метод для получения количества успешно обработанных файлов.
+    * @return Количество файлов.
+    */
+    size_t &getCompleted();
+
+private:
+    std::string config_path; ///< Путь к файлу конфигурации.
+    std::string io_backend; ///< Механизм ввода-вывода.
+    std::vector<int> cpus; ///< Процессоры рабочих потоков.
+    std::vector<BatchJob> jobs; ///< Список заданий.
+    uint64_t vectors; ///< Количество обработанных векторов.
+    size_t completed; ///< Количество успешно обработанных файлов.
+    double deadline; ///< Срок каждого задания в секундах (0 - без срока).
+    std::atomic<bool> cancelled; ///< Флаг отмены пакета.
+    std::mutex nets_mutex; ///< Мьютекс списка подключений.
+    std::vector<NetMan *> nets; ///< Подключения рабочих потоков для отмены.
+
+    /**
+    * @brief Вспомогательный метод для получения пути выходного файла по входному.
+    * @param input Путь к входному файлу.
+    * @param out_dir Каталог для выходных файлов.
+    * @return Путь к выходному файлу.
+    */
+    static std::string outputPath(const std::string &input, const std::string &out_dir);
+
+    /**
+    * @brief Вспомогательный метод для проверки, что выходные файлы заданий не совпадают.
+    * @details Файлы с одинаковым именем из разных каталогов (например, a/x.txt и b/x.txt
+    * при шаблоне) иначе перезаписывали бы результаты друг друга.
+    * @throw ArgsDecodeError Если у двух заданий совпадает выходной файл.
+    */
+    void checkOutputs() const;
+};
+
+#endif // BATCH_MANAGER_H
@@ -0,0 +1,388 @@
+#include "compman.h"
+#include <zstd.h>
+#include <lz4frame.h>
+#include <cstring>
+
+// Размер блока чтения сжатого файла
+static const size_t CHUNK_SIZE = 1 << 17;
+// Максимальное количество распакованных блоков в очереди
+static const size_t MAX_BLOCKS = 8;
+
+namespace
+{
+    // Поток ввода, владеющий файлом и буфером распаковки
+    class CompIStream : public std::istream
+    {
+    public:
+        CompIStream(const std::string &path, const std::string &codec)
+            : std::istream(nullptr),
+              file(path, std::ios::binary),
+              buf(&file, codec)
+        {
+            this->rdbuf(&this->buf);
+        }
+
+        std::ifstream file;
+        DecompressBuf buf;
+    };
+
+    // Поток вывода, владеющий файлом и буфером сжатия
+    class CompOStream : public std::ostream
+    {
+    public:
+        CompOStream(const std::string &path, const std::string &codec)
+            : std::ostream(nullptr),
+              file(path, std::ios::binary),
+              buf(&file, codec)
+        {
+            this->rdbuf(&this->buf);
+        }
+
+        std::ofstream file;
+        CompressBuf buf;
+    };
+}
+
+// Конструктор
+DecompressBuf::DecompressBuf(std::ifstream *file, const std::string &codec)
+    : file(file), codec(codec), finished(false), stopped(false)
+{
+    this->setg(nullptr, nullptr, nullptr);
+    this->worker = std::thread(&DecompressBuf::produce, this);
+}
+
+// Деструктор
+DecompressBuf::~DecompressBuf()
+{
+    {
+        std::lock_guard<std::mutex> lock(this->mtx);
+        this->stopped = true;
+    }
+    this->cv.notify_all();
+    if (this->worker.joinable())
+        this->worker.join();
+}
+
+std::string DecompressBuf::error()
+{
+    std::lock_guard<std::mutex> lock(this->mtx);
+    return this->err;
+}
+
+// Метод для помещения блока в очередь с ожиданием свободного места
+bool DecompressBuf::push(std::vector<char> &block)
+{
+    std::unique_lock<std::mutex> lock(this->mtx);
+    this->cv.wait(lock, [this]
+                  { return this->stopped || this->blocks.size() < MAX_BLOCKS; });
+    if (this->stopped)
+        return false;
+    this->blocks.push_back(std::move(block));
+    this->cv.notify_all();
+    return true;
+}
+
+// Основной цикл потока-распаковщика
+void DecompressBuf::produce()
+{
+    std::vector<char> src(CHUNK_SIZE);
+    std::string error;
+    ZSTD_DStream *zds = nullptr;
+    LZ4F_dctx *lz4 = nullptr;
+
+    if (this->codec == "zst")
+        zds = ZSTD_createDStream();
+    else if (LZ4F_isError(LZ4F_createDecompressionContext(&lz4, LZ4F_VERSION)))
+        error = "Failed to create lz4 decompression context";
+
+    // Ненулевая подсказка декодера означает, что кадр не завершен и ожидаются еще данные;
+    // вызов без входа и выхода ее не обновляет (после конца кадра декодер ждет заголовок следующего)
+    size_t hint = 0;
+    while (error.empty())
+    {
+        size_t src_size = 0;
+        if (*this->file)
+        {
+            this->file->read(src.data(), src.size());
+            src_size = this->file->gcount();
+        }
+        bool eof = src_size == 0;
+
+        // Распаковка прочитанного блока, пока не израсходованы входные данные и выходной блок
+        // заполняется целиком (декодер может хранить еще не выданные данные); в конце файла
+        // декодер вызывается с пустым входом, пока не перестанет выдавать данные
+        size_t pos = 0;
+        bool full = true;
+        while (pos < src_size || full)
+        {
+            std::vector<char> block(CHUNK_SIZE * 2);
+            size_t produced = 0;
+            if (zds)
+            {
+                ZSTD_inBuffer in = {src.data() + pos, src_size - pos, 0};
+                ZSTD_outBuffer out = {block.data(), block.size(), 0};
+                size_t ret = ZSTD_decompressStream(zds, &out, &in);
+                if (ZSTD_isError(ret))
+                {
+                    error = ZSTD_getErrorName(ret);
+                    break;
+                }
+                pos += in.pos;
+                produced = out.pos;
+                if (in.pos || produced)
+                    hint = ret;
+            }
+            else
+            {
+                size_t in_size = src_size - pos;
+                size_t out_size = block.size();
+                size_t ret = LZ4F_decompress(lz4, block.data(), &out_size, src.data() + pos, &in_size, nullptr);
+                if (LZ4F_isError(ret))
+                {
+                    error = LZ4F_getErrorName(ret);
+                    break;
+                }
+                pos += in_size;
+                produced = out_size;
+                if (in_size || produced)
+                    hint = ret;
+            }
+            full = produced == block.size();
+            if (produced == 0)
+                continue;
+            block.resize(produced);
+            if (!this->push(block))
+            {
+                error = "Stopped";
+                break;
+            }
+        }
+        if (eof)
+            break;
+    }
+    if (error.empty() && hint != 0)
+        error = "Truncated compressed input";
+
+    if (zds)
+        ZSTD_freeDStream(zds);
+    if (lz4)
+        LZ4F_freeDecompressionContext(lz4);
+
+    std::lock_guard<std::mutex> lock(this->mtx);
+    this->err = error;
+    this->finished = true;
+    this->cv.notify_all();
+}
+
+// Метод для получения следующего блока из очереди
+DecompressBuf::int_type DecompressBuf::underflow()
+{
+    if (this->gptr() < this->egptr())
+        return traits_type::to_int_type(*this->gptr());
+
+    std::unique_lock<std::mutex> lock(this->mtx);
+    this->cv.wait(lock, [this]
+                  { return this->finished || !this->blocks.empty(); });
+    if (this->blocks.empty())
+        return traits_type::eof();
+
+    this->current = std::move(this->blocks.front());
+    this->blocks.pop_front();
+    this->cv.notify_all();
+
+    this->setg(this->current.data(), this->current.data(), this->current.data() + this->current.size());
+    return traits_type::to_int_type(*this->gptr());
+}
+
+// Конструктор
+CompressBuf::CompressBuf(std::ofstream *file, const std::string &codec)
+    : file(file), codec(codec), in(CHUNK_SIZE), ctx(nullptr), finished(false)
+{
+    if (this->codec == "zst")
+    {
+        this->ctx = ZSTD_createCCtx();
+        this->out.resize(ZSTD_CStreamOutSize());
+    }
+    else
+    {
+        LZ4F_cctx *lz4 = nullptr;
+        if (LZ4F_isError(LZ4F_createCompressionContext(&lz4, LZ4F_VERSION)))
+            throw InvalidDataFormatError("Failed to create lz4 compression context", "CompressBuf()");
+        this->ctx = lz4;
+        this->out.resize(LZ4F_compressBound(CHUNK_SIZE, nullptr) + LZ4F_HEADER_SIZE_MAX);
+        size_t ret = LZ4F_compressBegin(lz4, this->out.data(), this->out.size(), nullptr);
+        if (LZ4F_isError(ret))
+        {
+            // Деструктор не вызывается для объекта, конструктор которого выбросил исключение
+            LZ4F_freeCompressionContext(lz4);
+            throw InvalidDataFormatError(std::string("Failed to write lz4 header: ") + LZ4F_getErrorName(ret),
+                                         "CompressBuf()");
+        }
+        this->file->write(this->out.data(), ret);
+    }
+    this->setp(this->in.data(), this->in.data() + this->in.size());
+}
+
+// Деструктор
+CompressBuf::~CompressBuf()
+{
+    if (!this->finished)
+        this->compress(true);
+    if (this->codec == "zst")
+        ZSTD_freeCCtx(static_cast<ZSTD_CCtx *>(this->ctx));
+    else
+        LZ4F_freeCompressionContext(static_cast<LZ4F_cctx *>(this->ctx));
+}
+
+// Метод для сжатия накопленных данных
+bool CompressBuf::compress(bool end)
+{
+    size_t size = this->pptr() - this->pbase();
+
+    if (this->codec == "zst")
+    {
+        ZSTD_CCtx *zcs = static_cast<ZSTD_CCtx *>(this->ctx);
+        ZSTD_inBuffer input = {this->pbase(), size, 0};
+        ZSTD_EndDirective mode = end ? ZSTD_e_end : ZSTD_e_continue;
+        size_t remaining;
+        do
+        {
+            ZSTD_outBuffer output = {this->out.data(), this->out.size(), 0};
+            remaining = ZSTD_compressStream2(zcs, &output, &input, mode);
+            if (ZSTD_isError(remaining))
+                return false;
+            this->file->write(this->out.data(), output.pos);
+        } while (end ? remaining != 0 : input.pos != input.size);
+    }
+    else
+    {
+        LZ4F_cctx *lz4 = static_cast<LZ4F_cctx *>(this->ctx);
+        size_t ret = LZ4F_compressUpdate(lz4, this->out.data(), this->out.size(), this->pbase(), size, nullptr);
+        if (LZ4F_isError(ret))
+            return false;
+        this->file->write(this->out.data(), ret);
+        if (end)
+        {
+            ret = LZ4F_compressEnd(lz4, this->out.data(), this->out.size(), nullptr);
+            if (LZ4F_isError(ret))
+                return false;
+            this->file->write(this->out.data(), ret);
+        }
+    }
+
+    this->setp(this->in.data(), this->in.data() + this->in.size());
+    if (end)
+    {
+        this->finished = true;
+        this->file->flush();
+    }
+    return bool(*this->file);
+}
+
+CompressBuf::int_type CompressBuf::overflow(int_type ch)
+{
+    if (this->finished || !this->compress(false))
+        return traits_type::eof();
+    if (!traits_type::eq_int_type(ch, traits_type::eof()))
+    {
+        *this->pptr() = traits_type::to_char_type(ch);
+        this->pbump(1);
+    }
+    return traits_type::not_eof(ch);
+}
+
+int CompressBuf::sync()
+{
+    if (this->finished)
+        return 0;
+    return this->compress(false) ? 0 : -1;
+}
+
+void CompressBuf::finish()
+{
+    if (this->finished)
+        return;
+    if (!this->compress(true))
+        throw InvalidDataFormatError("Failed to compress output data", "CompressBuf.finish()");
+}
+
+// Метод для определения кодека по расширению файла
+std::string CompMan::codec(const std::string &path)
+{
+    size_t dot = path.rfind('.');
+    if (dot == std::string::npos)
+        return "";
+    std::string ext = path.substr(dot + 1);
+    if (ext == "zst" || ext == "lz4")
+        return ext;
+    return "";
+}
+
+// Метод для открытия входного файла
+std::istream *CompMan::openInput(const std::string &path)
+{
+    std::string codec = CompMan::codec(path);
+    if (codec.empty())
+    {
+        std::ifstream *file = new std::ifstream(path);
+        if (!file->is_open())
+        {
+            delete file;
+            return nullptr;
+        }
+        return file;
+    }
+
+    CompIStream *stream = new CompIStream(path, codec);
+    if (!stream->file.is_open())
+    {
+        delete stream;
+        return nullptr;
+    }
+    return stream;
+}
+
+// Метод для открытия выходного файла
+std::ostream *CompMan::openOutput(const std::string &path)
+{
+    std::string codec = CompMan::codec(path);
+    if (codec.empty())
+    {
+        std::ofstream *file = new std::ofstream(path, std::ios::binary);
+        if (!file->is_open())
+        {
+            delete file;
+            return nullptr;
+        }
+        return file;
+    }
+
+    CompOStream *stream = new CompOStream(path, codec);
+    if (!stream->file.is_open())
+    {
+        delete stream;
+        return nullptr;
+    }
+    return stream;
+}
+
+// Метод для проверки ошибок распаковки
+void CompMan::check(std::istream &stream)
+{
+    CompIStream *comp = dynamic_cast<CompIStream *>(&stream);
+    if (comp == nullptr)
+        return;
+    std::string error = comp->buf.error();
+    if (!error.empty())
+        throw InvalidDataFormatError("Failed to decompress input data: " + error, "CompMan.check()");
+}
+
+// Метод для завершения записи в поток
+void CompMan::finish(std::ostream &stream)
+{
+    CompOStream *comp = dynamic_cast<CompOStream *>(&stream);
+    if (comp != nullptr)
+        comp->buf.finish();
+    else
+        stream.flush();
+}
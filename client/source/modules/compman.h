@@ -0,0 +1,183 @@
+#ifndef COMPRESSION_MANAGER_H
+#define COMPRESSION_MANAGER_H
+
+#include <string>
+#include <vector>
+#include <deque>
+#include <istream>
+#include <ostream>
+#include <fstream>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include "errors.h"
+
+/**
+* @file compman.h
+* @brief Определение классов для потокового сжатия и распаковки файлов.
+* @details Этот файл содержит определения буферов потоков для форматов zstd и lz4,
+* а также фабричные методы для открытия входных и выходных файлов с учетом расширения.
+* @date 19.10.2026
+* @version 1.0
+* @authorsa Ягольницкий Р. С.
+*/
+
+/**
+* @brief Буфер потока с распаковкой в отдельном потоке.
+* @details Поток-распаковщик читает файл блоками и складывает распакованные данные
+* в ограниченную очередь, опережая разбор на стороне читателя.
+*/
+class DecompressBuf : public std::streambuf
+{
+public:
+    /**
+    * @brief Конструктор класса DecompressBuf.
+    * @param file Открытый входной файл.
+    * @param codec Кодек сжатия ("zst" или "lz4").
+    */
+    DecompressBuf(std::ifstream *file, const std::string &codec);
+
+    /**
+    * @brief Деструктор класса DecompressBuf. Останавливает поток-распаковщик.
+    */
+    ~DecompressBuf();
+
+    /**
+    * @brief Метод для получения сообщения об ошибке распаковки.
+    * @return Сообщение об ошибке или пустая строка.
+    */
+    std::string error();
+
+protected:
+    /**
+    * @brief Получение следующего распакованного блока из очереди.
+    * @return Следующий символ или EOF.
+    */
+    int_type underflow() override;
+
+private:
+    std::ifstream *file; ///< Входной файл.
+    std::string codec; ///< Кодек сжатия.
+    std::thread worker; ///< Поток-распаковщик.
+    std::mutex mtx; ///< Мьютекс очереди.
+    std::condition_variable cv; ///< Условная переменная очереди.
+    std::deque<std::vector<char>> blocks; ///< Очередь распакованных блоков.
+    std::vector<char> current; ///< Текущий блок читателя.
+    bool finished; ///< Флаг окончания распаковки.
+    bool stopped; ///< Флаг остановки потока-распаковщика.
+    std::string err; ///< Сообщение об ошибке распаковки.
+
+    /**
+    * @brief Основной цикл потока-распаковщика.
+    */
+    void produce();
+
+    /**
+    * @brief Помещение распакованного блока в очередь.
+    * @param block Распакованный блок.
+    * @return false, если поток-распаковщик должен завершиться.
+    */
+    bool push(std::vector<char> &block);
+};
+
+/**
+* @brief Буфер потока со сжатием при записи.
+*/
+class CompressBuf : public std::streambuf
+{
+public:
+    /**
+    * @brief Конструктор класса CompressBuf.
+    * @param file Открытый выходной файл.
+    * @param codec Кодек сжатия ("zst" или "lz4").
+    * @throw InvalidDataFormatError Если не удалось создать контекст lz4 или записать заголовок кадра.
+    */
+    CompressBuf(std::ofstream *file, const std::string &codec);
+
+    /**
+    * @brief Деструктор класса CompressBuf. Завершает кадр сжатия.
+    */
+    ~CompressBuf();
+
+    /**
+    * @brief Метод для завершения кадра сжатия и сброса данных в файл.
+    * @throw InvalidDataFormatError Если не удалось сжать данные.
+    */
+    void finish();
+
+protected:
+    /**
+    * @brief Сжатие заполненного буфера.
+    * @param ch Символ, не поместившийся в буфер.
+    * @return ch или EOF при ошибке.
+    */
+    int_type overflow(int_type ch) override;
+
+    /**
+    * @brief Синхронизация буфера (сжатие накопленных данных).
+    * @return 0 при успехе, -1 при ошибке.
+    */
+    int sync() override;
+
+private:
+    std::ofstream *file; ///< Выходной файл.
+    std::string codec; ///< Кодек сжатия.
+    std::vector<char> in; ///< Буфер несжатых данных.
+    std::vector<char> out; ///< Буфер сжатых данных.
+    void *ctx; ///< Контекст сжатия zstd или lz4.
+    bool finished; ///< Флаг завершенного кадра.
+
+    /**
+    * @brief Сжатие накопленных данных.
+    * @param end Завершить кадр сжатия.
+    * @return false при ошибке сжатия.
+    */
+    bool compress(bool end);
+};
+
+/**
+* @brief Класс для управления сжатием входных и выходных файлов.
+*/
+class CompMan
+{
+public:
+    /**
+    * @brief Статический метод для определения кодека по расширению файла.
+    * @param path Путь к файлу.
+    * @return "zst", "lz4" или пустая строка для несжатых файлов.
+    */
+    static std::string codec(const std::string &path);
+
+    /**
+    * @brief Статический метод для открытия входного файла.
+    * @details Для файлов .zst/.lz4 распаковка выполняется в отдельном потоке.
+    * @param path Путь к входному файлу.
+    * @return Указатель на поток ввода или nullptr, если файл не удалось открыть.
+    */
+    static std::istream *openInput(const std::string &path);
+
+    /**
+    * @brief Статический метод для открытия выходного файла.
+    * @details Для файлов .zst/.lz4 данные сжимаются при записи.
+    * @param path Путь к выходному файлу.
+    * @return Указатель на поток вывода или nullptr, если файл не удалось открыть.
+    * @throw InvalidDataFormatError Если не удалось инициализировать сжатие.
+    */
+    static std::ostream *openOutput(const std::string &path);
+
+    /**
+    * @brief Статический метод для проверки ошибок распаковки потока.
+    * @param stream Поток, открытый через openInput().
+    * @throw InvalidDataFormatError Если при распаковке произошла ошибка.
+    */
+    static void check(std::istream &stream);
+
+    /**
+    * @brief Статический метод для завершения записи в поток.
+    * @param stream Поток, открытый через openOutput().
+    * @throw InvalidDataFormatError Если не удалось завершить кадр сжатия.
+    */
+    static void finish(std::ostream &stream);
+};
+
+#endif // COMPRESSION_MANAGER_H
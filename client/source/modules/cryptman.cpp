@@ -1,4 +1,5 @@
 #include "cryptman.h"
+#include "probes.h"
 #include <cryptopp/hex.h>
 #include <cryptopp/md5.h>
 #include <cryptopp/osrng.h>
@@ -38,6 +39,7 @@ std::string CryptMan::get_hash(const std::string &salt, const std::string &data)
 {
     CryptoPP::MD5 hash_func; // создаем объект хеш-функции
     std::string hash_hex;
+    VCLIENT_PROBE1(hash_start, salt.size() + data.size());
 
     // формирование хэша и преобразование в шестнадцатеричную строку
     CryptoPP::StringSource(
@@ -50,5 +52,6 @@ std::string CryptMan::get_hash(const std::string &salt, const std::string &data)
                 true // Заглавные буквы
                 )));
 
+    VCLIENT_PROBE1(hash_end, salt.size() + data.size());
     return hash_hex;
 }
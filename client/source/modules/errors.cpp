@@ -27,3 +27,18 @@ AuthError::AuthError(const std::string &message, const std::string &func)
 
 NetworkError::NetworkError(const std::string &message, const std::string &func)
     : BasicClientError("NetworkError", message, func) {}
+
+NetworkError::NetworkError(const std::string &name, const std::string &message, const std::string &func)
+    : BasicClientError(name, message, func) {}
+
+TimeoutError::TimeoutError(const std::string &message, const std::string &func)
+    : NetworkError("TimeoutError", message, func) {}
+
+DeadlineError::DeadlineError(const std::string &message, const std::string &func)
+    : NetworkError("DeadlineError", message, func) {}
+
+CancelledError::CancelledError(const std::string &message, const std::string &func)
+    : NetworkError("CancelledError", message, func) {}
+
+BatchError::BatchError(const std::string &message, const std::string &func)
+    : BasicClientError("BatchError", message, func) {}
@@ -107,6 +107,71 @@ public:
     * @param func Имя функции, в которой возникла ошибка.
     */
     NetworkError(const std::string &message, const std::string &func);
+
+protected:
+    /**
+    * @brief Конструктор для подклассов NetworkError.
+    * @param name Имя ошибки.
+    * @param message Сообщение об ошибке.
+    * @param func Имя функции, в которой возникла ошибка.
+    */
+    NetworkError(const std::string &name, const std::string &message, const std::string &func);
+};
+
+/** 
+* @brief Класс для обработки истечения таймаута сетевой операции (подключения, отправки или приема).
+*/
+class TimeoutError : public NetworkError
+{
+public:
+    /**
+    * @brief Конструктор класса TimeoutError.
+    * @param message Сообщение об ошибке.
+    * @param func Имя функции, в которой возникла ошибка.
+    */
+    TimeoutError(const std::string &message, const std::string &func);
+};
+
+/** 
+* @brief Класс для обработки истечения срока задания. Повторные попытки не выполняются.
+*/
+class DeadlineError : public NetworkError
+{
+public:
+    /**
+    * @brief Конструктор класса DeadlineError.
+    * @param message Сообщение об ошибке.
+    * @param func Имя функции, в которой возникла ошибка.
+    */
+    DeadlineError(const std::string &message, const std::string &func);
+};
+
+/** 
+* @brief Класс для обработки отмены сетевой операции из другого потока. Повторные попытки не выполняются.
+*/
+class CancelledError : public NetworkError
+{
+public:
+    /**
+    * @brief Конструктор класса CancelledError.
+    * @param message Сообщение об ошибке.
+    * @param func Имя функции, в которой возникла ошибка.
+    */
+    CancelledError(const std::string &message, const std::string &func);
+};
+
+/** 
+* @brief Класс для обработки ошибок пакетной обработки файлов.
+*/
+class BatchError : public BasicClientError
+{
+public:
+    /**
+    * @brief Конструктор класса BatchError.
+    * @param message Сообщение об ошибке.
+    * @param func Имя функции, в которой возникла ошибка.
+    */
+    BatchError(const std::string &message, const std::string &func);
 };
 
 #endif // ERRORS_H
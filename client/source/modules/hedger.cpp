@@ -0,0 +1,358 @@
+#include "hedger.h"
+#include "errors.h"
+#include <algorithm>
+#include <thread>
+
+const size_t Hedger::BATCH = 256;
+const size_t Hedger::CONNECTIONS = 2;
+const uint64_t Hedger::MIN_SAMPLES = 8;
+
+// Конструктор
+Hedger::Hedger(
+    const std::function<NetMan *(size_t)> &make_net,
+    const std::string &login,
+    const std::string &password,
+    double percentile,
+    double budget,
+    int retries,
+    size_t batch)
+    : make_net(make_net),
+      login(login),
+      password(password),
+      percentile(percentile),
+      budget(budget),
+      retries(std::max(0, retries)),
+      batch(std::max<size_t>(1, batch)),
+      buffers(CONNECTIONS),
+      tasks(CONNECTIONS, -1),
+      connected(CONNECTIONS, 0),
+      sending(CONNECTIONS, 0),
+      started(CONNECTIONS),
+      batches(0),
+      hedges(0),
+      wins(0),
+      delay_ns(0),
+      stopping(false)
+{
+    for (size_t id = 0; id < CONNECTIONS; ++id)
+    {
+        this->nets.emplace_back(this->make_net(id));
+        this->nets.back()->setVerbose(false);
+    }
+}
+
+// Деструктор
+Hedger::~Hedger()
+{
+    for (auto &net : this->nets)
+        net->close();
+}
+
+uint64_t &Hedger::getBatches()
+{
+    return this->batches;
+};
+uint64_t &Hedger::getHedged()
+{
+    return this->hedges;
+};
+uint64_t &Hedger::getWins()
+{
+    return this->wins;
+};
+LatencyHist &Hedger::getHedgedLatency()
+{
+    return this->hedged_latency;
+};
+LatencyHist &Hedger::getPrimaryLatency()
+{
+    return this->primary_latency;
+};
+
+// Метод для поиска свободного подключения
+long Hedger::idle()
+{
+    for (size_t id = 0; id < CONNECTIONS; ++id)
+        if (this->tasks[id] < 0)
+            return id;
+    return -1;
+}
+
+// Метод для отправки пакета подключению
+void Hedger::issue(size_t id, size_t index)
+{
+    auto now = std::chrono::steady_clock::now();
+    if (this->primaries[index] < 0)
+    {
+        this->primaries[index] = id;
+        this->issued[index] = now;
+    }
+    this->tasks[id] = index;
+    this->started[id] = now;
+    ++this->in_flight[index];
+    this->cv.notify_all();
+}
+
+// Метод для обработки векторов с дублированием медленных пакетов
+void Hedger::calc(
+    const std::vector<std::vector<int16_t>> &data,
+    std::vector<int16_t> &results,
+    size_t first,
+    const std::function<void(size_t, size_t)> &commit)
+{
+    if (first >= data.size())
+        return;
+
+    this->bounds.clear();
+    for (size_t begin = first; begin < data.size(); begin += this->batch)
+        this->bounds.push_back(begin);
+    this->bounds.push_back(data.size());
+    size_t count = this->bounds.size() - 1;
+    this->issued.assign(count, std::chrono::steady_clock::time_point());
+    this->winners.assign(count, -1);
+    this->primaries.assign(count, -1);
+    this->in_flight.assign(count, 0);
+    this->first_ns.assign(count, 0);
+    this->primary_ns.assign(count, 0);
+    this->hedged.assign(count, 0);
+    for (auto &buffer : this->buffers)
+        buffer.resize(data.size());
+    this->stopping = false;
+    this->error = nullptr;
+
+    std::vector<std::thread> workers;
+    for (size_t id = 0; id < CONNECTIONS; ++id)
+        workers.emplace_back(&Hedger::work, this, id, std::cref(data), std::ref(results));
+
+    // Пакеты отправляются по одному; ожидание ответа прерывается для отправки копии
+    size_t done = 0;
+    size_t max_attempts = CONNECTIONS * (this->retries + 1);
+    {
+        std::unique_lock<std::mutex> lock(this->mutex);
+        for (size_t index = 0; index < count && !this->error; ++index)
+        {
+            size_t attempts = 0;
+            while (!this->error && this->winners[index] < 0)
+            {
+                if (this->in_flight[index] == 0)
+                {
+                    // Пакет еще не отправлен или все его копии завершились ошибкой
+                    if (attempts >= max_attempts)
+                    {
+                        this->error = std::make_exception_ptr(NetworkError(
+                            "Vectors " + std::to_string(this->bounds[index]) + "-" +
+                                std::to_string(this->bounds[index + 1]) + " failed on all connections",
+                            "Hedger.calc()"));
+                        break;
+                    }
+                    long id = this->idle();
+                    if (id < 0)
+                    {
+                        this->cv.wait(lock);
+                        continue;
+                    }
+                    ++attempts;
+                    this->issue(id, index);
+                    continue;
+                }
+
+                // Копия отправляется только после накопления измерений и в пределах доли дублирования
+                bool allowed = !this->hedged[index] && this->percentile > 0.0 &&
+                               this->observed.getCount() >= MIN_SAMPLES &&
+                               this->hedges + 1 <= this->budget * (this->batches + 1);
+                if (!allowed)
+                {
+                    this->cv.wait(lock);
+                    continue;
+                }
+                this->delay_ns = this->observed.percentile(this->percentile);
+                auto deadline = this->issued[index] + std::chrono::nanoseconds(this->delay_ns);
+                if (std::chrono::steady_clock::now() < deadline)
+                {
+                    this->cv.wait_until(lock, deadline);
+                    continue;
+                }
+                long id = this->idle();
+                if (id < 0)
+                {
+                    this->cv.wait(lock);
+                    continue;
+                }
+                this->hedged[index] = 1;
+                ++this->hedges;
+                this->issue(id, index);
+            }
+            if (this->error)
+                break;
+
+            ++this->batches;
+            ++done;
+            if (commit)
+            {
+                lock.unlock();
+                try
+                {
+                    commit(this->bounds[index], this->bounds[index + 1]);
+                }
+                catch (...)
+                {
+                    lock.lock();
+                    this->error = std::current_exception();
+                    break;
+                }
+                lock.lock();
+            }
+        }
+
+        // Копии, не завершенные к концу задания, больше не нужны
+        for (size_t id = 0; id < CONNECTIONS; ++id)
+            if (this->tasks[id] >= 0 && this->sending[id])
+                this->nets[id]->abort();
+        this->stopping = true;
+        this->cv.notify_all();
+    }
+    for (auto &worker : workers)
+        worker.join();
+
+    // Без дублирования пакет ждал бы ответа на первую отправку
+    for (size_t index = 0; index < done; ++index)
+    {
+        this->hedged_latency.record(this->first_ns[index]);
+        this->primary_latency.record(this->primary_ns[index] ? this->primary_ns[index] : this->first_ns[index]);
+    }
+
+    if (this->error)
+        std::rethrow_exception(this->error);
+}
+
+// Метод рабочего потока подключения
+void Hedger::work(
+    size_t id,
+    const std::vector<std::vector<int16_t>> &data,
+    std::vector<int16_t> &results)
+{
+    NetMan &net_man = *this->nets[id];
+
+    // Второе подключение устанавливается заранее, чтобы копия не ждала подключения и аутентификации
+    bool ready = this->connected[id];
+    if (!ready)
+    {
+        try
+        {
+            net_man.conn();
+            net_man.auth(this->login, this->password);
+            ready = true;
+        }
+        catch (const BasicClientError &)
+        {
+            net_man.close();
+        }
+    }
+
+    std::unique_lock<std::mutex> lock(this->mutex);
+    this->connected[id] = ready;
+    for (;;)
+    {
+        this->cv.wait(lock, [this, id]()
+                      { return this->stopping || this->tasks[id] >= 0; });
+        if (this->tasks[id] < 0)
+            break;
+        size_t index = this->tasks[id];
+        bool reconnect = !this->connected[id];
+        lock.unlock();
+
+        bool ok = false;
+        bool abandoned = false;
+        std::exception_ptr fatal;
+        try
+        {
+            if (reconnect)
+            {
+                net_man.close();
+                net_man.conn();
+                net_man.auth(this->login, this->password);
+            }
+            lock.lock();
+            this->connected[id] = 1;
+            abandoned = this->winners[index] >= 0 || this->stopping;
+            this->sending[id] = !abandoned;
+            lock.unlock();
+            if (!abandoned)
+                net_man.calcRange(data, this->buffers[id], this->bounds[index], this->bounds[index + 1]);
+            ok = true;
+        }
+        catch (const DeadlineError &)
+        {
+            // Срок и отмена относятся ко всему заданию, другой сервер их не исправит
+            fatal = std::current_exception();
+        }
+        catch (const CancelledError &)
+        {
+            fatal = std::current_exception();
+        }
+        catch (const NetworkError &)
+        {
+        }
+        catch (const AuthError &)
+        {
+        }
+        catch (...)
+        {
+            fatal = std::current_exception();
+        }
+        auto now = std::chrono::steady_clock::now();
+
+        lock.lock();
+        this->sending[id] = 0;
+        this->tasks[id] = -1;
+        --this->in_flight[index];
+        if (fatal)
+        {
+            if (!this->error)
+                this->error = fatal;
+        }
+        else if (!ok)
+            this->connected[id] = 0;
+        else if (!abandoned)
+        {
+            uint64_t ns = std::chrono::duration_cast<std::chrono::nanoseconds>(now - this->started[id]).count();
+            this->observed.record(ns);
+            if (this->primaries[index] == long(id))
+                this->primary_ns[index] = ns;
+            if (this->winners[index] < 0)
+            {
+                // Результаты берутся из копии, ответившей первой
+                this->winners[index] = id;
+                this->first_ns[index] = std::chrono::duration_cast<std::chrono::nanoseconds>(now - this->issued[index]).count();
+                if (this->primaries[index] != long(id))
+                    ++this->wins;
+                std::copy(this->buffers[id].begin() + this->bounds[index],
+                          this->buffers[id].begin() + this->bounds[index + 1],
+                          results.begin() + this->bounds[index]);
+            }
+        }
+        this->cv.notify_all();
+    }
+}
+
+// Метод для вывода доли дублирования и выигрыша в задержке
+void Hedger::report(std::ostream &out)
+{
+    std::lock_guard<std::mutex> lock(this->mutex);
+    out << "Log: \"Hedger.report()\"\n";
+    out << "Hedging: " << this->hedges << " of " << this->batches << " batches hedged ("
+        << (this->batches ? 100.0 * this->hedges / this->batches : 0.0) << "%, budget "
+        << 100.0 * this->budget << "%), " << this->wins << " won by the hedge, delay "
+        << this->delay_ns / 1e6 << " ms (p" << this->percentile << ")\n";
+
+    // Выигрыш сравнивается по процентилям задержек пакетов с дублированием и без него
+    const double percents[] = {50.0, 99.0, 100.0};
+    const char *names[] = {"p50", "p99", "max"};
+    for (size_t i = 0; i < 3; ++i)
+    {
+        double primary = this->primary_latency.percentile(percents[i]) / 1e6;
+        double hedged = this->hedged_latency.percentile(percents[i]) / 1e6;
+        out << "Batch " << names[i] << ": " << primary << " ms without hedging, " << hedged
+            << " ms with hedging (" << primary - hedged << " ms gain)\n";
+    }
+}
@@ -0,0 +1,176 @@
+#ifndef HEDGER_H
+#define HEDGER_H
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <vector>
+#include "netman.h"
+#include "latency.h"
+
+/**
+* @file hedger.h
+* @brief Определение класса дублирующих (hedged) запросов.
+* @details Этот файл содержит класс, который снижает хвостовые задержки небольших заданий: если результаты
+* пакета не получены за время, равное заданному процентилю задержек предыдущих пакетов, тот же пакет
+* отправляется по второму подключению и используется ответ, полученный первым.
+* @date 19.10.2026
+* @version 1.0
+* @authorsa Ягольницкий Р. С.
+*/
+
+/**
+* @brief Класс дублирующих запросов.
+* @details Задание передается пакетами по BATCH векторов по очереди через два подключения, каждое
+* обслуживается собственным потоком. Пакет отправляется свободному подключению; если ответа нет дольше
+* процентиля percentile задержек уже полученных пакетов, копия пакета отправляется второму подключению.
+* Доля продублированных пакетов не превышает budget. Проигравшая копия дочитывается в фоне, и ее время
+* дает задержку, которая была бы без дублирования; копии, не завершенные к концу задания, прерываются.
+*/
+class Hedger
+{
+public:
+    static const size_t BATCH; ///< Количество векторов в пакете по умолчанию.
+    static const size_t CONNECTIONS; ///< Количество подключений.
+    static const uint64_t MIN_SAMPLES; ///< Количество измеренных пакетов, после которого разрешено дублирование.
+
+    /**
+    * @brief Конструктор класса Hedger.
+    * @param make_net Функция, создающая настроенный NetMan для подключения с заданным номером.
+    * @param login Логин.
+    * @param password Пароль.
+    * @param percentile Процентиль задержек пакетов, после которого отправляется копия (0-100).
+    * @param budget Наибольшая доля продублированных пакетов (0-1).
+    * @param retries Количество повторных отправок пакета после ошибок.
+    * @param batch Количество векторов в пакете.
+    */
+    Hedger(
+        const std::function<NetMan *(size_t)> &make_net,
+        const std::string &login,
+        const std::string &password,
+        double percentile,
+        double budget,
+        int retries = 3,
+        size_t batch = BATCH);
+
+    /**
+    * @brief Деструктор класса Hedger. Закрывает подключения.
+    */
+    ~Hedger();
+
+    /**
+    * @brief Метод для обработки векторов с дублированием медленных пакетов.
+    * @param data Данные для обработки.
+    * @param results Буфер результатов размером data.size().
+    * @param first Индекс первого необработанного вектора.
+    * @param commit Функция, вызываемая с границами [begin, end) каждого обработанного пакета по порядку.
+    * @throw NetworkError Если пакет не удалось обработать после всех повторных отправок.
+    */
+    void calc(
+        const std::vector<std::vector<int16_t>> &data,
+        std::vector<int16_t> &results,
+        size_t first,
+        const std::function<void(size_t, size_t)> &commit);
+
+    /**
+    * @brief Метод для получения количества пакетов.
+    * @return Количество обработанных пакетов.
+    */
+    uint64_t &getBatches();
+
+    /**
+    * @brief Метод для получения количества продублированных пакетов.
+    * @return Количество пакетов, копия которых отправлена второму подключению.
+    */
+    uint64_t &getHedged();
+
+    /**
+    * @brief Метод для получения количества побед копий.
+    * @return Количество продублированных пакетов, копия которых ответила первой.
+    */
+    uint64_t &getWins();
+
+    /**
+    * @brief Метод для получения задержек пакетов с дублированием.
+    * @return Гистограмма времени от отправки пакета до первого ответа.
+    */
+    LatencyHist &getHedgedLatency();
+
+    /**
+    * @brief Метод для получения задержек пакетов без дублирования.
+    * @return Гистограмма времени ответа на первую отправку пакета (для прерванных копий - фактическое время).
+    */
+    LatencyHist &getPrimaryLatency();
+
+    /**
+    * @brief Метод для вывода доли дублирования и выигрыша в задержке.
+    * @param out Поток вывода.
+    */
+    void report(std::ostream &out);
+
+private:
+    std::function<NetMan *(size_t)> make_net; ///< Функция создания NetMan.
+    std::string login; ///< Логин.
+    std::string password; ///< Пароль.
+    double percentile; ///< Процентиль задержки перед отправкой копии.
+    double budget; ///< Наибольшая доля продублированных пакетов.
+    int retries; ///< Количество повторных отправок пакета.
+    size_t batch; ///< Количество векторов в пакете.
+    std::vector<std::unique_ptr<NetMan>> nets; ///< Подключения.
+    std::vector<std::vector<int16_t>> buffers; ///< Буферы результатов подключений.
+    std::vector<long> tasks; ///< Пакеты, выполняемые подключениями (-1 - подключение свободно).
+    std::vector<char> connected; ///< Флаги установленных подключений.
+    std::vector<char> sending; ///< Флаги передачи по установленному подключению (ее можно прервать).
+    std::vector<std::chrono::steady_clock::time_point> started; ///< Время отправки пакетов подключениями.
+    std::vector<size_t> bounds; ///< Границы пакетов.
+    std::vector<std::chrono::steady_clock::time_point> issued; ///< Время первой отправки пакетов.
+    std::vector<long> winners; ///< Подключение, первым вернувшее пакет (-1 - пакет не получен).
+    std::vector<long> primaries; ///< Подключение первой отправки пакета.
+    std::vector<int> in_flight; ///< Количество отправленных и не завершенных копий пакета.
+    std::vector<uint64_t> first_ns; ///< Время до первого ответа на пакет.
+    std::vector<uint64_t> primary_ns; ///< Время ответа на первую отправку пакета (0 - нет ответа).
+    std::vector<char> hedged; ///< Флаги продублированных пакетов.
+    LatencyHist observed; ///< Задержки всех полученных копий для выбора времени дублирования.
+    LatencyHist hedged_latency; ///< Задержки пакетов с дублированием.
+    LatencyHist primary_latency; ///< Задержки пакетов без дублирования.
+    uint64_t batches; ///< Количество обработанных пакетов.
+    uint64_t hedges; ///< Количество продублированных пакетов.
+    uint64_t wins; ///< Количество побед копий.
+    uint64_t delay_ns; ///< Последняя использованная задержка перед отправкой копии.
+    bool stopping; ///< Флаг завершения рабочих потоков.
+    std::exception_ptr error; ///< Ошибка, прервавшая задание.
+    std::mutex mutex; ///< Мьютекс состояния.
+    std::condition_variable cv; ///< Условная переменная изменений состояния.
+
+    /**
+    * @brief Вспомогательный метод для поиска свободного подключения.
+    * @return Номер подключения или -1, если все заняты.
+    */
+    long idle();
+
+    /**
+    * @brief Вспомогательный метод для отправки пакета подключению.
+    * @param id Номер подключения.
+    * @param index Номер пакета.
+    */
+    void issue(size_t id, size_t index);
+
+    /**
+    * @brief Метод рабочего потока подключения.
+    * @param id Номер подключения.
+    * @param data Данные для обработки.
+    * @param results Буфер результатов.
+    */
+    void work(
+        size_t id,
+        const std::vector<std::vector<int16_t>> &data,
+        std::vector<int16_t> &results);
+};
+
+#endif // HEDGER_H
@@ -0,0 +1,77 @@
+#include "hugemem.h"
+#include <atomic>
+#include <cstdint>
+#include <sys/mman.h>
+
+const size_t HugeMem::PAGE = size_t(2) << 20;
+
+// Текущий режим больших страниц
+static std::atomic<int> huge_mode(HugeMem::OFF);
+
+// Метод для установки режима
+void HugeMem::setMode(Mode mode)
+{
+    huge_mode = mode;
+}
+
+// Метод для получения режима
+HugeMem::Mode HugeMem::getMode()
+{
+    return static_cast<Mode>(huge_mode.load());
+}
+
+// Размер отображения для блока: целые большие страницы или 0 для блоков из кучи
+static size_t mappedSize(size_t bytes, HugeMem::Mode mode)
+{
+    if (mode == HugeMem::OFF || bytes < HugeMem::PAGE / 4)
+        return 0;
+    return (bytes + HugeMem::PAGE - 1) / HugeMem::PAGE * HugeMem::PAGE;
+}
+
+// Метод для выделения памяти
+void *HugeMem::allocate(size_t bytes, Mode mode)
+{
+    size_t length = mappedSize(bytes, mode);
+    if (length == 0)
+        return ::operator new(bytes);
+
+    void *ptr = MAP_FAILED;
+#ifdef MAP_HUGETLB
+    // Пул hugetlbfs может быть пуст или не настроен, тогда используются прозрачные большие страницы
+    if (mode == HUGETLB)
+        ptr = mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+#endif
+    if (ptr == MAP_FAILED)
+    {
+        ptr = mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (ptr == MAP_FAILED)
+            throw std::bad_alloc();
+        HugeMem::advise(ptr, length);
+    }
+    return ptr;
+}
+
+// Метод для освобождения памяти
+void HugeMem::release(void *ptr, size_t bytes, Mode mode)
+{
+    size_t length = mappedSize(bytes, mode);
+    if (length == 0)
+        ::operator delete(ptr);
+    else
+        munmap(ptr, length);
+}
+
+// Метод для пометки области памяти как предпочтительной для больших страниц
+void HugeMem::advise(void *ptr, size_t bytes)
+{
+#ifdef MADV_HUGEPAGE
+    // madvise() принимает только выровненные адреса, поэтому помечаются целые большие страницы внутри области
+    uintptr_t begin = (reinterpret_cast<uintptr_t>(ptr) + PAGE - 1) / PAGE * PAGE;
+    uintptr_t end = (reinterpret_cast<uintptr_t>(ptr) + bytes) / PAGE * PAGE;
+    if (begin < end)
+        madvise(reinterpret_cast<void *>(begin), end - begin, MADV_HUGEPAGE);
+#else
+    (void)ptr;
+    (void)bytes;
+#endif
+}
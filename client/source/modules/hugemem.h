@@ -0,0 +1,168 @@
+#ifndef HUGE_MEM_H
+#define HUGE_MEM_H
+
+#include <cstddef>
+#include <new>
+#include <vector>
+
+/**
+* @file hugemem.h
+* @brief Определение класса для размещения буферов на больших страницах.
+* @details Этот файл содержит выделение памяти страницами по 2 МБ (MAP_HUGETLB или прозрачные большие
+* страницы) и распределитель для контейнеров на его основе. Большие страницы сокращают промахи TLB
+* при проходе по буферам векторов и результатов в сотни мегабайт.
+* @date 19.10.2026
+* @version 1.0
+* @authorsa Ягольницкий Р. С.
+*/
+
+/**
+* @brief Класс для размещения буферов на больших страницах.
+* @details Режим задается один раз при запуске (--huge-pages). Новые отображения не заполняются
+* заранее, поэтому страницы размещаются на узле NUMA потока, который первым записывает в них.
+*/
+class HugeMem
+{
+public:
+    /**
+    * @brief Режим больших страниц.
+    */
+    enum Mode
+    {
+        OFF, ///< Обычные страницы.
+        THP, ///< Прозрачные большие страницы (madvise(MADV_HUGEPAGE)).
+        HUGETLB ///< Страницы из пула hugetlbfs (MAP_HUGETLB), при его нехватке - THP.
+    };
+
+    static const size_t PAGE; ///< Размер большой страницы (2 МБ).
+
+    /**
+    * @brief Статический метод для установки режима.
+    * @param mode Режим больших страниц.
+    */
+    static void setMode(Mode mode);
+
+    /**
+    * @brief Статический метод для получения режима.
+    * @return Режим больших страниц.
+    */
+    static Mode getMode();
+
+    /**
+    * @brief Статический метод для выделения памяти.
+    * @details В режимах THP и HUGETLB блоки от четверти большой страницы выделяются отдельным
+    * отображением, округленным до целых больших страниц; меньшие блоки - оператором new.
+    * @param bytes Размер блока.
+    * @param mode Режим больших страниц.
+    * @return Указатель на блок.
+    * @throw std::bad_alloc Если память не выделена.
+    */
+    static void *allocate(size_t bytes, Mode mode);
+
+    /**
+    * @brief Статический метод для освобождения памяти.
+    * @param ptr Указатель на блок.
+    * @param bytes Размер блока, переданный allocate().
+    * @param mode Режим, переданный allocate().
+    */
+    static void release(void *ptr, size_t bytes, Mode mode);
+
+    /**
+    * @brief Статический метод для пометки области памяти как предпочтительной для больших страниц.
+    * @param ptr Начало области.
+    * @param bytes Размер области (помечаются целые большие страницы внутри нее).
+    */
+    static void advise(void *ptr, size_t bytes);
+
+    /**
+    * @brief Статический метод для изменения размера вектора с размещением на больших страницах.
+    * @details Память резервируется и помечается до заполнения, поэтому первое обращение к страницам
+    * выделяет большие страницы на узле текущего потока. Без режима больших страниц - обычный resize().
+    * @tparam T Тип элемента.
+    * @param vec Вектор.
+    * @param size Новый размер.
+    */
+    template <typename T>
+    static void resize(std::vector<T> &vec, size_t size)
+    {
+        if (HugeMem::getMode() != OFF && size > vec.capacity() && size * sizeof(T) >= HugeMem::PAGE)
+        {
+            vec.reserve(size);
+            HugeMem::advise(vec.data(), size * sizeof(T));
+        }
+        vec.resize(size);
+    }
+};
+
+/**
+* @brief Распределитель памяти для контейнеров на больших страницах.
+* @details Режим запоминается при создании распределителя, поэтому память освобождается тем же
+* способом, каким выделена, даже если режим изменился.
+* @tparam T Тип элемента.
+*/
+template <typename T>
+class HugeAllocator
+{
+public:
+    typedef T value_type;
+
+    /**
+    * @brief Конструктор класса HugeAllocator с текущим режимом.
+    */
+    HugeAllocator()
+        : mode(HugeMem::getMode()) {}
+
+    /**
+    * @brief Конструктор копирования для другого типа элемента.
+    * @param other Распределитель.
+    */
+    template <typename U>
+    HugeAllocator(const HugeAllocator<U> &other)
+        : mode(other.getMode()) {}
+
+    /**
+    * @brief Метод для выделения памяти под элементы.
+    * @param n Количество элементов.
+    * @return Указатель на память.
+    */
+    T *allocate(size_t n)
+    {
+        return static_cast<T *>(HugeMem::allocate(n * sizeof(T), this->mode));
+    }
+
+    /**
+    * @brief Метод для освобождения памяти.
+    * @param ptr Указатель на память.
+    * @param n Количество элементов.
+    */
+    void deallocate(T *ptr, size_t n)
+    {
+        HugeMem::release(ptr, n * sizeof(T), this->mode);
+    }
+
+    /**
+    * @brief Метод для получения режима распределителя.
+    * @return Режим больших страниц.
+    */
+    HugeMem::Mode getMode() const
+    {
+        return this->mode;
+    }
+
+    template <typename U>
+    bool operator==(const HugeAllocator<U> &other) const
+    {
+        return this->mode == other.getMode();
+    }
+
+    template <typename U>
+    bool operator!=(const HugeAllocator<U> &other) const
+    {
+        return this->mode != other.getMode();
+    }
+
+private:
+    HugeMem::Mode mode; ///< Режим больших страниц.
+};
+
+#endif // HUGE_MEM_H
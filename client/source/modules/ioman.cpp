@@ -1,7 +1,23 @@
 #include "ioman.h"
+#include "compman.h"
+#include "uring.h"
+#include "probes.h"
+#include "hugemem.h"
+#include "stride.h"
+#include <algorithm>
 #include <fstream>
+#include <memory>
 #include <sstream>
 #include <iostream>
+#include <cstdio>
+#include <cstring>
+#include <sys/stat.h>
+
+// Сигнатура файла контрольной точки ("CKPT")
+static const uint32_t CKPT_MAGIC = 0x54504B43;
+
+// Размер блока при чтении записей с постоянным шагом
+static const size_t RECORD_BLOCK = 1 << 20;
 
 // Конструктор
 IOMan::IOMan(
@@ -10,7 +26,220 @@ IOMan::IOMan(
     const std::string &path_to_out)
     : path_to_conf(path_to_conf),
       path_to_in(path_to_in),
-      path_to_out(path_to_out) {}
+      path_to_out(path_to_out),
+      part_total(0),
+      backend("blocking"),
+      verbose(true),
+      indexed(false),
+      stream_binary(false),
+      stream_next(0) {}
+
+void IOMan::setBackend(const std::string &backend)
+{
+    this->backend = backend;
+}
+
+void IOMan::setVerbose(bool verbose)
+{
+    this->verbose = verbose;
+}
+
+VecIndex &IOMan::getIndex()
+{
+    return this->index;
+}
+
+// Метод для загрузки индекса смещений
+bool IOMan::loadIndex()
+{
+    this->indexed = false;
+    if (!CompMan::codec(this->path_to_in).empty() || !this->index.load(this->path_to_in))
+        return false;
+    if (this->index.format() == VecIndex::FORMAT_BINARY && this->index.valueSize() != sizeof(int16_t))
+    {
+        throw InvalidDataFormatError(
+            "Indexed input \"" + this->path_to_in + "\" does not contain int16_t values",
+            "IOMan.loadIndex()");
+    }
+    this->indexed = true;
+    return true;
+}
+
+// Метод для чтения диапазона векторов
+void IOMan::readRange(std::vector<std::vector<int16_t>> &data, uint32_t begin, uint32_t end) const
+{
+    if (!this->indexed)
+        throw InvalidDataFormatError("Input index is not loaded", "IOMan.readRange()");
+    if (begin > end || end > this->index.count())
+        throw InvalidDataFormatError("Invalid vector range", "IOMan.readRange()");
+    // Общий буфер параллельных читателей не расширяется: каждый вызов пишет только в свои элементы
+    if (data.size() < this->index.count())
+        throw InvalidDataFormatError("Vector buffer is smaller than the input", "IOMan.readRange()");
+
+    std::ifstream input_file(this->path_to_in, std::ios::binary);
+    if (!input_file.is_open())
+    {
+        throw std::runtime_error("Failed to open input file for reading.");
+    }
+
+    // Переход сразу к первому вектору диапазона
+    input_file.seekg(this->index.offset(begin));
+    bool binary = this->index.format() == VecIndex::FORMAT_BINARY;
+    size_t bytes = 0;
+    VCLIENT_PROBE1(read_start, begin);
+    if (binary && this->index.recordSize())
+    {
+        // Диапазоны могут читаться параллельно, поэтому блок принадлежит вызову
+        std::vector<uint8_t> block;
+        this->readRecords(input_file, block, data, begin, end - begin, "IOMan.readRange()");
+        VCLIENT_PROBE3(read_end, begin, end - begin, (end - begin) * this->index.recordSize());
+        return;
+    }
+    for (uint32_t i = begin; i < end; ++i)
+    {
+        uint32_t vector_size = 0;
+        std::vector<int16_t> &vec = data[i];
+        if (binary)
+        {
+            input_file.read(reinterpret_cast<char *>(&vector_size), sizeof(vector_size));
+            // Размер записи известен из индекса, поэтому поврежденный размер не приводит к большому выделению
+            if (sizeof(vector_size) + uint64_t(vector_size) * sizeof(int16_t) != this->index.offset(i + 1) - this->index.offset(i))
+                throw InvalidDataFormatError("Vector size does not match index", "IOMan.readRange()");
+            vec.resize(vector_size);
+            input_file.read(reinterpret_cast<char *>(vec.data()), vector_size * sizeof(int16_t));
+        }
+        else
+        {
+            input_file >> vector_size;
+            vec.resize(vector_size);
+            for (uint32_t j = 0; j < vector_size; ++j)
+                input_file >> vec[j];
+        }
+        if (!input_file)
+            throw InvalidDataFormatError("Truncated input file", "IOMan.readRange()");
+        bytes += sizeof(vector_size) + vector_size * sizeof(int16_t);
+    }
+    VCLIENT_PROBE3(read_end, begin, end - begin, bytes);
+}
+
+// Метод для чтения записей двоичного файла с постоянным шагом
+void IOMan::readRecords(std::istream &input, std::vector<uint8_t> &block, std::vector<std::vector<int16_t>> &data,
+                        size_t first, size_t count, const char *func) const
+{
+    uint64_t record = this->index.recordSize();
+    if (record < sizeof(uint32_t) || (record - sizeof(uint32_t)) % sizeof(int16_t) != 0)
+        throw InvalidDataFormatError("Vector size does not match index", func);
+    uint32_t size = (record - sizeof(uint32_t)) / sizeof(int16_t);
+
+    // Блок вмещает целое число записей, но не меньше одной
+    size_t per_block = std::max<size_t>(1, RECORD_BLOCK / record);
+    if (block.size() < std::min(per_block, count) * record)
+        block.resize(std::min(per_block, count) * record);
+    for (size_t done = 0; done < count;)
+    {
+        size_t n = std::min(per_block, count - done);
+        input.read(reinterpret_cast<char *>(block.data()), n * record);
+        if (!input)
+        {
+            CompMan::check(input);
+            throw InvalidDataFormatError("Truncated input file", func);
+        }
+        if (!FixedStride::unpack(block.data(), n, size, data, first + done))
+            throw InvalidDataFormatError("Vector size does not match index", func);
+        done += n;
+    }
+}
+
+// Метод для открытия входного файла для чтения пакетами
+uint32_t IOMan::openStream(uint32_t first)
+{
+    this->stream.reset();
+    this->stream_binary = false;
+    uint32_t num_vectors = 0;
+
+    // С индексом чтение начинается сразу с первого вектора, двоичные файлы читаются только по индексу
+    if (this->loadIndex())
+    {
+        num_vectors = this->index.count();
+        if (first > num_vectors)
+            throw InvalidDataFormatError("Invalid vector range", "IOMan.openStream()");
+        this->stream.reset(new std::ifstream(this->path_to_in, std::ios::binary));
+        if (!static_cast<std::ifstream &>(*this->stream).is_open())
+            throw std::runtime_error("Failed to open input file for reading.");
+        this->stream->seekg(this->index.offset(first));
+        this->stream_binary = this->index.format() == VecIndex::FORMAT_BINARY;
+        this->stream_next = first;
+        return num_vectors;
+    }
+
+    if (this->backend == "uring" && CompMan::codec(this->path_to_in).empty())
+        this->stream.reset(URing::openInput(this->path_to_in));
+    if (!this->stream)
+        this->stream.reset(CompMan::openInput(this->path_to_in));
+    if (!this->stream)
+        throw std::runtime_error("Failed to open input file for reading.");
+
+    *this->stream >> num_vectors;
+    CompMan::check(*this->stream);
+    if (!*this->stream || first > num_vectors)
+        throw InvalidDataFormatError("Missing vector count", "IOMan.openStream()");
+
+    // Без индекса уже обработанные векторы пропускаются разбором
+    this->stream_next = 0;
+    std::vector<std::vector<int16_t>> skipped(1);
+    while (this->stream_next < first)
+        this->readBatch(skipped, 1);
+    return num_vectors;
+}
+
+// Метод для чтения очередного пакета векторов
+void IOMan::readBatch(std::vector<std::vector<int16_t>> &batch, size_t count)
+{
+    if (!this->stream)
+        throw std::runtime_error("Input stream is not open.");
+    if (batch.size() < count)
+        batch.resize(count);
+
+    std::istream &input_file = *this->stream;
+    uint32_t first = this->stream_next;
+    size_t bytes = 0;
+    VCLIENT_PROBE1(read_start, first);
+    if (this->stream_binary && this->index.recordSize())
+    {
+        this->readRecords(input_file, this->stream_block, batch, 0, count, "IOMan.readBatch()");
+        this->stream_next += count;
+        VCLIENT_PROBE3(read_end, first, count, count * this->index.recordSize());
+        return;
+    }
+    for (size_t i = 0; i < count; ++i, ++this->stream_next)
+    {
+        uint32_t vector_size = 0;
+        std::vector<int16_t> &vec = batch[i];
+        if (this->stream_binary)
+        {
+            input_file.read(reinterpret_cast<char *>(&vector_size), sizeof(vector_size));
+            uint64_t record = this->index.offset(this->stream_next + 1) - this->index.offset(this->stream_next);
+            if (sizeof(vector_size) + uint64_t(vector_size) * sizeof(int16_t) != record)
+                throw InvalidDataFormatError("Vector size does not match index", "IOMan.readBatch()");
+            vec.resize(vector_size);
+            input_file.read(reinterpret_cast<char *>(vec.data()), vector_size * sizeof(int16_t));
+        }
+        else
+        {
+            input_file >> vector_size;
+            vec.resize(vector_size);
+            for (uint32_t j = 0; j < vector_size; ++j)
+                input_file >> vec[j];
+        }
+        if (!input_file)
+        {
+            CompMan::check(input_file);
+            throw InvalidDataFormatError("Truncated input file", "IOMan.readBatch()");
+        }
+        bytes += sizeof(vector_size) + vector_size * sizeof(int16_t);
+    }
+    VCLIENT_PROBE3(read_end, first, count, bytes);
+}
 
 // Метод для чтения конфигурационных данных
 std::array<std::string, 2> IOMan::conf()
@@ -52,37 +281,94 @@ std::array<std::string, 2> IOMan::conf()
 // Метод для чтения числовых данных с логированием из текстового файла
 std::vector<std::vector<int16_t>> IOMan::read()
 {
-    std::ifstream input_file(this->path_to_in);
-    if (!input_file.is_open())
+    std::vector<std::vector<int16_t>> data;
+    this->read(data);
+    return data;
+}
+
+// Векторы, ставшие лишними при уменьшении буфера, сохраняются с емкостью для следующих заданий потока
+static thread_local std::vector<std::vector<int16_t>> spare_vectors;
+
+// Функция для изменения количества векторов буфера без освобождения внутренних буферов
+static void resizeData(std::vector<std::vector<int16_t>> &data, size_t count)
+{
+    while (data.size() > count)
+    {
+        spare_vectors.push_back(std::move(data.back()));
+        data.pop_back();
+    }
+    size_t old_size = data.size();
+    HugeMem::resize(data, count);
+    for (size_t i = old_size; i < count && !spare_vectors.empty(); ++i)
+    {
+        data[i] = std::move(spare_vectors.back());
+        spare_vectors.pop_back();
+    }
+}
+
+// Метод для чтения числовых данных в существующий буфер
+void IOMan::read(std::vector<std::vector<int16_t>> &data)
+{
+    // Двоичные входные файлы читаются по индексу
+    if (this->loadIndex() && this->index.format() == VecIndex::FORMAT_BINARY)
+    {
+        resizeData(data, this->index.count());
+        this->readRange(data, 0, this->index.count());
+        if (this->verbose)
+            this->logVectors(data);
+        return;
+    }
+
+    // Несжатые файлы в режиме io_uring читаются блоками с опережением,
+    // сжатые (.zst/.lz4) распаковываются в отдельном потоке
+    std::unique_ptr<std::istream> input;
+    if (this->backend == "uring" && CompMan::codec(this->path_to_in).empty())
+        input.reset(URing::openInput(this->path_to_in));
+    if (!input)
+        input.reset(CompMan::openInput(this->path_to_in));
+    if (!input)
     {
         throw std::runtime_error("Failed to open input file for reading.");
     }
+    std::istream &input_file = *input;
+    size_t bytes = sizeof(uint32_t);
+    VCLIENT_PROBE1(read_start, 0);
 
     // Чтение количества векторов
-    uint32_t num_vectors;
+    uint32_t num_vectors = 0;
     input_file >> num_vectors;
+    CompMan::check(input_file);
 
-    std::vector<std::vector<int16_t>> data(num_vectors);
+    // Внутренние векторы сохраняют емкость от предыдущих заданий, в том числе более крупных:
+    // при уменьшении буфера лишние векторы не уничтожаются, а ждут следующего задания потока
+    resizeData(data, num_vectors);
 
     // Чтение каждого вектора
     for (uint32_t i = 0; i < num_vectors; ++i)
     {
         // Чтение размера вектора
-        uint32_t vector_size;
+        uint32_t vector_size = 0;
         input_file >> vector_size;
 
         // Чтение значений вектора
-        std::vector<int16_t> vec(vector_size);
+        std::vector<int16_t> &vec = data[i];
+        vec.resize(vector_size);
         for (uint32_t j = 0; j < vector_size; ++j)
         {
             input_file >> vec[j]; // Чтение в десятичном формате
         }
-
-        data[i] = vec;
+        bytes += sizeof(vector_size) + vector_size * sizeof(int16_t);
     }
 
-    input_file.close();
+    CompMan::check(input_file);
+    VCLIENT_PROBE3(read_end, 0, num_vectors, bytes);
+    if (this->verbose)
+        this->logVectors(data);
+}
 
+// Метод для логирования прочитанных векторов
+void IOMan::logVectors(const std::vector<std::vector<int16_t>> &data) const
+{
     // Логирование всех прочитанных векторов
     std::cout << "Log: IOMan.read()\n";
     std::cout << "Vectors: {";
@@ -98,31 +384,186 @@ std::vector<std::vector<int16_t>> IOMan::read()
     if (!data.empty())
         std::cout << "\b\b"; // Удалить последнюю запятую и пробел
     std::cout << "}\n";
-
-    return data;
 }
 
 // Метод для записи числовых данных
 void IOMan::write(const std::vector<int16_t> &data)
 {
-    std::ofstream output_file(this->path_to_out, std::ios::binary);
-    if (!output_file.is_open())
+    uint32_t count = data.size();
+    size_t bytes = sizeof(count) + count * sizeof(int16_t);
+    VCLIENT_PROBE2(write_start, 0, count);
+    if (this->backend == "uring" && CompMan::codec(this->path_to_out).empty())
+    {
+        // Количество и результаты собираются в один буфер и записываются одной операцией
+        std::vector<char> buffer(sizeof(count) + count * sizeof(int16_t));
+        std::memcpy(buffer.data(), &count, sizeof(count));
+        if (count > 0)
+            std::memcpy(buffer.data() + sizeof(count), data.data(), count * sizeof(int16_t));
+
+        int ret = URing::writeFile(this->path_to_out, buffer.data(), buffer.size());
+        if (ret == 1)
+        {
+            throw FileNotFoundError(
+                "Failed to open output file \"" +
+                    this->path_to_out + "\"",
+                "IOMan.write()");
+        }
+        // ret == -1: io_uring недоступен, используется обычная запись
+        if (ret == 0)
+        {
+            VCLIENT_PROBE3(write_end, 0, count, bytes);
+            return;
+        }
+    }
+
+    // Для путей .zst/.lz4 результаты сжимаются при записи
+    std::unique_ptr<std::ostream> output(CompMan::openOutput(this->path_to_out));
+    if (!output)
     {
         throw FileNotFoundError(
             "Failed to open output file \"" +
                 this->path_to_out + "\"",
             "IOMan.write()");
     }
+    std::ostream &output_file = *output;
 
-    // Запись количества результатов
-    uint32_t count = data.size();
+    // Запись количества результатов и самих результатов напрямую из буфера результатов
     output_file.write(reinterpret_cast<const char *>(&count), sizeof(count));
+    output_file.write(reinterpret_cast<const char *>(data.data()), count * sizeof(int16_t));
+
+    CompMan::finish(output_file);
+    VCLIENT_PROBE3(write_end, 0, count, bytes);
+}
 
-    // Запись самих результатов
-    for (const auto &num : data)
+// Метод для получения отпечатка входного файла
+std::array<uint64_t, 2> IOMan::inputStamp()
+{
+    struct stat st;
+    std::array<uint64_t, 2> stamp = {{0, 0}};
+    if (::stat(this->path_to_in.c_str(), &st) == 0)
     {
-        output_file.write(reinterpret_cast<const char *>(&num), sizeof(num));
+        stamp[0] = st.st_size;
+        stamp[1] = st.st_mtime;
     }
+    return stamp;
+}
 
-    output_file.close();
+// Метод для записи контрольной точки
+void IOMan::checkpoint(uint32_t done)
+{
+    // Запись во временный файл и переименование делают обновление атомарным
+    std::string path = this->path_to_out + ".ckpt";
+    std::string tmp_path = path + ".tmp";
+    std::ofstream ckpt_file(tmp_path, std::ios::binary);
+    if (!ckpt_file.is_open())
+    {
+        throw FileNotFoundError(
+            "Failed to open checkpoint file \"" + tmp_path + "\"",
+            "IOMan.checkpoint()");
+    }
+
+    std::array<uint64_t, 2> stamp = this->inputStamp();
+    ckpt_file.write(reinterpret_cast<const char *>(&CKPT_MAGIC), sizeof(CKPT_MAGIC));
+    ckpt_file.write(reinterpret_cast<const char *>(&this->part_total), sizeof(this->part_total));
+    ckpt_file.write(reinterpret_cast<const char *>(&done), sizeof(done));
+    ckpt_file.write(reinterpret_cast<const char *>(stamp.data()), sizeof(uint64_t) * stamp.size());
+    ckpt_file.close();
+
+    if (!ckpt_file || std::rename(tmp_path.c_str(), path.c_str()) != 0)
+    {
+        throw FileNotFoundError(
+            "Failed to write checkpoint file \"" + path + "\"",
+            "IOMan.checkpoint()");
+    }
+}
+
+// Метод для подготовки выходного файла к инкрементальной записи
+uint32_t IOMan::resume(std::vector<int16_t> &results)
+{
+    if (!CompMan::codec(this->path_to_out).empty())
+    {
+        throw InvalidDataFormatError(
+            "Resumable jobs require an uncompressed output file",
+            "IOMan.resume()");
+    }
+
+    this->part_total = results.size();
+    uint32_t done = 0;
+
+    // Проверка контрольной точки: то же задание и тот же входной файл
+    std::ifstream ckpt_file(this->path_to_out + ".ckpt", std::ios::binary);
+    if (ckpt_file.is_open())
+    {
+        uint32_t magic = 0, total = 0, ckpt_done = 0;
+        std::array<uint64_t, 2> stamp = {{0, 0}};
+        ckpt_file.read(reinterpret_cast<char *>(&magic), sizeof(magic));
+        ckpt_file.read(reinterpret_cast<char *>(&total), sizeof(total));
+        ckpt_file.read(reinterpret_cast<char *>(&ckpt_done), sizeof(ckpt_done));
+        ckpt_file.read(reinterpret_cast<char *>(stamp.data()), sizeof(uint64_t) * stamp.size());
+        if (ckpt_file && magic == CKPT_MAGIC && total == this->part_total &&
+            ckpt_done <= total && stamp == this->inputStamp())
+        {
+            done = ckpt_done;
+        }
+    }
+
+    if (done > 0)
+    {
+        this->part_file.open(this->path_to_out, std::ios::in | std::ios::out | std::ios::binary);
+        uint32_t count = 0;
+        this->part_file.read(reinterpret_cast<char *>(&count), sizeof(count));
+        this->part_file.read(reinterpret_cast<char *>(results.data()), done * sizeof(int16_t));
+        if (!this->part_file || count != this->part_total)
+        {
+            done = 0;
+            this->part_file.close();
+        }
+    }
+
+    if (done == 0)
+    {
+        this->part_file.clear();
+        this->part_file.open(this->path_to_out, std::ios::in | std::ios::out | std::ios::binary | std::ios::trunc);
+        if (!this->part_file.is_open())
+        {
+            throw FileNotFoundError(
+                "Failed to open output file \"" +
+                    this->path_to_out + "\"",
+                "IOMan.resume()");
+        }
+        this->part_file.write(reinterpret_cast<const char *>(&this->part_total), sizeof(this->part_total));
+        this->part_file.flush();
+        this->checkpoint(0);
+    }
+
+    std::cout << "Log: \"IOMan.resume()\"\n";
+    std::cout << "Resuming from vector " << done << " of " << this->part_total << "\n";
+    return done;
+}
+
+// Метод для записи части результатов
+void IOMan::writePart(const std::vector<int16_t> &results, uint32_t begin, uint32_t end)
+{
+    // Результаты записываются до обновления контрольной точки
+    VCLIENT_PROBE2(write_start, begin, end - begin);
+    this->part_file.seekp(sizeof(uint32_t) + begin * sizeof(int16_t));
+    this->part_file.write(reinterpret_cast<const char *>(&results[begin]), (end - begin) * sizeof(int16_t));
+    this->part_file.flush();
+    if (!this->part_file)
+    {
+        throw FileNotFoundError(
+            "Failed to write output file \"" +
+                this->path_to_out + "\"",
+            "IOMan.writePart()");
+    }
+    this->checkpoint(end);
+    VCLIENT_PROBE3(write_end, begin, end - begin, (end - begin) * sizeof(int16_t));
+}
+
+// Метод для завершения инкрементальной записи
+void IOMan::finish()
+{
+    if (this->part_file.is_open())
+        this->part_file.close();
+    std::remove((this->path_to_out + ".ckpt").c_str());
 }
@@ -4,7 +4,11 @@
 #include <string>
 #include <vector>
 #include <array>
+#include <fstream>
+#include <memory>
+#include <cstdint>
 #include "errors.h"
+#include "vecindex.h"
 
 /** 
 * @file ioman.h
@@ -40,24 +44,175 @@ public:
     */
     std::array<std::string, 2> conf();
 
+    /**
+    * @brief Метод для выбора механизма ввода-вывода.
+    * @details В режиме "uring" несжатые входные файлы читаются через io_uring с опережением,
+    * а результаты записываются одной операцией io_uring; при отсутствии поддержки в ядре
+    * используются обычные потоки.
+    * @param backend Механизм ввода-вывода ("blocking" или "uring").
+    */
+    void setBackend(const std::string& backend);
+
+    /**
+    * @brief Метод для управления выводом прочитанных векторов в журнал.
+    * @param verbose true - выводить все векторы (по умолчанию), false - не выводить.
+    */
+    void setVerbose(bool verbose);
+
     /**
     * @brief Метод для чтения данных из файла.
+    * @details Файлы с расширением .zst/.lz4 распаковываются на лету в отдельном потоке.
     * @return Двумерный вектор с данными.
     * @throw std::runtime_error Если не удалось открыть входной файл.
+    * @throw InvalidDataFormatError Если не удалось распаковать входной файл.
     */
     std::vector<std::vector<int16_t>> read();
 
+    /**
+    * @brief Метод для чтения данных из файла в существующий буфер.
+    * @details Векторы буфера переиспользуются: если их емкости достаточно, чтение нового задания
+    * не выделяет память на каждый вектор. При уменьшении буфера лишние векторы сохраняются в запасе
+    * потока, поэтому чередование малых и больших заданий тоже не выделяет память на вектор.
+    * @param data Буфер для данных (размер изменяется по количеству векторов в файле).
+    * @throw std::runtime_error Если не удалось открыть входной файл.
+    * @throw InvalidDataFormatError Если не удалось распаковать входной файл.
+    */
+    void read(std::vector<std::vector<int16_t>>& data);
+
+    /**
+    * @brief Метод для загрузки индекса смещений входного файла.
+    * @details Индекс читается из файла-спутника PATH.idx (см. VecIndex); для сжатых входных файлов
+    * индекс не используется. Двоичные входные файлы читаются только при наличии индекса.
+    * @return true, если индекс загружен.
+    * @throw InvalidDataFormatError Если индекс поврежден, устарел или описывает значения не int16_t.
+    */
+    bool loadIndex();
+
+    /**
+    * @brief Метод для получения загруженного индекса смещений.
+    * @return Индекс смещений.
+    */
+    VecIndex& getIndex();
+
+    /**
+    * @brief Метод для чтения диапазона векторов с переходом по индексу.
+    * @details Чтение начинается сразу со смещения первого вектора диапазона; каждый вызов открывает
+    * собственный поток и изменяет только элементы [begin, end), поэтому после loadIndex() диапазоны
+    * можно читать параллельно в общий буфер.
+    * @param data Буфер для данных, заранее размеченный на количество векторов в файле (не расширяется);
+    * заполняются элементы [begin, end).
+    * @param begin Индекс первого вектора.
+    * @param end Индекс за последним вектором.
+    * @throw InvalidDataFormatError Если индекс не загружен, диапазон некорректен, буфер меньше
+    * количества векторов в файле или файл поврежден.
+    * @throw std::runtime_error Если не удалось открыть входной файл.
+    */
+    void readRange(std::vector<std::vector<int16_t>>& data, uint32_t begin, uint32_t end) const;
+
+    /**
+    * @brief Метод для открытия входного файла для последовательного чтения пакетами.
+    * @details При наличии индекса чтение начинается сразу со смещения вектора first, иначе
+    * предыдущие векторы пропускаются разбором. Сжатые файлы распаковываются в отдельном потоке.
+    * @param first Индекс первого читаемого вектора.
+    * @return Количество векторов в файле.
+    * @throw std::runtime_error Если не удалось открыть входной файл.
+    * @throw InvalidDataFormatError Если отсутствует количество векторов или first больше него.
+    */
+    uint32_t openStream(uint32_t first = 0);
+
+    /**
+    * @brief Метод для чтения очередного пакета векторов из файла, открытого openStream().
+    * @param batch Буфер пакета (при необходимости расширяется, векторы переиспользуются);
+    * заполняются элементы [0, count).
+    * @param count Количество читаемых векторов.
+    * @throw std::runtime_error Если входной файл не открыт.
+    * @throw InvalidDataFormatError Если файл обрывается или размер записи не совпадает с индексом.
+    */
+    void readBatch(std::vector<std::vector<int16_t>>& batch, size_t count);
+
     /**
     * @brief Метод для записи данных в файл.
+    * @details Для выходных путей с расширением .zst/.lz4 данные сжимаются при записи.
     * @param data Вектор данных для записи.
     * @throw FileNotFoundError Если не удалось открыть выходной файл.
+    * @throw InvalidDataFormatError Если не удалось сжать выходные данные.
     */
     void write(const std::vector<int16_t>& data);
 
+    /**
+    * @brief Метод для подготовки выходного файла к инкрементальной записи.
+    * @details Если рядом с выходным файлом есть файл контрольной точки (PATH.ckpt) для того же
+    * входного файла, ранее полученные результаты загружаются, и задание продолжается с места остановки.
+    * Иначе создается новый выходной файл.
+    * @param results Буфер результатов размером, равным количеству векторов задания.
+    * @return Количество уже обработанных векторов.
+    * @throw FileNotFoundError Если не удалось открыть выходной файл.
+    * @throw InvalidDataFormatError Если выходной файл сжатый.
+    */
+    uint32_t resume(std::vector<int16_t>& results);
+
+    /**
+    * @brief Метод для записи части результатов и обновления контрольной точки.
+    * @param results Буфер результатов.
+    * @param begin Индекс первого записываемого результата.
+    * @param end Индекс за последним записываемым результатом.
+    * @throw FileNotFoundError Если не удалось записать результаты или контрольную точку.
+    */
+    void writePart(const std::vector<int16_t>& results, uint32_t begin, uint32_t end);
+
+    /**
+    * @brief Метод для завершения инкрементальной записи и удаления контрольной точки.
+    */
+    void finish();
+
 private:
     std::string path_to_conf; ///< Путь к файлу конфигурации.
     std::string path_to_in; ///< Путь к входному файлу.
     std::string path_to_out; ///< Путь к выходному файлу.
+    std::fstream part_file; ///< Выходной файл при инкрементальной записи.
+    uint32_t part_total; ///< Количество результатов задания при инкрементальной записи.
+    std::string backend; ///< Механизм ввода-вывода.
+    bool verbose; ///< Флаг вывода прочитанных векторов в журнал.
+    VecIndex index; ///< Индекс смещений входного файла.
+    bool indexed; ///< Флаг загруженного индекса.
+    std::unique_ptr<std::istream> stream; ///< Входной поток для чтения пакетами.
+    bool stream_binary; ///< Флаг двоичного формата входного потока.
+    uint32_t stream_next; ///< Индекс следующего читаемого вектора.
+    std::vector<uint8_t> stream_block; ///< Блок записей с постоянным шагом при чтении пакетами (сохраняется между пакетами).
+
+    /**
+    * @brief Вспомогательный метод для записи контрольной точки.
+    * @param done Количество обработанных векторов.
+    * @throw FileNotFoundError Если не удалось записать контрольную точку.
+    */
+    void checkpoint(uint32_t done);
+
+    /**
+    * @brief Вспомогательный метод для получения отпечатка входного файла (размер и время изменения).
+    * @return Отпечаток входного файла.
+    */
+    std::array<uint64_t, 2> inputStamp();
+
+    /**
+    * @brief Вспомогательный метод для вывода прочитанных векторов в журнал.
+    * @param data Прочитанные векторы.
+    */
+    void logVectors(const std::vector<std::vector<int16_t>>& data) const;
+
+    /**
+    * @brief Вспомогательный метод для чтения записей двоичного файла с постоянным шагом.
+    * @details Записи читаются блоками и разбираются FixedStride::unpack() без отдельного чтения
+    * размера и значений каждого вектора.
+    * @param input Входной поток, установленный на первую запись.
+    * @param block Буфер блока записей (при необходимости расширяется и переиспользуется между вызовами).
+    * @param data Буфер для данных.
+    * @param first Индекс первого заполняемого вектора буфера.
+    * @param count Количество записей.
+    * @param func Имя вызывающего метода для сообщений об ошибках.
+    * @throw InvalidDataFormatError Если файл обрывается или размер записи не совпадает с индексом.
+    */
+    void readRecords(std::istream& input, std::vector<uint8_t>& block, std::vector<std::vector<int16_t>>& data,
+                     size_t first, size_t count, const char* func) const;
 };
 
 #endif // IO_MANAGER_H
@@ -0,0 +1,292 @@
+#include "latency.h"
+#include "errors.h"
+#include <algorithm>
+#include <atomic>
+#include <fstream>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <sstream>
+
+// Количество линейных корзин на степень двойки и граница точного хранения значений
+static const unsigned SUB_BITS = 6;
+static const uint64_t SUB_COUNT = 1ull << SUB_BITS;
+
+// Процентили в отчетах
+static const double PERCENTILES[] = {50.0, 90.0, 99.0, 99.9};
+static const char *PERCENTILE_NAMES[] = {"p50", "p90", "p99", "p99_9"};
+
+const uint64_t LatencyHist::LIMIT = (1ull << 44) - 1;
+
+// Конструктор
+LatencyHist::LatencyHist()
+    : counts(index(LIMIT) + 1, 0), total(0), min(0), max(0), sum(0) {}
+
+// Метод для получения индекса корзины
+size_t LatencyHist::index(uint64_t ns)
+{
+    ns = std::min(ns, LIMIT);
+    if (ns < 2 * SUB_COUNT)
+        return ns;
+    unsigned msb = 63 - __builtin_clzll(ns);
+    unsigned shift = msb - SUB_BITS;
+    return (shift + 1) * SUB_COUNT + ((ns >> shift) - SUB_COUNT);
+}
+
+// Метод для получения верхней границы корзины
+uint64_t LatencyHist::upper(size_t index)
+{
+    if (index < 2 * SUB_COUNT)
+        return index;
+    unsigned shift = index / SUB_COUNT - 1;
+    uint64_t sub = index % SUB_COUNT + SUB_COUNT;
+    return ((sub + 1) << shift) - 1;
+}
+
+// Метод для учета значения
+void LatencyHist::record(uint64_t ns)
+{
+    ++this->counts[index(ns)];
+    this->min = this->total ? std::min(this->min, ns) : ns;
+    this->max = std::max(this->max, ns);
+    this->sum += ns;
+    ++this->total;
+}
+
+// Метод для добавления значений другой гистограммы
+void LatencyHist::merge(const LatencyHist &other)
+{
+    if (other.total == 0)
+        return;
+    for (size_t i = 0; i < this->counts.size(); ++i)
+        this->counts[i] += other.counts[i];
+    this->min = this->total ? std::min(this->min, other.min) : other.min;
+    this->max = std::max(this->max, other.max);
+    this->sum += other.sum;
+    this->total += other.total;
+}
+
+// Метод для получения значения процентиля
+uint64_t LatencyHist::percentile(double percent) const
+{
+    if (this->total == 0)
+        return 0;
+    uint64_t rank = std::max<uint64_t>(1, uint64_t(percent / 100.0 * this->total + 0.5));
+    uint64_t seen = 0;
+    for (size_t i = 0; i < this->counts.size(); ++i)
+    {
+        seen += this->counts[i];
+        // Последняя корзина содержит и значения больше LIMIT, для нее возвращается точный максимум
+        if (seen >= rank)
+            return i + 1 == this->counts.size() ? this->max : std::min(upper(i), this->max);
+    }
+    return this->max;
+}
+
+uint64_t LatencyHist::getCount() const
+{
+    return this->total;
+}
+uint64_t LatencyHist::getMin() const
+{
+    return this->min;
+}
+uint64_t LatencyHist::getMax() const
+{
+    return this->max;
+}
+double LatencyHist::getMean() const
+{
+    return this->total ? double(this->sum) / this->total : 0.0;
+}
+
+// Метод для записи гистограммы одной строкой
+void LatencyHist::save(std::ostream &out) const
+{
+    out << this->total << " " << this->min << " " << this->max << " " << this->sum;
+    for (size_t i = 0; i < this->counts.size(); ++i)
+        if (this->counts[i])
+            out << " " << i << ":" << this->counts[i];
+}
+
+// Метод для чтения строки гистограммы
+bool LatencyHist::load(const std::string &line)
+{
+    std::istringstream iss(line);
+    LatencyHist other;
+    if (!(iss >> other.total >> other.min >> other.max >> other.sum))
+        return false;
+
+    size_t idx;
+    char sep;
+    uint64_t count;
+    uint64_t buckets = 0;
+    while (iss >> idx >> sep >> count)
+    {
+        if (sep != ':' || idx >= other.counts.size())
+            return false;
+        other.counts[idx] += count;
+        buckets += count;
+    }
+    if (!iss.eof() || buckets != other.total)
+        return false;
+    this->merge(other);
+    return true;
+}
+
+// Метод для записи непустых корзин в формате JSON
+void LatencyHist::jsonBuckets(std::ostream &out) const
+{
+    out << "[";
+    bool first = true;
+    for (size_t i = 0; i < this->counts.size(); ++i)
+    {
+        if (!this->counts[i])
+            continue;
+        out << (first ? "" : ", ") << "[" << i << ", " << this->counts[i] << "]";
+        first = false;
+    }
+    out << "]";
+}
+
+// Реестр наборов гистограмм потоков; наборы живут дольше своих потоков до вызова reset()
+static std::mutex &registryMutex()
+{
+    static std::mutex mutex;
+    return mutex;
+}
+static std::vector<std::unique_ptr<LatencyStats>> &registry()
+{
+    static std::vector<std::unique_ptr<LatencyStats>> sets;
+    return sets;
+}
+static thread_local LatencyStats *local_stats = nullptr;
+static thread_local uint64_t local_generation = 0;
+static std::atomic<uint64_t> generation(1);
+
+const char *LatencyStats::name(Metric metric)
+{
+    static const char *names[] = {"connect", "auth", "batch", "job"};
+    return names[metric];
+}
+
+// Метод для учета задержки этапа в гистограмме текущего потока
+void LatencyStats::record(Metric metric, std::chrono::steady_clock::duration elapsed)
+{
+    if (local_stats == nullptr || local_generation != generation)
+    {
+        std::lock_guard<std::mutex> lock(registryMutex());
+        registry().emplace_back(new LatencyStats());
+        local_stats = registry().back().get();
+        local_generation = generation;
+    }
+    int64_t ns = std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count();
+    local_stats->hists[metric].record(ns > 0 ? ns : 0);
+}
+
+// Метод для объединения гистограмм всех потоков
+LatencyStats LatencyStats::collect()
+{
+    LatencyStats merged;
+    std::lock_guard<std::mutex> lock(registryMutex());
+    for (const auto &stats : registry())
+        merged.merge(*stats);
+    return merged;
+}
+
+// Метод для очистки гистограмм всех потоков
+void LatencyStats::reset()
+{
+    // Потоки с набором прежнего поколения заводят новый при следующей записи
+    std::lock_guard<std::mutex> lock(registryMutex());
+    registry().clear();
+    ++generation;
+}
+
+LatencyHist &LatencyStats::get(Metric metric)
+{
+    return this->hists[metric];
+}
+
+// Метод для добавления значений другого набора
+void LatencyStats::merge(const LatencyStats &other)
+{
+    for (int i = 0; i < METRICS; ++i)
+        this->hists[i].merge(other.hists[i]);
+}
+
+// Метод для добавления гистограмм из файла
+bool LatencyStats::load(const std::string &path)
+{
+    std::ifstream in(path);
+    if (!in.is_open())
+        return false;
+
+    std::string line;
+    while (std::getline(in, line))
+    {
+        std::istringstream iss(line);
+        std::string metric;
+        if (!(iss >> metric))
+            continue;
+        std::string rest;
+        std::getline(iss, rest);
+        for (int i = 0; i < METRICS; ++i)
+        {
+            if (metric == name(Metric(i)) && !this->hists[i].load(rest))
+                throw InvalidDataFormatError("Invalid latency file \"" + path + "\"", "LatencyStats.load()");
+        }
+    }
+    return true;
+}
+
+// Метод для сохранения гистограмм в файл
+void LatencyStats::save(const std::string &path) const
+{
+    std::ofstream out(path);
+    for (int i = 0; i < METRICS; ++i)
+    {
+        out << name(Metric(i)) << " ";
+        this->hists[i].save(out);
+        out << "\n";
+    }
+    if (!out)
+        throw FileNotFoundError("Failed to write latency file \"" + path + "\"", "LatencyStats.save()");
+}
+
+// Метод для вывода процентилей в читаемом виде
+void LatencyStats::report(std::ostream &out) const
+{
+    out << "Log: \"LatencyStats.report()\"\n";
+    std::ios::fmtflags flags = out.flags();
+    out << std::fixed << std::setprecision(1);
+    for (int i = 0; i < METRICS; ++i)
+    {
+        const LatencyHist &hist = this->hists[i];
+        if (hist.getCount() == 0)
+            continue;
+        out << "Latency " << name(Metric(i)) << ": n=" << hist.getCount();
+        for (size_t p = 0; p < 4; ++p)
+            out << " " << PERCENTILE_NAMES[p] << "=" << hist.percentile(PERCENTILES[p]) / 1e3;
+        out << " max=" << hist.getMax() / 1e3 << " us\n";
+    }
+    out.flags(flags);
+}
+
+// Метод для вывода процентилей и корзин в формате JSON
+void LatencyStats::json(std::ostream &out) const
+{
+    out << "{";
+    for (int i = 0; i < METRICS; ++i)
+    {
+        const LatencyHist &hist = this->hists[i];
+        out << (i ? ",\n " : "\n ") << "\"" << name(Metric(i)) << "\": {\"count\": " << hist.getCount()
+            << ", \"min_ns\": " << hist.getMin() << ", \"mean_ns\": " << uint64_t(hist.getMean());
+        for (size_t p = 0; p < 4; ++p)
+            out << ", \"" << PERCENTILE_NAMES[p] << "_ns\": " << hist.percentile(PERCENTILES[p]);
+        out << ", \"max_ns\": " << hist.getMax() << ", \"buckets\": ";
+        hist.jsonBuckets(out);
+        out << "}";
+    }
+    out << "\n}\n";
+}
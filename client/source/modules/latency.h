@@ -0,0 +1,215 @@
+#ifndef LATENCY_H
+#define LATENCY_H
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+/**
+* @file latency.h
+* @brief Определение классов для гистограмм задержек.
+* @details Этот файл содержит определения гистограммы с логарифмическими корзинами (в духе HDR Histogram)
+* и набора гистограмм этапов клиента, которые записываются в каждом потоке отдельно и объединяются
+* при выводе. Гистограммы сохраняются в текстовый файл и объединяются между запусками.
+* @date 19.10.2026
+* @version 1.0
+* @authorsa Ягольницкий Р. С.
+*/
+
+/**
+* @brief Гистограмма задержек с логарифмическими корзинами.
+* @details Значения в наносекундах. Каждая степень двойки делится на 64 линейные корзины,
+* поэтому относительная погрешность процентилей не превышает 1/64; значения до 128 нс хранятся точно.
+* Значения больше LIMIT учитываются в последней корзине, максимум хранится точно.
+*/
+class LatencyHist
+{
+public:
+    static const uint64_t LIMIT; ///< Наибольшее различимое значение (около 4,9 часа).
+
+    /**
+    * @brief Конструктор класса LatencyHist.
+    */
+    LatencyHist();
+
+    /**
+    * @brief Метод для учета значения.
+    * @param ns Значение в наносекундах.
+    */
+    void record(uint64_t ns);
+
+    /**
+    * @brief Метод для добавления значений другой гистограммы.
+    * @param other Гистограмма.
+    */
+    void merge(const LatencyHist &other);
+
+    /**
+    * @brief Метод для получения значения процентиля.
+    * @param percent Процентиль (0-100).
+    * @return Верхняя граница корзины процентиля в наносекундах (не больше максимума).
+    */
+    uint64_t percentile(double percent) const;
+
+    /**
+    * @brief Метод для получения количества значений.
+    * @return Количество значений.
+    */
+    uint64_t getCount() const;
+
+    /**
+    * @brief Метод для получения минимального значения.
+    * @return Минимальное значение в наносекундах (0, если значений нет).
+    */
+    uint64_t getMin() const;
+
+    /**
+    * @brief Метод для получения максимального значения.
+    * @return Максимальное значение в наносекундах.
+    */
+    uint64_t getMax() const;
+
+    /**
+    * @brief Метод для получения среднего значения.
+    * @return Среднее значение в наносекундах.
+    */
+    double getMean() const;
+
+    /**
+    * @brief Метод для записи гистограммы одной строкой: count min max sum и пары индекс:количество.
+    * @param out Поток вывода.
+    */
+    void save(std::ostream &out) const;
+
+    /**
+    * @brief Метод для чтения строки, записанной save(), с добавлением к текущим значениям.
+    * @param line Строка без имени гистограммы.
+    * @return false, если строка повреждена.
+    */
+    bool load(const std::string &line);
+
+    /**
+    * @brief Метод для записи непустых корзин в формате JSON ([[индекс, количество], ...]).
+    * @param out Поток вывода.
+    */
+    void jsonBuckets(std::ostream &out) const;
+
+private:
+    std::vector<uint64_t> counts; ///< Количество значений в корзинах.
+    uint64_t total; ///< Количество значений.
+    uint64_t min; ///< Минимальное значение.
+    uint64_t max; ///< Максимальное значение.
+    uint64_t sum; ///< Сумма значений.
+
+    /**
+    * @brief Вспомогательный метод для получения индекса корзины.
+    * @param ns Значение в наносекундах.
+    * @return Индекс корзины.
+    */
+    static size_t index(uint64_t ns);
+
+    /**
+    * @brief Вспомогательный метод для получения верхней границы корзины.
+    * @param index Индекс корзины.
+    * @return Наибольшее значение корзины в наносекундах.
+    */
+    static uint64_t upper(size_t index);
+};
+
+/**
+* @brief Набор гистограмм задержек этапов клиента.
+* @details Статический метод record() пишет в гистограммы текущего потока без блокировок; наборы
+* потоков хранятся до вызова reset() и объединяются методом collect().
+*/
+class LatencyStats
+{
+public:
+    /**
+    * @brief Измеряемые этапы.
+    */
+    enum Metric
+    {
+        CONNECT, ///< Установка подключения.
+        AUTH, ///< Аутентификация.
+        BATCH, ///< Время оборота одного окна (пакета) векторов.
+        JOB, ///< Полное время задания.
+        METRICS ///< Количество этапов.
+    };
+
+    /**
+    * @brief Статический метод для получения названия этапа.
+    * @param metric Этап.
+    * @return Название этапа.
+    */
+    static const char *name(Metric metric);
+
+    /**
+    * @brief Статический метод для учета задержки этапа в гистограмме текущего потока.
+    * @param metric Этап.
+    * @param elapsed Задержка.
+    */
+    static void record(Metric metric, std::chrono::steady_clock::duration elapsed);
+
+    /**
+    * @brief Статический метод для объединения гистограмм всех потоков.
+    * @details Вызывается после завершения потоков, записывающих задержки.
+    * @return Объединенный набор.
+    */
+    static LatencyStats collect();
+
+    /**
+    * @brief Статический метод для очистки гистограмм всех потоков.
+    * @details Вызывается, когда другие потоки не записывают задержки (например, перед началом задания).
+    */
+    static void reset();
+
+    /**
+    * @brief Метод для получения гистограммы этапа.
+    * @param metric Этап.
+    * @return Гистограмма.
+    */
+    LatencyHist &get(Metric metric);
+
+    /**
+    * @brief Метод для добавления значений другого набора.
+    * @param other Набор гистограмм.
+    */
+    void merge(const LatencyStats &other);
+
+    /**
+    * @brief Метод для добавления гистограмм из файла.
+    * @details Строки с одинаковыми именами объединяются, поэтому файлы разных запусков и машин
+    * можно объединить простой конкатенацией.
+    * @param path Путь к файлу гистограмм.
+    * @return false, если файла нет.
+    * @throw InvalidDataFormatError Если файл поврежден.
+    */
+    bool load(const std::string &path);
+
+    /**
+    * @brief Метод для сохранения гистограмм в файл.
+    * @param path Путь к файлу гистограмм.
+    * @throw FileNotFoundError Если не удалось записать файл.
+    */
+    void save(const std::string &path) const;
+
+    /**
+    * @brief Метод для вывода процентилей p50/p90/p99/p99.9/max в читаемом виде.
+    * @param out Поток вывода.
+    */
+    void report(std::ostream &out) const;
+
+    /**
+    * @brief Метод для вывода процентилей и корзин в формате JSON.
+    * @param out Поток вывода.
+    */
+    void json(std::ostream &out) const;
+
+private:
+    std::array<LatencyHist, METRICS> hists; ///< Гистограммы этапов.
+};
+
+#endif // LATENCY_H
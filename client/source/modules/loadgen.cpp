@@ -0,0 +1,172 @@
+#include "loadgen.h"
+#include "ioman.h"
+#include "latency.h"
+#include "vecgen.h"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <thread>
+#include <vector>
+#include <arpa/inet.h>
+
+// Количество заранее сгенерированных запросов каждого клиента
+static const size_t PAYLOADS = 8;
+// Пауза после ошибки в замкнутом цикле, чтобы недоступный сервер не превращал тест в цикл подключений
+static const int ERROR_PAUSE_MS = 10;
+
+// Конструктор
+LoadGen::LoadGen(
+    const std::string &config_path,
+    size_t clients,
+    double rate,
+    double duration,
+    size_t vectors,
+    size_t size)
+    : config_path(config_path),
+      clients(std::max<size_t>(1, clients)),
+      rate(rate),
+      duration(duration),
+      vectors(vectors),
+      size(size),
+      requests(0),
+      errors(0) {}
+
+uint64_t &LoadGen::getRequests()
+{
+    return this->requests;
+};
+uint64_t &LoadGen::getErrors()
+{
+    return this->errors;
+};
+
+// Метод для проверки, что адрес сервера локальный
+bool LoadGen::isLocal(const std::string &address)
+{
+    if (address.compare(0, 5, "unix:") == 0)
+        return true;
+    in_addr addr;
+    return inet_pton(AF_INET, address.c_str(), &addr) == 1 && (ntohl(addr.s_addr) >> 24) == 127;
+}
+
+// Метод для запуска теста
+uint64_t LoadGen::run(const std::function<NetMan *()> &make_net)
+{
+    IOMan conf_man(this->config_path, "", "");
+    std::array<std::string, 2> credentials = conf_man.conf();
+
+    std::atomic<uint64_t> requests(0);
+    std::atomic<uint64_t> network_errors(0);
+    std::atomic<uint64_t> auth_errors(0);
+    std::atomic<uint64_t> other_errors(0);
+    std::atomic<uint64_t> late(0);
+
+    typedef std::chrono::steady_clock clock;
+    // Интервал между запросами одного клиента в открытом цикле
+    auto interval = std::chrono::duration_cast<clock::duration>(
+        std::chrono::duration<double>(this->rate > 0 ? this->clients / this->rate : 0.0));
+    auto start = clock::now();
+    auto deadline = start + std::chrono::duration_cast<clock::duration>(std::chrono::duration<double>(this->duration));
+
+    auto worker = [&](size_t id)
+    {
+        std::unique_ptr<NetMan> net_man(make_net());
+        net_man->setVerbose(false);
+        bool connected = false;
+
+        // Запросы генерируются до начала теста, чтобы генерация не входила в измерения
+        VecGen gen(id + 1);
+        std::vector<std::vector<std::vector<int16_t>>> payloads(
+            PAYLOADS, std::vector<std::vector<int16_t>>(this->vectors, std::vector<int16_t>(this->size)));
+        for (auto &payload : payloads)
+            for (auto &vec : payload)
+                gen.fill(vec);
+        std::vector<int16_t> results(this->vectors);
+
+        // Клиенты открытого цикла сдвинуты по фазе, чтобы запросы не приходили пачками
+        auto next = start + interval * id / this->clients;
+        for (uint64_t k = 0;; ++k)
+        {
+            auto intended = clock::now();
+            if (this->rate > 0)
+            {
+                intended = next;
+                next += interval;
+                if (intended >= deadline)
+                    break;
+                auto now = clock::now();
+                if (now < intended)
+                    std::this_thread::sleep_until(intended);
+                else if (now - intended > interval)
+                    ++late;
+            }
+            else if (intended >= deadline)
+                break;
+
+            try
+            {
+                if (!connected)
+                {
+                    net_man->close();
+                    net_man->conn();
+                    net_man->auth(credentials[0], credentials[1]);
+                    connected = true;
+                }
+                net_man->calc(payloads[k % PAYLOADS], results, 0, std::function<void(size_t, size_t)>());
+                LatencyStats::record(LatencyStats::JOB, clock::now() - intended);
+                ++requests;
+                continue;
+            }
+            catch (const NetworkError &)
+            {
+                ++network_errors;
+                connected = false;
+            }
+            catch (const AuthError &)
+            {
+                ++auth_errors;
+                connected = false;
+            }
+            catch (const std::exception &)
+            {
+                ++other_errors;
+            }
+            if (this->rate <= 0)
+                std::this_thread::sleep_for(std::chrono::milliseconds(ERROR_PAUSE_MS));
+        }
+        net_man->close();
+    };
+
+    std::vector<std::thread> workers;
+    for (size_t i = 0; i < this->clients; ++i)
+        workers.emplace_back(worker, i);
+    for (auto &thread : workers)
+        thread.join();
+    std::chrono::duration<double> elapsed = clock::now() - start;
+
+    this->requests = requests;
+    this->errors = network_errors + auth_errors + other_errors;
+
+    // Сводка по тесту; распределение задержек запросов выводится как гистограмма "job"
+    double seconds = std::max(elapsed.count(), 1e-9);
+    std::cout << "Log: \"LoadGen.run()\"\n";
+    std::cout << "Load: " << this->clients << " clients, ";
+    if (this->rate > 0)
+        std::cout << "open loop at " << this->rate << " req/s";
+    else
+        std::cout << "closed loop";
+    std::cout << ", " << this->vectors << " vectors of " << this->size << " values per request, "
+              << elapsed.count() << " s\n";
+    std::cout << "Requests: " << this->requests << " ok, " << this->errors << " failed (network "
+              << network_errors << ", auth " << auth_errors << ", other " << other_errors << "), "
+              << late << " started late\n";
+    std::cout << "Throughput: " << this->requests / seconds << " req/s, "
+              << this->requests * this->vectors / seconds << " vectors/s, "
+              << this->requests * this->vectors * (sizeof(uint32_t) + this->size * sizeof(int16_t)) / seconds / 1e6
+              << " MB/s of vectors\n";
+
+    return this->errors;
+}
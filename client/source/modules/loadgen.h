@@ -0,0 +1,85 @@
+#ifndef LOAD_GEN_H
+#define LOAD_GEN_H
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include "netman.h"
+
+/**
+* @file loadgen.h
+* @brief Определение класса генератора нагрузки.
+* @details Этот файл содержит определения методов для нагрузочного тестирования сервера: несколько
+* виртуальных клиентов с собственными подключениями отправляют запросы из векторов, сгенерированных
+* в памяти, в замкнутом цикле (максимальная пропускная способность) или по расписанию с заданной частотой.
+* @date 19.10.2026
+* @version 1.0
+* @authorsa Ягольницкий Р. С.
+*/
+
+/**
+* @brief Класс генератора нагрузки.
+* @details В замкнутом цикле каждый клиент отправляет следующий запрос сразу после получения ответа.
+* В открытом цикле запросы клиента запланированы с постоянным интервалом, и задержка отсчитывается
+* от запланированного, а не от фактического времени отправки: если сервер не успевает, ожидание
+* в очереди входит в задержку (без скоординированного пропуска замеров). Задержки запросов
+* записываются в гистограмму LatencyStats::JOB.
+*/
+class LoadGen
+{
+public:
+    /**
+    * @brief Конструктор класса LoadGen.
+    * @param config_path Путь к файлу конфигурации с учетными данными.
+    * @param clients Количество виртуальных клиентов.
+    * @param rate Суммарная частота запросов в секунду (0 - замкнутый цикл).
+    * @param duration Длительность теста в секундах.
+    * @param vectors Количество векторов в запросе.
+    * @param size Количество значений в векторе.
+    */
+    LoadGen(
+        const std::string &config_path,
+        size_t clients,
+        double rate,
+        double duration,
+        size_t vectors,
+        size_t size);
+
+    /**
+    * @brief Статический метод для проверки, что адрес сервера локальный.
+    * @param address Адрес сервера.
+    * @return true для адресов 127.0.0.0/8 и unix:/path.
+    */
+    static bool isLocal(const std::string &address);
+
+    /**
+    * @brief Метод для запуска теста.
+    * @param make_net Функция, создающая настроенный NetMan для каждого виртуального клиента.
+    * @return Количество неудачных запросов.
+    */
+    uint64_t run(const std::function<NetMan *()> &make_net);
+
+    /**
+    * @brief Метод для получения количества выполненных запросов.
+    * @return Количество успешных запросов.
+    */
+    uint64_t &getRequests();
+
+    /**
+    * @brief Метод для получения количества ошибок.
+    * @return Количество неудачных запросов и подключений.
+    */
+    uint64_t &getErrors();
+
+private:
+    std::string config_path; ///< Путь к файлу конфигурации.
+    size_t clients; ///< Количество виртуальных клиентов.
+    double rate; ///< Суммарная частота запросов (0 - замкнутый цикл).
+    double duration; ///< Длительность теста в секундах.
+    size_t vectors; ///< Количество векторов в запросе.
+    size_t size; ///< Количество значений в векторе.
+    uint64_t requests; ///< Количество успешных запросов.
+    uint64_t errors; ///< Количество ошибок.
+};
+
+#endif // LOAD_GEN_H
@@ -0,0 +1,243 @@
+#include "loopback.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include "wirecodec.h"
+#include "stride.h"
+#include "errors.h"
+
+// Начальный размер кольцевого буфера ответа
+static const size_t RING_SIZE = 4096;
+
+// Размер разобранной части запроса, после которого она удаляется из буфера
+static const size_t COMPACT_AFTER = 65536;
+
+// Конструктор
+LoopbackScript::LoopbackScript(bool accept_auth, bool accept_compact, uint64_t drop_after)
+    : accept_auth(accept_auth), accept_compact(accept_compact), drop_after(drop_after) {}
+
+// Конструктор
+LoopbackTransport::LoopbackTransport(const LoopbackScript &script)
+    : script(script), state(AUTH), connected(false), input_pos(0), ring(RING_SIZE), head(0), tail(0),
+      remaining(0), bytes_in(0), bytes_out(0), vectors(0) {}
+
+uint64_t &LoopbackTransport::getBytesIn()
+{
+    return this->bytes_in;
+};
+uint64_t &LoopbackTransport::getBytesOut()
+{
+    return this->bytes_out;
+};
+uint64_t &LoopbackTransport::getVectors()
+{
+    return this->vectors;
+};
+
+// Метод для подключения к серверу
+int LoopbackTransport::connect(const SocketOptions &, int)
+{
+    this->connected = true;
+    return 0;
+}
+
+// Метод для отправки данных серверу
+ssize_t LoopbackTransport::send(const void *buf, size_t size)
+{
+    if (!this->connected || this->state == CLOSED)
+    {
+        errno = this->connected ? EPIPE : ENOTCONN;
+        return -1;
+    }
+    const uint8_t *bytes = static_cast<const uint8_t *>(buf);
+    this->input.insert(this->input.end(), bytes, bytes + size);
+    this->bytes_in += size;
+    while (this->step())
+    {
+    }
+
+    // Разобранная часть запроса удаляется, когда становится заметной
+    if (this->input_pos == this->input.size())
+    {
+        this->input.clear();
+        this->input_pos = 0;
+    }
+    else if (this->input_pos >= COMPACT_AFTER)
+    {
+        this->input.erase(this->input.begin(), this->input.begin() + this->input_pos);
+        this->input_pos = 0;
+    }
+    return size;
+}
+
+// Метод для приема ответа сервера
+ssize_t LoopbackTransport::recv(void *buf, size_t size)
+{
+    if (!this->connected)
+    {
+        errno = ENOTCONN;
+        return -1;
+    }
+    // Сервер отвечает синхронно в send(), поэтому пустой буфер означает, что ответа не будет
+    size_t mask = this->ring.size() - 1;
+    size = std::min(size, this->tail - this->head);
+    uint8_t *out = static_cast<uint8_t *>(buf);
+    for (size_t done = 0; done < size;)
+    {
+        size_t pos = (this->head + done) & mask;
+        size_t part = std::min(size - done, this->ring.size() - pos);
+        std::memcpy(out + done, &this->ring[pos], part);
+        done += part;
+    }
+    this->head += size;
+    return size;
+}
+
+// Метод для разбора накопленных байт запроса
+bool LoopbackTransport::step()
+{
+    const uint8_t *pos = this->input.data() + this->input_pos;
+    size_t avail = this->input.size() - this->input_pos;
+    switch (this->state)
+    {
+    case AUTH:
+    {
+        // Сообщение аутентификации передается одним вызовом send()
+        if (avail == 0)
+            return false;
+        this->input_pos += avail;
+        if (!this->script.accept_auth)
+        {
+            this->reply("ERR", 3);
+            this->state = CLOSED;
+            return false;
+        }
+        this->reply("OK", 2);
+        this->state = HEADER;
+        return true;
+    }
+    case HEADER:
+    {
+        uint32_t value;
+        if (avail < sizeof(value))
+            return false;
+        std::memcpy(&value, pos, sizeof(value));
+        if (value == WireCodec::MAGIC)
+        {
+            // Запрос компактного режима: сигнатура и версия формата
+            if (avail < sizeof(value) + 1)
+                return false;
+            this->input_pos += sizeof(value) + 1;
+            uint8_t accepted = this->script.accept_compact ? 1 : 0;
+            this->reply(&accepted, sizeof(accepted));
+            if (accepted)
+                this->state = FRAMES;
+            return true;
+        }
+        this->input_pos += sizeof(value);
+        this->remaining = value;
+        if (this->remaining > 0)
+            this->state = VECTORS;
+        return true;
+    }
+    case VECTORS:
+    {
+        uint32_t size;
+        if (avail < sizeof(size))
+            return false;
+        std::memcpy(&size, pos, sizeof(size));
+        size_t bytes = sizeof(size) + size_t(size) * sizeof(int16_t);
+        if (avail < bytes)
+            return false;
+        this->input_pos += bytes;
+        if (--this->remaining == 0)
+            this->state = HEADER;
+        this->answer(pos + sizeof(size), size);
+        return this->state != CLOSED;
+    }
+    case FRAMES:
+    {
+        // Заголовок пакета: флаг и два varint, второй - длина полезной нагрузки
+        if (avail == 0)
+            return false;
+        const uint8_t *cur = pos + 1;
+        const uint8_t *end = pos + avail;
+        uint32_t payload_size = 0;
+        for (int field = 0; field < 2; ++field)
+        {
+            payload_size = 0;
+            int shift = 0;
+            uint8_t byte;
+            do
+            {
+                if (cur == end)
+                    return false;
+                byte = *cur++;
+                payload_size |= uint32_t(byte & 0x7F) << shift;
+                shift += 7;
+            } while ((byte & 0x80) && shift < 35);
+        }
+        size_t frame_size = (cur - pos) + size_t(payload_size);
+        if (avail < frame_size)
+            return false;
+        this->input_pos += frame_size;
+
+        std::vector<std::vector<int16_t>> batch;
+        try
+        {
+            batch = WireCodec::decode(pos, frame_size);
+        }
+        catch (const InvalidDataFormatError &)
+        {
+            // Сервер разрывает подключение при поврежденном пакете
+            this->state = CLOSED;
+            return false;
+        }
+        for (size_t i = 0; i < batch.size() && this->state != CLOSED; ++i)
+            this->answer(reinterpret_cast<const uint8_t *>(batch[i].data()), batch[i].size());
+        return this->state != CLOSED;
+    }
+    default:
+        return false;
+    }
+}
+
+// Метод для записи ответа в кольцевой буфер
+void LoopbackTransport::reply(const void *buf, size_t size)
+{
+    size_t used = this->tail - this->head;
+    if (used + size > this->ring.size())
+    {
+        // Буфер расширяется до степени двойки, непрочитанные байты переносятся в начало
+        size_t capacity = this->ring.size();
+        while (capacity < used + size)
+            capacity <<= 1;
+        std::vector<uint8_t> grown(capacity);
+        this->recv(grown.data(), used);
+        this->ring.swap(grown);
+        this->head = 0;
+        this->tail = used;
+    }
+    size_t mask = this->ring.size() - 1;
+    const uint8_t *in = static_cast<const uint8_t *>(buf);
+    for (size_t done = 0; done < size;)
+    {
+        size_t pos = (this->tail + done) & mask;
+        size_t part = std::min(size - done, this->ring.size() - pos);
+        std::memcpy(&this->ring[pos], in + done, part);
+        done += part;
+    }
+    this->tail += size;
+    this->bytes_out += size;
+}
+
+// Метод для ответа на вектор
+void LoopbackTransport::answer(const uint8_t *values, size_t size)
+{
+    int16_t result = FixedStride::sum(values, size);
+    this->reply(&result, sizeof(result));
+
+    ++this->vectors;
+    if (this->script.drop_after && this->vectors >= this->script.drop_after)
+        this->state = CLOSED;
+}
@@ -0,0 +1,124 @@
+#ifndef LOOPBACK_H
+#define LOOPBACK_H
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include "transport.h"
+
+/**
+* @file loopback.h
+* @brief Определение транспорта с сервером внутри процесса.
+* @details Этот файл содержит транспорт, который вместо сокета передает байты встроенному серверу,
+* выполняющему протокол по заданному сценарию. Транспорт не использует ядро и потоки, поэтому
+* подходит для детерминированных тестов NetMan и измерения затрат на кодирование протокола.
+* @date 19.10.2026
+* @version 1.0
+* @authorsa Ягольницкий Р. С.
+*/
+
+/**
+* @brief Сценарий встроенного сервера.
+*/
+struct LoopbackScript
+{
+    bool accept_auth; ///< Подтверждать аутентификацию.
+    bool accept_compact; ///< Принимать компактный режим.
+    uint64_t drop_after; ///< Количество векторов, после которого подключение разрывается (0 - не разрывать).
+
+    /**
+    * @brief Конструктор структуры LoopbackScript.
+    * @param accept_auth Подтверждать аутентификацию.
+    * @param accept_compact Принимать компактный режим.
+    * @param drop_after Количество векторов до разрыва подключения (0 - не разрывать).
+    */
+    LoopbackScript(bool accept_auth = true, bool accept_compact = true, uint64_t drop_after = 0);
+};
+
+/**
+* @brief Транспорт с сервером внутри процесса.
+* @details Сервер работает синхронно в вызове send(): разбирает накопленные байты запроса
+* (аутентификация, согласование компактного режима, сырые векторы или пакеты WireCodec) и помещает
+* суммы векторов с насыщением в кольцевой буфер ответа, из которого читает recv(). Буфер ответа
+* расширяется, поэтому окно любого размера передается без блокировки. После разрыва подключения
+* send() завершается ошибкой EPIPE, а recv() возвращает оставшиеся ответы, затем 0.
+*/
+class LoopbackTransport : public Transport
+{
+public:
+    /**
+    * @brief Конструктор класса LoopbackTransport.
+    * @param script Сценарий сервера.
+    */
+    explicit LoopbackTransport(const LoopbackScript &script = LoopbackScript());
+
+    int connect(const SocketOptions &options, int timeout_ms) override;
+    ssize_t send(const void *buf, size_t size) override;
+    ssize_t recv(void *buf, size_t size) override;
+
+    /**
+    * @brief Метод для получения количества байт, принятых сервером.
+    * @return Количество байт.
+    */
+    uint64_t &getBytesIn();
+
+    /**
+    * @brief Метод для получения количества байт, отправленных сервером.
+    * @return Количество байт.
+    */
+    uint64_t &getBytesOut();
+
+    /**
+    * @brief Метод для получения количества векторов, обработанных сервером.
+    * @return Количество векторов.
+    */
+    uint64_t &getVectors();
+
+private:
+    /**
+    * @brief Состояние разбора запроса.
+    */
+    enum State
+    {
+        AUTH, ///< Ожидается сообщение аутентификации.
+        HEADER, ///< Ожидается запрос компактного режима или количество векторов.
+        VECTORS, ///< Ожидаются векторы сырого режима.
+        FRAMES, ///< Ожидаются пакеты компактного режима.
+        CLOSED ///< Подключение разорвано сервером.
+    };
+
+    LoopbackScript script; ///< Сценарий сервера.
+    State state; ///< Состояние разбора запроса.
+    bool connected; ///< Флаг выполненного подключения.
+    std::vector<uint8_t> input; ///< Принятые и еще не разобранные байты запроса.
+    size_t input_pos; ///< Позиция разбора в input.
+    std::vector<uint8_t> ring; ///< Кольцевой буфер ответа (размер - степень двойки).
+    size_t head; ///< Счетчик прочитанных байт ответа.
+    size_t tail; ///< Счетчик записанных байт ответа.
+    uint32_t remaining; ///< Количество оставшихся векторов сырого режима.
+    uint64_t bytes_in; ///< Количество принятых байт.
+    uint64_t bytes_out; ///< Количество отправленных байт.
+    uint64_t vectors; ///< Количество обработанных векторов.
+
+    /**
+    * @brief Вспомогательный метод для разбора накопленных байт запроса.
+    * @return false, если данных недостаточно для следующего шага.
+    */
+    bool step();
+
+    /**
+    * @brief Вспомогательный метод для записи ответа в кольцевой буфер.
+    * @param buf Данные.
+    * @param size Размер данных в байтах.
+    */
+    void reply(const void *buf, size_t size);
+
+    /**
+    * @brief Вспомогательный метод для ответа на вектор суммой его значений с насыщением.
+    * @param values Значения вектора (int16 без требований к выравниванию).
+    * @param size Количество значений.
+    */
+    void answer(const uint8_t *values, size_t size);
+};
+
+#endif // LOOPBACK_H
@@ -1,17 +1,46 @@
 #include "netman.h"
 #include <cstring>
+#include <cerrno>
+#include <algorithm>
+#include <limits>
 #include <stdexcept>
 #include <sys/types.h>
 #include <sys/socket.h>
-#include <arpa/inet.h>
 #include <unistd.h>
+#include <fcntl.h>
+#include <csignal>
+#include <pthread.h>
+#include <sys/sendfile.h>
+#include <poll.h>
 #include "cryptman.h"
 #include "errors.h"
+#include "wirecodec.h"
+#include "stride.h"
+#include "sockopts.h"
+#include "latency.h"
+#include "probes.h"
+#include "hugemem.h"
+#include "transport.h"
 #include <iostream>
+#include <thread>
+#include <chrono>
+
+// Шаг ожидания перед повторным подключением, с которым проверяется отмена
+static const int RETRY_POLL_MS = 10;
+
+// Начальная и максимальная задержка перед повторным подключением
+static const int RETRY_BASE_DELAY_MS = 100;
+static const int RETRY_MAX_DELAY_MS = 5000;
+
+// Время ожидания ответа на запрос расширения протокола: сервер без расширения не отвечает
+static const int HANDSHAKE_TIMEOUT_MS = 1000;
 
 // Конструктор
 NetMan::NetMan(const std::string &address, uint16_t port)
-    : address(address), port(port), socket(-1) {}
+    : address(address), port(port), socket(-1), wire_mode("raw"), compact(false), retries(3),
+      transport("socket"), local(false), tcp(false), verbose(true), cache(nullptr), progress(nullptr), timeout_ms(0),
+      deadline(std::chrono::steady_clock::time_point::max()), armed_ms(0), cancelled(false),
+      compact_unsupported(false), shm_unsupported(false) {}
 
 std::string &NetMan::getAddress()
 {
@@ -21,85 +50,870 @@ uint16_t &NetMan::getPort()
 {
     return this->port;
 };
+void NetMan::setWireMode(const std::string &mode)
+{
+    this->wire_mode = mode;
+};
+std::string &NetMan::getWireMode()
+{
+    return this->wire_mode;
+};
+void NetMan::setRetries(int retries)
+{
+    this->retries = retries;
+};
+void NetMan::setWindow(size_t window)
+{
+    this->window_ctl.setFixed(window);
+};
+size_t NetMan::getWindow()
+{
+    return this->window_ctl.getWindow();
+};
+void NetMan::setOptions(const SocketOptions &options)
+{
+    this->options = options;
+};
+SocketOptions &NetMan::getOptions()
+{
+    return this->options;
+};
+void NetMan::setBackend(const std::string &backend)
+{
+    this->ring.reset();
+    if (backend != "uring")
+        return;
+    this->ring.reset(new URing());
+    if (!this->ring->available())
+    {
+        this->ring.reset();
+        std::cout << "Log: \"NetMan.setBackend()\"\n";
+        std::cout << "io_uring is not supported, using blocking I/O\n";
+    }
+};
+bool NetMan::usesRing()
+{
+    return bool(this->ring);
+};
+void NetMan::setTransport(const std::string &transport)
+{
+    this->transport = transport;
+};
+std::string &NetMan::getTransport()
+{
+    return this->transport;
+};
+bool NetMan::usesShm()
+{
+    return bool(this->shm);
+};
+bool NetMan::canSendFile()
+{
+    return !this->compact && !this->shm && !this->cache && this->socket >= 0;
+};
+void NetMan::setCache(ResultCache *cache)
+{
+    this->cache = cache;
+};
+void NetMan::setConnector(const std::function<Transport *()> &connector)
+{
+    this->connector = connector;
+};
+void NetMan::setProgress(Progress *progress)
+{
+    this->progress = progress;
+};
+void NetMan::setVerbose(bool verbose)
+{
+    this->verbose = verbose;
+};
+void NetMan::setTimeout(int timeout_ms)
+{
+    this->timeout_ms = std::max(0, timeout_ms);
+};
+void NetMan::setDeadline(std::chrono::steady_clock::time_point deadline)
+{
+    this->deadline = deadline;
+};
+bool NetMan::isCancelled()
+{
+    return this->cancelled;
+};
+
+// Метод для отмены операций из другого потока
+void NetMan::cancel()
+{
+    // Флаг устанавливается до прерывания: операция, завершившаяся ошибкой, видит причину
+    this->cancelled = true;
+    this->abort();
+}
+
+// Метод для проверки ограничений по времени
+bool NetMan::timed()
+{
+    return this->timeout_ms > 0 || this->deadline != std::chrono::steady_clock::time_point::max();
+}
+
+// Метод для проверки срока и отмены и установки таймаутов сокета
+void NetMan::arm()
+{
+    if (this->cancelled)
+        throw CancelledError("Operation cancelled", "NetMan.arm()");
+    int timeout = this->timeout_ms;
+    if (this->deadline != std::chrono::steady_clock::time_point::max())
+    {
+        // Остаток округляется вверх, чтобы таймаут сокета не истекал раньше срока
+        auto left = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                        this->deadline - std::chrono::steady_clock::now())
+                        .count();
+        if (left <= 0)
+            throw DeadlineError("Job deadline exceeded", "NetMan.arm()");
+        long long left_ms = std::min<long long>((left + 999999) / 1000000, std::numeric_limits<int>::max());
+        if (timeout <= 0 || left_ms < timeout)
+            timeout = left_ms;
+    }
+    if (timeout == this->armed_ms || this->socket < 0)
+        return;
+
+    // Блокирующие send(), recv() и sendfile() возвращают EAGAIN, если за это время не передано ни байта
+    struct timeval tv;
+    tv.tv_sec = timeout / 1000;
+    tv.tv_usec = (timeout % 1000) * 1000;
+    setsockopt(this->socket, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+    setsockopt(this->socket, SOL_SOCKET, SO_SNDTIMEO, &tv, sizeof(tv));
+    this->armed_ms = timeout;
+}
+
+// Метод для определения прерванной операции
+void NetMan::interrupt(const std::string &message, const std::string &func, int error)
+{
+    if (this->cancelled)
+        throw CancelledError(message + " (cancelled)", func);
+    if (std::chrono::steady_clock::now() >= this->deadline)
+        throw DeadlineError(message + " (job deadline exceeded)", func);
+    if (error == ETIMEDOUT || (this->timed() && (error == EAGAIN || error == EWOULDBLOCK)))
+        throw TimeoutError(message + " (timed out)", func);
+}
+
+// Метод для сообщения о сбое отправки или приема
+void NetMan::fail(const std::string &message, const std::string &func)
+{
+    this->interrupt(message, func, errno);
+    throw NetworkError(message, func);
+}
+
+// Метод для отправки всего буфера с учетом частичной отправки
+bool NetMan::sendAll(const void *buf, size_t size)
+{
+    if (this->shm)
+    {
+        this->shm->setLimits(this->timeout_ms, this->deadline);
+        return this->shm->sendAll(buf, size, this->socket);
+    }
+    const char *pos = static_cast<const char *>(buf);
+    errno = 0;
+    if (!this->link)
+        return false;
+    while (size > 0)
+    {
+        ssize_t sent = this->link->send(pos, size);
+        if (sent <= 0)
+            return false;
+        pos += sent;
+        size -= sent;
+    }
+    return true;
+}
+
+// Метод для получения буфера заданного размера с учетом частичного приема
+bool NetMan::recvAll(void *buf, size_t size)
+{
+    if (this->shm)
+    {
+        this->shm->setLimits(this->timeout_ms, this->deadline);
+        return this->shm->recvAll(buf, size, this->socket);
+    }
+    char *pos = static_cast<char *>(buf);
+    errno = 0;
+    if (!this->link)
+        return false;
+    while (size > 0)
+    {
+        ssize_t received = this->link->recv(pos, size);
+        if (received <= 0)
+            return false;
+        pos += received;
+        size -= received;
+    }
+    return true;
+}
 // Метод для установки соединения
 void NetMan::conn()
 {
-    this->socket = ::socket(AF_INET, SOCK_STREAM, 0);
-    if (this->socket < 0)
+    this->arm();
+    // Предыдущее подключение закрывается до создания нового; транспорт выбирается по адресу,
+    // если функция создания транспорта не задана
     {
-        throw NetworkError("Failed to create socket", "NetMan.conn()");
+        std::lock_guard<std::mutex> lock(this->link_mutex);
+        this->socket = -1;
+        this->link.reset();
     }
+    std::unique_ptr<Transport> link(this->connector ? this->connector() : Transport::open(this->address, this->port));
+    {
+        std::lock_guard<std::mutex> lock(this->link_mutex);
+        this->link = std::move(link);
+        this->socket = this->link->fd();
+    }
+    this->local = this->link->local();
+    this->tcp = this->link->tcp();
+    this->armed_ms = 0;
+    // Отмена, вызванная до создания сокета, не могла его прервать
+    if (this->cancelled)
+        throw CancelledError("Operation cancelled", "NetMan.conn()");
 
-    struct sockaddr_in server_addr;
-    std::memset(&server_addr, 0, sizeof(server_addr));
-    server_addr.sin_family = AF_INET;
-    server_addr.sin_port = htons(this->port);
-
-    if (inet_pton(AF_INET, this->address.c_str(), &server_addr.sin_addr) <= 0)
-        throw NetworkError("Invalid address/ Address not supported", "NetMan.conn()");
+    // Параметры сокета применяются до подключения (размеры буферов влияют на масштабирование окна TCP)
+    if (this->socket >= 0)
+    {
+        std::string failed = this->options.apply(this->socket, this->tcp);
+        if (!failed.empty())
+        {
+            std::cout << "Log: \"NetMan.conn()\"\n";
+            std::cout << "Socket options not applied:" << failed << "\n";
+        }
+    }
 
-    if (connect(this->socket, (struct sockaddr *)&server_addr, sizeof(server_addr)) < 0)
+    auto start = std::chrono::steady_clock::now();
+    VCLIENT_PROBE1(connect_start, this->port);
+    // Подключение ограничено меньшим из таймаутов профиля и операций и оставшимся до срока временем
+    int timeout = this->options.connect_timeout_ms;
+    if (this->timeout_ms > 0 && (timeout <= 0 || this->timeout_ms < timeout))
+        timeout = this->timeout_ms;
+    if (this->deadline != std::chrono::steady_clock::time_point::max())
+    {
+        int left = std::max<long long>(1, std::min<long long>(std::chrono::duration_cast<std::chrono::milliseconds>(this->deadline - start).count(), std::numeric_limits<int>::max()));
+        if (timeout <= 0 || left < timeout)
+            timeout = left;
+    }
+    int error = this->link->connect(this->options, timeout);
+    VCLIENT_PROBE1(connect_end, error);
+    if (error != 0)
+    {
+        this->interrupt(error == ETIMEDOUT ? "Connection timed out" : "Connection failed", "NetMan.conn()", error);
         throw NetworkError("Connection failed", "NetMan.conn()");
+    }
+    LatencyStats::record(LatencyStats::CONNECT, std::chrono::steady_clock::now() - start);
+    this->arm();
 }
 
 // Метод для аутентификации
 void NetMan::auth(const std::string &login, const std::string &password)
 {
+    // Учетные данные сохраняются для повторной аутентификации при переподключении
+    this->login = login;
+    this->password = password;
+
+    this->arm();
+    auto start = std::chrono::steady_clock::now();
+    VCLIENT_PROBE0(auth_start);
     std::string salt = CryptMan::get_salt();
     std::string hash = CryptMan::get_hash(salt, password);
 
     std::string auth_message = login + salt + hash;
-    if (send(this->socket, auth_message.c_str(), auth_message.size(), 0) < 0)
+    if (!this->link || this->link->send(auth_message.c_str(), auth_message.size()) < 0)
+    {
+        VCLIENT_PROBE1(auth_end, 0);
+        this->interrupt("Failed to send auth message", "NetMan.auth()", errno);
         throw AuthError("Failed to send auth message", "NetMan.auth()");
+    }
 
     char response[1024];
-    int response_length = recv(this->socket, response, sizeof(response) - 1, 0);
+    int response_length = this->link->recv(response, sizeof(response) - 1);
     if (response_length < 0)
     {
+        VCLIENT_PROBE1(auth_end, 0);
+        this->interrupt("Failed to receive auth response", "NetMan.auth()", errno);
         throw AuthError("Failed to receive auth response", "NetMan.auth()");
     }
 
     response[response_length] = '\0';
     if (std::string(response) != "OK")
     {
+        VCLIENT_PROBE1(auth_end, 0);
         throw AuthError("Authentication failed", "NetMan.auth()");
     }
+    VCLIENT_PROBE1(auth_end, 1);
+    LatencyStats::record(LatencyStats::AUTH, std::chrono::steady_clock::now() - start);
+
+    this->compact = false;
+    this->shm.reset();
+    if (this->wire_mode == "compact" && !this->compact_unsupported && !this->negotiate())
+    {
+        // Сервер без компактного режима принял запрос за количество векторов и ждет данные:
+        // подключение пересоздается, и режим больше не запрашивается у этого сервера
+        this->compact_unsupported = true;
+        std::cout << "Log: \"NetMan.auth()\"\n";
+        std::cout << "Server did not answer the compact mode request, using raw\n";
+        this->conn();
+        this->auth(this->login, this->password);
+        return;
+    }
+
+    if (this->transport == "shm" && !this->shm_unsupported && !this->attachShm())
+    {
+        // Сервер без общей памяти принял запрос за данные: подключение пересоздается без нее
+        this->shm_unsupported = true;
+        std::cout << "Log: \"NetMan.auth()\"\n";
+        std::cout << "Server did not answer the shared memory request, using socket\n";
+        this->conn();
+        this->auth(this->login, this->password);
+    }
 }
 
-// Метод для передачи данных и получения результата
-std::vector<int16_t> NetMan::calc(const std::vector<std::vector<int16_t>> &data)
+// Метод для ожидания ответа на запрос расширения протокола
+bool NetMan::awaitReply()
+{
+    // Встроенный транспорт отвечает синхронно
+    if (this->socket < 0)
+        return true;
+    int timeout = HANDSHAKE_TIMEOUT_MS;
+    if (this->deadline != std::chrono::steady_clock::time_point::max())
+    {
+        long long left = std::chrono::duration_cast<std::chrono::milliseconds>(
+                             this->deadline - std::chrono::steady_clock::now())
+                             .count();
+        timeout = std::max<long long>(1, std::min<long long>(timeout, left));
+    }
+
+    // Разрыв и отмена тоже завершают ожидание: ошибку сообщит следующий прием
+    struct pollfd pfd = {this->socket, POLLIN, 0};
+    int ready;
+    do
+        ready = ::poll(&pfd, 1, timeout);
+    while (ready < 0 && errno == EINTR);
+    return ready != 0;
+}
+
+// Метод для согласования компактного режима
+bool NetMan::negotiate()
+{
+    // Запрос: сигнатура и версия формата, ответ: 1 - режим принят, 0 - отклонен
+    uint8_t request[5];
+    uint32_t magic = WireCodec::MAGIC;
+    std::memcpy(request, &magic, sizeof(magic));
+    request[4] = 1;
+    if (!this->sendAll(request, sizeof(request)))
+        this->fail("Failed to send wire mode request", "NetMan.negotiate()");
+    if (!this->awaitReply())
+        return false;
+
+    uint8_t accepted = 0;
+    if (!this->recvAll(&accepted, sizeof(accepted)))
+        this->fail("Failed to receive wire mode response", "NetMan.negotiate()");
+    this->compact = accepted == 1;
+    return true;
+}
+
+// Метод для согласования транспорта через общую память
+bool NetMan::attachShm()
 {
-    // Передача количества векторов
-    uint32_t num_vectors = data.size();
-    if (send(this->socket, &num_vectors, sizeof(num_vectors), 0) < 0)
+    // Сегмент можно передать только процессу на том же хосте через Unix-сокет
+    if (!this->local)
     {
-        throw NetworkError("Failed to send number of vectors", "NetMan.calc()");
+        std::cout << "Log: \"NetMan.attachShm()\"\n";
+        std::cout << "Shared memory transport requires a unix: address, using socket\n";
+        return true;
     }
+    std::unique_ptr<ShmTransport> transport(new ShmTransport(-1, ShmTransport::CAPACITY, false));
+    if (!transport->ready())
+    {
+        std::cout << "Log: \"NetMan.attachShm()\"\n";
+        std::cout << "Shared memory is not available, using socket\n";
+        return true;
+    }
+
+    // Запрос: сигнатура и размер кольцевого буфера с дескриптором сегмента, ответ: 1 - принят, 0 - отклонен
+    uint32_t request[2] = {ShmTransport::MAGIC, static_cast<uint32_t>(ShmTransport::CAPACITY)};
+    if (!ShmTransport::sendFd(this->socket, request, sizeof(request), transport->getFd()))
+        this->fail("Failed to send transport request", "NetMan.attachShm()");
+    if (!this->awaitReply())
+        return false;
+
+    uint8_t accepted = 0;
+    if (!this->recvAll(&accepted, sizeof(accepted)))
+        this->fail("Failed to receive transport response", "NetMan.attachShm()");
+    if (accepted == 1)
+        this->shm = std::move(transport);
+    return true;
+}
 
-    // Передача каждого вектора
-    for (const auto &vec : data)
+// Метод для отправки окна и приема его результатов
+void NetMan::exchange(const void *out, size_t out_size, void *in, size_t in_size)
+{
+    size_t sent = 0;
+    size_t received = 0;
+    // Операции кольца не учитывают таймауты сокета, поэтому при ограничениях по времени используются блокирующие вызовы
+    if (this->ring && !this->shm && !this->timed() && this->socket >= 0)
     {
-        uint32_t vec_size = vec.size();
-        if (send(this->socket, &vec_size, sizeof(vec_size), 0) < 0)
+        // Отправка и прием передаются ядру одним вызовом и выполняются асинхронно
+        this->ring->prepSend(this->socket, out, out_size, 0, MSG_NOSIGNAL);
+        this->ring->prepRecv(this->socket, in, in_size, 1, MSG_WAITALL);
+        this->ring->submit(2);
+
+        // Оба завершения собираются до проверки, чтобы в кольце не осталось операций над буферами.
+        // Остаток короткой отправки передается сразу: сервер не ответит, пока не получит все окно,
+        // поэтому ожидание приема до досылки привело бы к взаимной блокировке
+        int results[2] = {-EIO, -EIO};
+        bool pending[2] = {true, true};
+        while (pending[0] || pending[1])
         {
-            throw NetworkError("Failed to send vector size", "NetMan.calc()");
+            uint64_t tag;
+            int res;
+            if (!this->ring->complete(tag, res, true))
+                break;
+            if (tag >= 2)
+                continue;
+            if (tag == 0 && res > 0 && sent + res < out_size)
+            {
+                sent += res;
+                this->ring->prepSend(this->socket, static_cast<const char *>(out) + sent, out_size - sent, 0,
+                                     MSG_NOSIGNAL);
+                this->ring->submit();
+                continue;
+            }
+            results[tag] = res;
+            pending[tag] = false;
         }
-        if (send(this->socket, vec.data(), vec_size * sizeof(int16_t), 0) < 0)
+        if (results[0] < 0)
         {
-            throw NetworkError("Failed to send vector data", "NetMan.calc()");
+            errno = -results[0];
+            this->fail("Failed to send vector batch", "NetMan.calc()");
         }
+        if (results[1] <= 0 && in_size > 0)
+        {
+            errno = results[1] < 0 ? -results[1] : 0;
+            this->fail("Failed to receive result", "NetMan.calc()");
+        }
+        sent += results[0];
+        received = results[1];
     }
 
-    // Получение результатов
-    std::vector<int16_t> results(num_vectors);
-    for (uint32_t i = 0; i < num_vectors; ++i)
+    // Завершение частично выполненных операций блокирующими вызовами
+    if (!this->sendAll(static_cast<const char *>(out) + sent, out_size - sent))
+        this->fail("Failed to send vector batch", "NetMan.calc()");
+    if (!this->recvAll(static_cast<char *>(in) + received, in_size - received))
+        this->fail("Failed to receive result", "NetMan.calc()");
+}
+
+// Метод для передачи данных в рамках одного подключения
+void NetMan::session(
+    const std::vector<std::vector<int16_t>> &data,
+    std::vector<int16_t> &results,
+    size_t &done,
+    size_t last,
+    const std::function<void(size_t, size_t)> &commit,
+    const std::vector<size_t> *order)
+{
+    if (done >= last)
+        return;
+
+    // В сыром режиме сервер ожидает количество оставшихся векторов
+    if (!this->compact)
     {
-        if (recv(this->socket, &results[i], sizeof(int16_t), 0) < 0)
+        uint32_t remaining = last - done;
+        if (!this->sendAll(&remaining, sizeof(remaining)))
         {
-            throw NetworkError("Failed to receive result", "NetMan.calc()");
+            this->fail("Failed to send number of vectors", "NetMan.calc()");
         }
     }
 
+    std::vector<uint8_t> &frame = this->frame;
+    while (done < last)
+    {
+        // Срок и отмена проверяются перед каждым окном
+        this->arm();
+
+        // Размер окна подбирается по измерениям предыдущих окон
+        size_t end = std::min(this->window_ctl.next(data, done, order), last);
+        size_t bytes = 0;
+        auto start = std::chrono::steady_clock::now();
+        VCLIENT_PROBE2(batch_start, done, end - done);
+        // Окно из векторов одинакового малого размера сериализуется целиком без отправки по вектору
+        if (this->compact || this->ring || FixedStride::fixedSize(data, done, end, order))
+        {
+            // Окно передается одним буфером: в компактном формате или сериализованным сырым
+            if (this->compact)
+                this->codec.encode(data, done, end, frame, order);
+            else
+                FixedStride::pack(data, done, end, frame, order);
+            bytes = frame.size();
+            // Отправка и прием совмещены, поэтому batch_send отмечает передачу буфера ядру
+            VCLIENT_PROBE3(batch_send, done, end - done, bytes);
+            if (this->progress)
+                this->progress->sent(end - done, bytes);
+            this->exchange(frame.data(), frame.size(), &results[done], (end - done) * sizeof(int16_t));
+        }
+        else
+        {
+            if (this->tcp)
+                this->options.setCork(this->socket, true);
+
+            // Передача каждого вектора окна
+            for (size_t i = done; i < end; ++i)
+            {
+                const std::vector<int16_t> &vec = data[order ? (*order)[i] : i];
+                uint32_t vec_size = vec.size();
+                if (!this->sendAll(&vec_size, sizeof(vec_size)))
+                {
+                    this->fail("Failed to send vector size", "NetMan.calc()");
+                }
+                if (!this->sendAll(vec.data(), vec_size * sizeof(int16_t)))
+                {
+                    this->fail("Failed to send vector data", "NetMan.calc()");
+                }
+                bytes += sizeof(vec_size) + vec_size * sizeof(int16_t);
+            }
+
+            // Снятие TCP_CORK отправляет накопленное окно одним потоком сегментов
+            if (this->tcp)
+                this->options.setCork(this->socket, false);
+            VCLIENT_PROBE3(batch_send, done, end - done, bytes);
+            if (this->progress)
+                this->progress->sent(end - done, bytes);
+
+            // Получение результатов окна
+            if (!this->recvAll(&results[done], (end - done) * sizeof(int16_t)))
+            {
+                this->fail("Failed to receive result", "NetMan.calc()");
+            }
+        }
+        VCLIENT_PROBE3(batch_recv, done, end - done, (end - done) * sizeof(int16_t));
+        if (this->progress)
+            this->progress->acked(end - done, (end - done) * sizeof(int16_t));
+        auto elapsed = std::chrono::steady_clock::now() - start;
+        LatencyStats::record(LatencyStats::BATCH, elapsed);
+        std::chrono::duration<double> rtt = elapsed;
+        this->window_ctl.update(end - done, bytes + (end - done) * sizeof(int16_t), rtt.count());
+
+        if (commit)
+            commit(done, end);
+        done = end;
+    }
+}
+
+// Метод для начала потоковой передачи
+void NetMan::streamBegin(uint32_t count)
+{
+    this->arm();
+    this->codec.resetStats();
+    if (!this->compact && !this->sendAll(&count, sizeof(count)))
+        this->fail("Failed to send number of vectors", "NetMan.streamBegin()");
+}
+
+// Метод для отправки пакета векторов без ожидания результатов
+size_t NetMan::streamSend(const std::vector<std::vector<int16_t>> &batch, size_t count)
+{
+    // Таймауты устанавливает только поток отправки; поток приема использует их без изменения
+    this->arm();
+    if (this->compact)
+    {
+        this->codec.encode(batch, 0, count, this->frame);
+        if (!this->sendAll(this->frame.data(), this->frame.size()))
+            this->fail("Failed to send vector batch", "NetMan.streamSend()");
+        if (this->progress)
+            this->progress->sent(count, this->frame.size());
+        return this->frame.size();
+    }
+
+    if (FixedStride::fixedSize(batch, 0, count))
+    {
+        FixedStride::pack(batch, 0, count, this->frame);
+        if (!this->sendAll(this->frame.data(), this->frame.size()))
+            this->fail("Failed to send vector batch", "NetMan.streamSend()");
+        if (this->progress)
+            this->progress->sent(count, this->frame.size());
+        return this->frame.size();
+    }
+
+    if (this->tcp)
+        this->options.setCork(this->socket, true);
+    size_t bytes = 0;
+    for (size_t i = 0; i < count; ++i)
+    {
+        uint32_t vec_size = batch[i].size();
+        if (!this->sendAll(&vec_size, sizeof(vec_size)))
+            this->fail("Failed to send vector size", "NetMan.streamSend()");
+        if (!this->sendAll(batch[i].data(), vec_size * sizeof(int16_t)))
+            this->fail("Failed to send vector data", "NetMan.streamSend()");
+        bytes += sizeof(vec_size) + vec_size * sizeof(int16_t);
+    }
+    if (this->tcp)
+        this->options.setCork(this->socket, false);
+    if (this->progress)
+        this->progress->sent(count, bytes);
+    return bytes;
+}
+
+// Метод для получения результатов отправленного пакета
+void NetMan::streamRecv(int16_t *results, size_t count)
+{
+    if (!this->recvAll(results, count * sizeof(int16_t)))
+        this->fail("Failed to receive result", "NetMan.streamRecv()");
+    if (this->progress)
+        this->progress->acked(count, count * sizeof(int16_t));
+}
+
+// Метод для прерывания передачи из другого потока
+void NetMan::abort()
+{
+    // Заблокированные send() и recv() других потоков завершаются с ошибкой. Мьютекс не дает
+    // conn() и close() закрыть сокет между проверкой и shutdown(): иначе номер дескриптора мог бы
+    // достаться другому файлу или сокету процесса
+    std::lock_guard<std::mutex> lock(this->link_mutex);
+    if (this->socket >= 0)
+        ::shutdown(this->socket, SHUT_RDWR);
+}
+
+// Метод для передачи данных и получения результата
+std::vector<int16_t> NetMan::calc(const std::vector<std::vector<int16_t>> &data)
+{
+    std::vector<int16_t> results;
+    HugeMem::resize(results, data.size());
+    this->calc(data, results, 0, std::function<void(size_t, size_t)>());
+    return results;
+}
+
+// Метод для передачи данных с повторными попытками и сохранением прогресса
+void NetMan::calc(
+    const std::vector<std::vector<int16_t>> &data,
+    std::vector<int16_t> &results,
+    size_t first,
+    const std::function<void(size_t, size_t)> &commit)
+{
+    this->codec.resetStats();
+    if (!this->cache)
+    {
+        size_t done = first;
+        this->retryLoop(done, [&](size_t &progress)
+                        { this->session(data, results, progress, data.size(), commit); });
+        this->logSummary(results);
+        return;
+    }
+
+    // Найденные в кэше результаты записываются сразу, на сервер отправляются только промахи:
+    // сеанс выбирает их из data по списку номеров, не копируя векторы
+    this->cache->lookup(data, first, data.size(), results, this->misses);
+    if (this->progress)
+        this->progress->acked(data.size() - first - this->misses.size(), 0);
+    this->miss_results.resize(this->misses.size());
+
+    // Подтверждение окна промахов подтверждает и все попадания до следующего промаха
+    size_t committed = first;
+    auto merge = [&](size_t begin, size_t end)
+    {
+        for (size_t i = begin; i < end; ++i)
+            results[this->misses[i]] = this->miss_results[i];
+        size_t upto = end < this->misses.size() ? this->misses[end] : data.size();
+        if (commit && upto > committed)
+            commit(committed, upto);
+        committed = upto;
+    };
+    if (this->misses.empty())
+        merge(0, 0);
+    else
+    {
+        size_t done = 0;
+        this->retryLoop(done, [&](size_t &progress)
+                        { this->session(data, this->miss_results, progress, this->misses.size(), merge, &this->misses); });
+        this->cache->insert(data, this->misses, results);
+    }
+    this->logSummary(results);
+}
+
+// Метод для передачи диапазона векторов без повторных попыток
+void NetMan::calcRange(
+    const std::vector<std::vector<int16_t>> &data,
+    std::vector<int16_t> &results,
+    size_t begin,
+    size_t end)
+{
+    this->session(data, results, begin, end, std::function<void(size_t, size_t)>());
+}
+
+// Метод для передачи двоичного входного файла напрямую из файла в сокет
+void NetMan::calcFile(
+    const std::string &path,
+    const VecIndex &index,
+    std::vector<int16_t> &results,
+    size_t first,
+    const std::function<void(size_t, size_t)> &commit)
+{
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+        throw FileNotFoundError("Failed to open input file \"" + path + "\"", "NetMan.calcFile()");
+
+    // Файл читается последовательно, ядру можно читать его с опережением
+    posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+
+    // sendfile() не принимает MSG_NOSIGNAL, поэтому SIGPIPE блокируется на время передачи
+    sigset_t pipe_set, old_set;
+    sigemptyset(&pipe_set);
+    sigaddset(&pipe_set, SIGPIPE);
+    pthread_sigmask(SIG_BLOCK, &pipe_set, &old_set);
+
+    size_t done = first;
+    try
+    {
+        this->retryLoop(done, [&](size_t &progress)
+                        { this->fileSession(fd, index, results, progress, commit); });
+    }
+    catch (...)
+    {
+        ::close(fd);
+        this->restoreSigpipe(pipe_set, old_set);
+        throw;
+    }
+    ::close(fd);
+    this->restoreSigpipe(pipe_set, old_set);
+    this->logSummary(results);
+}
+
+// Метод для восстановления маски сигналов после передачи файла
+void NetMan::restoreSigpipe(const sigset_t &pipe_set, const sigset_t &old_set)
+{
+    // Сигнал SIGPIPE, возникший при разрыве соединения, снимается до восстановления маски
+    struct timespec no_wait = {0, 0};
+    while (sigtimedwait(&pipe_set, nullptr, &no_wait) > 0)
+        ;
+    pthread_sigmask(SIG_SETMASK, &old_set, nullptr);
+}
+
+// Метод для передачи двоичного входного файла в рамках одного подключения
+void NetMan::fileSession(
+    int fd,
+    const VecIndex &index,
+    std::vector<int16_t> &results,
+    size_t &done,
+    const std::function<void(size_t, size_t)> &commit)
+{
+    size_t total = index.count();
+    if (done >= total)
+        return;
+
+    // Поле количества векторов в файле совпадает с сырым протоколом только при передаче с начала,
+    // поэтому количество оставшихся векторов всегда отправляется отдельно
+    uint32_t remaining = total - done;
+    if (!this->sendAll(&remaining, sizeof(remaining)))
+        this->fail("Failed to send number of vectors", "NetMan.calcFile()");
+
+    while (done < total)
+    {
+        this->arm();
+        size_t end = this->window_ctl.next(index, done);
+        off_t offset = index.offset(done);
+        size_t bytes = index.offset(end) - offset;
+        auto start = std::chrono::steady_clock::now();
+        VCLIENT_PROBE2(batch_start, done, end - done);
+
+        // Записи окна передаются из кэша страниц в сокет без копирования в память процесса
+        if (this->tcp)
+            this->options.setCork(this->socket, true);
+        size_t left = bytes;
+        errno = 0;
+        while (left > 0)
+        {
+            ssize_t sent = sendfile(this->socket, fd, &offset, left);
+            if (sent <= 0)
+                this->fail("Failed to send vector batch", "NetMan.calcFile()");
+            left -= sent;
+        }
+        if (this->tcp)
+            this->options.setCork(this->socket, false);
+        VCLIENT_PROBE3(batch_send, done, end - done, bytes);
+        if (this->progress)
+            this->progress->sent(end - done, bytes);
+
+        if (!this->recvAll(&results[done], (end - done) * sizeof(int16_t)))
+            this->fail("Failed to receive result", "NetMan.calcFile()");
+        VCLIENT_PROBE3(batch_recv, done, end - done, (end - done) * sizeof(int16_t));
+        if (this->progress)
+            this->progress->acked(end - done, (end - done) * sizeof(int16_t));
+
+        auto elapsed = std::chrono::steady_clock::now() - start;
+        LatencyStats::record(LatencyStats::BATCH, elapsed);
+        std::chrono::duration<double> rtt = elapsed;
+        this->window_ctl.update(end - done, bytes + (end - done) * sizeof(int16_t), rtt.count());
+        if (commit)
+            commit(done, end);
+        done = end;
+    }
+}
+
+// Метод для повторения передачи с переподключением
+void NetMan::retryLoop(size_t &done, const std::function<void(size_t &)> &session)
+{
+    int attempt = 0;
+    bool connected = true;
+
+    for (;;)
+    {
+        size_t before = done;
+        try
+        {
+            if (!connected)
+            {
+                this->close();
+                this->conn();
+                this->auth(this->login, this->password);
+                connected = true;
+            }
+            session(done);
+            break;
+        }
+        catch (const BasicClientError &e)
+        {
+            // Ошибки аутентификации при переподключении также считаются временными,
+            // истечение срока и отмена - нет
+            if (!dynamic_cast<const NetworkError *>(&e) && !dynamic_cast<const AuthError *>(&e))
+                throw;
+            if (dynamic_cast<const DeadlineError *>(&e) || dynamic_cast<const CancelledError *>(&e))
+                throw;
+            if (done > before)
+                attempt = 0;
+            if (attempt >= this->retries)
+                throw;
+
+            // Экспоненциальная задержка перед переподключением
+            int delay_ms = std::min(RETRY_MAX_DELAY_MS, RETRY_BASE_DELAY_MS << attempt);
+            ++attempt;
+            VCLIENT_PROBE2(retry, attempt, done);
+            std::cout << "Log: \"NetMan.calc()\"\n";
+            std::cout << "Retry " << attempt << "/" << this->retries << " after " << delay_ms
+                      << " ms, resuming from vector " << done << ": " << e.what() << "\n";
+            // Ожидание прерывается отменой и не продолжается после срока задания
+            auto wake = std::min(std::chrono::steady_clock::now() + std::chrono::milliseconds(delay_ms), this->deadline);
+            while (!this->cancelled && std::chrono::steady_clock::now() < wake)
+                std::this_thread::sleep_for(std::chrono::milliseconds(RETRY_POLL_MS));
+            connected = false;
+        }
+    }
+}
+
+// Метод для вывода статистики передачи и результатов
+void NetMan::logSummary(const std::vector<int16_t> &results)
+{
+    if (!this->verbose)
+        return;
+
+    std::cout << "Window: " << this->window_ctl.getWindow() << " vectors (best "
+              << this->window_ctl.getBestRate() / 1e6 << " MB/s, min RTT "
+              << this->window_ctl.getMinRtt() * 1e3 << " ms)\n";
+    if (this->compact)
+    {
+        std::cout << "Wire: " << this->codec.getRawBytes() << " raw bytes sent as "
+                  << this->codec.getWireBytes() << " bytes ("
+                  << this->codec.getLz4Frames() << " lz4 frames)\n";
+    }
+
     // Логирование результата
     std::cout << "Log: \"NetMan.calc()\"\n";
     std::cout << "Results: {";
@@ -112,16 +926,14 @@ std::vector<int16_t> NetMan::calc(const std::vector<std::vector<int16_t>> &data)
         std::cout << "\b\b"; // Удалить последнюю запятую и пробел
     }
     std::cout << "}\n";
-
-    return results;
 }
 
 // Метод для закрытия соединения
 void NetMan::close()
 {
-    if (this->socket >= 0)
-    {
-        ::close(this->socket);
-        this->socket = -1;
-    }
+    this->shm.reset();
+    // Сокет закрывается деструктором транспорта
+    std::lock_guard<std::mutex> lock(this->link_mutex);
+    this->socket = -1;
+    this->link.reset();
 }
@@ -4,6 +4,22 @@
 #include <string>
 #include <vector>
 #include <cstdint>
+#include <cstddef>
+#include <functional>
+#include "wirecodec.h"
+#include "window.h"
+#include "sockopts.h"
+#include "uring.h"
+#include "shmring.h"
+#include "vecindex.h"
+#include "resultcache.h"
+#include "transport.h"
+#include "progress.h"
+#include <csignal>
+#include <memory>
+#include <atomic>
+#include <mutex>
+#include <chrono>
 
 /** 
 * @file netman.h
@@ -22,7 +38,7 @@ class NetMan
 public:
     /**
     * @brief Конструктор класса NetMan.
-    * @param address Адрес сервера.
+    * @param address Адрес сервера (IPv4 или "unix:/путь" для Unix-сокета).
     * @param port Порт сервера.
     */
     NetMan(const std::string &address, uint16_t port);
@@ -39,14 +55,168 @@ public:
     */
     uint16_t &getPort();
 
+    /**
+    * @brief Метод для задания режима кодирования данных при передаче.
+    * @details Режим "compact" согласуется с сервером после аутентификации; если сервер
+    * отклоняет его, используется режим "raw". Сервер без поддержки согласования не отвечает на запрос:
+    * через секунду ожидания подключение пересоздается в режиме "raw", и режим больше не запрашивается.
+    * @param mode Режим кодирования ("raw" или "compact").
+    */
+    void setWireMode(const std::string &mode);
+
+    /**
+    * @brief Метод для получения режима кодирования данных при передаче.
+    * @return Режим кодирования.
+    */
+    std::string &getWireMode();
+
+    /**
+    * @brief Метод для задания количества повторных попыток при сетевых ошибках.
+    * @param retries Количество попыток переподключения без прогресса (0 - без повторов).
+    */
+    void setRetries(int retries);
+
+    /**
+    * @brief Метод для задания фиксированного размера окна передачи.
+    * @param window Количество векторов в окне (0 - адаптивный подбор по RTT и скорости).
+    */
+    void setWindow(size_t window);
+
+    /**
+    * @brief Метод для получения текущего размера окна передачи.
+    * @return Количество векторов в окне.
+    */
+    size_t getWindow();
+
+    /**
+    * @brief Метод для задания параметров сокета.
+    * @param options Параметры сокета (см. SocketOptions::profile()).
+    */
+    void setOptions(const SocketOptions &options);
+
+    /**
+    * @brief Метод для получения параметров сокета.
+    * @return Параметры сокета.
+    */
+    SocketOptions &getOptions();
+
+    /**
+    * @brief Метод для выбора механизма ввода-вывода.
+    * @details В режиме "uring" отправка окна и прием его результатов передаются ядру одним
+    * вызовом io_uring_enter; если ядро не поддерживает io_uring, используются блокирующие вызовы.
+    * @param backend Механизм ввода-вывода ("blocking" или "uring").
+    */
+    void setBackend(const std::string &backend);
+
+    /**
+    * @brief Метод для проверки использования io_uring.
+    * @return true, если передача выполняется через io_uring.
+    */
+    bool usesRing();
+
+    /**
+    * @brief Метод для выбора транспорта данных.
+    * @details Транспорт "shm" согласуется с сервером после аутентификации и доступен только
+    * при подключении через Unix-сокет; если сервер его отклоняет, данные передаются через сокет.
+    * Сервер без поддержки согласования не отвечает на запрос: через секунду ожидания подключение
+    * пересоздается без общей памяти, и транспорт больше не запрашивается.
+    * @param transport Транспорт ("socket" или "shm").
+    */
+    void setTransport(const std::string &transport);
+
+    /**
+    * @brief Метод для получения запрошенного транспорта данных.
+    * @return Транспорт.
+    */
+    std::string &getTransport();
+
+    /**
+    * @brief Метод для проверки использования общей памяти.
+    * @return true, если транспорт "shm" согласован с сервером.
+    */
+    bool usesShm();
+
+    /**
+    * @brief Метод для проверки возможности передачи входного файла напрямую в сокет.
+    * @return true, если согласован сырой режим через сокет (не компактный и не общая память).
+    */
+    bool canSendFile();
+
+    /**
+    * @brief Метод для подключения кэша результатов.
+    * @details С кэшем calc() отправляет на сервер только векторы, которых нет в кэше,
+    * и добавляет в кэш их результаты; передача файла через sendfile() не используется.
+    * @param cache Кэш результатов (nullptr - без кэша). Кэш должен существовать дольше NetMan.
+    */
+    void setCache(ResultCache *cache);
+
+    /**
+    * @brief Метод для установки функции создания транспорта.
+    * @details Функция вызывается при каждом подключении вместо выбора транспорта по адресу
+    * (например, для LoopbackTransport). Без сокета io_uring, sendfile() и общая память не используются.
+    * @param connector Функция, создающая транспорт (пустая - выбор по адресу).
+    */
+    void setConnector(const std::function<Transport *()> &connector);
+
+    /**
+    * @brief Метод для подключения счетчиков хода задания.
+    * @details Окна учитываются как отправленные после передачи и как подтвержденные после приема
+    * результатов; попадания в кэш учитываются как подтвержденные сразу.
+    * @param progress Счетчики хода (nullptr - без учета). Счетчики должны существовать дольше NetMan.
+    */
+    void setProgress(Progress *progress);
+
+    /**
+    * @brief Метод для управления выводом результатов и статистики передачи в журнал.
+    * @param verbose true - выводить (по умолчанию), false - выводить только ошибки и повторы.
+    */
+    void setVerbose(bool verbose);
+
+    /**
+    * @brief Метод для установки таймаута сетевых операций.
+    * @details Ограничивает подключение (вместе с таймаутом профиля берется меньший) и каждый вызов
+    * отправки или приема, не передавший ни одного байта за это время. При таймауте io_uring не используется.
+    * @param timeout_ms Таймаут в миллисекундах (0 - без ограничения).
+    */
+    void setTimeout(int timeout_ms);
+
+    /**
+    * @brief Метод для установки срока задания.
+    * @details Срок проверяется перед каждой операцией и окном, а таймауты сокета сокращаются до оставшегося
+    * времени, поэтому блокирующие вызовы не ожидают дольше срока. Повторные попытки после срока не выполняются.
+    * @param deadline Момент истечения срока (time_point::max() - без срока).
+    */
+    void setDeadline(std::chrono::steady_clock::time_point deadline);
+
+    /**
+    * @brief Метод для отмены операций из другого потока.
+    * @details Устанавливает флаг отмены и прерывает передачу; текущая и все последующие операции
+    * этого NetMan завершаются CancelledError без повторных попыток.
+    */
+    void cancel();
+
+    /**
+    * @brief Метод для проверки отмены.
+    * @return true, если был вызван cancel().
+    */
+    bool isCancelled();
+
     /**
     * @brief Метод для установления сетевого подключения.
+    * @details Адрес вида "unix:/путь" означает Unix-сокет на том же хосте, иначе используется TCP;
+    * функция setConnector() заменяет этот выбор. К сокету применяются параметры профиля;
+    * подключение ограничено таймаутом профиля.
     * @throw NetworkError Если не удалось создать сокет, установить соединение или адрес не поддерживается.
+    * @throw TimeoutError Если соединение не установлено за отведенное время.
+    * @throw DeadlineError Если истек срок задания.
+    * @throw CancelledError Если операции отменены.
     */
     void conn();
 
     /**
     * @brief Метод для аутентификации пользователя.
+    * @details После успешной аутентификации согласуются режим кодирования данных и транспорт;
+    * если сервер не ответил на запрос расширения, подключение пересоздается без него.
     * @param username Имя пользователя.
     * @param password Пароль.
     * @throw AuthError Если не удалось отправить логин, получить соль, отправить хеш или аутентификация не удалась.
@@ -55,21 +225,287 @@ public:
 
     /**
     * @brief Метод для передачи данных и получения результата.
+    * @details В режиме "compact" векторы передаются пакетами в формате WireCodec.
     * @param data Данные для обработки.
     * @return Результаты обработки данных.
     * @throw NetworkError Если не удалось отправить или получить данные.
     */
     std::vector<int16_t> calc(const std::vector<std::vector<int16_t>> &data);
 
+    /**
+    * @brief Метод для передачи данных с повторными попытками и сохранением прогресса.
+    * @details Векторы передаются окнами, размер которых подбирается по измеренным времени
+    * оборота и скорости передачи; после получения результатов окна вызывается commit.
+    * Буферы окна сохраняются между вызовами, поэтому повторные задания с тем же буфером
+    * результатов не выделяют память на каждый вектор.
+    * При сетевой ошибке выполняется переподключение и повторная аутентификация с экспоненциальной
+    * задержкой, после чего повторно передаются только неподтвержденные векторы.
+    * С кэшем результатов отправляются только векторы, которых нет в кэше; границы commit
+    * охватывают и найденные в кэше векторы до следующего отправленного.
+    * @param data Данные для обработки.
+    * @param results Буфер результатов размером data.size().
+    * @param first Индекс первого необработанного вектора.
+    * @param commit Функция, вызываемая с границами [begin, end) подтвержденного окна.
+    * @throw NetworkError Если исчерпаны повторные попытки.
+    * @throw AuthError Если исчерпаны повторные попытки при переподключении.
+    */
+    void calc(
+        const std::vector<std::vector<int16_t>> &data,
+        std::vector<int16_t> &results,
+        size_t first,
+        const std::function<void(size_t, size_t)> &commit);
+
+    /**
+    * @brief Метод для передачи диапазона векторов по установленному подключению.
+    * @details Выполняется одна попытка без переподключения и без кэша: повторную отправку
+    * на другой сервер выполняет вызывающий (Balancer, Hedger).
+    * @param data Данные для обработки.
+    * @param results Буфер результатов размером data.size(); заполняется диапазон [begin, end).
+    * @param begin Индекс первого вектора диапазона.
+    * @param end Индекс после последнего вектора диапазона.
+    * @throw NetworkError Если не удалось отправить или получить данные.
+    */
+    void calcRange(
+        const std::vector<std::vector<int16_t>> &data,
+        std::vector<int16_t> &results,
+        size_t begin,
+        size_t end);
+
+    /**
+    * @brief Метод для передачи двоичного входного файла без чтения векторов в память процесса.
+    * @details Записи двоичного файла (размер uint32 и значения int16) совпадают с сырым протоколом,
+    * поэтому окна передаются из файла в сокет вызовом sendfile(); принимаются только результаты.
+    * Границы окон берутся из индекса смещений. Используется, только если canSendFile() возвращает true.
+    * @param path Путь к двоичному входному файлу.
+    * @param index Индекс смещений файла.
+    * @param results Буфер результатов размером index.count().
+    * @param first Индекс первого необработанного вектора.
+    * @param commit Функция, вызываемая с границами [begin, end) подтвержденного окна.
+    * @throw FileNotFoundError Если не удалось открыть входной файл.
+    * @throw NetworkError Если исчерпаны повторные попытки.
+    * @throw AuthError Если исчерпаны повторные попытки при переподключении.
+    */
+    void calcFile(
+        const std::string &path,
+        const VecIndex &index,
+        std::vector<int16_t> &results,
+        size_t first,
+        const std::function<void(size_t, size_t)> &commit);
+
+    /**
+    * @brief Метод для начала потоковой передачи, в которой отправка и прием выполняются разными потоками.
+    * @details В сыром режиме отправляет количество векторов задания. Повторные попытки в потоковой
+    * передаче не выполняются.
+    * @param count Количество векторов, которое будет отправлено.
+    * @throw NetworkError Если не удалось отправить данные.
+    */
+    void streamBegin(uint32_t count);
+
+    /**
+    * @brief Метод для отправки пакета векторов без ожидания результатов.
+    * @details Может вызываться одновременно с streamRecv() из другого потока.
+    * @param batch Буфер пакета.
+    * @param count Количество отправляемых векторов из начала буфера.
+    * @return Количество отправленных байт.
+    * @throw NetworkError Если не удалось отправить данные.
+    */
+    size_t streamSend(const std::vector<std::vector<int16_t>> &batch, size_t count);
+
+    /**
+    * @brief Метод для получения результатов ранее отправленных векторов.
+    * @param results Буфер для результатов.
+    * @param count Количество результатов.
+    * @throw NetworkError Если не удалось получить данные.
+    */
+    void streamRecv(int16_t *results, size_t count);
+
+    /**
+    * @brief Метод для прерывания передачи из другого потока.
+    * @details Сокет закрывается в обоих направлениях, поэтому ожидающие отправка и прием завершаются с ошибкой.
+    * Вызов безопасен во время conn() и close() в другом потоке: сокет прерывается, только пока он
+    * принадлежит подключению.
+    */
+    void abort();
+
     /**
     * @brief Метод для закрытия сетевого подключения.
     */
     void close();
 
 private:
-    int socket; ///< Сокет подключения.
+    std::atomic<int> socket; ///< Сокет подключения (читается cancel() из другого потока, -1 - без сокета).
+    std::unique_ptr<Transport> link; ///< Транспорт подключения.
+    std::mutex link_mutex; ///< Мьютекс замены и закрытия транспорта (abort() вызывается из другого потока).
+    std::function<Transport *()> connector; ///< Функция создания транспорта (пустая - выбор по адресу).
     std::string address; ///< Адрес сервера.
     uint16_t port; ///< Порт сервера.
+    std::string wire_mode; ///< Запрошенный режим кодирования данных.
+    bool compact; ///< Флаг согласованного компактного режима.
+    int retries; ///< Количество повторных попыток при сетевых ошибках.
+    std::string login; ///< Логин для повторной аутентификации.
+    std::string password; ///< Пароль для повторной аутентификации.
+    WindowControl window_ctl; ///< Управление размером окна передачи.
+    SocketOptions options; ///< Параметры сокета.
+    std::unique_ptr<URing> ring; ///< Кольцо io_uring (nullptr - блокирующий ввод-вывод).
+    std::string transport; ///< Запрошенный транспорт данных.
+    bool local; ///< Флаг подключения через Unix-сокет.
+    bool tcp; ///< Флаг подключения по TCP.
+    std::unique_ptr<ShmTransport> shm; ///< Кольцевые буферы в общей памяти (nullptr - передача через сокет).
+    bool verbose; ///< Флаг вывода результатов и статистики передачи в журнал.
+    WireCodec codec; ///< Кодировщик пакетов компактного режима (буферы сохраняются между заданиями).
+    std::vector<uint8_t> frame; ///< Буфер окна (сохраняется между заданиями).
+    ResultCache *cache; ///< Кэш результатов (nullptr - без кэша).
+    Progress *progress; ///< Счетчики хода задания (nullptr - без учета).
+    std::vector<int16_t> miss_results; ///< Результаты векторов, не найденных в кэше.
+    std::vector<size_t> misses; ///< Индексы векторов, не найденных в кэше.
+    int timeout_ms; ///< Таймаут сетевых операций в миллисекундах (0 - без ограничения).
+    std::chrono::steady_clock::time_point deadline; ///< Срок задания.
+    int armed_ms; ///< Таймаут, установленный сокету (0 - не установлен).
+    std::atomic<bool> cancelled; ///< Флаг отмены операций.
+    bool compact_unsupported; ///< Флаг сервера, не ответившего на запрос компактного режима.
+    bool shm_unsupported; ///< Флаг сервера, не ответившего на запрос общей памяти.
+
+    /**
+    * @brief Вспомогательный метод для проверки ограничений по времени (таймаута или срока задания).
+    * @return true, если задан таймаут или срок.
+    */
+    bool timed();
+
+    /**
+    * @brief Вспомогательный метод для проверки срока и отмены и установки таймаутов сокета.
+    * @details Таймауты приема и отправки сокета устанавливаются равными меньшему из таймаута операций
+    * и оставшегося до срока времени.
+    * @throw DeadlineError Если срок задания истек.
+    * @throw CancelledError Если операции отменены.
+    */
+    void arm();
+
+    /**
+    * @brief Вспомогательный метод для определения прерванной операции.
+    * @details Ничего не делает, если причина сбоя не связана с отменой, сроком или таймаутом.
+    * @param message Сообщение об ошибке.
+    * @param func Имя функции, в которой возникла ошибка.
+    * @param error Код ошибки errno.
+    * @throw CancelledError Если операции отменены.
+    * @throw DeadlineError Если срок задания истек.
+    * @throw TimeoutError Если истек таймаут операции.
+    */
+    void interrupt(const std::string &message, const std::string &func, int error);
+
+    /**
+    * @brief Вспомогательный метод для сообщения о сбое отправки или приема.
+    * @param message Сообщение об ошибке.
+    * @param func Имя функции, в которой возникла ошибка.
+    * @throw NetworkError Всегда; подкласс выбирается по причине сбоя (interrupt()).
+    */
+    [[noreturn]] void fail(const std::string &message, const std::string &func);
+
+    /**
+    * @brief Вспомогательный метод для отправки окна и приема его результатов.
+    * @param out Данные окна.
+    * @param out_size Размер данных окна в байтах.
+    * @param in Буфер для результатов.
+    * @param in_size Размер результатов в байтах.
+    * @throw NetworkError Если не удалось отправить или получить данные.
+    */
+    void exchange(const void *out, size_t out_size, void *in, size_t in_size);
+
+    /**
+    * @brief Вспомогательный метод для отправки всего буфера.
+    * @param buf Данные для отправки.
+    * @param size Размер данных в байтах.
+    * @return true, если все данные отправлены.
+    */
+    bool sendAll(const void *buf, size_t size);
+
+    /**
+    * @brief Вспомогательный метод для получения буфера заданного размера.
+    * @param buf Буфер для данных.
+    * @param size Размер данных в байтах.
+    * @return true, если все данные получены.
+    */
+    bool recvAll(void *buf, size_t size);
+
+    /**
+    * @brief Вспомогательный метод для ожидания ответа на запрос расширения протокола.
+    * @details Ожидание ограничено секундой и сроком задания; для транспорта без
+    * сокета ответ считается готовым.
+    * @return false, если сервер не ответил за отведенное время.
+    */
+    bool awaitReply();
+
+    /**
+    * @brief Вспомогательный метод для согласования компактного режима с сервером.
+    * @return false, если сервер не ответил на запрос (подключение рассинхронизировано).
+    * @throw NetworkError Если не удалось отправить запрос или получить ответ.
+    */
+    bool negotiate();
+
+    /**
+    * @brief Вспомогательный метод для согласования транспорта через общую память.
+    * @details Сегмент memfd передается серверу через Unix-сокет (SCM_RIGHTS) вместе с запросом.
+    * Если общая память недоступна, запрос не отправляется и данные передаются через сокет.
+    * @return false, если сервер не ответил на запрос (подключение рассинхронизировано).
+    * @throw NetworkError Если не удалось отправить запрос или получить ответ.
+    */
+    bool attachShm();
+
+    /**
+    * @brief Вспомогательный метод для передачи данных в рамках одного подключения.
+    * @param data Данные для обработки.
+    * @param results Буфер для результатов.
+    * @param done Количество подтвержденных векторов, увеличивается по мере передачи.
+    * @param last Индекс после последнего передаваемого вектора.
+    * @param commit Функция, вызываемая после подтверждения пакета.
+    * @param order Номера передаваемых векторов в data (nullptr - векторы data подряд); done, last
+    * и результаты отсчитываются по этому списку.
+    * @throw NetworkError Если не удалось отправить или получить данные.
+    */
+    void session(
+        const std::vector<std::vector<int16_t>> &data,
+        std::vector<int16_t> &results,
+        size_t &done,
+        size_t last,
+        const std::function<void(size_t, size_t)> &commit,
+        const std::vector<size_t> *order = nullptr);
+
+    /**
+    * @brief Вспомогательный метод для передачи двоичного входного файла в рамках одного подключения.
+    * @param fd Дескриптор входного файла.
+    * @param index Индекс смещений файла.
+    * @param results Буфер для результатов.
+    * @param done Количество подтвержденных векторов, увеличивается по мере передачи.
+    * @param commit Функция, вызываемая после подтверждения окна.
+    * @throw NetworkError Если не удалось отправить или получить данные.
+    */
+    void fileSession(
+        int fd,
+        const VecIndex &index,
+        std::vector<int16_t> &results,
+        size_t &done,
+        const std::function<void(size_t, size_t)> &commit);
+
+    /**
+    * @brief Вспомогательный метод для повторения передачи с переподключением и экспоненциальной задержкой.
+    * @param done Количество подтвержденных векторов.
+    * @param session Функция передачи в рамках одного подключения.
+    * @throw NetworkError Если исчерпаны повторные попытки.
+    * @throw AuthError Если исчерпаны повторные попытки при переподключении.
+    */
+    void retryLoop(size_t &done, const std::function<void(size_t &)> &session);
+
+    /**
+    * @brief Вспомогательный метод для вывода статистики передачи и результатов в журнал.
+    * @param results Результаты задания.
+    */
+    void logSummary(const std::vector<int16_t> &results);
+
+    /**
+    * @brief Вспомогательный метод для снятия ожидающего SIGPIPE и восстановления маски сигналов.
+    * @param pipe_set Множество из сигнала SIGPIPE.
+    * @param old_set Исходная маска сигналов потока.
+    */
+    static void restoreSigpipe(const sigset_t &pipe_set, const sigset_t &old_set);
 };
 
 #endif // NETWORK_MANAGER_H
@@ -0,0 +1,251 @@
+#include "pipeline.h"
+#include "latency.h"
+#include "probes.h"
+#include "affinity.h"
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <iostream>
+#include <thread>
+
+const size_t Pipeline::BATCH = 1024;
+const size_t Pipeline::DEPTH = 8;
+
+// Количество активных проверок очереди перед переходом к ожиданию со сном
+static const int SPIN_LIMIT = 64;
+
+// Конструктор
+Pipeline::Pipeline(IOMan &io_man, NetMan &net_man, size_t batch, size_t depth)
+    : io_man(io_man),
+      net_man(net_man),
+      batch(std::max<size_t>(1, batch)),
+      free_ring(depth),
+      send_ring(depth),
+      recv_ring(depth),
+      write_ring(depth),
+      aborted(false)
+{
+    // Пул не больше емкости очередей, поэтому стадия записи никогда не ждет места в очереди свободных пакетов
+    this->pool.resize(this->free_ring.capacity());
+    const char *stage_names[] = {"read", "send", "receive", "write"};
+    for (const char *name : stage_names)
+        this->stages.push_back({name, 0, 0, 0, 0.0, 0.0, 0.0, -1});
+    const char *ring_names[] = {"read->send", "send->receive", "receive->write", "write->read"};
+    for (const char *name : ring_names)
+        this->rings.push_back({name, 0, 0});
+}
+
+void Pipeline::setCpus(const std::vector<int> &cpus)
+{
+    this->cpus = cpus;
+}
+
+std::vector<StageStats> &Pipeline::getStages()
+{
+    return this->stages;
+};
+std::vector<RingStats> &Pipeline::getRings()
+{
+    return this->rings;
+};
+std::string &Pipeline::getBottleneck()
+{
+    return this->bottleneck;
+};
+
+// Метод для добавления пакета в очередь с ожиданием
+bool Pipeline::push(SpscRing<PipelineBatch *> &ring, PipelineBatch *item, StageStats &stage, RingStats &ring_stats)
+{
+    if (!ring.push(item))
+    {
+        // Очередь заполнена: следующая стадия не успевает
+        ++stage.blocked;
+        auto start = std::chrono::steady_clock::now();
+        for (int spins = 0; !ring.push(item); ++spins)
+        {
+            if (this->aborted.load(std::memory_order_relaxed))
+                return false;
+            if (spins < SPIN_LIMIT)
+                std::this_thread::yield();
+            else
+                std::this_thread::sleep_for(std::chrono::microseconds(20));
+        }
+        std::chrono::duration<double> waited = std::chrono::steady_clock::now() - start;
+        stage.blocked_time += waited.count();
+    }
+    ++ring_stats.samples;
+    ring_stats.occupied += ring.size();
+    return true;
+}
+
+// Метод для извлечения пакета из очереди с ожиданием
+bool Pipeline::pop(SpscRing<PipelineBatch *> &ring, PipelineBatch *&item, StageStats &stage)
+{
+    if (ring.pop(item))
+        return true;
+
+    // Очередь пуста: предыдущая стадия не успевает
+    ++stage.starved;
+    auto start = std::chrono::steady_clock::now();
+    for (int spins = 0; !ring.pop(item); ++spins)
+    {
+        if (this->aborted.load(std::memory_order_relaxed))
+            return false;
+        if (spins < SPIN_LIMIT)
+            std::this_thread::yield();
+        else
+            std::this_thread::sleep_for(std::chrono::microseconds(20));
+    }
+    std::chrono::duration<double> waited = std::chrono::steady_clock::now() - start;
+    stage.starved_time += waited.count();
+    return true;
+}
+
+// Метод для прерывания конвейера
+void Pipeline::fail(std::exception_ptr error)
+{
+    {
+        std::lock_guard<std::mutex> lock(this->error_mutex);
+        if (!this->error)
+            this->error = error;
+    }
+    this->aborted = true;
+    this->net_man.abort();
+}
+
+// Метод для обработки задания
+void Pipeline::run(std::vector<int16_t> &results, uint32_t first)
+{
+    uint32_t total = results.size();
+    if (first >= total)
+        return;
+
+    for (auto &item : this->pool)
+        this->free_ring.push(&item);
+
+    // Каждая стадия выполняется в своем потоке; пустой указатель обозначает конец задания
+    auto stage = [this](StageStats &stats, const std::function<void()> &body)
+    {
+        return std::thread([this, &stats, body]()
+                           {
+            stats.cpu = Affinity::pin(this->cpus, &stats - &this->stages[0]);
+            auto start = std::chrono::steady_clock::now();
+            try
+            {
+                body();
+            }
+            catch (...)
+            {
+                this->fail(std::current_exception());
+            }
+            std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+            stats.elapsed = elapsed.count(); });
+    };
+
+    std::vector<std::thread> threads;
+    threads.push_back(stage(this->stages[0], [this, first, total]()
+                            {
+        StageStats &stats = this->stages[0];
+        PipelineBatch *item = nullptr;
+        for (uint32_t next = first; next < total; next += item->count)
+        {
+            if (!this->pop(this->free_ring, item, stats))
+                return;
+            item->count = std::min<size_t>(this->batch, total - next);
+            item->first = next;
+            this->io_man.readBatch(item->vectors, item->count);
+            ++stats.batches;
+            if (!this->push(this->send_ring, item, stats, this->rings[0]))
+                return;
+        }
+        this->push(this->send_ring, nullptr, stats, this->rings[0]); }));
+
+    threads.push_back(stage(this->stages[1], [this, first, total]()
+                            {
+        StageStats &stats = this->stages[1];
+        this->net_man.streamBegin(total - first);
+        PipelineBatch *item = nullptr;
+        while (this->pop(this->send_ring, item, stats) && item)
+        {
+            item->sent = std::chrono::steady_clock::now();
+            VCLIENT_PROBE2(batch_start, item->first, item->count);
+            size_t bytes = this->net_man.streamSend(item->vectors, item->count);
+            VCLIENT_PROBE3(batch_send, item->first, item->count, bytes);
+            ++stats.batches;
+            if (!this->push(this->recv_ring, item, stats, this->rings[1]))
+                return;
+        }
+        if (!item)
+            this->push(this->recv_ring, nullptr, stats, this->rings[1]); }));
+
+    threads.push_back(stage(this->stages[2], [this, &results]()
+                            {
+        StageStats &stats = this->stages[2];
+        PipelineBatch *item = nullptr;
+        while (this->pop(this->recv_ring, item, stats) && item)
+        {
+            this->net_man.streamRecv(&results[item->first], item->count);
+            VCLIENT_PROBE3(batch_recv, item->first, item->count, item->count * sizeof(int16_t));
+            LatencyStats::record(LatencyStats::BATCH, std::chrono::steady_clock::now() - item->sent);
+            ++stats.batches;
+            if (!this->push(this->write_ring, item, stats, this->rings[2]))
+                return;
+        }
+        if (!item)
+            this->push(this->write_ring, nullptr, stats, this->rings[2]); }));
+
+    threads.push_back(stage(this->stages[3], [this, &results]()
+                            {
+        StageStats &stats = this->stages[3];
+        PipelineBatch *item = nullptr;
+        while (this->pop(this->write_ring, item, stats) && item)
+        {
+            this->io_man.writePart(results, item->first, item->first + item->count);
+            ++stats.batches;
+            this->push(this->free_ring, item, stats, this->rings[3]);
+        } }));
+
+    for (auto &thread : threads)
+        thread.join();
+
+    // Самая загруженная стадия - с наибольшей долей времени без ожидания очередей
+    double busiest = -1.0;
+    for (const auto &stats : this->stages)
+    {
+        double busy = stats.elapsed - stats.starved_time - stats.blocked_time;
+        double share = stats.elapsed > 0.0 ? busy / stats.elapsed : 0.0;
+        if (share > busiest)
+        {
+            busiest = share;
+            this->bottleneck = stats.name;
+        }
+    }
+    this->report();
+
+    if (this->error)
+        std::rethrow_exception(this->error);
+}
+
+// Метод для вывода счетчиков стадий и очередей
+void Pipeline::report()
+{
+    std::cout << "Log: \"Pipeline.run()\"\n";
+    for (const auto &stats : this->stages)
+    {
+        double busy = stats.elapsed - stats.starved_time - stats.blocked_time;
+        std::cout << "Stage " << stats.name << ": " << stats.batches << " batches, busy "
+                  << (stats.elapsed > 0.0 ? 100.0 * busy / stats.elapsed : 0.0) << "%, starved "
+                  << stats.starved << " times (" << stats.starved_time << " s), blocked "
+                  << stats.blocked << " times (" << stats.blocked_time << " s)";
+        if (stats.cpu >= 0)
+            std::cout << ", cpu " << stats.cpu << " (node " << Affinity::node(stats.cpu) << ")";
+        std::cout << "\n";
+    }
+    for (const auto &ring : this->rings)
+    {
+        std::cout << "Ring " << ring.name << ": average occupancy "
+                  << (ring.samples ? double(ring.occupied) / ring.samples : 0.0) << "/"
+                  << this->free_ring.capacity() << "\n";
+    }
+    std::cout << "Bottleneck: " << this->bottleneck << "\n";
+}
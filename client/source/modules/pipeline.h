@@ -0,0 +1,170 @@
+#ifndef PIPELINE_H
+#define PIPELINE_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <exception>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "ioman.h"
+#include "netman.h"
+#include "spscring.h"
+
+/**
+* @file pipeline.h
+* @brief Определение класса конвейерной обработки задания.
+* @details Этот файл содержит определения методов для обработки задания четырьмя потоками:
+* разбор входного файла, отправка векторов, прием результатов и запись выходного файла.
+* Стадии соединены ограниченными очередями без блокировок, поэтому диск, сеть и разбор
+* выполняются одновременно.
+* @date 19.10.2026
+* @version 1.0
+* @authorsa Ягольницкий Р. С.
+*/
+
+/**
+* @brief Пакет векторов, передаваемый между стадиями конвейера.
+*/
+struct PipelineBatch
+{
+    std::vector<std::vector<int16_t>> vectors; ///< Векторы пакета (переиспользуются между пакетами).
+    size_t count; ///< Количество векторов пакета.
+    uint32_t first; ///< Индекс первого вектора пакета в задании.
+    std::chrono::steady_clock::time_point sent; ///< Время начала отправки пакета.
+};
+
+/**
+* @brief Счетчики стадии конвейера.
+*/
+struct StageStats
+{
+    std::string name; ///< Название стадии.
+    uint64_t batches; ///< Количество обработанных пакетов.
+    uint64_t starved; ///< Количество ожиданий пустой входной очереди.
+    uint64_t blocked; ///< Количество ожиданий заполненной выходной очереди.
+    double starved_time; ///< Время ожидания входной очереди в секундах.
+    double blocked_time; ///< Время ожидания выходной очереди в секундах.
+    double elapsed; ///< Время работы стадии в секундах.
+    int cpu; ///< Процессор, к которому привязан поток стадии (-1 - без привязки).
+};
+
+/**
+* @brief Счетчики очереди между стадиями.
+*/
+struct RingStats
+{
+    std::string name; ///< Название очереди.
+    uint64_t samples; ///< Количество замеров заполненности.
+    uint64_t occupied; ///< Сумма замеров заполненности.
+};
+
+/**
+* @brief Класс для конвейерной обработки задания.
+* @details Пакеты берутся из фиксированного пула и проходят по кругу: разбор -> отправка ->
+* прием -> запись -> разбор. Когда пул исчерпан, стадия разбора ждет освобождения пакета, так что
+* количество векторов в пути ограничено. Результаты записываются через IOMan::writePart(), поэтому
+* прерванное задание продолжается с контрольной точки. Повторные попытки при сетевых ошибках не выполняются.
+*/
+class Pipeline
+{
+public:
+    static const size_t BATCH; ///< Количество векторов в пакете по умолчанию.
+    static const size_t DEPTH; ///< Количество пакетов в пуле по умолчанию.
+
+    /**
+    * @brief Конструктор класса Pipeline.
+    * @param io_man Менеджер ввода-вывода с открытым через openStream() входным файлом
+    * и выходным файлом, подготовленным через resume().
+    * @param net_man Менеджер сетевого взаимодействия с установленным и аутентифицированным подключением.
+    * @param batch Количество векторов в пакете.
+    * @param depth Количество пакетов в пуле (округляется до степени двойки).
+    */
+    Pipeline(IOMan &io_man, NetMan &net_man, size_t batch = BATCH, size_t depth = DEPTH);
+
+    /**
+    * @brief Метод для обработки задания.
+    * @param results Буфер результатов размером, равным количеству векторов задания.
+    * @param first Индекс первого необработанного вектора (с него открыт входной файл).
+    * @throw NetworkError Если не удалось отправить или получить данные.
+    * @throw InvalidDataFormatError Если входной файл поврежден.
+    * @throw FileNotFoundError Если не удалось записать результаты.
+    */
+    void run(std::vector<int16_t> &results, uint32_t first);
+
+    /**
+    * @brief Метод для установки процессоров потоков стадий.
+    * @details Стадии разбора, отправки, приема и записи привязываются к процессорам списка по кругу.
+    * Пакеты заполняются потоком разбора, поэтому их буферы размещаются на узле NUMA его процессора.
+    * @param cpus Список процессоров (пустой список - без привязки).
+    */
+    void setCpus(const std::vector<int> &cpus);
+
+    /**
+    * @brief Метод для получения счетчиков стадий.
+    * @return Счетчики стадий в порядке разбор, отправка, прием, запись.
+    */
+    std::vector<StageStats> &getStages();
+
+    /**
+    * @brief Метод для получения счетчиков очередей.
+    * @return Счетчики очередей в порядке следования пакетов.
+    */
+    std::vector<RingStats> &getRings();
+
+    /**
+    * @brief Метод для получения названия самой загруженной стадии.
+    * @return Название стадии с наибольшей долей времени работы без ожидания очередей.
+    */
+    std::string &getBottleneck();
+
+private:
+    IOMan &io_man; ///< Менеджер ввода-вывода.
+    NetMan &net_man; ///< Менеджер сетевого взаимодействия.
+    size_t batch; ///< Количество векторов в пакете.
+    std::vector<int> cpus; ///< Процессоры потоков стадий.
+    std::vector<PipelineBatch> pool; ///< Пул пакетов.
+    SpscRing<PipelineBatch *> free_ring; ///< Свободные пакеты (запись -> разбор).
+    SpscRing<PipelineBatch *> send_ring; ///< Прочитанные пакеты (разбор -> отправка).
+    SpscRing<PipelineBatch *> recv_ring; ///< Отправленные пакеты (отправка -> прием).
+    SpscRing<PipelineBatch *> write_ring; ///< Пакеты с результатами (прием -> запись).
+    std::vector<StageStats> stages; ///< Счетчики стадий.
+    std::vector<RingStats> rings; ///< Счетчики очередей.
+    std::string bottleneck; ///< Самая загруженная стадия.
+    std::atomic<bool> aborted; ///< Флаг прерывания после ошибки одной из стадий.
+    std::exception_ptr error; ///< Первая ошибка стадии.
+    std::mutex error_mutex; ///< Мьютекс для первой ошибки.
+
+    /**
+    * @brief Вспомогательный метод для добавления пакета в очередь с ожиданием свободного места.
+    * @param ring Очередь.
+    * @param item Пакет (nullptr - признак конца задания).
+    * @param stage Счетчики стадии-писателя.
+    * @param ring_stats Счетчики очереди.
+    * @return false, если конвейер прерван.
+    */
+    bool push(SpscRing<PipelineBatch *> &ring, PipelineBatch *item, StageStats &stage, RingStats &ring_stats);
+
+    /**
+    * @brief Вспомогательный метод для извлечения пакета из очереди с ожиданием.
+    * @param ring Очередь.
+    * @param item Буфер для пакета.
+    * @param stage Счетчики стадии-читателя.
+    * @return false, если конвейер прерван.
+    */
+    bool pop(SpscRing<PipelineBatch *> &ring, PipelineBatch *&item, StageStats &stage);
+
+    /**
+    * @brief Вспомогательный метод для прерывания конвейера после ошибки стадии.
+    * @param error Ошибка стадии.
+    */
+    void fail(std::exception_ptr error);
+
+    /**
+    * @brief Вспомогательный метод для вывода счетчиков стадий и очередей.
+    */
+    void report();
+};
+
+#endif // PIPELINE_H
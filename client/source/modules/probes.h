@@ -0,0 +1,70 @@
+#ifndef PROBES_H
+#define PROBES_H
+
+/**
+* @file probes.h
+* @brief Статические точки трассировки (USDT) клиента.
+* @details Этот файл содержит макросы точек трассировки провайдера vclient для bpftrace, perf и SystemTap.
+* Точка трассировки компилируется в одну инструкцию nop и запись в секции .note.stapsdt; пока к ней
+* не подключен трассировщик, ее стоимость - вычисление аргументов, уже находящихся в регистрах.
+* Если заголовок <sys/sdt.h> (пакет systemtap-sdt-dev) недоступен или задан -DVCLIENT_NO_PROBES,
+* макросы раскрываются в пустые операторы.
+*
+* Точки трассировки:
+* - connect_start(port), connect_end(error) - установка соединения (error - код errno, 0 - успех);
+* - auth_start(), auth_end(ok) - аутентификация (ok - 1 при успехе);
+* - hash_start(bytes), hash_end(bytes) - вычисление хеша пароля в CryptMan;
+* - batch_start(first, count) - начало передачи окна или пакета векторов;
+* - batch_send(first, count, bytes) - окно передано в сокет (bytes - байты запроса);
+* - batch_recv(first, count, bytes) - получены результаты окна;
+* - retry(attempt, done) - переподключение после сетевой ошибки;
+* - read_start(first), read_end(first, count, bytes) - чтение векторов из входного файла;
+* - write_start(first, count), write_end(first, count, bytes) - запись результатов.
+*
+* Индексы векторов отсчитываются от начала задания, bytes - размер данных в формате протокола.
+* Примеры сценариев bpftrace находятся в каталоге client/trace.
+* Цель make probes-check проверяет, что с -DVCLIENT_NO_PROBES точки не попадают в объектные файлы
+* и что сценарии используют только объявленные точки.
+* @date 19.10.2026
+* @version 1.0
+* @authorsa Ягольницкий Р. С.
+*/
+
+#if defined(__has_include) && !defined(VCLIENT_NO_PROBES)
+#if __has_include(<sys/sdt.h>)
+#include <sys/sdt.h>
+#define VCLIENT_HAVE_PROBES 1
+#endif
+#endif
+
+#ifdef VCLIENT_HAVE_PROBES
+#define VCLIENT_PROBE0(name) DTRACE_PROBE(vclient, name)
+#define VCLIENT_PROBE1(name, a) DTRACE_PROBE1(vclient, name, a)
+#define VCLIENT_PROBE2(name, a, b) DTRACE_PROBE2(vclient, name, a, b)
+#define VCLIENT_PROBE3(name, a, b, c) DTRACE_PROBE3(vclient, name, a, b, c)
+#else
+#define VCLIENT_PROBE0(name) \
+    do                       \
+    {                        \
+    } while (0)
+#define VCLIENT_PROBE1(name, a) \
+    do                          \
+    {                           \
+        (void)(a);              \
+    } while (0)
+#define VCLIENT_PROBE2(name, a, b) \
+    do                             \
+    {                              \
+        (void)(a);                 \
+        (void)(b);                 \
+    } while (0)
+#define VCLIENT_PROBE3(name, a, b, c) \
+    do                                \
+    {                                 \
+        (void)(a);                    \
+        (void)(b);                    \
+        (void)(c);                    \
+    } while (0)
+#endif
+
+#endif // PROBES_H
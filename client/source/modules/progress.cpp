@@ -0,0 +1,151 @@
+#include "progress.h"
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+// Конструктор
+Progress::Progress(double interval, const std::string &path)
+    : interval(interval), path(path), total(0), sent_vectors(0), sent_bytes(0), acked_vectors(0),
+      received_bytes(0), started(std::chrono::steady_clock::now()), last_time(started), last_bytes(0),
+      last_acked(0), running(false) {}
+
+// Деструктор
+Progress::~Progress()
+{
+    if (this->running)
+        this->stop(false);
+}
+
+void Progress::setTotal(uint64_t total)
+{
+    this->total.store(total, std::memory_order_relaxed);
+};
+
+// Метод для запуска потока таймера
+void Progress::start()
+{
+    if (this->running)
+        return;
+    this->started = std::chrono::steady_clock::now();
+    this->last_time = this->started;
+    this->running = true;
+    this->timer = std::thread(&Progress::work, this);
+}
+
+// Метод для остановки потока таймера
+void Progress::stop(bool finished)
+{
+    {
+        std::lock_guard<std::mutex> lock(this->mutex);
+        if (!this->running)
+            return;
+        this->running = false;
+    }
+    this->cv.notify_all();
+    this->timer.join();
+    this->emit(finished ? "done" : "failed");
+}
+
+// Метод потока таймера
+void Progress::work()
+{
+    auto period = std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+        std::chrono::duration<double>(this->interval));
+    std::unique_lock<std::mutex> lock(this->mutex);
+    auto next = this->started + period;
+    while (!this->cv.wait_until(lock, next, [this]()
+                                { return !this->running; }))
+    {
+        lock.unlock();
+        this->emit("running");
+        lock.lock();
+        next += period;
+    }
+}
+
+// Метод для получения снимка счетчиков
+ProgressSample Progress::sample()
+{
+    ProgressSample sample;
+    sample.total = this->total.load(std::memory_order_relaxed);
+    sample.sent = this->sent_vectors.load(std::memory_order_relaxed);
+    sample.acked = this->acked_vectors.load(std::memory_order_relaxed);
+    sample.bytes_sent = this->sent_bytes.load(std::memory_order_relaxed);
+    sample.bytes_received = this->received_bytes.load(std::memory_order_relaxed);
+
+    auto now = std::chrono::steady_clock::now();
+    sample.elapsed = std::chrono::duration<double>(now - this->started).count();
+    double dt = std::chrono::duration<double>(now - this->last_time).count();
+    uint64_t bytes = sample.bytes_sent + sample.bytes_received;
+    sample.mb_per_s = dt > 0 ? (bytes - this->last_bytes) / dt / 1e6 : 0.0;
+    sample.vectors_per_s = dt > 0 ? (sample.acked - this->last_acked) / dt : 0.0;
+    this->last_time = now;
+    this->last_bytes = bytes;
+    this->last_acked = sample.acked;
+
+    // Оставшееся время оценивается по средней скорости: она меньше колеблется между интервалами
+    sample.eta = -1.0;
+    if (sample.total > 0 && sample.acked > 0 && sample.elapsed > 0)
+    {
+        uint64_t left = sample.acked < sample.total ? sample.total - sample.acked : 0;
+        sample.eta = left / (sample.acked / sample.elapsed);
+    }
+    return sample;
+}
+
+// Метод для вывода снимка одной строкой
+void Progress::line(std::ostream &out, const ProgressSample &sample)
+{
+    out << "Progress: " << sample.acked;
+    if (sample.total > 0)
+        out << "/" << sample.total << " vectors ("
+            << 100.0 * std::min(sample.acked, sample.total) / sample.total << "%)";
+    else
+        out << " vectors";
+    out << ", " << sample.sent << " sent, " << (sample.bytes_sent + sample.bytes_received) / 1e6 << " MB, "
+        << sample.mb_per_s << " MB/s, " << sample.vectors_per_s << " vectors/s";
+    if (sample.eta >= 0)
+        out << ", ETA " << sample.eta << " s";
+    out << "\n";
+}
+
+// Метод для вывода снимка строками "ключ=значение"
+void Progress::status(std::ostream &out, const ProgressSample &sample, const std::string &state)
+{
+    out << "state=" << state << "\n"
+        << "total=" << sample.total << "\n"
+        << "sent=" << sample.sent << "\n"
+        << "acked=" << sample.acked << "\n"
+        << "bytes_sent=" << sample.bytes_sent << "\n"
+        << "bytes_received=" << sample.bytes_received << "\n"
+        << "elapsed_s=" << sample.elapsed << "\n"
+        << "mb_per_s=" << sample.mb_per_s << "\n"
+        << "vectors_per_s=" << sample.vectors_per_s << "\n"
+        << "eta_s=" << sample.eta << "\n";
+}
+
+// Метод для вывода снимка в stderr или файл состояния
+void Progress::emit(const std::string &state)
+{
+    ProgressSample sample = this->sample();
+    if (this->path.empty())
+    {
+        // Строка собирается заранее, чтобы вывод других потоков не разрывал ее
+        std::ostringstream text;
+        line(text, sample);
+        std::cerr << text.str() << std::flush;
+        return;
+    }
+
+    // Ошибка записи файла состояния не прерывает задание: следующий интервал перезапишет файл
+    std::string temp = this->path + ".tmp";
+    {
+        std::ofstream file(temp, std::ios::trunc);
+        status(file, sample, state);
+        if (!file)
+            return;
+    }
+    std::rename(temp.c_str(), this->path.c_str());
+}
@@ -0,0 +1,153 @@
+#ifndef PROGRESS_H
+#define PROGRESS_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <thread>
+
+/**
+* @file progress.h
+* @brief Определение класса вывода хода длительных заданий.
+* @details Этот файл содержит счетчики отправленных и подтвержденных векторов, которые увеличиваются
+* в циклах передачи, и поток таймера, который периодически считывает их и выводит ход задания,
+* текущую скорость и оставшееся время в stderr или в файл состояния.
+* @date 19.10.2026
+* @version 1.0
+* @authorsa Ягольницкий Р. С.
+*/
+
+/**
+* @brief Снимок счетчиков хода задания.
+*/
+struct ProgressSample
+{
+    uint64_t total; ///< Количество векторов задания (0 - неизвестно).
+    uint64_t sent; ///< Количество отправленных векторов (с повторными отправками).
+    uint64_t acked; ///< Количество векторов, результаты которых получены.
+    uint64_t bytes_sent; ///< Количество отправленных байт.
+    uint64_t bytes_received; ///< Количество принятых байт.
+    double elapsed; ///< Время от начала задания в секундах.
+    double mb_per_s; ///< Скорость передачи за последний интервал в МБ/с (отправка и прием).
+    double vectors_per_s; ///< Скорость подтверждения векторов за последний интервал.
+    double eta; ///< Оставшееся время в секундах по средней скорости (-1 - неизвестно).
+};
+
+/**
+* @brief Класс вывода хода длительных заданий.
+* @details Подключения увеличивают счетчики методами sent() и acked() с упорядочением relaxed:
+* циклы передачи не форматируют вывод и не захватывают мьютексы. Поток таймера раз в интервал
+* считывает счетчики и выводит строку в stderr или перезаписывает файл состояния строками
+* "ключ=значение" (через временный файл и rename(), поэтому читатель не увидит файл частично).
+* При дублировании пакетов обе копии учитываются как отправленные и подтвержденные.
+*/
+class Progress
+{
+public:
+    /**
+    * @brief Конструктор класса Progress.
+    * @param interval Интервал вывода в секундах.
+    * @param path Путь к файлу состояния (пустая строка - вывод в stderr).
+    */
+    Progress(double interval, const std::string &path = "");
+
+    /**
+    * @brief Деструктор класса Progress. Останавливает поток таймера.
+    */
+    ~Progress();
+
+    /**
+    * @brief Метод для установки количества векторов задания.
+    * @param total Количество векторов (0 - неизвестно, процент и оставшееся время не выводятся).
+    */
+    void setTotal(uint64_t total);
+
+    /**
+    * @brief Метод для учета отправленных векторов.
+    * @param vectors Количество векторов.
+    * @param bytes Количество байт.
+    */
+    void sent(uint64_t vectors, uint64_t bytes)
+    {
+        this->sent_vectors.fetch_add(vectors, std::memory_order_relaxed);
+        this->sent_bytes.fetch_add(bytes, std::memory_order_relaxed);
+    }
+
+    /**
+    * @brief Метод для учета векторов, результаты которых получены.
+    * @param vectors Количество векторов.
+    * @param bytes Количество принятых байт.
+    */
+    void acked(uint64_t vectors, uint64_t bytes)
+    {
+        this->acked_vectors.fetch_add(vectors, std::memory_order_relaxed);
+        this->received_bytes.fetch_add(bytes, std::memory_order_relaxed);
+    }
+
+    /**
+    * @brief Метод для запуска потока таймера.
+    */
+    void start();
+
+    /**
+    * @brief Метод для остановки потока таймера и вывода итогового состояния.
+    * @param finished true - задание завершено успешно, false - с ошибкой.
+    */
+    void stop(bool finished = true);
+
+    /**
+    * @brief Метод для получения снимка счетчиков.
+    * @details Скорость вычисляется по изменению счетчиков с предыдущего снимка.
+    * @return Снимок счетчиков.
+    */
+    ProgressSample sample();
+
+    /**
+    * @brief Статический метод для вывода снимка одной строкой.
+    * @param out Поток вывода.
+    * @param sample Снимок счетчиков.
+    */
+    static void line(std::ostream &out, const ProgressSample &sample);
+
+    /**
+    * @brief Статический метод для вывода снимка строками "ключ=значение".
+    * @param out Поток вывода.
+    * @param sample Снимок счетчиков.
+    * @param state Состояние задания ("running", "done" или "failed").
+    */
+    static void status(std::ostream &out, const ProgressSample &sample, const std::string &state);
+
+private:
+    double interval; ///< Интервал вывода в секундах.
+    std::string path; ///< Путь к файлу состояния (пустая строка - stderr).
+    std::atomic<uint64_t> total; ///< Количество векторов задания.
+    std::atomic<uint64_t> sent_vectors; ///< Количество отправленных векторов.
+    std::atomic<uint64_t> sent_bytes; ///< Количество отправленных байт.
+    std::atomic<uint64_t> acked_vectors; ///< Количество подтвержденных векторов.
+    std::atomic<uint64_t> received_bytes; ///< Количество принятых байт.
+    std::chrono::steady_clock::time_point started; ///< Время начала задания.
+    std::chrono::steady_clock::time_point last_time; ///< Время предыдущего снимка.
+    uint64_t last_bytes; ///< Переданные байты на момент предыдущего снимка.
+    uint64_t last_acked; ///< Подтвержденные векторы на момент предыдущего снимка.
+    bool running; ///< Флаг работы потока таймера.
+    std::thread timer; ///< Поток таймера.
+    std::mutex mutex; ///< Мьютекс остановки.
+    std::condition_variable cv; ///< Условная переменная остановки.
+
+    /**
+    * @brief Метод потока таймера.
+    */
+    void work();
+
+    /**
+    * @brief Вспомогательный метод для вывода снимка в stderr или файл состояния.
+    * @param state Состояние задания.
+    */
+    void emit(const std::string &state);
+};
+
+#endif // PROGRESS_H
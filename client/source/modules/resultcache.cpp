@@ -0,0 +1,203 @@
+#include "resultcache.h"
+#include "errors.h"
+#include <cstring>
+#include <fstream>
+
+const size_t ResultCache::MAX_ENTRIES = size_t(1) << 24;
+
+// Сигнатура файла кэша ("VRC1")
+static const uint32_t CACHE_MAGIC = 0x31435256;
+// Размер записи файла: ключ и результат без выравнивания
+static const size_t RECORD_SIZE = 2 * sizeof(uint64_t) + sizeof(int16_t);
+// Тип элементов векторов, входящий в ключ
+static const uint64_t TYPE_INT16 = 1;
+
+// Константы перемешивания (как в xxHash64 и MurmurHash3)
+static const uint64_t PRIME1 = 0x9E3779B185EBCA87ULL;
+static const uint64_t PRIME2 = 0xC2B2AE3D27D4EB4FULL;
+
+static inline uint64_t rotl(uint64_t x, int r)
+{
+    return (x << r) | (x >> (64 - r));
+}
+
+static inline uint64_t fmix(uint64_t x)
+{
+    x ^= x >> 33;
+    x *= 0xFF51AFD7ED558CCDULL;
+    x ^= x >> 33;
+    x *= 0xC4CEB9FE1A85EC53ULL;
+    x ^= x >> 33;
+    return x;
+}
+
+// Конструктор
+ResultCache::ResultCache(const std::string &path, size_t max_entries)
+    : path(path),
+      max_entries(max_entries),
+      hits(0),
+      misses(0),
+      loaded(0)
+{
+    if (!this->path.empty())
+        this->load();
+}
+
+uint64_t &ResultCache::getHits()
+{
+    return this->hits;
+};
+uint64_t &ResultCache::getMisses()
+{
+    return this->misses;
+};
+size_t ResultCache::size()
+{
+    std::lock_guard<std::mutex> lock(this->mutex);
+    return this->entries.size();
+};
+
+// Метод для вычисления ключа вектора
+CacheKey ResultCache::key(const std::vector<int16_t> &vec)
+{
+    // Две независимые полосы по 64 бита обрабатывают содержимое словами по 8 байт;
+    // длина входит в начальное состояние, поэтому дополнение нулями не дает совпадений
+    const unsigned char *bytes = reinterpret_cast<const unsigned char *>(vec.data());
+    size_t size = vec.size() * sizeof(int16_t);
+    uint64_t h1 = PRIME1 ^ (TYPE_INT16 << 56) ^ vec.size();
+    uint64_t h2 = PRIME2 ^ (TYPE_INT16 << 48) ^ (uint64_t(vec.size()) << 8);
+
+    size_t pos = 0;
+    for (; pos + sizeof(uint64_t) <= size; pos += sizeof(uint64_t))
+    {
+        uint64_t word;
+        std::memcpy(&word, bytes + pos, sizeof(word));
+        h1 = rotl(h1 ^ (word * PRIME2), 31) * PRIME1;
+        h2 = rotl(h2 ^ (word * PRIME1), 29) * PRIME2 + h1;
+    }
+    if (pos < size)
+    {
+        uint64_t word = 0;
+        std::memcpy(&word, bytes + pos, size - pos);
+        h1 = rotl(h1 ^ (word * PRIME2), 31) * PRIME1;
+        h2 = rotl(h2 ^ (word * PRIME1), 29) * PRIME2 + h1;
+    }
+
+    CacheKey key;
+    key.lo = fmix(h1 ^ rotl(h2, 17));
+    key.hi = fmix(h2 + key.lo);
+    return key;
+}
+
+// Метод для поиска результатов диапазона векторов
+void ResultCache::lookup(
+    const std::vector<std::vector<int16_t>> &data,
+    size_t begin,
+    size_t end,
+    std::vector<int16_t> &results,
+    std::vector<size_t> &misses)
+{
+    // Ключи вычисляются без блокировки, под мьютексом выполняется только поиск
+    std::vector<CacheKey> keys(end - begin);
+    for (size_t i = begin; i < end; ++i)
+        keys[i - begin] = ResultCache::key(data[i]);
+
+    misses.clear();
+    std::lock_guard<std::mutex> lock(this->mutex);
+    for (size_t i = begin; i < end; ++i)
+    {
+        auto it = this->entries.find(keys[i - begin]);
+        if (it != this->entries.end())
+            results[i] = it->second;
+        else
+            misses.push_back(i);
+    }
+    this->hits += (end - begin) - misses.size();
+    this->misses += misses.size();
+}
+
+// Метод для добавления результатов векторов
+void ResultCache::insert(
+    const std::vector<std::vector<int16_t>> &data,
+    const std::vector<size_t> &indices,
+    const std::vector<int16_t> &results)
+{
+    std::vector<CacheKey> keys(indices.size());
+    for (size_t i = 0; i < indices.size(); ++i)
+        keys[i] = ResultCache::key(data[indices[i]]);
+
+    std::lock_guard<std::mutex> lock(this->mutex);
+    for (size_t i = 0; i < indices.size() && this->entries.size() < this->max_entries; ++i)
+    {
+        // Повторы внутри одного задания добавляются один раз
+        if (this->entries.emplace(keys[i], results[indices[i]]).second && !this->path.empty())
+            this->pending.push_back(std::make_pair(keys[i], results[indices[i]]));
+    }
+}
+
+// Метод для загрузки записей из файла
+void ResultCache::load()
+{
+    std::ifstream file(this->path, std::ios::binary);
+    if (!file.is_open())
+        return;
+
+    uint32_t magic = 0;
+    file.read(reinterpret_cast<char *>(&magic), sizeof(magic));
+    if (!file)
+        return;
+    if (magic != CACHE_MAGIC)
+        throw InvalidDataFormatError("Not a result cache file: " + this->path, "ResultCache.load()");
+
+    char record[RECORD_SIZE];
+    while (this->entries.size() < this->max_entries && file.read(record, RECORD_SIZE))
+    {
+        CacheKey key;
+        int16_t result;
+        std::memcpy(&key.lo, record, sizeof(key.lo));
+        std::memcpy(&key.hi, record + sizeof(key.lo), sizeof(key.hi));
+        std::memcpy(&result, record + 2 * sizeof(uint64_t), sizeof(result));
+        this->entries[key] = result;
+    }
+    this->loaded = this->entries.size();
+}
+
+// Метод для дописывания новых записей в файл кэша
+void ResultCache::save()
+{
+    std::lock_guard<std::mutex> lock(this->mutex);
+    if (this->path.empty() || this->pending.empty())
+        return;
+
+    // Записи только дописываются, поэтому прерванное сохранение теряет лишь последнюю запись
+    std::ofstream file(this->path, std::ios::binary | std::ios::app);
+    if (file.is_open() && file.tellp() == 0)
+        file.write(reinterpret_cast<const char *>(&CACHE_MAGIC), sizeof(CACHE_MAGIC));
+
+    std::vector<char> buffer(this->pending.size() * RECORD_SIZE);
+    char *out = buffer.data();
+    for (const auto &entry : this->pending)
+    {
+        std::memcpy(out, &entry.first.lo, sizeof(entry.first.lo));
+        std::memcpy(out + sizeof(uint64_t), &entry.first.hi, sizeof(entry.first.hi));
+        std::memcpy(out + 2 * sizeof(uint64_t), &entry.second, sizeof(entry.second));
+        out += RECORD_SIZE;
+    }
+    file.write(buffer.data(), buffer.size());
+    file.flush();
+    if (!file)
+        throw FileNotFoundError("Failed to write result cache \"" + this->path + "\"", "ResultCache.save()");
+    this->pending.clear();
+}
+
+// Метод для вывода счетчиков попаданий и промахов
+void ResultCache::report(std::ostream &out)
+{
+    std::lock_guard<std::mutex> lock(this->mutex);
+    uint64_t total = this->hits + this->misses;
+    out << "Log: \"ResultCache.report()\"\n";
+    out << "Cache: " << this->hits << " hits, " << this->misses << " misses ("
+        << (total ? 100.0 * this->hits / total : 0.0) << "% hit rate), "
+        << this->entries.size() << " entries (" << this->loaded << " loaded, "
+        << this->entries.size() - this->loaded << " new)\n";
+}
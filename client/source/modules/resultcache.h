@@ -0,0 +1,149 @@
+#ifndef RESULT_CACHE_H
+#define RESULT_CACHE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/**
+* @file resultcache.h
+* @brief Определение класса кэша результатов по содержимому векторов.
+* @details Этот файл содержит кэш, который сопоставляет содержимому вектора результат сервера.
+* Результат зависит только от значений вектора, поэтому повторно отправленные векторы
+* обрабатываются локально, а на сервер передаются только промахи.
+* @date 19.10.2026
+* @version 1.0
+* @authorsa Ягольницкий Р. С.
+*/
+
+/**
+* @brief Ключ кэша - 128-битный хеш типа элементов, длины и содержимого вектора.
+*/
+struct CacheKey
+{
+    uint64_t lo; ///< Младшая половина хеша.
+    uint64_t hi; ///< Старшая половина хеша.
+
+    bool operator==(const CacheKey &other) const
+    {
+        return this->lo == other.lo && this->hi == other.hi;
+    }
+};
+
+/**
+* @brief Функция хеширования ключа для unordered_map.
+*/
+struct CacheKeyHash
+{
+    size_t operator()(const CacheKey &key) const
+    {
+        return key.lo;
+    }
+};
+
+/**
+* @brief Класс кэша результатов по содержимому векторов.
+* @details Записи хранятся в памяти; если задан файл, они загружаются из него при создании,
+* а новые записи дописываются в конец файла методом save(). Файл состоит из сигнатуры "VRC1"
+* и записей по 18 байт (ключ и результат); неполная последняя запись после сбоя пропускается.
+* Количество записей в памяти ограничено: после заполнения новые результаты не кэшируются.
+* Методы потокобезопасны, поэтому один кэш используется всеми подключениями пакетного режима.
+*/
+class ResultCache
+{
+public:
+    static const size_t MAX_ENTRIES; ///< Ограничение количества записей по умолчанию.
+
+    /**
+    * @brief Конструктор класса ResultCache.
+    * @param path Путь к файлу кэша (пустая строка - только в памяти).
+    * @param max_entries Наибольшее количество записей в памяти.
+    * @throw InvalidDataFormatError Если файл существует, но не является файлом кэша.
+    */
+    explicit ResultCache(const std::string &path = "", size_t max_entries = MAX_ENTRIES);
+
+    /**
+    * @brief Статический метод для вычисления ключа вектора.
+    * @param vec Вектор.
+    * @return Ключ кэша.
+    */
+    static CacheKey key(const std::vector<int16_t> &vec);
+
+    /**
+    * @brief Метод для поиска результатов диапазона векторов.
+    * @param data Векторы.
+    * @param begin Индекс первого вектора диапазона.
+    * @param end Индекс после последнего вектора диапазона.
+    * @param results Буфер результатов; для найденных векторов результат записывается на их место.
+    * @param misses Индексы ненайденных векторов по возрастанию (заменяются).
+    */
+    void lookup(
+        const std::vector<std::vector<int16_t>> &data,
+        size_t begin,
+        size_t end,
+        std::vector<int16_t> &results,
+        std::vector<size_t> &misses);
+
+    /**
+    * @brief Метод для добавления результатов векторов.
+    * @param data Векторы.
+    * @param indices Индексы добавляемых векторов.
+    * @param results Буфер результатов, индексированный так же, как data.
+    */
+    void insert(
+        const std::vector<std::vector<int16_t>> &data,
+        const std::vector<size_t> &indices,
+        const std::vector<int16_t> &results);
+
+    /**
+    * @brief Метод для дописывания новых записей в файл кэша.
+    * @throw FileNotFoundError Если не удалось записать файл.
+    */
+    void save();
+
+    /**
+    * @brief Метод для вывода счетчиков попаданий и промахов.
+    * @param out Поток вывода.
+    */
+    void report(std::ostream &out);
+
+    /**
+    * @brief Метод для получения количества попаданий.
+    * @return Количество векторов, результат которых найден в кэше.
+    */
+    uint64_t &getHits();
+
+    /**
+    * @brief Метод для получения количества промахов.
+    * @return Количество векторов, отправленных на сервер.
+    */
+    uint64_t &getMisses();
+
+    /**
+    * @brief Метод для получения количества записей в памяти.
+    * @return Количество записей.
+    */
+    size_t size();
+
+private:
+    std::string path; ///< Путь к файлу кэша.
+    size_t max_entries; ///< Наибольшее количество записей в памяти.
+    std::unordered_map<CacheKey, int16_t, CacheKeyHash> entries; ///< Записи в памяти.
+    std::vector<std::pair<CacheKey, int16_t>> pending; ///< Записи, еще не сохраненные в файл.
+    uint64_t hits; ///< Количество попаданий.
+    uint64_t misses; ///< Количество промахов.
+    uint64_t loaded; ///< Количество записей, загруженных из файла.
+    std::mutex mutex; ///< Мьютекс записей и счетчиков.
+
+    /**
+    * @brief Вспомогательный метод для загрузки записей из файла.
+    * @throw InvalidDataFormatError Если файл не является файлом кэша.
+    */
+    void load();
+};
+
+#endif // RESULT_CACHE_H
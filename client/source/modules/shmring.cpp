@@ -0,0 +1,244 @@
+#include "shmring.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <new>
+#include <poll.h>
+#include <sched.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+
+const uint32_t ShmTransport::MAGIC = 0x524D4853;
+const size_t ShmTransport::CAPACITY = 1 << 20;
+
+// Количество активных попыток перед уступкой процессора и перед проверкой собеседника
+static const unsigned SPIN_LIMIT = 1000;
+static const unsigned YIELD_LIMIT = 2000;
+
+// Конструктор
+ShmRing::ShmRing(ShmRingHeader *header, char *data, size_t capacity)
+    : header(header), data(data), capacity(capacity) {}
+
+// Метод для записи данных без ожидания
+size_t ShmRing::write(const void *buf, size_t size)
+{
+    uint64_t tail = this->header->tail.load(std::memory_order_relaxed);
+    uint64_t head = this->header->head.load(std::memory_order_acquire);
+    size = std::min<size_t>(size, this->capacity - (tail - head));
+    if (size == 0)
+        return 0;
+
+    // Запись может переходить через конец области данных
+    size_t pos = tail & (this->capacity - 1);
+    size_t first = std::min(size, this->capacity - pos);
+    std::memcpy(this->data + pos, buf, first);
+    std::memcpy(this->data, static_cast<const char *>(buf) + first, size - first);
+    this->header->tail.store(tail + size, std::memory_order_release);
+    return size;
+}
+
+// Метод для чтения данных без ожидания
+size_t ShmRing::read(void *buf, size_t size)
+{
+    uint64_t head = this->header->head.load(std::memory_order_relaxed);
+    uint64_t tail = this->header->tail.load(std::memory_order_acquire);
+    size = std::min<size_t>(size, tail - head);
+    if (size == 0)
+        return 0;
+
+    size_t pos = head & (this->capacity - 1);
+    size_t first = std::min(size, this->capacity - pos);
+    std::memcpy(buf, this->data + pos, first);
+    std::memcpy(static_cast<char *>(buf) + first, this->data, size - first);
+    this->header->head.store(head + size, std::memory_order_release);
+    return size;
+}
+
+// Конструктор
+ShmTransport::ShmTransport(int memfd, size_t capacity, bool server)
+    : fd(memfd), capacity(capacity), base(MAP_FAILED), length(0), tx(nullptr), rx(nullptr),
+      timeout_ms(0), deadline(std::chrono::steady_clock::time_point::max())
+{
+    // Сегмент: два заголовка, затем области данных двух буферов
+    this->length = 2 * sizeof(ShmRingHeader) + 2 * capacity;
+    bool created = this->fd < 0;
+    if (created)
+    {
+        this->fd = memfd_create("vclient-ring", MFD_CLOEXEC);
+        if (this->fd < 0 || ftruncate(this->fd, this->length) < 0)
+            return;
+    }
+
+    this->base = mmap(nullptr, this->length, PROT_READ | PROT_WRITE, MAP_SHARED, this->fd, 0);
+    if (this->base == MAP_FAILED)
+        return;
+
+    char *mem = static_cast<char *>(this->base);
+    ShmRingHeader *up = reinterpret_cast<ShmRingHeader *>(mem);
+    ShmRingHeader *down = up + 1;
+    if (created)
+    {
+        new (up) ShmRingHeader();
+        new (down) ShmRingHeader();
+        up->head.store(0);
+        up->tail.store(0);
+        down->head.store(0);
+        down->tail.store(0);
+    }
+    char *up_data = mem + 2 * sizeof(ShmRingHeader);
+    char *down_data = up_data + capacity;
+
+    // Клиент пишет в буфер "up" и читает из "down", сервер - наоборот
+    ShmRing *up_ring = new ShmRing(up, up_data, capacity);
+    ShmRing *down_ring = new ShmRing(down, down_data, capacity);
+    this->tx = server ? down_ring : up_ring;
+    this->rx = server ? up_ring : down_ring;
+}
+
+// Деструктор
+ShmTransport::~ShmTransport()
+{
+    delete this->tx;
+    delete this->rx;
+    if (this->base != MAP_FAILED)
+        munmap(this->base, this->length);
+    if (this->fd >= 0)
+        ::close(this->fd);
+}
+
+bool ShmTransport::ready() const
+{
+    return this->base != MAP_FAILED;
+}
+
+int ShmTransport::getFd() const
+{
+    return this->fd;
+}
+
+void ShmTransport::setLimits(int timeout_ms, std::chrono::steady_clock::time_point deadline)
+{
+    this->timeout_ms = timeout_ms;
+    this->deadline = deadline;
+}
+
+// Метод ожидания с проверкой состояния собеседника
+bool ShmTransport::backoff(unsigned &spins, int sock, std::chrono::steady_clock::time_point &idle_since) const
+{
+    ++spins;
+    if (spins < SPIN_LIMIT)
+        return true;
+    if (spins < YIELD_LIMIT)
+    {
+        sched_yield();
+        return true;
+    }
+
+    // Долгое ожидание: проверяем, не закрыт ли сокет собеседника, и засыпаем ненадолго
+    struct pollfd pfd = {sock, POLLRDHUP, 0};
+    if (poll(&pfd, 1, 0) > 0 && (pfd.revents & (POLLRDHUP | POLLHUP | POLLERR)))
+        return false;
+
+    // Зависший собеседник не закрывает сокет, поэтому ожидание ограничено таймаутом и сроком
+    auto now = std::chrono::steady_clock::now();
+    if (spins == YIELD_LIMIT)
+        idle_since = now;
+    if (now >= this->deadline ||
+        (this->timeout_ms > 0 && now - idle_since >= std::chrono::milliseconds(this->timeout_ms)))
+    {
+        errno = ETIMEDOUT;
+        return false;
+    }
+    usleep(50);
+    return true;
+}
+
+// Метод для отправки всего буфера
+bool ShmTransport::sendAll(const void *buf, size_t size, int sock)
+{
+    const char *pos = static_cast<const char *>(buf);
+    unsigned spins = 0;
+    std::chrono::steady_clock::time_point idle_since;
+    while (size > 0)
+    {
+        size_t written = this->tx->write(pos, size);
+        if (written == 0)
+        {
+            if (!this->backoff(spins, sock, idle_since))
+                return false;
+            continue;
+        }
+        spins = 0;
+        pos += written;
+        size -= written;
+    }
+    return true;
+}
+
+// Метод для получения буфера заданного размера
+bool ShmTransport::recvAll(void *buf, size_t size, int sock)
+{
+    char *pos = static_cast<char *>(buf);
+    unsigned spins = 0;
+    std::chrono::steady_clock::time_point idle_since;
+    while (size > 0)
+    {
+        size_t received = this->rx->read(pos, size);
+        if (received == 0)
+        {
+            if (!this->backoff(spins, sock, idle_since))
+                return false;
+            continue;
+        }
+        spins = 0;
+        pos += received;
+        size -= received;
+    }
+    return true;
+}
+
+// Метод для передачи дескриптора через Unix-сокет
+bool ShmTransport::sendFd(int sock, const void *buf, size_t size, int fd)
+{
+    struct iovec iov = {const_cast<void *>(buf), size};
+    char control[CMSG_SPACE(sizeof(int))];
+    std::memset(control, 0, sizeof(control));
+
+    struct msghdr msg;
+    std::memset(&msg, 0, sizeof(msg));
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+    msg.msg_control = control;
+    msg.msg_controllen = sizeof(control);
+
+    struct cmsghdr *cmsg = CMSG_FIRSTHDR(&msg);
+    cmsg->cmsg_level = SOL_SOCKET;
+    cmsg->cmsg_type = SCM_RIGHTS;
+    cmsg->cmsg_len = CMSG_LEN(sizeof(int));
+    std::memcpy(CMSG_DATA(cmsg), &fd, sizeof(int));
+
+    return sendmsg(sock, &msg, MSG_NOSIGNAL) == static_cast<ssize_t>(size);
+}
+
+// Метод для получения дескриптора из Unix-сокета
+int ShmTransport::recvFd(int sock, void *buf, size_t size)
+{
+    struct iovec iov = {buf, size};
+    char control[CMSG_SPACE(sizeof(int))];
+    struct msghdr msg;
+    std::memset(&msg, 0, sizeof(msg));
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+    msg.msg_control = control;
+    msg.msg_controllen = sizeof(control);
+
+    if (recvmsg(sock, &msg, MSG_WAITALL) != static_cast<ssize_t>(size))
+        return -1;
+    struct cmsghdr *cmsg = CMSG_FIRSTHDR(&msg);
+    if (cmsg == nullptr || cmsg->cmsg_type != SCM_RIGHTS)
+        return -1;
+    int fd;
+    std::memcpy(&fd, CMSG_DATA(cmsg), sizeof(int));
+    return fd;
+}
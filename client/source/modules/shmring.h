@@ -0,0 +1,171 @@
+#ifndef SHM_RING_H
+#define SHM_RING_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstddef>
+
+/**
+* @file shmring.h
+* @brief Определение классов для передачи данных через кольцевые буферы в общей памяти.
+* @details Этот файл содержит определения кольцевого буфера с одним писателем и одним читателем
+* и транспорта из двух таких буферов в сегменте memfd, который передается серверу на том же хосте
+* через Unix-сокет.
+* @date 19.10.2026
+* @version 1.0
+* @authorsa Ягольницкий Р. С.
+*/
+
+/**
+* @brief Заголовок кольцевого буфера в общей памяти.
+* @details Счетчики разнесены по разным строкам кэша, чтобы писатель и читатель не мешали друг другу.
+*/
+struct ShmRingHeader
+{
+    std::atomic<uint64_t> head; ///< Количество прочитанных байт.
+    char pad_head[56]; ///< Выравнивание до строки кэша.
+    std::atomic<uint64_t> tail; ///< Количество записанных байт.
+    char pad_tail[56]; ///< Выравнивание до строки кэша.
+};
+
+/**
+* @brief Кольцевой байтовый буфер с одним писателем и одним читателем.
+*/
+class ShmRing
+{
+public:
+    /**
+    * @brief Конструктор класса ShmRing.
+    * @param header Заголовок буфера в общей памяти.
+    * @param data Область данных буфера.
+    * @param capacity Размер области данных (степень двойки).
+    */
+    ShmRing(ShmRingHeader *header, char *data, size_t capacity);
+
+    /**
+    * @brief Метод для записи данных без ожидания.
+    * @param buf Данные.
+    * @param size Размер данных.
+    * @return Количество записанных байт.
+    */
+    size_t write(const void *buf, size_t size);
+
+    /**
+    * @brief Метод для чтения данных без ожидания.
+    * @param buf Буфер.
+    * @param size Размер буфера.
+    * @return Количество прочитанных байт.
+    */
+    size_t read(void *buf, size_t size);
+
+private:
+    ShmRingHeader *header; ///< Заголовок буфера.
+    char *data; ///< Область данных.
+    size_t capacity; ///< Размер области данных.
+};
+
+/**
+* @brief Транспорт из двух кольцевых буферов в сегменте общей памяти.
+* @details Один буфер передает данные от клиента серверу, другой - в обратном направлении.
+* Пока данных или места нет, сторона ожидает активно и периодически проверяет, что Unix-сокет
+* собеседника не закрыт, а также не истекли таймаут и срок, заданные setLimits().
+*/
+class ShmTransport
+{
+public:
+    static const uint32_t MAGIC; ///< Сигнатура запроса транспорта через общую память ("SHMR").
+    static const size_t CAPACITY; ///< Размер каждого кольцевого буфера по умолчанию.
+
+    /**
+    * @brief Конструктор класса ShmTransport.
+    * @param memfd Дескриптор сегмента общей памяти (-1 - создать новый сегмент).
+    * @param capacity Размер каждого кольцевого буфера в байтах (степень двойки).
+    * @param server Сторона сервера (буферы используются в обратном направлении).
+    */
+    ShmTransport(int memfd, size_t capacity, bool server);
+
+    /**
+    * @brief Деструктор класса ShmTransport. Освобождает сегмент.
+    */
+    ~ShmTransport();
+
+    /**
+    * @brief Метод для проверки готовности транспорта.
+    * @return true, если сегмент создан и отображен.
+    */
+    bool ready() const;
+
+    /**
+    * @brief Метод для получения дескриптора сегмента общей памяти.
+    * @return Дескриптор сегмента.
+    */
+    int getFd() const;
+
+    /**
+    * @brief Метод для задания ограничений ожидания.
+    * @details Сокет в режиме общей памяти не читается, поэтому таймауты сокета к ожиданию
+    * буферов неприменимы; ограничения проверяются при долгом ожидании.
+    * @param timeout_ms Наибольшее время без передачи данных в миллисекундах (0 - без таймаута).
+    * @param deadline Срок операции (time_point::max() - без срока).
+    */
+    void setLimits(int timeout_ms, std::chrono::steady_clock::time_point deadline);
+
+    /**
+    * @brief Метод для отправки всего буфера.
+    * @param buf Данные.
+    * @param size Размер данных.
+    * @param sock Unix-сокет для проверки состояния собеседника.
+    * @return false, если собеседник отключился или истекло время ожидания (errno = ETIMEDOUT).
+    */
+    bool sendAll(const void *buf, size_t size, int sock);
+
+    /**
+    * @brief Метод для получения буфера заданного размера.
+    * @param buf Буфер.
+    * @param size Размер данных.
+    * @param sock Unix-сокет для проверки состояния собеседника.
+    * @return false, если собеседник отключился или истекло время ожидания (errno = ETIMEDOUT).
+    */
+    bool recvAll(void *buf, size_t size, int sock);
+
+    /**
+    * @brief Статический метод для передачи дескриптора через Unix-сокет вместе с данными.
+    * @param sock Unix-сокет.
+    * @param buf Данные.
+    * @param size Размер данных.
+    * @param fd Передаваемый дескриптор.
+    * @return true при успехе.
+    */
+    static bool sendFd(int sock, const void *buf, size_t size, int fd);
+
+    /**
+    * @brief Статический метод для получения дескриптора из Unix-сокета вместе с данными.
+    * @param sock Unix-сокет.
+    * @param buf Буфер для данных.
+    * @param size Размер данных.
+    * @return Полученный дескриптор или -1.
+    */
+    static int recvFd(int sock, void *buf, size_t size);
+
+private:
+    int fd; ///< Дескриптор сегмента общей памяти.
+    size_t capacity; ///< Размер каждого кольцевого буфера.
+    void *base; ///< Отображение сегмента.
+    size_t length; ///< Размер отображения.
+    ShmRing *tx; ///< Буфер исходящих данных.
+    ShmRing *rx; ///< Буфер входящих данных.
+    int timeout_ms; ///< Наибольшее время без передачи данных (0 - без таймаута).
+    std::chrono::steady_clock::time_point deadline; ///< Срок операции.
+
+    /**
+    * @brief Вспомогательный метод ожидания с проверкой состояния собеседника.
+    * @param spins Количество неудачных попыток подряд.
+    * @param sock Unix-сокет собеседника.
+    * @param idle_since Начало долгого ожидания (задается при первом засыпании).
+    * @return false, если собеседник отключился или истекло время ожидания (errno = ETIMEDOUT).
+    */
+    bool backoff(unsigned &spins, int sock, std::chrono::steady_clock::time_point &idle_since) const;
+};
+
+#endif // SHM_RING_H
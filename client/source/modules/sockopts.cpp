@@ -0,0 +1,104 @@
+#include "sockopts.h"
+#include <cerrno>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+
+// Конструктор
+SocketOptions::SocketOptions()
+    : nodelay(false),
+      cork(false),
+      sndbuf(0),
+      rcvbuf(0),
+      busy_poll(0),
+      connect_timeout_ms(0) {}
+
+// Метод для получения профиля параметров
+SocketOptions SocketOptions::profile(const std::string &name)
+{
+    SocketOptions options;
+    if (name == "latency")
+    {
+        options.nodelay = true;
+        options.busy_poll = 50;
+        options.connect_timeout_ms = 3000;
+    }
+    else if (name == "throughput")
+    {
+        options.cork = true;
+        options.sndbuf = 4 << 20;
+        options.rcvbuf = 4 << 20;
+        options.connect_timeout_ms = 10000;
+    }
+    else if (name != "default")
+    {
+        throw ArgsDecodeError(
+            "Unknown network profile: " + name,
+            "SocketOptions.profile()");
+    }
+    return options;
+}
+
+// Метод для применения параметров к сокету
+std::string SocketOptions::apply(int fd, bool tcp) const
+{
+    // Ошибки необязательных параметров (например, SO_BUSY_POLL без CAP_NET_ADMIN) не прерывают работу
+    std::string failed;
+    int one = 1;
+    if (tcp && this->nodelay && setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one)) < 0)
+        failed += " TCP_NODELAY";
+    if (this->sndbuf > 0 && setsockopt(fd, SOL_SOCKET, SO_SNDBUF, &this->sndbuf, sizeof(this->sndbuf)) < 0)
+        failed += " SO_SNDBUF";
+    if (this->rcvbuf > 0 && setsockopt(fd, SOL_SOCKET, SO_RCVBUF, &this->rcvbuf, sizeof(this->rcvbuf)) < 0)
+        failed += " SO_RCVBUF";
+#ifdef SO_BUSY_POLL
+    if (tcp && this->busy_poll > 0 && setsockopt(fd, SOL_SOCKET, SO_BUSY_POLL, &this->busy_poll, sizeof(this->busy_poll)) < 0)
+        failed += " SO_BUSY_POLL";
+#endif
+    return failed;
+}
+
+// Метод для подключения сокета с таймаутом
+int SocketOptions::connect(int fd, const struct sockaddr *addr, socklen_t addr_len, int timeout_ms) const
+{
+    if (timeout_ms < 0)
+        timeout_ms = this->connect_timeout_ms;
+    if (timeout_ms <= 0)
+        return ::connect(fd, addr, addr_len) < 0 ? errno : 0;
+
+    // Неблокирующее подключение с ожиданием готовности сокета к записи
+    int flags = fcntl(fd, F_GETFL, 0);
+    fcntl(fd, F_SETFL, flags | O_NONBLOCK);
+    int error = 0;
+    if (::connect(fd, addr, addr_len) < 0)
+    {
+        error = errno;
+        if (error == EINPROGRESS)
+        {
+            struct pollfd pfd = {fd, POLLOUT, 0};
+            int ready = poll(&pfd, 1, timeout_ms);
+            if (ready == 0)
+                error = ETIMEDOUT;
+            else if (ready < 0)
+                error = errno;
+            else
+            {
+                socklen_t len = sizeof(error);
+                getsockopt(fd, SOL_SOCKET, SO_ERROR, &error, &len);
+            }
+        }
+    }
+    fcntl(fd, F_SETFL, flags);
+    return error;
+}
+
+// Метод для управления накоплением данных
+void SocketOptions::setCork(int fd, bool on) const
+{
+    if (!this->cork)
+        return;
+    int value = on ? 1 : 0;
+    setsockopt(fd, IPPROTO_TCP, TCP_CORK, &value, sizeof(value));
+}
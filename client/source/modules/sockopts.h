@@ -0,0 +1,74 @@
+#ifndef SOCKET_OPTIONS_H
+#define SOCKET_OPTIONS_H
+
+#include <string>
+#include <sys/socket.h>
+#include "errors.h"
+
+/**
+* @file sockopts.h
+* @brief Определение класса для настройки параметров сокета.
+* @details Этот файл содержит определения профилей параметров сокета (задержка или пропускная
+* способность) и методов для их применения к сокету, включая подключение с таймаутом.
+* @date 19.10.2026
+* @version 1.0
+* @authorsa Ягольницкий Р. С.
+*/
+
+/**
+* @brief Класс для хранения и применения параметров сокета.
+*/
+class SocketOptions
+{
+public:
+    bool nodelay; ///< Отключение алгоритма Нейгла (TCP_NODELAY).
+    bool cork; ///< Накопление окна перед отправкой (TCP_CORK).
+    int sndbuf; ///< Размер буфера отправки в байтах (0 - по умолчанию).
+    int rcvbuf; ///< Размер буфера приема в байтах (0 - по умолчанию).
+    int busy_poll; ///< Время активного ожидания при приеме в микросекундах (0 - отключено).
+    int connect_timeout_ms; ///< Таймаут подключения в миллисекундах (0 - без ограничения).
+
+    /**
+    * @brief Конструктор класса SocketOptions (параметры системы по умолчанию).
+    */
+    SocketOptions();
+
+    /**
+    * @brief Статический метод для получения профиля параметров.
+    * @details "latency": TCP_NODELAY и SO_BUSY_POLL для коротких заданий;
+    * "throughput": TCP_CORK на время отправки окна и увеличенные буферы для больших заданий;
+    * "default": параметры системы.
+    * @param name Имя профиля.
+    * @return Параметры профиля.
+    * @throw ArgsDecodeError Если профиль неизвестен.
+    */
+    static SocketOptions profile(const std::string &name);
+
+    /**
+    * @brief Метод для применения параметров к сокету до подключения.
+    * @param fd Сокет.
+    * @param tcp Сокет TCP (для Unix-сокета параметры TCP не применяются).
+    * @return Список параметров, которые не удалось применить (пустая строка при успехе).
+    */
+    std::string apply(int fd, bool tcp = true) const;
+
+    /**
+    * @brief Метод для подключения сокета с таймаутом.
+    * @param fd Сокет.
+    * @param addr Адрес сервера.
+    * @param addr_len Размер структуры адреса.
+    * @param timeout_ms Таймаут в миллисекундах (отрицательное значение - таймаут профиля, 0 - без ограничения).
+    * @return 0 при успехе, иначе код ошибки errno (ETIMEDOUT при истечении таймаута).
+    */
+    int connect(int fd, const struct sockaddr *addr, socklen_t addr_len, int timeout_ms = -1) const;
+
+    /**
+    * @brief Метод для включения или отключения накопления данных (TCP_CORK).
+    * @details Не выполняет действий, если профиль не использует TCP_CORK.
+    * @param fd Сокет.
+    * @param on Включить накопление.
+    */
+    void setCork(int fd, bool on) const;
+};
+
+#endif // SOCKET_OPTIONS_H
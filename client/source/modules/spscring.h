@@ -0,0 +1,108 @@
+#ifndef SPSC_RING_H
+#define SPSC_RING_H
+
+#include <atomic>
+#include <vector>
+#include <cstddef>
+
+/**
+* @file spscring.h
+* @brief Определение шаблона очереди с одним писателем и одним читателем между потоками.
+* @details Этот файл содержит ограниченную очередь без блокировок, которой соединяются стадии
+* конвейера обработки. Писатель и читатель изменяют только свой счетчик, поэтому операции
+* не требуют мьютексов и атомарных операций чтения-модификации-записи.
+* @date 19.10.2026
+* @version 1.0
+* @authorsa Ягольницкий Р. С.
+*/
+
+/**
+* @brief Ограниченная очередь без блокировок с одним писателем и одним читателем.
+* @details Счетчики разнесены по разным строкам кэша, как в ShmRingHeader. Каждая сторона
+* хранит копию чужого счетчика и перечитывает его, только когда очередь кажется полной или пустой.
+* @tparam T Тип элемента (копируемый).
+*/
+template <typename T>
+class SpscRing
+{
+public:
+    /**
+    * @brief Конструктор класса SpscRing.
+    * @param capacity Емкость очереди (округляется вверх до степени двойки).
+    */
+    explicit SpscRing(size_t capacity)
+        : head(0), cached_tail(0), tail(0), cached_head(0)
+    {
+        size_t size = 1;
+        while (size < capacity)
+            size <<= 1;
+        this->slots.resize(size);
+        this->mask = size - 1;
+    }
+
+    /**
+    * @brief Метод для добавления элемента без ожидания (вызывается только писателем).
+    * @param item Элемент.
+    * @return false, если очередь заполнена.
+    */
+    bool push(const T &item)
+    {
+        size_t pos = this->tail.load(std::memory_order_relaxed);
+        if (pos - this->cached_head > this->mask)
+        {
+            this->cached_head = this->head.load(std::memory_order_acquire);
+            if (pos - this->cached_head > this->mask)
+                return false;
+        }
+        this->slots[pos & this->mask] = item;
+        this->tail.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+    * @brief Метод для извлечения элемента без ожидания (вызывается только читателем).
+    * @param item Буфер для элемента.
+    * @return false, если очередь пуста.
+    */
+    bool pop(T &item)
+    {
+        size_t pos = this->head.load(std::memory_order_relaxed);
+        if (pos == this->cached_tail)
+        {
+            this->cached_tail = this->tail.load(std::memory_order_acquire);
+            if (pos == this->cached_tail)
+                return false;
+        }
+        item = this->slots[pos & this->mask];
+        this->head.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+    * @brief Метод для получения текущего количества элементов (приблизительного для третьего потока).
+    * @return Количество элементов в очереди.
+    */
+    size_t size() const
+    {
+        return this->tail.load(std::memory_order_acquire) - this->head.load(std::memory_order_acquire);
+    }
+
+    /**
+    * @brief Метод для получения емкости очереди.
+    * @return Емкость очереди.
+    */
+    size_t capacity() const
+    {
+        return this->mask + 1;
+    }
+
+private:
+    std::vector<T> slots; ///< Ячейки очереди.
+    size_t mask; ///< Маска индекса ячейки (емкость - 1).
+    alignas(64) std::atomic<size_t> head; ///< Количество извлеченных элементов (изменяет читатель).
+    size_t cached_tail; ///< Копия счетчика писателя у читателя.
+    alignas(64) std::atomic<size_t> tail; ///< Количество добавленных элементов (изменяет писатель).
+    size_t cached_head; ///< Копия счетчика читателя у писателя.
+};
+
+#endif // SPSC_RING_H
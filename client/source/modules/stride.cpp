@@ -0,0 +1,151 @@
+#include "stride.h"
+#include <algorithm>
+#include <cstring>
+
+const uint32_t FixedStride::MIN_SIZE;
+const uint32_t FixedStride::MAX_SIZE;
+
+// Сериализация векторов размера N в записи "размер, значения"
+template <uint32_t N>
+static void packFixed(const std::vector<std::vector<int16_t>> &data, size_t begin, size_t end, const size_t *order,
+                      uint8_t *out)
+{
+    const uint32_t size = N;
+    for (size_t i = begin; i < end; ++i)
+    {
+        std::memcpy(out, &size, sizeof(size));
+        std::memcpy(out + sizeof(size), data[order ? order[i] : i].data(), N * sizeof(int16_t));
+        out += sizeof(size) + N * sizeof(int16_t);
+    }
+}
+
+// Разбор записей с векторами размера N
+template <uint32_t N>
+static bool unpackFixed(const uint8_t *records, size_t count, std::vector<std::vector<int16_t>> &data, size_t first)
+{
+    for (size_t i = 0; i < count; ++i)
+    {
+        uint32_t size;
+        std::memcpy(&size, records, sizeof(size));
+        if (size != N)
+            return false;
+        std::vector<int16_t> &vec = data[first + i];
+        vec.resize(N);
+        std::memcpy(vec.data(), records + sizeof(size), N * sizeof(int16_t));
+        records += sizeof(size) + N * sizeof(int16_t);
+    }
+    return true;
+}
+
+// Сумма N значений с насыщением после каждого сложения
+template <uint32_t N>
+static int16_t sumFixed(const uint8_t *values)
+{
+    int16_t buf[N];
+    std::memcpy(buf, values, sizeof(buf));
+    int32_t sum = 0;
+    for (uint32_t i = 0; i < N; ++i)
+        sum = std::max(-32768, std::min(32767, sum + buf[i]));
+    return static_cast<int16_t>(sum);
+}
+
+typedef void (*PackFn)(const std::vector<std::vector<int16_t>> &, size_t, size_t, const size_t *, uint8_t *);
+typedef bool (*UnpackFn)(const uint8_t *, size_t, std::vector<std::vector<int16_t>> &, size_t);
+typedef int16_t (*SumFn)(const uint8_t *);
+
+// Экземпляры шаблонов для размеров от MIN_SIZE до MAX_SIZE
+static const PackFn PACK_FIXED[] = {
+    packFixed<2>, packFixed<3>, packFixed<4>, packFixed<5>, packFixed<6>, packFixed<7>, packFixed<8>, packFixed<9>,
+    packFixed<10>, packFixed<11>, packFixed<12>, packFixed<13>, packFixed<14>, packFixed<15>, packFixed<16>};
+static const UnpackFn UNPACK_FIXED[] = {
+    unpackFixed<2>, unpackFixed<3>, unpackFixed<4>, unpackFixed<5>, unpackFixed<6>, unpackFixed<7>,
+    unpackFixed<8>, unpackFixed<9>, unpackFixed<10>, unpackFixed<11>, unpackFixed<12>, unpackFixed<13>,
+    unpackFixed<14>, unpackFixed<15>, unpackFixed<16>};
+static const SumFn SUM_FIXED[] = {
+    sumFixed<2>, sumFixed<3>, sumFixed<4>, sumFixed<5>, sumFixed<6>, sumFixed<7>, sumFixed<8>, sumFixed<9>,
+    sumFixed<10>, sumFixed<11>, sumFixed<12>, sumFixed<13>, sumFixed<14>, sumFixed<15>, sumFixed<16>};
+
+// Метод для определения специализированного размера диапазона векторов
+uint32_t FixedStride::fixedSize(const std::vector<std::vector<int16_t>> &data, size_t begin, size_t end,
+                                const std::vector<size_t> *order)
+{
+    if (begin >= end)
+        return 0;
+    const size_t *ids = order ? order->data() : nullptr;
+    size_t size = data[ids ? ids[begin] : begin].size();
+    if (size < MIN_SIZE || size > MAX_SIZE)
+        return 0;
+    for (size_t i = begin + 1; i < end; ++i)
+    {
+        if (data[ids ? ids[i] : i].size() != size)
+            return 0;
+    }
+    return static_cast<uint32_t>(size);
+}
+
+// Метод для сериализации векторов в сыром формате протокола
+void FixedStride::pack(const std::vector<std::vector<int16_t>> &data, size_t begin, size_t end, std::vector<uint8_t> &frame,
+                       const std::vector<size_t> *order)
+{
+    const size_t *ids = order ? order->data() : nullptr;
+    uint32_t fixed = fixedSize(data, begin, end, order);
+    if (fixed)
+    {
+        frame.resize((end - begin) * (sizeof(uint32_t) + fixed * sizeof(int16_t)));
+        PACK_FIXED[fixed - MIN_SIZE](data, begin, end, ids, frame.data());
+        return;
+    }
+
+    size_t bytes = 0;
+    for (size_t i = begin; i < end; ++i)
+        bytes += sizeof(uint32_t) + data[ids ? ids[i] : i].size() * sizeof(int16_t);
+    frame.resize(bytes);
+    uint8_t *out = frame.data();
+    for (size_t i = begin; i < end; ++i)
+    {
+        const std::vector<int16_t> &vec = data[ids ? ids[i] : i];
+        uint32_t vec_size = vec.size();
+        std::memcpy(out, &vec_size, sizeof(vec_size));
+        if (vec_size)
+            std::memcpy(out + sizeof(vec_size), vec.data(), vec_size * sizeof(int16_t));
+        out += sizeof(vec_size) + vec_size * sizeof(int16_t);
+    }
+}
+
+// Метод для разбора записей с постоянным шагом
+bool FixedStride::unpack(const uint8_t *records, size_t count, uint32_t size,
+                         std::vector<std::vector<int16_t>> &data, size_t first)
+{
+    if (size >= MIN_SIZE && size <= MAX_SIZE)
+        return UNPACK_FIXED[size - MIN_SIZE](records, count, data, first);
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        uint32_t vec_size;
+        std::memcpy(&vec_size, records, sizeof(vec_size));
+        if (vec_size != size)
+            return false;
+        std::vector<int16_t> &vec = data[first + i];
+        vec.resize(size);
+        if (size)
+            std::memcpy(vec.data(), records + sizeof(vec_size), size * sizeof(int16_t));
+        records += sizeof(vec_size) + size_t(size) * sizeof(int16_t);
+    }
+    return true;
+}
+
+// Метод для вычисления суммы значений вектора с насыщением
+int16_t FixedStride::sum(const uint8_t *values, size_t size)
+{
+    if (size >= MIN_SIZE && size <= MAX_SIZE)
+        return SUM_FIXED[size - MIN_SIZE](values);
+
+    int32_t sum = 0;
+    for (size_t i = 0; i < size; ++i)
+    {
+        int16_t value;
+        std::memcpy(&value, values + i * sizeof(value), sizeof(value));
+        sum = std::max(-32768, std::min(32767, sum + value));
+    }
+    return static_cast<int16_t>(sum);
+}
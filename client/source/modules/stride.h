@@ -0,0 +1,78 @@
+#ifndef FIXED_STRIDE_H
+#define FIXED_STRIDE_H
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+/**
+* @file stride.h
+* @brief Определение класса для обработки векторов одинаковой длины.
+* @details Этот файл содержит разбор, сериализацию и свертку записей с постоянным шагом
+* (размер вектора и значения), специализированные на этапе компиляции для размеров 2-16.
+* @date 19.10.2026
+* @version 1.0
+* @authorsa Ягольницкий Р. С.
+*/
+
+/**
+* @brief Класс для обработки векторов одинаковой длины.
+* @details Файлы filer с параметром -s содержат векторы одного размера, поэтому двоичный файл
+* или окно передачи - это матрица записей с постоянным шагом. Для размеров от MIN_SIZE до MAX_SIZE
+* методы выбирают по таблице экземпляр шаблона с размером-константой: копирование значений
+* выполняется без цикла по размеру, и в горячих циклах нет ветвлений по длине вектора.
+* Для других размеров используется общий путь с тем же результатом.
+*/
+class FixedStride
+{
+public:
+    static const uint32_t MIN_SIZE = 2; ///< Наименьший специализированный размер вектора.
+    static const uint32_t MAX_SIZE = 16; ///< Наибольший специализированный размер вектора.
+
+    /**
+    * @brief Статический метод для определения специализированного размера диапазона векторов.
+    * @param data Все векторы задания.
+    * @param begin Индекс первого вектора диапазона.
+    * @param end Индекс за последним вектором диапазона.
+    * @param order Номера векторов в data, по которым отсчитываются begin и end (nullptr - векторы data подряд).
+    * @return Общий размер векторов диапазона, если он от MIN_SIZE до MAX_SIZE, иначе 0.
+    */
+    static uint32_t fixedSize(const std::vector<std::vector<int16_t>> &data, size_t begin, size_t end,
+                              const std::vector<size_t> *order = nullptr);
+
+    /**
+    * @brief Статический метод для сериализации векторов в сыром формате протокола.
+    * @details Буфер заполняется записями "размер (4 байта), значения" и выделяется один раз
+    * на весь диапазон.
+    * @param data Все векторы задания.
+    * @param begin Индекс первого вектора диапазона.
+    * @param end Индекс за последним вектором диапазона.
+    * @param frame Буфер для записей (перезаписывается).
+    * @param order Номера векторов в data, по которым отсчитываются begin и end (nullptr - векторы data подряд).
+    */
+    static void pack(const std::vector<std::vector<int16_t>> &data, size_t begin, size_t end, std::vector<uint8_t> &frame,
+                     const std::vector<size_t> *order = nullptr);
+
+    /**
+    * @brief Статический метод для разбора записей с постоянным шагом.
+    * @param records Записи "размер (4 байта), значения" подряд.
+    * @param count Количество записей.
+    * @param size Размер вектора каждой записи.
+    * @param data Буфер векторов (заполняются элементы [first, first + count), векторы переиспользуются).
+    * @param first Индекс первого заполняемого вектора.
+    * @return false, если размер какой-либо записи отличается от size.
+    */
+    static bool unpack(const uint8_t *records, size_t count, uint32_t size,
+                       std::vector<std::vector<int16_t>> &data, size_t first);
+
+    /**
+    * @brief Статический метод для вычисления суммы значений вектора с насыщением.
+    * @details Насыщение применяется после каждого сложения, как на сервере.
+    * @param values Значения вектора (без выравнивания).
+    * @param size Количество значений.
+    * @return Сумма, ограниченная диапазоном int16_t.
+    */
+    static int16_t sum(const uint8_t *values, size_t size);
+};
+
+#endif // FIXED_STRIDE_H
@@ -0,0 +1,105 @@
+#include "transport.h"
+#include <cstring>
+#include <sys/un.h>
+#include <arpa/inet.h>
+#include <unistd.h>
+#include "errors.h"
+
+// Префикс адреса Unix-сокета
+static const char UNIX_PREFIX[] = "unix:";
+
+Transport::~Transport() {}
+
+// Метод для создания транспорта по адресу сервера
+Transport *Transport::open(const std::string &address, uint16_t port)
+{
+    if (address.compare(0, sizeof(UNIX_PREFIX) - 1, UNIX_PREFIX) == 0)
+        return new UnixTransport(address.substr(sizeof(UNIX_PREFIX) - 1));
+    return new TcpTransport(address, port);
+}
+
+int Transport::fd() const
+{
+    return -1;
+};
+bool Transport::local() const
+{
+    return false;
+};
+bool Transport::tcp() const
+{
+    return false;
+};
+
+// Конструктор
+SocketTransport::SocketTransport(int domain)
+    : sock(::socket(domain, SOCK_STREAM, 0)), addr_len(0)
+{
+    if (this->sock < 0)
+        throw NetworkError("Failed to create socket", "SocketTransport()");
+    std::memset(&this->addr, 0, sizeof(this->addr));
+}
+
+// Деструктор
+SocketTransport::~SocketTransport()
+{
+    ::close(this->sock);
+}
+
+// Метод для подключения к серверу
+int SocketTransport::connect(const SocketOptions &options, int timeout_ms)
+{
+    return options.connect(this->sock, reinterpret_cast<struct sockaddr *>(&this->addr), this->addr_len, timeout_ms);
+}
+
+// Метод для отправки данных
+ssize_t SocketTransport::send(const void *buf, size_t size)
+{
+    return ::send(this->sock, buf, size, MSG_NOSIGNAL);
+}
+
+// Метод для приема данных
+ssize_t SocketTransport::recv(void *buf, size_t size)
+{
+    return ::recv(this->sock, buf, size, 0);
+}
+
+int SocketTransport::fd() const
+{
+    return this->sock;
+};
+
+// Конструктор
+TcpTransport::TcpTransport(const std::string &address, uint16_t port)
+    : SocketTransport(AF_INET)
+{
+    struct sockaddr_in *in_addr = reinterpret_cast<struct sockaddr_in *>(&this->addr);
+    in_addr->sin_family = AF_INET;
+    in_addr->sin_port = htons(port);
+    if (inet_pton(AF_INET, address.c_str(), &in_addr->sin_addr) <= 0)
+        throw NetworkError("Invalid address/ Address not supported", "TcpTransport()");
+    this->addr_len = sizeof(struct sockaddr_in);
+}
+
+bool TcpTransport::tcp() const
+{
+    return true;
+};
+
+// Конструктор
+UnixTransport::UnixTransport(const std::string &path)
+    : SocketTransport(AF_UNIX)
+{
+    // Порт не используется, адрес - путь к сокету
+    struct sockaddr_un *un_addr = reinterpret_cast<struct sockaddr_un *>(&this->addr);
+    if (path.empty() || path.size() >= sizeof(un_addr->sun_path))
+        throw NetworkError("Invalid address/ Address not supported", "UnixTransport()");
+    un_addr->sun_family = AF_UNIX;
+    std::memcpy(un_addr->sun_path, path.c_str(), path.size() + 1);
+    this->addr_len = sizeof(struct sockaddr_un);
+}
+
+bool UnixTransport::local() const
+{
+    return true;
+};
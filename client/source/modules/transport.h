@@ -0,0 +1,152 @@
+#ifndef TRANSPORT_H
+#define TRANSPORT_H
+
+#include <string>
+#include <cstdint>
+#include <cstddef>
+#include <sys/types.h>
+#include <sys/socket.h>
+#include "sockopts.h"
+
+/**
+* @file transport.h
+* @brief Определение интерфейса транспорта подключения NetMan.
+* @details Этот файл содержит интерфейс, через который NetMan передает байты протокола, и его реализации
+* поверх TCP и Unix-сокета. Замена транспорта (например, на LoopbackTransport) позволяет проверять
+* и измерять протокол без сервера и без затрат ядра.
+* @date 19.10.2026
+* @version 1.0
+* @authorsa Ягольницкий Р. С.
+*/
+
+/**
+* @brief Интерфейс транспорта подключения.
+* @details Методы send() и recv() имеют семантику одноименных системных вызовов: возвращают количество
+* переданных байт, 0 при закрытии подключения сервером или -1 с кодом ошибки в errno.
+*/
+class Transport
+{
+public:
+    /**
+    * @brief Деструктор класса Transport. Закрывает подключение.
+    */
+    virtual ~Transport();
+
+    /**
+    * @brief Статический метод для создания транспорта по адресу сервера.
+    * @param address Адрес IPv4 или unix:/путь для Unix-сокета.
+    * @param port Порт сервера (для Unix-сокета не используется).
+    * @return Транспорт (владение передается вызывающему).
+    * @throw NetworkError Если сокет не создан или адрес некорректен.
+    */
+    static Transport *open(const std::string &address, uint16_t port);
+
+    /**
+    * @brief Метод для подключения к серверу.
+    * @param options Параметры сокета (используется только таймаут подключения).
+    * @param timeout_ms Таймаут в миллисекундах (отрицательное значение - таймаут профиля, 0 - без ограничения).
+    * @return 0 при успехе, иначе код ошибки errno.
+    */
+    virtual int connect(const SocketOptions &options, int timeout_ms) = 0;
+
+    /**
+    * @brief Метод для отправки данных.
+    * @param buf Данные.
+    * @param size Размер данных в байтах.
+    * @return Количество отправленных байт или -1 при ошибке.
+    */
+    virtual ssize_t send(const void *buf, size_t size) = 0;
+
+    /**
+    * @brief Метод для приема данных.
+    * @param buf Буфер.
+    * @param size Размер буфера в байтах.
+    * @return Количество принятых байт, 0 при закрытии подключения или -1 при ошибке.
+    */
+    virtual ssize_t recv(void *buf, size_t size) = 0;
+
+    /**
+    * @brief Метод для получения дескриптора сокета.
+    * @details Дескриптор нужен для параметров и таймаутов сокета, io_uring, sendfile() и передачи
+    * сегмента общей памяти; без него NetMan использует только send() и recv().
+    * @return Дескриптор или -1, если транспорт не использует сокет.
+    */
+    virtual int fd() const;
+
+    /**
+    * @brief Метод для проверки подключения через Unix-сокет.
+    * @return true, если сервер на том же хосте доступен через Unix-сокет.
+    */
+    virtual bool local() const;
+
+    /**
+    * @brief Метод для проверки подключения по TCP.
+    * @return true, если к сокету применимы параметры TCP.
+    */
+    virtual bool tcp() const;
+};
+
+/**
+* @brief Базовый класс транспорта через сокет.
+* @details Создает сокет в конструкторе и закрывает его в деструкторе.
+*/
+class SocketTransport : public Transport
+{
+public:
+    /**
+    * @brief Деструктор класса SocketTransport. Закрывает сокет.
+    */
+    ~SocketTransport() override;
+
+    int connect(const SocketOptions &options, int timeout_ms) override;
+    ssize_t send(const void *buf, size_t size) override;
+    ssize_t recv(void *buf, size_t size) override;
+    int fd() const override;
+
+protected:
+    int sock; ///< Сокет.
+    struct sockaddr_storage addr; ///< Адрес сервера.
+    socklen_t addr_len; ///< Размер адреса сервера.
+
+    /**
+    * @brief Конструктор класса SocketTransport.
+    * @param domain Семейство адресов сокета (AF_INET или AF_UNIX).
+    * @throw NetworkError Если сокет не создан.
+    */
+    explicit SocketTransport(int domain);
+};
+
+/**
+* @brief Транспорт через TCP.
+*/
+class TcpTransport : public SocketTransport
+{
+public:
+    /**
+    * @brief Конструктор класса TcpTransport.
+    * @param address Адрес IPv4 сервера.
+    * @param port Порт сервера.
+    * @throw NetworkError Если сокет не создан или адрес некорректен.
+    */
+    TcpTransport(const std::string &address, uint16_t port);
+
+    bool tcp() const override;
+};
+
+/**
+* @brief Транспорт через Unix-сокет.
+*/
+class UnixTransport : public SocketTransport
+{
+public:
+    /**
+    * @brief Конструктор класса UnixTransport.
+    * @param path Путь к Unix-сокету сервера.
+    * @throw NetworkError Если сокет не создан или путь пуст или слишком длинный.
+    */
+    explicit UnixTransport(const std::string &path);
+
+    bool local() const override;
+};
+
+#endif // TRANSPORT_H
@@ -1,15 +1,42 @@
 #include "ui.h"
 #include <iostream>
 #include <cstring>
+#include <algorithm>
+#include <thread>
+#include <chrono>
+#include <fstream>
 
 // Конструктор
 UserInterface::UserInterface(int argc, char *argv[])
     : address("127.0.0.1"),
       port(33333),
       config_path("./config/vclient.conf"),
+      wire_mode("raw"),
+      retries(3),
+      resume_flag(false),
+      pipeline_flag(false),
+      window(0),
+      net_profile("default"),
+      io_backend("blocking"),
+      transport("socket"),
+      jobs(std::max(1u, std::thread::hardware_concurrency())),
+      load(0),
+      rate(0),
+      duration(10),
+      load_vectors(100),
+      load_vec_size(16),
+      huge_pages("off"),
+      hedge(0),
+      hedge_budget(0.05),
+      timeout_ms(0),
+      deadline(0),
+      deadline_at(std::chrono::steady_clock::time_point::max()),
+      progress_interval(0),
       help_flag(false),
       io_man(nullptr),
-      net_man(nullptr)
+      net_man(nullptr),
+      cache(nullptr),
+      progress(nullptr)
 {
     this->parseArgs(argc, argv);
 
@@ -19,8 +46,10 @@ UserInterface::UserInterface(int argc, char *argv[])
         exit(0);
     }
 
-    // Проверка, что все обязательные параметры заданы
-    if (this->input_path.empty() || this->output_path.empty())
+    // Проверка, что все обязательные параметры заданы (в пакетном режиме пути берутся из источника заданий,
+    // генератору нагрузки входные и выходные файлы не нужны)
+    if (this->batch_spec.empty() && this->latency_report_path.empty() && this->load == 0 &&
+        (this->input_path.empty() || this->output_path.empty()))
     {
         this->showHelp();
         throw ArgsDecodeError(
@@ -28,13 +57,102 @@ UserInterface::UserInterface(int argc, char *argv[])
             "UserInterface::UserInterface()");
     }
 
+    // Адрес может содержать список серверов; первый из них используется режимами с одним подключением
+    this->endpoints = Balancer::parse(this->address, this->port);
+    this->address = this->endpoints[0].address;
+    this->port = this->endpoints[0].port;
+    if ((this->endpoints.size() > 1 || this->hedge > 0) &&
+        (!this->batch_spec.empty() || this->pipeline_flag || this->load > 0 || !this->cache_path.empty() ||
+         this->transport == "shm"))
+        throw ArgsDecodeError(
+            "Multiple servers and hedging are supported only for a single file without pipeline, load, cache and shm",
+            "UserInterface::UserInterface()");
+    // Копия пакета отправляется второму серверу списка или второму подключению к единственному серверу
+    if (this->hedge > 0 && this->endpoints.size() > Hedger::CONNECTIONS)
+        throw ArgsDecodeError(
+            "Hedging accepts at most " + std::to_string(Hedger::CONNECTIONS) + " servers",
+            "UserInterface::UserInterface()");
+
+    // Общая память доступна только серверу на том же хосте
+    if (this->transport == "shm" && this->address.compare(0, 5, "unix:") != 0)
+        throw ArgsDecodeError(
+            "Shared memory transport requires a unix: address",
+            "UserInterface::UserInterface()");
+
+    // Генератор нагрузки предназначен для проверки собственного сервера, а не чужих узлов
+    if (this->load > 0 && !LoadGen::isLocal(this->address))
+        throw ArgsDecodeError(
+            "Load generator accepts only a local server address (127.0.0.0/8 or unix:)",
+            "UserInterface::UserInterface()");
+
+    // Длительность нагрузочного теста задается --duration, а не сроком задания
+    if (this->load > 0 && this->deadline > 0)
+        throw ArgsDecodeError(
+            "Job deadline is not supported in load mode, use --duration",
+            "UserInterface::UserInterface()");
+
+    // Процессоры проверяются заранее, чтобы ошибка в списке не обнаружилась внутри рабочих потоков
+    for (int cpu : this->cpus)
+        if (!Affinity::available(cpu))
+            throw ArgsDecodeError(
+                "CPU " + std::to_string(cpu) + " is not available",
+                "UserInterface::UserInterface()");
+    if (this->huge_pages == "thp")
+        HugeMem::setMode(HugeMem::THP);
+    else if (this->huge_pages == "hugetlb")
+        HugeMem::setMode(HugeMem::HUGETLB);
+    else
+        HugeMem::setMode(HugeMem::OFF);
+
+    // Пакетный режим обрабатывает файлы независимыми заданиями без состояния возобновления и конвейера
+    if (!this->batch_spec.empty() && (this->resume_flag || this->pipeline_flag))
+        throw ArgsDecodeError(
+            "Resume and pipeline are not supported in batch mode",
+            "UserInterface::UserInterface()");
+
+    // Конвейер и генератор нагрузки передают векторы без calc(), поэтому кэш к ним неприменим
+    if (!this->cache_path.empty() && (this->pipeline_flag || this->load > 0))
+        throw ArgsDecodeError(
+            "Result cache is not supported in pipeline and load modes",
+            "UserInterface::UserInterface()");
+    if (!this->cache_path.empty())
+        this->cache = new ResultCache(this->cache_path);
+
+    // Файл состояния без интервала обновляется раз в секунду
+    if (this->progress_interval > 0 || !this->progress_path.empty())
+        this->progress = new Progress(this->progress_interval > 0 ? this->progress_interval : 1.0, this->progress_path);
+
     this->io_man = new IOMan(
         this->config_path,
         this->input_path,
         this->output_path);
-    this->net_man = new NetMan(
-        this->address,
-        this->port);
+    this->net_man = this->makeNetMan();
+    this->io_man->setBackend(this->io_backend);
+}
+
+// Метод для создания менеджера сетевого взаимодействия
+NetMan *UserInterface::makeNetMan()
+{
+    return this->makeNetMan(this->address, this->port);
+}
+
+// Метод для создания менеджера сетевого взаимодействия для заданного сервера
+NetMan *UserInterface::makeNetMan(const std::string &address, uint16_t port)
+{
+    NetMan *net_man = new NetMan(
+        address,
+        port);
+    net_man->setWireMode(this->wire_mode);
+    net_man->setRetries(this->retries);
+    net_man->setWindow(this->window);
+    net_man->setOptions(SocketOptions::profile(this->net_profile));
+    net_man->setBackend(this->io_backend);
+    net_man->setTransport(this->transport);
+    net_man->setCache(this->cache);
+    net_man->setTimeout(this->timeout_ms);
+    net_man->setDeadline(this->deadline_at);
+    net_man->setProgress(this->progress);
+    return net_man;
 }
 
 // Деструктор
@@ -42,6 +160,8 @@ UserInterface::~UserInterface()
 {
     delete this->io_man;
     delete this->net_man;
+    delete this->cache;
+    delete this->progress;
 }
 
 std::string &UserInterface::getAddress()
@@ -64,6 +184,118 @@ std::string &UserInterface::getConfigFilePath()
 {
     return this->config_path;
 };
+std::string &UserInterface::getWireMode()
+{
+    return this->wire_mode;
+};
+int &UserInterface::getRetries()
+{
+    return this->retries;
+};
+bool &UserInterface::getResumeFlag()
+{
+    return this->resume_flag;
+};
+bool &UserInterface::getPipelineFlag()
+{
+    return this->pipeline_flag;
+};
+size_t &UserInterface::getWindow()
+{
+    return this->window;
+};
+std::string &UserInterface::getNetProfile()
+{
+    return this->net_profile;
+};
+std::string &UserInterface::getIOBackend()
+{
+    return this->io_backend;
+};
+std::string &UserInterface::getTransport()
+{
+    return this->transport;
+};
+std::string &UserInterface::getBatchSpec()
+{
+    return this->batch_spec;
+};
+size_t &UserInterface::getJobs()
+{
+    return this->jobs;
+};
+std::string &UserInterface::getLatencyPath()
+{
+    return this->latency_path;
+};
+std::string &UserInterface::getLatencyJsonPath()
+{
+    return this->latency_json_path;
+};
+std::string &UserInterface::getLatencyReportPath()
+{
+    return this->latency_report_path;
+};
+size_t &UserInterface::getLoad()
+{
+    return this->load;
+};
+double &UserInterface::getRate()
+{
+    return this->rate;
+};
+double &UserInterface::getDuration()
+{
+    return this->duration;
+};
+size_t &UserInterface::getLoadVectors()
+{
+    return this->load_vectors;
+};
+size_t &UserInterface::getLoadVecSize()
+{
+    return this->load_vec_size;
+};
+std::vector<int> &UserInterface::getCpus()
+{
+    return this->cpus;
+};
+std::string &UserInterface::getHugePages()
+{
+    return this->huge_pages;
+};
+std::string &UserInterface::getCachePath()
+{
+    return this->cache_path;
+};
+std::vector<Endpoint> &UserInterface::getEndpoints()
+{
+    return this->endpoints;
+};
+double &UserInterface::getHedge()
+{
+    return this->hedge;
+};
+double &UserInterface::getHedgeBudget()
+{
+    return this->hedge_budget;
+};
+int &UserInterface::getTimeout()
+{
+    return this->timeout_ms;
+};
+double &UserInterface::getDeadline()
+{
+    return this->deadline;
+};
+double &UserInterface::getProgressInterval()
+{
+    return this->progress_interval;
+};
+std::string &UserInterface::getProgressPath()
+{
+    return this->progress_path;
+};
 
 // Метод для разбора аргументов
 void UserInterface::parseArgs(int argc, char *argv[])
@@ -127,6 +359,289 @@ void UserInterface::parseArgs(int argc, char *argv[])
                     "Missing value for config parameter",
                     "UserInterface::parseArgs()");
         }
+        else if (
+            std::strcmp(argv[i], "-w") == 0 ||
+            std::strcmp(argv[i], "--wire") == 0)
+        {
+            if (i + 1 < argc)
+                this->wire_mode = argv[++i];
+            else
+                throw ArgsDecodeError(
+                    "Missing value for wire parameter",
+                    "UserInterface::parseArgs()");
+            if (this->wire_mode != "raw" && this->wire_mode != "compact")
+                throw ArgsDecodeError(
+                    "Unknown wire mode: " + this->wire_mode,
+                    "UserInterface::parseArgs()");
+        }
+        else if (
+            std::strcmp(argv[i], "-r") == 0 ||
+            std::strcmp(argv[i], "--retries") == 0)
+        {
+            if (i + 1 < argc)
+                this->retries = std::stoi(argv[++i]);
+            else
+                throw ArgsDecodeError(
+                    "Missing value for retries parameter",
+                    "UserInterface::parseArgs()");
+        }
+        else if (std::strcmp(argv[i], "--window") == 0)
+        {
+            if (i + 1 < argc)
+                this->window = std::stoul(argv[++i]);
+            else
+                throw ArgsDecodeError(
+                    "Missing value for window parameter",
+                    "UserInterface::parseArgs()");
+        }
+        else if (std::strcmp(argv[i], "--net-profile") == 0)
+        {
+            if (i + 1 < argc)
+                this->net_profile = argv[++i];
+            else
+                throw ArgsDecodeError(
+                    "Missing value for net-profile parameter",
+                    "UserInterface::parseArgs()");
+        }
+        else if (std::strncmp(argv[i], "--net-profile=", 14) == 0)
+            this->net_profile = argv[i] + 14;
+        else if (std::strcmp(argv[i], "--io") == 0)
+        {
+            if (i + 1 < argc)
+                this->io_backend = argv[++i];
+            else
+                throw ArgsDecodeError(
+                    "Missing value for io parameter",
+                    "UserInterface::parseArgs()");
+            if (this->io_backend != "blocking" && this->io_backend != "uring")
+                throw ArgsDecodeError(
+                    "Unknown I/O backend: " + this->io_backend,
+                    "UserInterface::parseArgs()");
+        }
+        else if (std::strcmp(argv[i], "--transport") == 0)
+        {
+            if (i + 1 < argc)
+                this->transport = argv[++i];
+            else
+                throw ArgsDecodeError(
+                    "Missing value for transport parameter",
+                    "UserInterface::parseArgs()");
+            if (this->transport != "socket" && this->transport != "shm")
+                throw ArgsDecodeError(
+                    "Unknown transport: " + this->transport,
+                    "UserInterface::parseArgs()");
+        }
+        else if (
+            std::strcmp(argv[i], "-b") == 0 ||
+            std::strcmp(argv[i], "--batch") == 0)
+        {
+            if (i + 1 < argc)
+                this->batch_spec = argv[++i];
+            else
+                throw ArgsDecodeError(
+                    "Missing value for batch parameter",
+                    "UserInterface::parseArgs()");
+        }
+        else if (
+            std::strcmp(argv[i], "-j") == 0 ||
+            std::strcmp(argv[i], "--jobs") == 0)
+        {
+            if (i + 1 < argc)
+                this->jobs = std::stoul(argv[++i]);
+            else
+                throw ArgsDecodeError(
+                    "Missing value for jobs parameter",
+                    "UserInterface::parseArgs()");
+            if (this->jobs == 0)
+                throw ArgsDecodeError(
+                    "Number of jobs must be positive",
+                    "UserInterface::parseArgs()");
+        }
+        else if (std::strcmp(argv[i], "--resume") == 0)
+            this->resume_flag = true;
+        else if (std::strcmp(argv[i], "--latency") == 0)
+        {
+            if (i + 1 < argc)
+                this->latency_path = argv[++i];
+            else
+                throw ArgsDecodeError(
+                    "Missing value for latency parameter",
+                    "UserInterface::parseArgs()");
+        }
+        else if (std::strcmp(argv[i], "--latency-json") == 0)
+        {
+            if (i + 1 < argc)
+                this->latency_json_path = argv[++i];
+            else
+                throw ArgsDecodeError(
+                    "Missing value for latency-json parameter",
+                    "UserInterface::parseArgs()");
+        }
+        else if (std::strcmp(argv[i], "--latency-report") == 0)
+        {
+            if (i + 1 < argc)
+                this->latency_report_path = argv[++i];
+            else
+                throw ArgsDecodeError(
+                    "Missing value for latency-report parameter",
+                    "UserInterface::parseArgs()");
+        }
+        else if (std::strcmp(argv[i], "--pipeline") == 0)
+            this->pipeline_flag = true;
+        else if (std::strcmp(argv[i], "--cpus") == 0)
+        {
+            if (i + 1 < argc)
+                this->cpus = Affinity::parse(argv[++i]);
+            else
+                throw ArgsDecodeError(
+                    "Missing value for cpus parameter",
+                    "UserInterface::parseArgs()");
+        }
+        else if (std::strcmp(argv[i], "--huge-pages") == 0)
+        {
+            if (i + 1 < argc)
+                this->huge_pages = argv[++i];
+            else
+                throw ArgsDecodeError(
+                    "Missing value for huge-pages parameter",
+                    "UserInterface::parseArgs()");
+            if (this->huge_pages != "off" && this->huge_pages != "thp" && this->huge_pages != "hugetlb")
+                throw ArgsDecodeError(
+                    "Unknown huge page mode: " + this->huge_pages,
+                    "UserInterface::parseArgs()");
+        }
+        else if (std::strcmp(argv[i], "--cache") == 0)
+        {
+            if (i + 1 < argc)
+                this->cache_path = argv[++i];
+            else
+                throw ArgsDecodeError(
+                    "Missing value for cache parameter",
+                    "UserInterface::parseArgs()");
+        }
+        else if (std::strcmp(argv[i], "--hedge") == 0)
+        {
+            if (i + 1 < argc)
+                this->hedge = std::stod(argv[++i]);
+            else
+                throw ArgsDecodeError(
+                    "Missing value for hedge parameter",
+                    "UserInterface::parseArgs()");
+            if (this->hedge < 0 || this->hedge > 100)
+                throw ArgsDecodeError(
+                    "Hedge percentile must be between 0 and 100",
+                    "UserInterface::parseArgs()");
+        }
+        else if (std::strcmp(argv[i], "--hedge-budget") == 0)
+        {
+            if (i + 1 < argc)
+                this->hedge_budget = std::stod(argv[++i]);
+            else
+                throw ArgsDecodeError(
+                    "Missing value for hedge-budget parameter",
+                    "UserInterface::parseArgs()");
+            if (this->hedge_budget < 0 || this->hedge_budget > 1)
+                throw ArgsDecodeError(
+                    "Hedge budget must be between 0 and 1",
+                    "UserInterface::parseArgs()");
+        }
+        else if (std::strcmp(argv[i], "--timeout") == 0)
+        {
+            if (i + 1 < argc)
+                this->timeout_ms = std::stoi(argv[++i]);
+            else
+                throw ArgsDecodeError(
+                    "Missing value for timeout parameter",
+                    "UserInterface::parseArgs()");
+            if (this->timeout_ms < 0)
+                throw ArgsDecodeError(
+                    "Timeout must not be negative",
+                    "UserInterface::parseArgs()");
+        }
+        else if (std::strcmp(argv[i], "--deadline") == 0)
+        {
+            if (i + 1 < argc)
+                this->deadline = std::stod(argv[++i]);
+            else
+                throw ArgsDecodeError(
+                    "Missing value for deadline parameter",
+                    "UserInterface::parseArgs()");
+            if (this->deadline < 0)
+                throw ArgsDecodeError(
+                    "Deadline must not be negative",
+                    "UserInterface::parseArgs()");
+        }
+        else if (std::strcmp(argv[i], "--progress") == 0)
+        {
+            if (i + 1 < argc)
+                this->progress_interval = std::stod(argv[++i]);
+            else
+                throw ArgsDecodeError(
+                    "Missing value for progress parameter",
+                    "UserInterface::parseArgs()");
+            if (this->progress_interval <= 0)
+                throw ArgsDecodeError(
+                    "Progress interval must be positive",
+                    "UserInterface::parseArgs()");
+        }
+        else if (std::strcmp(argv[i], "--progress-file") == 0)
+        {
+            if (i + 1 < argc)
+                this->progress_path = argv[++i];
+            else
+                throw ArgsDecodeError(
+                    "Missing value for progress-file parameter",
+                    "UserInterface::parseArgs()");
+        }
+        else if (std::strcmp(argv[i], "--load") == 0)
+        {
+            if (i + 1 < argc)
+                this->load = std::stoul(argv[++i]);
+            else
+                throw ArgsDecodeError(
+                    "Missing value for load parameter",
+                    "UserInterface::parseArgs()");
+        }
+        else if (std::strcmp(argv[i], "--rate") == 0)
+        {
+            if (i + 1 < argc)
+                this->rate = std::stod(argv[++i]);
+            else
+                throw ArgsDecodeError(
+                    "Missing value for rate parameter",
+                    "UserInterface::parseArgs()");
+            if (this->rate < 0)
+                throw ArgsDecodeError(
+                    "Request rate must not be negative",
+                    "UserInterface::parseArgs()");
+        }
+        else if (std::strcmp(argv[i], "--duration") == 0)
+        {
+            if (i + 1 < argc)
+                this->duration = std::stod(argv[++i]);
+            else
+                throw ArgsDecodeError(
+                    "Missing value for duration parameter",
+                    "UserInterface::parseArgs()");
+        }
+        else if (std::strcmp(argv[i], "--vectors") == 0)
+        {
+            if (i + 1 < argc)
+                this->load_vectors = std::stoul(argv[++i]);
+            else
+                throw ArgsDecodeError(
+                    "Missing value for vectors parameter",
+                    "UserInterface::parseArgs()");
+        }
+        else if (std::strcmp(argv[i], "--vec-size") == 0)
+        {
+            if (i + 1 < argc)
+                this->load_vec_size = std::stoul(argv[++i]);
+            else
+                throw ArgsDecodeError(
+                    "Missing value for vec-size parameter",
+                    "UserInterface::parseArgs()");
+        }
         else
             throw ArgsDecodeError(
                 "Unknown parameter: " + std::string(argv[i]),
@@ -140,24 +655,295 @@ void UserInterface::showHelp()
     std::cout << "Usage: vclient [options]\n"
               << "Options:\n"
               << "  -h, --help            Show this help message and exit\n"
-              << "  -a, --address ADDRESS Server address (default: 127.0.0.1)\n"
+              << "  -a, --address ADDRESS Server address or unix:/path (default: 127.0.0.1)\n"
+              << "                        or a comma-separated list host[:port],... to spread\n"
+              << "                        a single file across servers by outstanding work\n"
               << "  -p, --port PORT       Server port (default: 33333)\n"
-              << "  -i, --input PATH      Path to input data file\n"
-              << "  -o, --output PATH     Path to output data file\n"
-              << "  -c, --config PATH     Path to config file (default: ./config/vclient.conf)\n";
+              << "  -i, --input PATH      Path to input data file (.zst/.lz4 are decompressed)\n"
+              << "  -o, --output PATH     Path to output data file (.zst/.lz4 are compressed),\n"
+              << "                        or output directory in batch mode\n"
+              << "  -c, --config PATH     Path to config file (default: ./config/vclient.conf)\n"
+              << "  -w, --wire MODE       Wire encoding: raw or compact (default: raw)\n"
+              << "  -r, --retries N       Reconnect attempts on network errors (default: 3)\n"
+              << "      --resume          Write results incrementally and resume from PATH.ckpt\n"
+              << "      --window N        Fixed number of vectors in flight (default: adaptive),\n"
+              << "                        or vectors per batch in pipeline mode (default: 1024)\n"
+              << "      --pipeline        Read, send, receive and write in separate threads\n"
+              << "      --net-profile P   Socket profile: default, latency or throughput\n"
+              << "      --io BACKEND      I/O backend: blocking or uring (default: blocking)\n"
+              << "      --transport T     Data transport: socket or shm (unix: address only)\n"
+              << "      --cpus LIST       Pin main, pipeline stage and batch worker threads to CPUs,\n"
+              << "                        e.g. 0-3,8 (buffers are placed on the NUMA node of the thread)\n"
+              << "      --huge-pages M    Large buffers on huge pages: off, thp or hugetlb (default: off)\n"
+              << "      --cache FILE      Answer repeated vectors from a persistent result cache\n"
+              << "      --hedge P         Resend a batch on a second connection when it is slower than\n"
+              << "                        the P-th percentile of previous batches (default: 0, off)\n"
+              << "      --hedge-budget F  Largest fraction of batches sent twice (default: 0.05)\n"
+              << "      --timeout MS      Fail a connect, send or receive that makes no progress for MS ms\n"
+              << "      --deadline S      Fail the job (each file in batch mode) after S seconds\n"
+              << "      --progress S      Print vectors acked, MB/s, vectors/s and ETA to stderr every S s\n"
+              << "      --progress-file F Write progress as key=value lines to F instead (every 1 s\n"
+              << "                        unless --progress is given)\n"
+              << "  -b, --batch SPEC      Process a directory, glob or manifest of \"input output\" lines\n"
+              << "  -j, --jobs N          Concurrent connections in batch mode (default: CPU count)\n"
+              << "      --latency FILE    Merge latency histograms of this run into FILE\n"
+              << "      --latency-json F  Write latency percentiles and buckets as JSON to F\n"
+              << "      --latency-report FILE  Print percentiles of a histogram file and exit\n"
+              << "      --load N          Load-test a local server with N virtual clients\n"
+              << "      --rate R          Total requests per second in load mode (default: 0, closed loop)\n"
+              << "      --duration S      Load test duration in seconds (default: 10)\n"
+              << "      --vectors V       Vectors per load request (default: 100)\n"
+              << "      --vec-size S      Values per generated vector (default: 16)\n";
 }
 
 // Метод для запуска программы
 void UserInterface::run()
 {
-    // Пример использования методов io_man и net_man
+    if (!this->latency_report_path.empty())
+    {
+        // Отчет по сохраненным гистограммам (в том числе объединенным с разных машин)
+        LatencyStats stats;
+        if (!stats.load(this->latency_report_path))
+            throw FileNotFoundError(
+                "Failed to open latency file \"" + this->latency_report_path + "\"",
+                "UserInterface::run()");
+        this->latency_path.clear();
+        this->reportLatency(stats);
+        return;
+    }
+
+    // Задержки записываются в гистограммы рабочих потоков и объединяются после задания
+    LatencyStats::reset();
+    auto start = std::chrono::steady_clock::now();
+    if (this->progress)
+        this->progress->start();
+    try
+    {
+        this->process();
+    }
+    catch (...)
+    {
+        if (this->progress)
+            this->progress->stop(false);
+        // Записи кэша добавляются только после успешных сеансов, поэтому они сохраняются и при
+        // ошибке задания: повторный запуск не вычисляет их заново. Ошибка сохранения не заменяет
+        // исходную ошибку задания
+        if (this->cache)
+        {
+            try
+            {
+                this->cache->save();
+            }
+            catch (const std::exception &e)
+            {
+                std::cerr << e.what() << std::endl;
+            }
+        }
+        throw;
+    }
+    if (this->progress)
+        this->progress->stop(true);
+    if (this->batch_spec.empty() && this->load == 0)
+        LatencyStats::record(LatencyStats::JOB, std::chrono::steady_clock::now() - start);
+    if (this->cache)
+    {
+        this->cache->report(std::cout);
+        this->cache->save();
+    }
+    LatencyStats stats = LatencyStats::collect();
+    this->reportLatency(stats);
+}
+
+// Метод для вывода и сохранения гистограмм задержек
+void UserInterface::reportLatency(LatencyStats &stats)
+{
+    if (!this->latency_path.empty())
+    {
+        // Гистограммы прежних запусков объединяются с текущими
+        stats.load(this->latency_path);
+        stats.save(this->latency_path);
+    }
+    stats.report(std::cout);
+
+    if (!this->latency_json_path.empty())
+    {
+        std::ofstream json_file(this->latency_json_path);
+        stats.json(json_file);
+        if (!json_file)
+            throw FileNotFoundError(
+                "Failed to write latency report \"" + this->latency_json_path + "\"",
+                "UserInterface::reportLatency()");
+    }
+}
+
+// Метод для обработки задания или пакета заданий
+void UserInterface::process()
+{
+    if (this->load > 0)
+    {
+        // Нагрузочный тест: задержка каждого запроса записывается в гистограмму заданий
+        LoadGen load_gen(this->config_path, this->load, this->rate, this->duration,
+                         this->load_vectors, this->load_vec_size);
+        load_gen.run([this]()
+                     { return this->makeNetMan(); });
+        return;
+    }
+
+    if (!this->batch_spec.empty())
+    {
+        // Пакетный режим: каждый рабочий поток использует собственное подключение
+        BatchMan batch_man(this->config_path, this->io_backend);
+        batch_man.setCpus(this->cpus);
+        batch_man.setDeadline(this->deadline);
+        batch_man.collect(this->batch_spec, this->output_path);
+        size_t failed = batch_man.run(this->jobs, [this]()
+                                      { return this->makeNetMan(); });
+        if (failed > 0)
+            throw BatchError(
+                std::to_string(failed) + " of " + std::to_string(batch_man.getJobs().size()) + " files failed",
+                "UserInterface::run()");
+        return;
+    }
+
+    // Срок отсчитывается от начала задания и действует на все его подключения
+    if (this->deadline > 0)
+        this->deadline_at = std::chrono::steady_clock::now() +
+                            std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                                std::chrono::duration<double>(this->deadline));
+    this->net_man->setDeadline(this->deadline_at);
+
+    // Главный поток привязывается до выделения буферов, чтобы они разместились на узле NUMA его процессора
+    Affinity::pin(this->cpus, 0);
+
     auto credentials = this->io_man->conf();
+    if (this->endpoints.size() > 1 || this->hedge > 0)
+    {
+        // Несколько серверов или дублирование медленных пакетов по второму подключению
+        bool indexed = this->io_man->loadIndex();
+        std::vector<std::vector<int16_t>> data;
+        if (!indexed)
+            data = this->io_man->read();
+        std::vector<int16_t> results;
+        HugeMem::resize(results, indexed ? this->io_man->getIndex().count() : data.size());
+
+        uint32_t first = 0;
+        std::function<void(size_t, size_t)> commit;
+        IOMan *io_man = this->io_man;
+        if (this->resume_flag)
+        {
+            first = this->io_man->resume(results);
+            commit = [io_man, &results](size_t begin, size_t end)
+            { io_man->writePart(results, begin, end); };
+        }
+        if (indexed)
+        {
+            HugeMem::resize(data, results.size());
+            this->io_man->readRange(data, first, results.size());
+        }
+        if (this->progress)
+            this->progress->setTotal(results.size() - first);
+
+        if (this->hedge > 0)
+        {
+            std::vector<Endpoint> &endpoints = this->endpoints;
+            Hedger hedger([this, &endpoints](size_t id)
+                          {
+                const Endpoint &endpoint = endpoints[id % endpoints.size()];
+                return this->makeNetMan(endpoint.address, endpoint.port); },
+                          credentials[0], credentials[1], this->hedge, this->hedge_budget, this->retries);
+            hedger.calc(data, results, first, commit);
+            hedger.report(std::cout);
+        }
+        else
+        {
+            // Части файла направляются серверу с наименьшим объемом ожидающей работы
+            Balancer balancer(this->endpoints, [this](const Endpoint &endpoint)
+                              { return this->makeNetMan(endpoint.address, endpoint.port); },
+                              credentials[0], credentials[1], this->retries);
+            balancer.calc(data, results, first, commit);
+            balancer.report(std::cout);
+        }
+        if (this->resume_flag)
+            this->io_man->finish();
+        else
+            this->io_man->write(results);
+        return;
+    }
+
+    // Пример использования методов io_man и net_man
     this->net_man->conn();
     this->net_man->auth(credentials[0], credentials[1]);
 
-    auto data = this->io_man->read();
-    auto results = this->net_man->calc(data);
-    this->io_man->write(results);
+    if (this->pipeline_flag)
+    {
+        // Конвейер пишет результаты инкрементально; без --resume прежняя контрольная точка не учитывается
+        std::vector<int16_t> results;
+        HugeMem::resize(results, this->io_man->openStream());
+        if (!this->resume_flag)
+            this->io_man->finish();
+        uint32_t first = this->io_man->resume(results);
+        if (first > 0)
+            this->io_man->openStream(first);
+        if (this->progress)
+            this->progress->setTotal(results.size() - first);
+        Pipeline pipeline(*this->io_man, *this->net_man, this->window ? this->window : Pipeline::BATCH);
+        pipeline.setCpus(this->cpus);
+        pipeline.run(results, first);
+        this->io_man->finish();
+        this->net_man->close();
+        return;
+    }
+
+    // Двоичный файл с индексом в сыром режиме передается из файла в сокет без разбора векторов
+    bool indexed = this->io_man->loadIndex();
+    bool direct = indexed && this->io_man->getIndex().format() == VecIndex::FORMAT_BINARY && this->net_man->canSendFile();
+
+    if (this->resume_flag)
+    {
+        // С индексом смещений читаются только векторы после контрольной точки
+        std::vector<std::vector<int16_t>> data;
+        if (!indexed)
+            data = this->io_man->read();
+
+        // Результаты сохраняются по мере подтверждения пакетов
+        std::vector<int16_t> results;
+        HugeMem::resize(results, indexed ? this->io_man->getIndex().count() : data.size());
+        uint32_t first = this->io_man->resume(results);
+        if (this->progress)
+            this->progress->setTotal(results.size() - first);
+        IOMan *io_man = this->io_man;
+        auto commit = [io_man, &results](size_t begin, size_t end)
+        { io_man->writePart(results, begin, end); };
+        if (direct)
+            this->net_man->calcFile(this->input_path, this->io_man->getIndex(), results, first, commit);
+        else
+        {
+            if (indexed)
+            {
+                HugeMem::resize(data, results.size());
+                this->io_man->readRange(data, first, results.size());
+            }
+            this->net_man->calc(data, results, first, commit);
+        }
+        this->io_man->finish();
+    }
+    else if (direct)
+    {
+        std::vector<int16_t> results;
+        HugeMem::resize(results, this->io_man->getIndex().count());
+        if (this->progress)
+            this->progress->setTotal(results.size());
+        this->net_man->calcFile(this->input_path, this->io_man->getIndex(), results, 0, std::function<void(size_t, size_t)>());
+        this->io_man->write(results);
+    }
+    else
+    {
+        auto data = this->io_man->read();
+        if (this->progress)
+            this->progress->setTotal(data.size());
+        auto results = this->net_man->calc(data);
+        this->io_man->write(results);
+    }
 
     this->net_man->close();
 }
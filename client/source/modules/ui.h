@@ -3,7 +3,17 @@
 
 #include "ioman.h"
 #include "netman.h"
+#include "batchman.h"
+#include "pipeline.h"
+#include "latency.h"
+#include "loadgen.h"
+#include "affinity.h"
+#include "hugemem.h"
+#include "balancer.h"
+#include "hedger.h"
+#include "progress.h"
 #include "errors.h"
+#include <chrono>
 #include <string>
 #include <vector>
 
@@ -64,7 +74,175 @@ public:
     * @return Путь к конфигурационному файлу.
     */
     std::string &getConfigFilePath();
-    
+
+    /**
+    * @brief Метод для получения режима кодирования данных при передаче.
+    * @return Режим кодирования.
+    */
+    std::string &getWireMode();
+
+    /**
+    * @brief Метод для получения количества повторных попыток при сетевых ошибках.
+    * @return Количество повторных попыток.
+    */
+    int &getRetries();
+
+    /**
+    * @brief Метод для проверки режима возобновляемого задания.
+    * @return true, если результаты сохраняются инкрементально с контрольной точкой.
+    */
+    bool &getResumeFlag();
+
+    /**
+    * @brief Метод для проверки конвейерного режима.
+    * @return true, если разбор, отправка, прием и запись выполняются отдельными потоками.
+    */
+    bool &getPipelineFlag();
+
+    /**
+    * @brief Метод для получения фиксированного размера окна передачи.
+    * @return Размер окна в векторах (0 - адаптивный подбор).
+    */
+    size_t &getWindow();
+
+    /**
+    * @brief Метод для получения профиля параметров сокета.
+    * @return Имя профиля.
+    */
+    std::string &getNetProfile();
+
+    /**
+    * @brief Метод для получения механизма ввода-вывода.
+    * @return Механизм ввода-вывода ("blocking" или "uring").
+    */
+    std::string &getIOBackend();
+
+    /**
+    * @brief Метод для получения транспорта данных.
+    * @return Транспорт ("socket" или "shm").
+    */
+    std::string &getTransport();
+
+    /**
+    * @brief Метод для получения источника заданий пакетного режима.
+    * @return Каталог, шаблон имен или манифест (пустая строка - обработка одного файла).
+    */
+    std::string &getBatchSpec();
+
+    /**
+    * @brief Метод для получения количества одновременных подключений пакетного режима.
+    * @return Количество рабочих потоков.
+    */
+    size_t &getJobs();
+
+    /**
+    * @brief Метод для получения пути к файлу гистограмм задержек.
+    * @return Путь к файлу, в который добавляются гистограммы запуска (пустая строка - не сохранять).
+    */
+    std::string &getLatencyPath();
+
+    /**
+    * @brief Метод для получения пути к отчету о задержках в формате JSON.
+    * @return Путь к отчету (пустая строка - не записывать).
+    */
+    std::string &getLatencyJsonPath();
+
+    /**
+    * @brief Метод для получения пути к файлу гистограмм для вывода отчета без запуска задания.
+    * @return Путь к файлу гистограмм (пустая строка - обычный запуск).
+    */
+    std::string &getLatencyReportPath();
+
+    /**
+    * @brief Метод для получения количества виртуальных клиентов генератора нагрузки.
+    * @return Количество клиентов (0 - обычный запуск).
+    */
+    size_t &getLoad();
+
+    /**
+    * @brief Метод для получения частоты запросов генератора нагрузки.
+    * @return Суммарная частота запросов в секунду (0 - замкнутый цикл).
+    */
+    double &getRate();
+
+    /**
+    * @brief Метод для получения длительности нагрузочного теста.
+    * @return Длительность в секундах.
+    */
+    double &getDuration();
+
+    /**
+    * @brief Метод для получения количества векторов в запросе генератора нагрузки.
+    * @return Количество векторов.
+    */
+    size_t &getLoadVectors();
+
+    /**
+    * @brief Метод для получения размера векторов генератора нагрузки.
+    * @return Количество значений в векторе.
+    */
+    size_t &getLoadVecSize();
+
+    /**
+    * @brief Метод для получения списка процессоров для привязки потоков.
+    * @return Номера процессоров (пустой список - без привязки).
+    */
+    std::vector<int> &getCpus();
+
+    /**
+    * @brief Метод для получения режима больших страниц.
+    * @return Режим ("off", "thp" или "hugetlb").
+    */
+    std::string &getHugePages();
+
+    /**
+    * @brief Метод для получения пути к файлу кэша результатов.
+    * @return Путь к файлу кэша (пустая строка - без кэша).
+    */
+    std::string &getCachePath();
+
+    /**
+    * @brief Метод для получения списка серверов.
+    * @return Серверы из параметра адреса (один сервер, если список не задан).
+    */
+    std::vector<Endpoint> &getEndpoints();
+
+    /**
+    * @brief Метод для получения процентиля задержки дублирования пакетов.
+    * @return Процентиль задержек, после которого отправляется копия пакета (0 - без дублирования).
+    */
+    double &getHedge();
+
+    /**
+    * @brief Метод для получения доли дублирования пакетов.
+    * @return Наибольшая доля продублированных пакетов (0-1).
+    */
+    double &getHedgeBudget();
+
+    /**
+    * @brief Метод для получения таймаута сетевых операций.
+    * @return Таймаут в миллисекундах (0 - без ограничения).
+    */
+    int &getTimeout();
+
+    /**
+    * @brief Метод для получения срока задания.
+    * @return Срок в секундах (0 - без срока); в пакетном режиме - срок каждого файла.
+    */
+    double &getDeadline();
+
+    /**
+    * @brief Метод для получения интервала вывода хода задания.
+    * @return Интервал в секундах (0 - ход не выводится, если не задан файл состояния).
+    */
+    double &getProgressInterval();
+
+    /**
+    * @brief Метод для получения пути к файлу состояния хода задания.
+    * @return Путь к файлу (пустая строка - вывод в stderr).
+    */
+    std::string &getProgressPath();
+
     /**
     * @brief Метод для запуска программы.
     */
@@ -76,9 +254,40 @@ private:
     std::string input_path; ///< Путь к входному файлу.
     std::string output_path; ///< Путь к выходному файлу.
     std::string config_path; ///< Путь к файлу конфигурации.
+    std::string wire_mode; ///< Режим кодирования данных при передаче.
+    int retries; ///< Количество повторных попыток при сетевых ошибках.
+    bool resume_flag; ///< Флаг возобновляемого задания.
+    bool pipeline_flag; ///< Флаг конвейерного режима.
+    size_t window; ///< Фиксированный размер окна передачи (0 - адаптивный).
+    std::string net_profile; ///< Профиль параметров сокета.
+    std::string io_backend; ///< Механизм ввода-вывода.
+    std::string transport; ///< Транспорт данных.
+    std::string batch_spec; ///< Источник заданий пакетного режима.
+    size_t jobs; ///< Количество одновременных подключений пакетного режима.
+    std::string latency_path; ///< Файл гистограмм задержек, объединяемых между запусками.
+    std::string latency_json_path; ///< Отчет о задержках в формате JSON.
+    std::string latency_report_path; ///< Файл гистограмм для вывода отчета без запуска задания.
+    size_t load; ///< Количество виртуальных клиентов генератора нагрузки (0 - обычный запуск).
+    double rate; ///< Частота запросов генератора нагрузки (0 - замкнутый цикл).
+    double duration; ///< Длительность нагрузочного теста в секундах.
+    size_t load_vectors; ///< Количество векторов в запросе генератора нагрузки.
+    size_t load_vec_size; ///< Количество значений в векторе генератора нагрузки.
+    std::vector<int> cpus; ///< Процессоры для привязки потоков.
+    std::string huge_pages; ///< Режим больших страниц для буферов.
+    std::string cache_path; ///< Файл кэша результатов.
+    std::vector<Endpoint> endpoints; ///< Серверы для распределения векторов.
+    double hedge; ///< Процентиль задержки дублирования пакетов (0 - без дублирования).
+    double hedge_budget; ///< Наибольшая доля продублированных пакетов.
+    int timeout_ms; ///< Таймаут сетевых операций в миллисекундах (0 - без ограничения).
+    double deadline; ///< Срок задания в секундах (0 - без срока).
+    std::chrono::steady_clock::time_point deadline_at; ///< Момент истечения срока текущего задания.
+    double progress_interval; ///< Интервал вывода хода задания в секундах (0 - по умолчанию или без вывода).
+    std::string progress_path; ///< Файл состояния хода задания (пустая строка - stderr).
 
     IOMan *io_man; ///< Менеджер ввода-вывода.
     NetMan *net_man; ///< Менеджер сетевого взаимодействия.
+    ResultCache *cache; ///< Кэш результатов (nullptr - без кэша).
+    Progress *progress; ///< Счетчики хода задания (nullptr - ход не выводится).
 
     bool help_flag; ///< Флаг для отображения справки.
 
@@ -90,6 +299,32 @@ private:
     */
     void parseArgs(int argc, char *argv[]);
 
+    /**
+    * @brief Вспомогательный метод для обработки задания или пакета заданий.
+    */
+    void process();
+
+    /**
+    * @brief Вспомогательный метод для вывода и сохранения гистограмм задержек.
+    * @param stats Гистограммы задержек.
+    * @throw FileNotFoundError Если не удалось записать файл гистограмм или отчет.
+    */
+    void reportLatency(LatencyStats &stats);
+
+    /**
+    * @brief Вспомогательный метод для создания менеджера сетевого взаимодействия с заданными параметрами.
+    * @return Указатель на новый NetMan.
+    */
+    NetMan *makeNetMan();
+
+    /**
+    * @brief Вспомогательный метод для создания менеджера сетевого взаимодействия для заданного сервера.
+    * @param address Адрес сервера.
+    * @param port Порт сервера.
+    * @return Указатель на новый NetMan.
+    */
+    NetMan *makeNetMan(const std::string &address, uint16_t port);
+
     /**
     * @brief Метод для отображения справки.
     */
@@ -0,0 +1,381 @@
+#include "uring.h"
+#include "hugemem.h"
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstring>
+#include <algorithm>
+
+// Размер блока чтения файла и количество блоков, читаемых с опережением
+static const unsigned READ_BLOCK = 1 << 17;
+static const unsigned READ_SLOTS = 4;
+
+namespace
+{
+    int uringSetup(unsigned entries, struct io_uring_params *params)
+    {
+        return syscall(__NR_io_uring_setup, entries, params);
+    }
+
+    int uringEnter(int fd, unsigned to_submit, unsigned min_complete, unsigned flags)
+    {
+        return syscall(__NR_io_uring_enter, fd, to_submit, min_complete, flags, nullptr, 0);
+    }
+
+    // Буфер потока, читающий файл блоками с опережением через io_uring
+    class URingFileBuf : public std::streambuf
+    {
+    public:
+        URingFileBuf(int file)
+            : file(file),
+              ring(READ_SLOTS * 2),
+              memory(READ_SLOTS * READ_BLOCK),
+              results(READ_SLOTS, 0),
+              current(0),
+              offset(0),
+              eof(false),
+              fixed(false)
+        {
+            std::vector<struct iovec> buffers(READ_SLOTS);
+            for (unsigned i = 0; i < READ_SLOTS; ++i)
+            {
+                buffers[i].iov_base = this->slot(i);
+                buffers[i].iov_len = READ_BLOCK;
+            }
+            // Без регистрации (например, из-за RLIMIT_MEMLOCK) используются обычные буферы
+            this->fixed = this->ring.available() && this->ring.registerBuffers(buffers);
+            for (unsigned i = 0; i < READ_SLOTS; ++i)
+                this->queue(i);
+            this->ring.submit();
+            this->setg(nullptr, nullptr, nullptr);
+        }
+
+        ~URingFileBuf()
+        {
+            // Дожидаемся незавершенных чтений, прежде чем освобождать буферы
+            for (unsigned i = 0; i < READ_SLOTS; ++i)
+                this->wait(i);
+            ::close(this->file);
+        }
+
+        bool available() const
+        {
+            return this->ring.available();
+        }
+
+    protected:
+        int_type underflow() override
+        {
+            if (this->gptr() < this->egptr())
+                return traits_type::to_int_type(*this->gptr());
+
+            // Прочитанный блок освобожден: ставим в очередь чтение следующей части файла
+            if (this->eback() != nullptr)
+            {
+                this->queue(this->current);
+                this->ring.submit();
+                this->current = (this->current + 1) % READ_SLOTS;
+            }
+
+            int res = this->wait(this->current);
+            if (res <= 0)
+                return traits_type::eof();
+            // Короткое чтение обычного файла означает его конец
+            if (static_cast<unsigned>(res) < READ_BLOCK)
+                this->eof = true;
+
+            char *base = this->slot(this->current);
+            this->setg(base, base, base + res);
+            return traits_type::to_int_type(*this->gptr());
+        }
+
+    private:
+        int file;
+        URing ring;
+        std::vector<char, HugeAllocator<char>> memory;
+        std::vector<int> results; // результат чтения блока, 1 << 30 - чтение выполняется
+        unsigned current;
+        uint64_t offset;
+        bool eof;
+        bool fixed;
+
+        char *slot(unsigned index)
+        {
+            return this->memory.data() + index * READ_BLOCK;
+        }
+
+        void queue(unsigned index)
+        {
+            if (this->eof)
+            {
+                this->results[index] = 0;
+                return;
+            }
+            this->results[index] = 1 << 30;
+            this->ring.prepRead(this->file, this->slot(index), READ_BLOCK, this->offset, index, this->fixed ? index : -1);
+            this->offset += READ_BLOCK;
+        }
+
+        int wait(unsigned index)
+        {
+            while (this->results[index] == 1 << 30)
+            {
+                uint64_t user_data;
+                int res;
+                if (!this->ring.complete(user_data, res, true))
+                    return -EIO;
+                this->results[user_data] = res;
+            }
+            return this->results[index];
+        }
+    };
+
+    // Поток ввода, владеющий буфером чтения через io_uring
+    class URingIStream : public std::istream
+    {
+    public:
+        URingIStream(int file) : std::istream(nullptr), buf(file)
+        {
+            this->rdbuf(&this->buf);
+        }
+
+        URingFileBuf buf;
+    };
+}
+
+// Конструктор
+URing::URing(unsigned entries)
+    : fd(-1), sqes(nullptr), cqes(nullptr), sq_ptr(MAP_FAILED), sq_len(0),
+      cq_ptr(MAP_FAILED), cq_len(0), sqes_len(0), pending(0)
+{
+    struct io_uring_params params;
+    std::memset(&params, 0, sizeof(params));
+    this->fd = uringSetup(entries, &params);
+    if (this->fd < 0)
+        return;
+
+    // Отображение очередей отправки и завершения в память процесса
+    this->sq_len = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    this->cq_len = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+    bool single = params.features & IORING_FEAT_SINGLE_MMAP;
+    if (single)
+        this->sq_len = this->cq_len = std::max(this->sq_len, this->cq_len);
+
+    this->sq_ptr = mmap(nullptr, this->sq_len, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, this->fd, IORING_OFF_SQ_RING);
+    this->cq_ptr = single ? this->sq_ptr : mmap(nullptr, this->cq_len, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, this->fd, IORING_OFF_CQ_RING);
+    this->sqes_len = params.sq_entries * sizeof(struct io_uring_sqe);
+    void *sqes_ptr = mmap(nullptr, this->sqes_len, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, this->fd, IORING_OFF_SQES);
+    if (sqes_ptr != MAP_FAILED)
+        this->sqes = static_cast<struct io_uring_sqe *>(sqes_ptr);
+    if (this->sq_ptr == MAP_FAILED || this->cq_ptr == MAP_FAILED || sqes_ptr == MAP_FAILED)
+    {
+        // Кольцо без отображения непригодно: освобождаем его и работаем в блокирующем режиме
+        if (this->sqes != nullptr)
+            munmap(this->sqes, this->sqes_len);
+        if (this->cq_ptr != MAP_FAILED && this->cq_ptr != this->sq_ptr)
+            munmap(this->cq_ptr, this->cq_len);
+        if (this->sq_ptr != MAP_FAILED)
+            munmap(this->sq_ptr, this->sq_len);
+        ::close(this->fd);
+        this->fd = -1;
+        this->sqes = nullptr;
+        this->sq_ptr = this->cq_ptr = MAP_FAILED;
+        return;
+    }
+
+    char *sq = static_cast<char *>(this->sq_ptr);
+    char *cq = static_cast<char *>(this->cq_ptr);
+    this->sq_head = reinterpret_cast<unsigned *>(sq + params.sq_off.head);
+    this->sq_tail = reinterpret_cast<unsigned *>(sq + params.sq_off.tail);
+    this->sq_mask = reinterpret_cast<unsigned *>(sq + params.sq_off.ring_mask);
+    this->sq_array = reinterpret_cast<unsigned *>(sq + params.sq_off.array);
+    this->cq_head = reinterpret_cast<unsigned *>(cq + params.cq_off.head);
+    this->cq_tail = reinterpret_cast<unsigned *>(cq + params.cq_off.tail);
+    this->cq_mask = reinterpret_cast<unsigned *>(cq + params.cq_off.ring_mask);
+    this->cqes = reinterpret_cast<struct io_uring_cqe *>(cq + params.cq_off.cqes);
+}
+
+// Деструктор
+URing::~URing()
+{
+    if (this->sqes != nullptr)
+        munmap(this->sqes, this->sqes_len);
+    if (this->cq_ptr != MAP_FAILED && this->cq_ptr != this->sq_ptr)
+        munmap(this->cq_ptr, this->cq_len);
+    if (this->sq_ptr != MAP_FAILED)
+        munmap(this->sq_ptr, this->sq_len);
+    if (this->fd >= 0)
+        ::close(this->fd);
+}
+
+bool URing::available() const
+{
+    return this->fd >= 0;
+}
+
+bool URing::registerBuffers(const std::vector<struct iovec> &buffers)
+{
+    return syscall(__NR_io_uring_register, this->fd, IORING_REGISTER_BUFFERS, buffers.data(), buffers.size()) == 0;
+}
+
+// Метод для получения свободной записи очереди отправки
+struct io_uring_sqe *URing::getSqe()
+{
+    if (!this->available())
+        return nullptr;
+    unsigned head = __atomic_load_n(this->sq_head, __ATOMIC_ACQUIRE);
+    unsigned tail = *this->sq_tail + this->pending;
+    if (tail - head > *this->sq_mask)
+        return nullptr;
+
+    unsigned index = tail & *this->sq_mask;
+    this->sq_array[index] = index;
+    ++this->pending;
+    struct io_uring_sqe *sqe = &this->sqes[index];
+    std::memset(sqe, 0, sizeof(*sqe));
+    return sqe;
+}
+
+bool URing::prepRead(int fd, void *buf, unsigned len, uint64_t offset, uint64_t user_data, int buf_index)
+{
+    struct io_uring_sqe *sqe = this->getSqe();
+    if (sqe == nullptr)
+        return false;
+    sqe->opcode = buf_index >= 0 ? IORING_OP_READ_FIXED : IORING_OP_READ;
+    sqe->fd = fd;
+    sqe->addr = reinterpret_cast<uint64_t>(buf);
+    sqe->len = len;
+    sqe->off = offset;
+    sqe->user_data = user_data;
+    if (buf_index >= 0)
+        sqe->buf_index = buf_index;
+    return true;
+}
+
+bool URing::prepWrite(int fd, const void *buf, unsigned len, uint64_t offset, uint64_t user_data)
+{
+    struct io_uring_sqe *sqe = this->getSqe();
+    if (sqe == nullptr)
+        return false;
+    sqe->opcode = IORING_OP_WRITE;
+    sqe->fd = fd;
+    sqe->addr = reinterpret_cast<uint64_t>(buf);
+    sqe->len = len;
+    sqe->off = offset;
+    sqe->user_data = user_data;
+    return true;
+}
+
+bool URing::prepSend(int fd, const void *buf, unsigned len, uint64_t user_data, int flags)
+{
+    struct io_uring_sqe *sqe = this->getSqe();
+    if (sqe == nullptr)
+        return false;
+    sqe->opcode = IORING_OP_SEND;
+    sqe->fd = fd;
+    sqe->addr = reinterpret_cast<uint64_t>(buf);
+    sqe->len = len;
+    sqe->msg_flags = flags;
+    sqe->user_data = user_data;
+    return true;
+}
+
+bool URing::prepRecv(int fd, void *buf, unsigned len, uint64_t user_data, int flags)
+{
+    struct io_uring_sqe *sqe = this->getSqe();
+    if (sqe == nullptr)
+        return false;
+    sqe->opcode = IORING_OP_RECV;
+    sqe->fd = fd;
+    sqe->addr = reinterpret_cast<uint64_t>(buf);
+    sqe->len = len;
+    sqe->msg_flags = flags;
+    sqe->user_data = user_data;
+    return true;
+}
+
+// Метод для передачи накопленных операций ядру
+int URing::submit(unsigned wait_nr)
+{
+    if (!this->available())
+        return -ENOSYS;
+    unsigned count = this->pending;
+    __atomic_store_n(this->sq_tail, *this->sq_tail + count, __ATOMIC_RELEASE);
+    this->pending = 0;
+
+    int ret;
+    do
+        ret = uringEnter(this->fd, count, wait_nr, wait_nr > 0 ? IORING_ENTER_GETEVENTS : 0);
+    while (ret < 0 && errno == EINTR);
+    return ret < 0 ? -errno : ret;
+}
+
+// Метод для получения результата завершенной операции
+bool URing::complete(uint64_t &user_data, int &res, bool wait)
+{
+    if (!this->available())
+        return false;
+    for (;;)
+    {
+        unsigned head = *this->cq_head;
+        if (head != __atomic_load_n(this->cq_tail, __ATOMIC_ACQUIRE))
+        {
+            struct io_uring_cqe *cqe = &this->cqes[head & *this->cq_mask];
+            user_data = cqe->user_data;
+            res = cqe->res;
+            __atomic_store_n(this->cq_head, head + 1, __ATOMIC_RELEASE);
+            return true;
+        }
+        if (!wait)
+            return false;
+        if (uringEnter(this->fd, 0, 1, IORING_ENTER_GETEVENTS) < 0 && errno != EINTR)
+            return false;
+    }
+}
+
+// Метод для открытия входного файла с чтением через io_uring
+std::istream *URing::openInput(const std::string &path)
+{
+    int file = ::open(path.c_str(), O_RDONLY);
+    if (file < 0)
+        return nullptr;
+    URingIStream *stream = new URingIStream(file);
+    if (!stream->buf.available())
+    {
+        delete stream;
+        return nullptr;
+    }
+    return stream;
+}
+
+// Метод для записи буфера в файл через io_uring
+int URing::writeFile(const std::string &path, const char *data, size_t size)
+{
+    URing ring(4);
+    if (!ring.available())
+        return -1;
+    int file = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (file < 0)
+        return 1;
+
+    size_t written = 0;
+    int result = 0;
+    while (written < size)
+    {
+        uint64_t user_data;
+        int res;
+        ring.prepWrite(file, data + written, size - written, written, 0);
+        ring.submit(1);
+        if (!ring.complete(user_data, res, true) || res <= 0)
+        {
+            result = 1;
+            break;
+        }
+        written += res;
+    }
+    ::close(file);
+    return result;
+}
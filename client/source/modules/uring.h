@@ -0,0 +1,161 @@
+#ifndef URING_H
+#define URING_H
+
+#include <string>
+#include <vector>
+#include <istream>
+#include <cstdint>
+#include <cstddef>
+#include <sys/uio.h>
+
+struct io_uring_sqe;
+struct io_uring_cqe;
+
+/**
+* @file uring.h
+* @brief Определение класса для асинхронного ввода-вывода через io_uring.
+* @details Этот файл содержит определения методов для создания кольца io_uring, регистрации буферов,
+* пакетной постановки операций чтения, записи, отправки и приема и получения их результатов.
+* Кольцо создается системными вызовами напрямую, без зависимости от liburing.
+* @date 19.10.2026
+* @version 1.0
+* @authorsa Ягольницкий Р. С.
+*/
+
+/**
+* @brief Класс для управления кольцом io_uring.
+* @details Операции накапливаются в очереди отправки и передаются ядру одним вызовом submit().
+* Если ядро не поддерживает io_uring (или он запрещен), available() возвращает false,
+* и вызывающий код использует блокирующие вызовы.
+*/
+class URing
+{
+public:
+    /**
+    * @brief Конструктор класса URing.
+    * @param entries Размер очереди отправки.
+    */
+    URing(unsigned entries = 64);
+
+    /**
+    * @brief Деструктор класса URing. Освобождает кольцо.
+    */
+    ~URing();
+
+    /**
+    * @brief Метод для проверки доступности io_uring.
+    * @return true, если кольцо создано.
+    */
+    bool available() const;
+
+    /**
+    * @brief Метод для регистрации буферов для операций с фиксированными буферами.
+    * @param buffers Буферы.
+    * @return true, если буферы зарегистрированы.
+    */
+    bool registerBuffers(const std::vector<struct iovec> &buffers);
+
+    /**
+    * @brief Метод для постановки чтения файла в очередь.
+    * @param fd Файловый дескриптор.
+    * @param buf Буфер.
+    * @param len Размер буфера.
+    * @param offset Смещение в файле.
+    * @param user_data Метка операции.
+    * @param buf_index Индекс зарегистрированного буфера (-1 - обычный буфер).
+    * @return false, если очередь заполнена.
+    */
+    bool prepRead(int fd, void *buf, unsigned len, uint64_t offset, uint64_t user_data, int buf_index = -1);
+
+    /**
+    * @brief Метод для постановки записи в файл в очередь.
+    * @param fd Файловый дескриптор.
+    * @param buf Данные.
+    * @param len Размер данных.
+    * @param offset Смещение в файле.
+    * @param user_data Метка операции.
+    * @return false, если очередь заполнена.
+    */
+    bool prepWrite(int fd, const void *buf, unsigned len, uint64_t offset, uint64_t user_data);
+
+    /**
+    * @brief Метод для постановки отправки в сокет в очередь.
+    * @param fd Сокет.
+    * @param buf Данные.
+    * @param len Размер данных.
+    * @param user_data Метка операции.
+    * @param flags Флаги send().
+    * @return false, если очередь заполнена.
+    */
+    bool prepSend(int fd, const void *buf, unsigned len, uint64_t user_data, int flags = 0);
+
+    /**
+    * @brief Метод для постановки приема из сокета в очередь.
+    * @param fd Сокет.
+    * @param buf Буфер.
+    * @param len Размер буфера.
+    * @param user_data Метка операции.
+    * @param flags Флаги recv().
+    * @return false, если очередь заполнена.
+    */
+    bool prepRecv(int fd, void *buf, unsigned len, uint64_t user_data, int flags = 0);
+
+    /**
+    * @brief Метод для передачи накопленных операций ядру.
+    * @param wait_nr Количество завершений, которых нужно дождаться.
+    * @return Количество переданных операций или -errno.
+    */
+    int submit(unsigned wait_nr = 0);
+
+    /**
+    * @brief Метод для получения результата завершенной операции.
+    * @param user_data Метка операции.
+    * @param res Результат операции (как у системного вызова, -errno при ошибке).
+    * @param wait Ожидать завершения, если готовых результатов нет.
+    * @return true, если результат получен.
+    */
+    bool complete(uint64_t &user_data, int &res, bool wait);
+
+    /**
+    * @brief Статический метод для открытия входного файла с чтением через io_uring.
+    * @details Несколько блоков файла читаются с опережением в зарегистрированные буферы.
+    * @param path Путь к файлу.
+    * @return Указатель на поток ввода или nullptr, если файл не открыт или io_uring недоступен.
+    */
+    static std::istream *openInput(const std::string &path);
+
+    /**
+    * @brief Статический метод для записи буфера в файл через io_uring.
+    * @param path Путь к файлу.
+    * @param data Данные.
+    * @param size Размер данных.
+    * @return 0 при успехе, 1 если файл не удалось открыть, -1 если io_uring недоступен.
+    */
+    static int writeFile(const std::string &path, const char *data, size_t size);
+
+private:
+    int fd; ///< Дескриптор кольца.
+    unsigned *sq_head; ///< Голова очереди отправки.
+    unsigned *sq_tail; ///< Хвост очереди отправки.
+    unsigned *sq_mask; ///< Маска индексов очереди отправки.
+    unsigned *sq_array; ///< Массив индексов записей очереди отправки.
+    unsigned *cq_head; ///< Голова очереди завершения.
+    unsigned *cq_tail; ///< Хвост очереди завершения.
+    unsigned *cq_mask; ///< Маска индексов очереди завершения.
+    io_uring_sqe *sqes; ///< Записи очереди отправки.
+    io_uring_cqe *cqes; ///< Записи очереди завершения.
+    void *sq_ptr; ///< Отображение очереди отправки.
+    size_t sq_len; ///< Размер отображения очереди отправки.
+    void *cq_ptr; ///< Отображение очереди завершения.
+    size_t cq_len; ///< Размер отображения очереди завершения.
+    size_t sqes_len; ///< Размер отображения записей очереди отправки.
+    unsigned pending; ///< Количество операций, еще не переданных ядру.
+
+    /**
+    * @brief Вспомогательный метод для получения свободной записи очереди отправки.
+    * @return Запись или nullptr, если очередь заполнена.
+    */
+    io_uring_sqe *getSqe();
+};
+
+#endif // URING_H
@@ -0,0 +1,141 @@
+#include "vclient.h"
+#include "latency.h"
+#include <algorithm>
+#include <chrono>
+#include <memory>
+
+// Конструктор
+VClient::VClient(
+    const std::string &address,
+    uint16_t port,
+    const std::string &login,
+    const std::string &password,
+    size_t connections,
+    const std::function<void(NetMan &)> &setup)
+    : address(address),
+      port(port),
+      login(login),
+      password(password),
+      setup(setup),
+      stopping(false)
+{
+    for (size_t i = 0; i < std::max<size_t>(1, connections); ++i)
+        this->workers.emplace_back(&VClient::work, this);
+}
+
+// Деструктор
+VClient::~VClient()
+{
+    {
+        std::lock_guard<std::mutex> lock(this->queue_mutex);
+        this->stopping = true;
+    }
+    this->queue_cv.notify_all();
+    for (auto &worker : this->workers)
+        worker.join();
+}
+
+// Метод для отправки векторов с обратным вызовом
+void VClient::submit(const std::vector<std::vector<int16_t>> &data, const Callback &callback)
+{
+    Request request;
+    request.data = &data;
+    request.callback = callback;
+    this->enqueue(std::move(request));
+}
+
+// Метод для отправки векторов с получением результатов через future
+std::future<std::vector<int16_t>> VClient::submit(std::vector<std::vector<int16_t>> data)
+{
+    std::shared_ptr<std::promise<std::vector<int16_t>>> promise(new std::promise<std::vector<int16_t>>());
+    std::future<std::vector<int16_t>> future = promise->get_future();
+
+    Request request;
+    request.owned = std::move(data);
+    request.data = nullptr;
+    request.callback = [promise](std::vector<int16_t> &results, std::exception_ptr error)
+    {
+        if (error)
+            promise->set_exception(error);
+        else
+            promise->set_value(std::move(results));
+    };
+    this->enqueue(std::move(request));
+    return future;
+}
+
+// Метод для синхронной передачи векторов
+std::vector<int16_t> VClient::calc(const std::vector<std::vector<int16_t>> &data)
+{
+    std::promise<std::vector<int16_t>> promise;
+    std::future<std::vector<int16_t>> future = promise.get_future();
+    this->submit(data, [&promise](std::vector<int16_t> &results, std::exception_ptr error)
+                 {
+        if (error)
+            promise.set_exception(error);
+        else
+            promise.set_value(std::move(results)); });
+    return future.get();
+}
+
+// Метод для добавления запроса в очередь
+void VClient::enqueue(Request &&request)
+{
+    {
+        std::lock_guard<std::mutex> lock(this->queue_mutex);
+        this->queue.push_back(std::move(request));
+    }
+    this->queue_cv.notify_one();
+}
+
+// Метод рабочего потока
+void VClient::work()
+{
+    NetMan net_man(this->address, this->port);
+    if (this->setup)
+        this->setup(net_man);
+    net_man.setVerbose(false);
+    bool connected = false;
+
+    for (;;)
+    {
+        Request request;
+        {
+            std::unique_lock<std::mutex> lock(this->queue_mutex);
+            this->queue_cv.wait(lock, [this]()
+                                { return this->stopping || !this->queue.empty(); });
+            if (this->queue.empty())
+                break;
+            request = std::move(this->queue.front());
+            this->queue.pop_front();
+        }
+
+        const std::vector<std::vector<int16_t>> &data = request.data ? *request.data : request.owned;
+        std::vector<int16_t> results;
+        std::exception_ptr error;
+        auto start = std::chrono::steady_clock::now();
+        try
+        {
+            // Подключение устанавливается при первом запросе и восстанавливается после ошибки
+            if (!connected)
+            {
+                net_man.close();
+                net_man.conn();
+                net_man.auth(this->login, this->password);
+                connected = true;
+            }
+            results.resize(data.size());
+            net_man.calc(data, results, 0, std::function<void(size_t, size_t)>());
+            LatencyStats::record(LatencyStats::JOB, std::chrono::steady_clock::now() - start);
+        }
+        catch (const std::exception &e)
+        {
+            if (dynamic_cast<const NetworkError *>(&e) || dynamic_cast<const AuthError *>(&e))
+                connected = false;
+            results.clear();
+            error = std::current_exception();
+        }
+        request.callback(results, error);
+    }
+    net_man.close();
+}
@@ -0,0 +1,125 @@
+#ifndef VCLIENT_H
+#define VCLIENT_H
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "netman.h"
+
+/**
+* @file vclient.h
+* @brief Определение программного интерфейса встраиваемой библиотеки клиента (libvclient).
+* @details Этот файл содержит определения методов для асинхронной передачи векторов серверу из памяти
+* вызывающего процесса без запуска исполняемого файла клиента и обмена через файлы.
+* @date 19.10.2026
+* @version 1.0
+* @authorsa Ягольницкий Р. С.
+*/
+
+/**
+* @brief Класс асинхронного клиента для встраивания в другие программы.
+* @details Запросы ставятся в общую очередь и выполняются рабочими потоками; каждый поток держит
+* собственное подключение, которое устанавливается при первом запросе и переиспользуется
+* между запросами. После сетевой ошибки или ошибки аутентификации подключение восстанавливается
+* при следующем запросе. Запросы одного подключения выполняются по порядку.
+*/
+class VClient
+{
+public:
+    /**
+    * @brief Тип функции обратного вызова.
+    * @details Вызывается в рабочем потоке. При ошибке error содержит исключение, а results пуст.
+    */
+    typedef std::function<void(std::vector<int16_t> &results, std::exception_ptr error)> Callback;
+
+    /**
+    * @brief Конструктор класса VClient.
+    * @param address Адрес сервера (IPv4 или unix:/path).
+    * @param port Порт сервера.
+    * @param login Логин.
+    * @param password Пароль.
+    * @param connections Количество подключений (рабочих потоков).
+    * @param setup Функция для настройки каждого NetMan перед подключением (режим передачи, повторы и т.д.).
+    */
+    VClient(
+        const std::string &address,
+        uint16_t port,
+        const std::string &login,
+        const std::string &password,
+        size_t connections = 1,
+        const std::function<void(NetMan &)> &setup = std::function<void(NetMan &)>());
+
+    /**
+    * @brief Деструктор класса VClient.
+    * @details Дожидается выполнения запросов из очереди и закрывает подключения.
+    */
+    ~VClient();
+
+    VClient(const VClient &) = delete;
+    VClient &operator=(const VClient &) = delete;
+
+    /**
+    * @brief Метод для отправки векторов без копирования с обратным вызовом.
+    * @param data Векторы; должны оставаться неизменными до вызова callback.
+    * @param callback Функция, получающая результаты или ошибку.
+    */
+    void submit(const std::vector<std::vector<int16_t>> &data, const Callback &callback);
+
+    /**
+    * @brief Метод для отправки векторов с получением результатов через future.
+    * @param data Векторы (перемещаются во владение запроса).
+    * @return Future с результатами; при ошибке get() выбрасывает исключение запроса.
+    */
+    std::future<std::vector<int16_t>> submit(std::vector<std::vector<int16_t>> data);
+
+    /**
+    * @brief Метод для синхронной передачи векторов.
+    * @param data Векторы.
+    * @return Результаты.
+    * @throw NetworkError Если исчерпаны повторные попытки.
+    * @throw AuthError Если сервер отклонил аутентификацию.
+    */
+    std::vector<int16_t> calc(const std::vector<std::vector<int16_t>> &data);
+
+private:
+    /**
+    * @brief Запрос в очереди.
+    */
+    struct Request
+    {
+        const std::vector<std::vector<int16_t>> *data; ///< Векторы запроса.
+        std::vector<std::vector<int16_t>> owned; ///< Векторы, принадлежащие запросу.
+        Callback callback; ///< Функция обратного вызова.
+    };
+
+    std::string address; ///< Адрес сервера.
+    uint16_t port; ///< Порт сервера.
+    std::string login; ///< Логин.
+    std::string password; ///< Пароль.
+    std::function<void(NetMan &)> setup; ///< Функция настройки подключений.
+    std::deque<Request> queue; ///< Очередь запросов.
+    std::mutex queue_mutex; ///< Мьютекс очереди.
+    std::condition_variable queue_cv; ///< Условная переменная очереди.
+    bool stopping; ///< Флаг завершения работы.
+    std::vector<std::thread> workers; ///< Рабочие потоки.
+
+    /**
+    * @brief Вспомогательный метод для добавления запроса в очередь.
+    * @param request Запрос.
+    */
+    void enqueue(Request &&request);
+
+    /**
+    * @brief Вспомогательный метод рабочего потока.
+    */
+    void work();
+};
+
+#endif // VCLIENT_H
@@ -0,0 +1,69 @@
+#ifndef VEC_GEN_H
+#define VEC_GEN_H
+
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <type_traits>
+#include <vector>
+
+/**
+* @file vecgen.h
+* @brief Определение генератора случайных векторов.
+* @details Этот файл содержит генератор значений во всем диапазоне типа данных, которым filer заполняет
+* входные файлы, а генератор нагрузки клиента - векторы в памяти.
+* @date 19.10.2026
+* @version 1.0
+* @authorsa Ягольницкий Р. С.
+*/
+
+/**
+* @brief Генератор случайных векторов.
+* @details Значения равномерно распределены по всему диапазону типа: целые получаются усечением
+* 64-битного значения, значения с плавающей точкой выбираются из [lowest(), max()) типа.
+*/
+class VecGen
+{
+public:
+    /**
+    * @brief Конструктор класса VecGen.
+    * @param seed Начальное значение генератора.
+    */
+    explicit VecGen(uint64_t seed = std::random_device()())
+        : gen(seed) {}
+
+    /**
+    * @brief Метод для получения случайного значения в диапазоне типа данных.
+    * @tparam T Тип значения.
+    * @return Случайное значение.
+    */
+    template <typename T>
+    T value()
+    {
+        if (std::is_integral<T>::value)
+            return static_cast<T>(this->int_dis(this->gen));
+
+        // Половина диапазона удваивается, чтобы ширина распределения не превышала максимум double
+        std::uniform_real_distribution<double> dis(std::numeric_limits<T>::lowest() / 2, std::numeric_limits<T>::max() / 2);
+        return static_cast<T>(2 * dis(this->gen));
+    }
+
+    /**
+    * @brief Метод для заполнения вектора случайными значениями.
+    * @tparam T Тип значения.
+    * @param vec Вектор (заполняется на всю длину).
+    */
+    template <typename T>
+    void fill(std::vector<T> &vec)
+    {
+        for (auto &v : vec)
+            v = this->value<T>();
+    }
+
+private:
+    std::mt19937_64 gen; ///< Генератор псевдослучайных чисел.
+    std::uniform_int_distribution<int64_t> int_dis{
+        std::numeric_limits<int64_t>::min(), std::numeric_limits<int64_t>::max()}; ///< Распределение целых значений.
+};
+
+#endif // VEC_GEN_H
@@ -0,0 +1,226 @@
+#include "vecindex.h"
+#include <fstream>
+#include <sys/stat.h>
+
+const uint32_t VecIndex::MAGIC = 0x58444956;
+const uint8_t VecIndex::FORMAT_TEXT;
+const uint8_t VecIndex::FORMAT_BINARY;
+
+// Версия формата файла индекса (2 - с временем изменения индексируемого файла)
+static const uint8_t INDEX_VERSION = 2;
+// Раскладка смещений: таблица или постоянный шаг
+static const uint8_t LAYOUT_TABLE = 0;
+static const uint8_t LAYOUT_STRIDE = 1;
+
+// Конструктор
+VecIndex::VecIndex(uint8_t format, uint8_t value_size)
+    : data_format(format), value_size(value_size), vectors(0), data_size(0), data_mtime(0), base(0), stride(0) {}
+
+// Время изменения файла в наносекундах (0, если файл недоступен)
+static uint64_t modifiedAt(const std::string &input, uint64_t *size = nullptr)
+{
+    struct stat st;
+    if (::stat(input.c_str(), &st) != 0)
+        return 0;
+    if (size)
+        *size = st.st_size;
+    return static_cast<uint64_t>(st.st_mtim.tv_sec) * 1000000000 + st.st_mtim.tv_nsec;
+}
+
+std::string VecIndex::path(const std::string &input)
+{
+    return input + ".idx";
+}
+
+uint32_t VecIndex::count() const
+{
+    return this->vectors;
+}
+
+uint8_t VecIndex::format() const
+{
+    return this->data_format;
+}
+
+uint8_t VecIndex::valueSize() const
+{
+    return this->value_size;
+}
+
+uint64_t VecIndex::recordSize() const
+{
+    return this->stride;
+}
+
+// Метод для получения смещения вектора
+uint64_t VecIndex::offset(uint32_t i) const
+{
+    if (i >= this->vectors)
+        return this->data_size;
+    return this->stride ? this->base + i * this->stride : this->offsets[i];
+}
+
+// Метод для добавления смещения очередного вектора
+void VecIndex::add(uint64_t offset)
+{
+    this->offsets.push_back(offset);
+    ++this->vectors;
+}
+
+// Метод для завершения построения индекса
+void VecIndex::finish(uint64_t data_size)
+{
+    this->data_size = data_size;
+    this->stride = 0;
+    if (this->vectors == 0)
+        return;
+
+    // Постоянный шаг проверяется до конца файла, чтобы последняя запись тоже имела ту же длину
+    uint64_t step = data_size - this->offsets.back();
+    for (uint32_t i = 1; i < this->vectors && step; ++i)
+        if (this->offsets[i] - this->offsets[i - 1] != step)
+            step = 0;
+    if (step && this->data_format == FORMAT_BINARY)
+    {
+        this->base = this->offsets.front();
+        this->stride = step;
+        std::vector<uint64_t>().swap(this->offsets);
+    }
+}
+
+// Метод для запоминания времени изменения индексируемого файла
+void VecIndex::stamp(const std::string &input)
+{
+    this->data_mtime = modifiedAt(input);
+}
+
+// Метод для сохранения индекса
+void VecIndex::save(const std::string &path) const
+{
+    std::ofstream index_file(path, std::ios::binary);
+    if (!index_file.is_open())
+    {
+        throw FileNotFoundError(
+            "Failed to open index file \"" + path + "\"",
+            "VecIndex.save()");
+    }
+
+    uint8_t layout = this->stride ? LAYOUT_STRIDE : LAYOUT_TABLE;
+    uint8_t header[4] = {INDEX_VERSION, this->data_format, this->value_size, layout};
+    index_file.write(reinterpret_cast<const char *>(&MAGIC), sizeof(MAGIC));
+    index_file.write(reinterpret_cast<const char *>(header), sizeof(header));
+    index_file.write(reinterpret_cast<const char *>(&this->vectors), sizeof(this->vectors));
+    index_file.write(reinterpret_cast<const char *>(&this->data_size), sizeof(this->data_size));
+    index_file.write(reinterpret_cast<const char *>(&this->data_mtime), sizeof(this->data_mtime));
+    if (this->stride)
+    {
+        index_file.write(reinterpret_cast<const char *>(&this->base), sizeof(this->base));
+        index_file.write(reinterpret_cast<const char *>(&this->stride), sizeof(this->stride));
+    }
+    else
+        index_file.write(reinterpret_cast<const char *>(this->offsets.data()), this->offsets.size() * sizeof(uint64_t));
+
+    if (!index_file)
+    {
+        throw FileNotFoundError(
+            "Failed to write index file \"" + path + "\"",
+            "VecIndex.save()");
+    }
+}
+
+// Метод для загрузки индекса
+bool VecIndex::load(const std::string &input)
+{
+    std::ifstream index_file(path(input), std::ios::binary);
+    if (!index_file.is_open())
+        return false;
+
+    uint32_t magic = 0;
+    uint8_t header[4] = {0, 0, 0, 0};
+    index_file.read(reinterpret_cast<char *>(&magic), sizeof(magic));
+    index_file.read(reinterpret_cast<char *>(header), sizeof(header));
+    index_file.read(reinterpret_cast<char *>(&this->vectors), sizeof(this->vectors));
+    index_file.read(reinterpret_cast<char *>(&this->data_size), sizeof(this->data_size));
+    index_file.read(reinterpret_cast<char *>(&this->data_mtime), sizeof(this->data_mtime));
+    if (!index_file || magic != MAGIC || header[0] != INDEX_VERSION || this->vectors > this->data_size)
+        throw InvalidDataFormatError("Invalid index file \"" + path(input) + "\"", "VecIndex.load()");
+    this->data_format = header[1];
+    this->value_size = header[2];
+
+    this->stride = 0;
+    this->offsets.clear();
+    if (header[3] == LAYOUT_STRIDE)
+    {
+        index_file.read(reinterpret_cast<char *>(&this->base), sizeof(this->base));
+        index_file.read(reinterpret_cast<char *>(&this->stride), sizeof(this->stride));
+    }
+    else
+    {
+        this->offsets.resize(this->vectors);
+        index_file.read(reinterpret_cast<char *>(this->offsets.data()), this->offsets.size() * sizeof(uint64_t));
+    }
+    if (!index_file)
+        throw InvalidDataFormatError("Truncated index file \"" + path(input) + "\"", "VecIndex.load()");
+
+    // Индекс устаревает, если входной файл был перезаписан, даже с прежним размером
+    uint64_t size = 0;
+    uint64_t mtime = modifiedAt(input, &size);
+    if (mtime == 0 || size != this->data_size || mtime != this->data_mtime)
+        throw InvalidDataFormatError("Stale index file \"" + path(input) + "\"", "VecIndex.load()");
+    return true;
+}
+
+// Метод для построения индекса существующего файла
+VecIndex VecIndex::build(const std::string &input, uint8_t format, uint8_t value_size)
+{
+    std::ifstream input_file(input, std::ios::binary);
+    if (!input_file.is_open())
+    {
+        throw FileNotFoundError(
+            "Failed to open input file \"" + input + "\"",
+            "VecIndex.build()");
+    }
+
+    VecIndex index(format, value_size);
+    uint32_t num_vectors = 0;
+    if (format == FORMAT_BINARY)
+        input_file.read(reinterpret_cast<char *>(&num_vectors), sizeof(num_vectors));
+    else
+        input_file >> num_vectors;
+    if (!input_file)
+        throw InvalidDataFormatError("Missing vector count", "VecIndex.build()");
+
+    // Один проход: в двоичном файле значения пропускаются по размеру, в текстовом - по пробелам
+    std::string token;
+    for (uint32_t i = 0; i < num_vectors; ++i)
+    {
+        // В текстовом файле смещение указывает на начало поля размера, как при записи в filer
+        if (format == FORMAT_TEXT)
+            input_file >> std::ws;
+        index.add(input_file.tellg());
+        uint32_t vector_size = 0;
+        if (format == FORMAT_BINARY)
+        {
+            input_file.read(reinterpret_cast<char *>(&vector_size), sizeof(vector_size));
+            input_file.seekg(static_cast<std::streamoff>(vector_size) * value_size, std::ios::cur);
+        }
+        else
+        {
+            input_file >> vector_size;
+            // Значения только пропускаются: целые любой ширины и числа с плавающей точкой
+            for (uint32_t j = 0; j < vector_size && input_file; ++j)
+                input_file >> token;
+        }
+        if (!input_file)
+            throw InvalidDataFormatError("Truncated vector " + std::to_string(i), "VecIndex.build()");
+    }
+
+    // Пропуск значений двоичного файла за его концом не вызывает ошибку потока, поэтому конец проверяется отдельно
+    struct stat st;
+    ::stat(input.c_str(), &st);
+    if (format == FORMAT_BINARY && static_cast<uint64_t>(input_file.tellg()) > static_cast<uint64_t>(st.st_size))
+        throw InvalidDataFormatError("Truncated vector " + std::to_string(num_vectors - 1), "VecIndex.build()");
+    index.finish(st.st_size);
+    index.stamp(input);
+    return index;
+}
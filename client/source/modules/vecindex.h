@@ -0,0 +1,140 @@
+#ifndef VEC_INDEX_H
+#define VEC_INDEX_H
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include "errors.h"
+
+/**
+* @file vecindex.h
+* @brief Определение класса индекса смещений векторов во входном файле.
+* @details Этот файл содержит определения методов для построения, сохранения и загрузки
+* файла-спутника PATH.idx, в котором хранится смещение каждого вектора входного файла.
+* Индекс позволяет начинать чтение с любого вектора без последовательного прохода по файлу.
+* @date 19.10.2026
+* @version 1.0
+* @authorsa Ягольницкий Р. С.
+*/
+
+/**
+* @brief Класс индекса смещений векторов.
+* @details Формат файла индекса: сигнатура "VIDX", версия, формат данных (текстовый или двоичный),
+* размер значения в байтах, раскладка, количество векторов, размер и время изменения
+* индексируемого файла и смещения. Если все записи двоичного файла имеют одинаковую длину (как у файлов filer), хранятся
+* только смещение первой записи и шаг; иначе хранится таблица смещений по 8 байт на вектор.
+* Смещение указывает на поле размера вектора.
+*/
+class VecIndex
+{
+public:
+    static const uint32_t MAGIC; ///< Сигнатура файла индекса ("VIDX").
+    static const uint8_t FORMAT_TEXT = 0; ///< Текстовый входной файл.
+    static const uint8_t FORMAT_BINARY = 1; ///< Двоичный входной файл.
+
+    /**
+    * @brief Конструктор класса VecIndex.
+    * @param format Формат индексируемого файла (FORMAT_TEXT или FORMAT_BINARY).
+    * @param value_size Размер значения в байтах (для двоичного формата).
+    */
+    VecIndex(uint8_t format = FORMAT_TEXT, uint8_t value_size = sizeof(int16_t));
+
+    /**
+    * @brief Статический метод для получения пути к файлу индекса.
+    * @param input Путь к индексируемому файлу.
+    * @return Путь к файлу индекса (PATH.idx).
+    */
+    static std::string path(const std::string &input);
+
+    /**
+    * @brief Метод для добавления смещения очередного вектора при построении индекса.
+    * @param offset Смещение поля размера вектора в файле.
+    */
+    void add(uint64_t offset);
+
+    /**
+    * @brief Метод для завершения построения индекса.
+    * @details Если шаг между записями постоянный, таблица смещений заменяется шагом.
+    * @param data_size Размер индексируемого файла в байтах.
+    */
+    void finish(uint64_t data_size);
+
+    /**
+    * @brief Метод для запоминания времени изменения индексируемого файла.
+    * @details Вызывается после того, как файл полностью записан; load() отклоняет индекс,
+    * если файл с тех пор изменялся.
+    * @param input Путь к индексируемому файлу.
+    */
+    void stamp(const std::string &input);
+
+    /**
+    * @brief Метод для сохранения индекса в файл.
+    * @param path Путь к файлу индекса.
+    * @throw FileNotFoundError Если не удалось записать файл.
+    */
+    void save(const std::string &path) const;
+
+    /**
+    * @brief Метод для загрузки индекса для входного файла.
+    * @param input Путь к индексируемому файлу (индекс читается из PATH.idx).
+    * @return false, если файла индекса нет.
+    * @throw InvalidDataFormatError Если индекс поврежден или не соответствует размеру
+    * или времени изменения входного файла.
+    */
+    bool load(const std::string &input);
+
+    /**
+    * @brief Статический метод для построения индекса существующего файла за один проход.
+    * @param input Путь к индексируемому файлу.
+    * @param format Формат файла (FORMAT_TEXT или FORMAT_BINARY).
+    * @param value_size Размер значения в байтах (для двоичного формата).
+    * @return Индекс файла.
+    * @throw FileNotFoundError Если не удалось открыть файл.
+    * @throw InvalidDataFormatError Если файл обрывается посреди вектора.
+    */
+    static VecIndex build(const std::string &input, uint8_t format, uint8_t value_size = sizeof(int16_t));
+
+    /**
+    * @brief Метод для получения количества векторов.
+    * @return Количество векторов.
+    */
+    uint32_t count() const;
+
+    /**
+    * @brief Метод для получения смещения вектора.
+    * @param i Индекс вектора (i == count() - конец данных).
+    * @return Смещение поля размера вектора в файле.
+    */
+    uint64_t offset(uint32_t i) const;
+
+    /**
+    * @brief Метод для получения формата индексируемого файла.
+    * @return FORMAT_TEXT или FORMAT_BINARY.
+    */
+    uint8_t format() const;
+
+    /**
+    * @brief Метод для получения размера значения.
+    * @return Размер значения в байтах.
+    */
+    uint8_t valueSize() const;
+
+    /**
+    * @brief Метод для получения постоянного шага между записями.
+    * @return Размер записи в байтах (0 - записи разной длины, используется таблица смещений).
+    */
+    uint64_t recordSize() const;
+
+private:
+    uint8_t data_format; ///< Формат индексируемого файла.
+    uint8_t value_size; ///< Размер значения в байтах.
+    uint32_t vectors; ///< Количество векторов.
+    uint64_t data_size; ///< Размер индексируемого файла.
+    uint64_t data_mtime; ///< Время изменения индексируемого файла в наносекундах.
+    uint64_t base; ///< Смещение первой записи (раскладка с постоянным шагом).
+    uint64_t stride; ///< Шаг между записями (0 - используется таблица смещений).
+    std::vector<uint64_t> offsets; ///< Таблица смещений.
+};
+
+#endif // VEC_INDEX_H
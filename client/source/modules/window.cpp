@@ -0,0 +1,146 @@
+#include "window.h"
+#include <algorithm>
+
+// Начальный размер окна в векторах
+static const size_t INITIAL_WINDOW = 16;
+// Минимальный прирост скорости, оправдывающий увеличение окна
+static const double GAIN_THRESHOLD = 1.10;
+// Доля лучшей скорости, ниже которой окно уменьшается
+static const double LOSS_THRESHOLD = 0.70;
+// Период зондирования больших окон после медленного старта
+static const uint64_t PROBE_PERIOD = 8;
+
+// Конструктор
+WindowControl::WindowControl(size_t max_vectors, size_t max_bytes)
+    : max_vectors(max_vectors),
+      max_bytes(max_bytes),
+      window(INITIAL_WINDOW),
+      best_window(INITIAL_WINDOW),
+      best_rate(0),
+      min_rtt(0),
+      slow_start(true),
+      fixed(false),
+      windows(0) {}
+
+void WindowControl::setFixed(size_t window)
+{
+    this->fixed = window > 0;
+    this->window = this->fixed ? window : INITIAL_WINDOW;
+}
+
+// Метод для определения границы следующего окна
+size_t WindowControl::next(const std::vector<std::vector<int16_t>> &data, size_t begin,
+                           const std::vector<size_t> *order) const
+{
+    size_t end = std::min(order ? order->size() : data.size(), begin + this->window);
+    if (this->fixed)
+        return end;
+
+    // Ограничение объема окна в байтах (хотя бы один вектор)
+    size_t bytes = 0;
+    for (size_t i = begin; i < end; ++i)
+    {
+        bytes += sizeof(uint32_t) + data[order ? (*order)[i] : i].size() * sizeof(int16_t);
+        if (bytes > this->max_bytes && i > begin)
+            return i;
+    }
+    return end;
+}
+
+// Метод для определения границы следующего окна по индексу смещений
+size_t WindowControl::next(const VecIndex &index, size_t begin) const
+{
+    size_t end = std::min<size_t>(index.count(), begin + this->window);
+    if (this->fixed)
+        return end;
+
+    // Смещения возрастают, поэтому граница по объему находится двоичным поиском (хотя бы один вектор)
+    uint64_t limit = index.offset(begin) + this->max_bytes;
+    size_t lo = begin + 1;
+    size_t hi = end;
+    while (lo < hi)
+    {
+        size_t mid = lo + (hi - lo + 1) / 2;
+        if (index.offset(mid) <= limit)
+            lo = mid;
+        else
+            hi = mid - 1;
+    }
+    return std::min(lo, end);
+}
+
+// Метод для учета измерений переданного окна
+void WindowControl::update(size_t vectors, size_t bytes, double seconds)
+{
+    if (this->fixed || seconds <= 0)
+        return;
+
+    ++this->windows;
+    if (this->min_rtt == 0 || seconds < this->min_rtt)
+        this->min_rtt = seconds;
+
+    double rate = bytes / seconds;
+    if (vectors < this->window && vectors > 0)
+    {
+        if (bytes + bytes / vectors > this->max_bytes)
+        {
+            // Окно ограничено объемом в байтах: регулирование продолжается от фактически
+            // переданного количества векторов, иначе окно не смогло бы ни вырасти, ни уменьшиться
+            this->window = vectors;
+        }
+        else if (vectors * 2 >= this->window)
+        {
+            // Последнее окно задания: скорость пересчитывается на полное окно по доле векторов в пути
+            rate *= double(this->window) / vectors;
+        }
+        else
+        {
+            // Короткий остаток задания не характеризует канал
+            return;
+        }
+    }
+    if (rate > this->best_rate * GAIN_THRESHOLD)
+    {
+        this->best_rate = rate;
+        this->best_window = this->window;
+        this->window += this->slow_start ? this->window : this->window / 4;
+    }
+    else if (this->slow_start)
+    {
+        // Насыщение канала: возврат к лучшему окну
+        this->slow_start = false;
+        this->window = this->best_window;
+    }
+    else if (rate < this->best_rate * LOSS_THRESHOLD)
+    {
+        // Ухудшение канала: уменьшение окна и сброс эталонной скорости
+        this->window -= this->window / 4;
+        this->best_window = this->window;
+        this->best_rate = rate;
+    }
+    else if (this->windows % PROBE_PERIOD == 0)
+    {
+        // Периодическое зондирование: эталон слегка занижается, чтобы увеличение окна было принято
+        this->best_rate *= 0.95;
+        this->window += this->window / 8 + 1;
+    }
+    else
+        this->window = this->best_window;
+
+    this->window = std::max<size_t>(1, std::min(this->window, this->max_vectors));
+}
+
+size_t WindowControl::getWindow() const
+{
+    return this->window;
+}
+
+double WindowControl::getMinRtt() const
+{
+    return this->min_rtt;
+}
+
+double WindowControl::getBestRate() const
+{
+    return this->best_rate;
+}
@@ -0,0 +1,101 @@
+#ifndef WINDOW_CONTROL_H
+#define WINDOW_CONTROL_H
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include "vecindex.h"
+
+/**
+* @file window.h
+* @brief Определение класса для адаптивного выбора размера окна передачи.
+* @details Этот файл содержит определения методов для подбора количества векторов, одновременно
+* находящихся в пути, по измеренным времени оборота и скорости передачи каждого окна.
+* @date 19.10.2026
+* @version 1.0
+* @authorsa Ягольницкий Р. С.
+*/
+
+/**
+* @brief Класс для адаптивного управления окном передачи векторов.
+* @details Окно удваивается, пока это увеличивает скорость передачи хотя бы на 10%
+* (медленный старт), затем остается у лучшего найденного значения и периодически
+* зондирует большие окна. При заметном падении скорости окно уменьшается.
+* Размер окна ограничен по количеству векторов и байт.
+*/
+class WindowControl
+{
+public:
+    /**
+    * @brief Конструктор класса WindowControl.
+    * @param max_vectors Максимальное количество векторов в окне.
+    * @param max_bytes Максимальный объем данных окна в байтах.
+    */
+    WindowControl(size_t max_vectors = 32768, size_t max_bytes = 4 << 20);
+
+    /**
+    * @brief Метод для задания фиксированного размера окна.
+    * @param window Размер окна в векторах (0 - адаптивный режим).
+    */
+    void setFixed(size_t window);
+
+    /**
+    * @brief Метод для определения границы следующего окна.
+    * @param data Все векторы задания.
+    * @param begin Индекс первого вектора окна.
+    * @param order Номера векторов в data, по которым отсчитываются begin и граница окна (nullptr - векторы data подряд).
+    * @return Индекс за последним вектором окна.
+    */
+    size_t next(const std::vector<std::vector<int16_t>> &data, size_t begin,
+                const std::vector<size_t> *order = nullptr) const;
+
+    /**
+    * @brief Метод для определения границы следующего окна по индексу смещений входного файла.
+    * @param index Индекс смещений файла.
+    * @param begin Индекс первого вектора окна.
+    * @return Индекс за последним вектором окна.
+    */
+    size_t next(const VecIndex &index, size_t begin) const;
+
+    /**
+    * @brief Метод для учета измерений переданного окна.
+    * @details Окно, ограниченное объемом в байтах, учитывается как окно из фактически переданных
+    * векторов. Неполное последнее окно задания учитывается, если в пути была хотя бы половина окна,
+    * со скоростью, пересчитанной на полное окно.
+    * @param vectors Количество векторов окна.
+    * @param bytes Количество переданных байт.
+    * @param seconds Время от начала отправки до получения последнего результата.
+    */
+    void update(size_t vectors, size_t bytes, double seconds);
+
+    /**
+    * @brief Метод для получения текущего размера окна.
+    * @return Размер окна в векторах.
+    */
+    size_t getWindow() const;
+
+    /**
+    * @brief Метод для получения минимального измеренного времени оборота окна.
+    * @return Время в секундах.
+    */
+    double getMinRtt() const;
+
+    /**
+    * @brief Метод для получения лучшей измеренной скорости передачи.
+    * @return Скорость в байтах в секунду.
+    */
+    double getBestRate() const;
+
+private:
+    size_t max_vectors; ///< Максимальное количество векторов в окне.
+    size_t max_bytes; ///< Максимальный объем данных окна.
+    size_t window; ///< Текущий размер окна.
+    size_t best_window; ///< Размер окна с лучшей скоростью.
+    double best_rate; ///< Лучшая измеренная скорость передачи.
+    double min_rtt; ///< Минимальное время оборота окна.
+    bool slow_start; ///< Флаг фазы медленного старта.
+    bool fixed; ///< Флаг фиксированного размера окна.
+    uint64_t windows; ///< Количество учтенных окон.
+};
+
+#endif // WINDOW_CONTROL_H
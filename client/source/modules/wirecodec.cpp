@@ -0,0 +1,180 @@
+#include "wirecodec.h"
+#include <lz4.h>
+
+// Количество неудачных попыток сжатия, после которого LZ4 пробуется реже
+static const uint32_t LZ4_MAX_MISSES = 4;
+// Период пробного сжатия после серии неудач
+static const uint64_t LZ4_PROBE_PERIOD = 16;
+
+const uint32_t WireCodec::MAGIC;
+const uint8_t WireCodec::FLAG_RAW;
+const uint8_t WireCodec::FLAG_LZ4;
+
+// Конструктор
+WireCodec::WireCodec()
+    : raw_bytes(0), wire_bytes(0), lz4_frames(0), lz4_misses(0), frame_no(0) {}
+
+// Метод для записи числа в формате varint
+void WireCodec::putVarint(std::vector<uint8_t> &out, uint32_t value)
+{
+    while (value >= 0x80)
+    {
+        out.push_back(static_cast<uint8_t>(value | 0x80));
+        value >>= 7;
+    }
+    out.push_back(static_cast<uint8_t>(value));
+}
+
+// Метод для чтения числа в формате varint
+uint32_t WireCodec::getVarint(const uint8_t *&pos, const uint8_t *end)
+{
+    uint32_t value = 0;
+    for (int shift = 0; shift < 35; shift += 7)
+    {
+        if (pos == end)
+            throw InvalidDataFormatError("Truncated varint", "WireCodec.getVarint()");
+        uint8_t byte = *pos++;
+        value |= static_cast<uint32_t>(byte & 0x7F) << shift;
+        if (!(byte & 0x80))
+            return value;
+    }
+    throw InvalidDataFormatError("Varint is too long", "WireCodec.getVarint()");
+}
+
+// Метод для кодирования пакета векторов
+void WireCodec::encode(
+    const std::vector<std::vector<int16_t>> &data,
+    size_t begin,
+    size_t end,
+    std::vector<uint8_t> &frame,
+    const std::vector<size_t> *order)
+{
+    this->plain.clear();
+    putVarint(this->plain, end - begin);
+    for (size_t i = begin; i < end; ++i)
+    {
+        const std::vector<int16_t> &vec = data[order ? (*order)[i] : i];
+        putVarint(this->plain, vec.size());
+        int32_t prev = 0;
+        for (int16_t val : vec)
+        {
+            // Разность соседних значений в zigzag-представлении
+            int32_t delta = static_cast<int32_t>(val) - prev;
+            putVarint(this->plain, (static_cast<uint32_t>(delta) << 1) ^ static_cast<uint32_t>(delta >> 31));
+            prev = val;
+        }
+        this->raw_bytes += sizeof(uint32_t) + vec.size() * sizeof(int16_t);
+    }
+
+    // Пробное сжатие LZ4 с учетом истории коэффициента сжатия
+    ++this->frame_no;
+    bool use_lz4 = false;
+    int packed_size = 0;
+    if (this->lz4_misses < LZ4_MAX_MISSES || this->frame_no % LZ4_PROBE_PERIOD == 0)
+    {
+        this->packed.resize(LZ4_compressBound(this->plain.size()));
+        packed_size = LZ4_compress_default(
+            reinterpret_cast<const char *>(this->plain.data()),
+            this->packed.data(),
+            this->plain.size(),
+            this->packed.size());
+        use_lz4 = packed_size > 0 && packed_size * 10 < static_cast<int>(this->plain.size()) * 9;
+        this->lz4_misses = use_lz4 ? 0 : this->lz4_misses + 1;
+    }
+
+    frame.clear();
+    frame.push_back(use_lz4 ? FLAG_LZ4 : FLAG_RAW);
+    putVarint(frame, this->plain.size());
+    if (use_lz4)
+    {
+        putVarint(frame, packed_size);
+        frame.insert(frame.end(), this->packed.begin(), this->packed.begin() + packed_size);
+        ++this->lz4_frames;
+    }
+    else
+    {
+        putVarint(frame, this->plain.size());
+        frame.insert(frame.end(), this->plain.begin(), this->plain.end());
+    }
+    this->wire_bytes += frame.size();
+}
+
+// Метод для декодирования пакета векторов
+std::vector<std::vector<int16_t>> WireCodec::decode(const uint8_t *frame, size_t size)
+{
+    const uint8_t *pos = frame;
+    const uint8_t *end = frame + size;
+    if (pos == end)
+        throw InvalidDataFormatError("Empty frame", "WireCodec.decode()");
+
+    uint8_t flag = *pos++;
+    uint32_t plain_size = getVarint(pos, end);
+    uint32_t payload_size = getVarint(pos, end);
+    if (payload_size > static_cast<size_t>(end - pos))
+        throw InvalidDataFormatError("Truncated frame payload", "WireCodec.decode()");
+
+    std::vector<uint8_t> plain;
+    if (flag == FLAG_LZ4)
+    {
+        plain.resize(plain_size);
+        int ret = LZ4_decompress_safe(
+            reinterpret_cast<const char *>(pos),
+            reinterpret_cast<char *>(plain.data()),
+            payload_size,
+            plain_size);
+        if (ret < 0 || static_cast<uint32_t>(ret) != plain_size)
+            throw InvalidDataFormatError("Failed to decompress frame", "WireCodec.decode()");
+    }
+    else if (flag == FLAG_RAW && payload_size == plain_size)
+        plain.assign(pos, pos + payload_size);
+    else
+        throw InvalidDataFormatError("Unknown frame flag", "WireCodec.decode()");
+
+    pos = plain.data();
+    end = plain.data() + plain.size();
+    uint32_t count = getVarint(pos, end);
+    // Каждый вектор занимает хотя бы один байт
+    if (count > static_cast<size_t>(end - pos))
+        throw InvalidDataFormatError("Invalid vector count", "WireCodec.decode()");
+
+    std::vector<std::vector<int16_t>> data(count);
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        uint32_t vec_size = getVarint(pos, end);
+        if (vec_size > static_cast<size_t>(end - pos))
+            throw InvalidDataFormatError("Invalid vector size", "WireCodec.decode()");
+        data[i].resize(vec_size);
+        int32_t prev = 0;
+        for (uint32_t j = 0; j < vec_size; ++j)
+        {
+            uint32_t zz = getVarint(pos, end);
+            int32_t delta = static_cast<int32_t>(zz >> 1) ^ -static_cast<int32_t>(zz & 1);
+            prev += delta;
+            data[i][j] = static_cast<int16_t>(prev);
+        }
+    }
+    return data;
+}
+
+uint64_t WireCodec::getRawBytes() const
+{
+    return this->raw_bytes;
+}
+
+uint64_t WireCodec::getWireBytes() const
+{
+    return this->wire_bytes;
+}
+
+uint64_t WireCodec::getLz4Frames() const
+{
+    return this->lz4_frames;
+}
+
+// Метод для сброса статистики кодирования
+void WireCodec::resetStats()
+{
+    this->raw_bytes = 0;
+    this->wire_bytes = 0;
+    this->lz4_frames = 0;
+}
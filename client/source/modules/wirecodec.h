@@ -0,0 +1,110 @@
+#ifndef WIRE_CODEC_H
+#define WIRE_CODEC_H
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include "errors.h"
+
+/**
+* @file wirecodec.h
+* @brief Определение класса для компактного кодирования векторов при передаче по сети.
+* @details Этот файл содержит определения методов для кодирования пакетов векторов
+* (varint-размеры, дельта- и zigzag-кодирование значений, блочное сжатие LZ4) и их декодирования.
+* @date 19.10.2026
+* @version 1.0
+* @authorsa Ягольницкий Р. С.
+*/
+
+/**
+* @brief Класс для кодирования и декодирования пакетов векторов в компактном формате.
+* @details Формат пакета: флаг (1 байт), varint длины несжатых данных, varint длины полезной нагрузки,
+* полезная нагрузка. Несжатые данные: varint количества векторов, затем для каждого вектора
+* varint размера и zigzag-varint разностей соседних значений.
+*/
+class WireCodec
+{
+public:
+    static const uint32_t MAGIC = 0x45524957; ///< Сигнатура запроса компактного режима ("WIRE").
+    static const uint8_t FLAG_RAW = 0; ///< Полезная нагрузка не сжата.
+    static const uint8_t FLAG_LZ4 = 1; ///< Полезная нагрузка сжата LZ4.
+
+    /**
+    * @brief Конструктор класса WireCodec.
+    */
+    WireCodec();
+
+    /**
+    * @brief Метод для кодирования пакета векторов.
+    * @details Сжатие LZ4 применяется, только если оно уменьшает пакет хотя бы на 10%;
+    * после серии неудачных попыток оно пробуется лишь для каждого 16-го пакета.
+    * @param data Все векторы задания.
+    * @param begin Индекс первого вектора пакета.
+    * @param end Индекс за последним вектором пакета.
+    * @param frame Буфер для закодированного пакета.
+    * @param order Номера векторов в data, по которым отсчитываются begin и end (nullptr - векторы data подряд).
+    */
+    void encode(const std::vector<std::vector<int16_t>> &data, size_t begin, size_t end, std::vector<uint8_t> &frame,
+                const std::vector<size_t> *order = nullptr);
+
+    /**
+    * @brief Статический метод для декодирования пакета векторов.
+    * @param frame Закодированный пакет.
+    * @param size Размер пакета в байтах.
+    * @return Векторы пакета.
+    * @throw InvalidDataFormatError Если пакет поврежден.
+    */
+    static std::vector<std::vector<int16_t>> decode(const uint8_t *frame, size_t size);
+
+    /**
+    * @brief Статический метод для записи числа в формате varint.
+    * @param out Буфер для записи.
+    * @param value Число.
+    */
+    static void putVarint(std::vector<uint8_t> &out, uint32_t value);
+
+    /**
+    * @brief Статический метод для чтения числа в формате varint.
+    * @param pos Текущая позиция чтения, сдвигается за прочитанное число.
+    * @param end Конец буфера.
+    * @return Прочитанное число.
+    * @throw InvalidDataFormatError Если число обрезано или слишком длинное.
+    */
+    static uint32_t getVarint(const uint8_t *&pos, const uint8_t *end);
+
+    /**
+    * @brief Метод для получения количества байт до кодирования (в сыром формате).
+    * @return Количество байт.
+    */
+    uint64_t getRawBytes() const;
+
+    /**
+    * @brief Метод для получения количества закодированных байт.
+    * @return Количество байт.
+    */
+    uint64_t getWireBytes() const;
+
+    /**
+    * @brief Метод для получения количества пакетов, сжатых LZ4.
+    * @return Количество пакетов.
+    */
+    uint64_t getLz4Frames() const;
+
+    /**
+    * @brief Метод для сброса статистики кодирования перед новым заданием.
+    * @details Буферы кодировщика сохраняются, поэтому последующие задания не выделяют память заново.
+    */
+    void resetStats();
+
+private:
+    std::vector<uint8_t> plain; ///< Буфер несжатой полезной нагрузки.
+    std::vector<char> packed; ///< Буфер сжатой полезной нагрузки.
+    uint64_t raw_bytes; ///< Количество байт в сыром формате.
+    uint64_t wire_bytes; ///< Количество закодированных байт.
+    uint64_t lz4_frames; ///< Количество пакетов, сжатых LZ4.
+    uint32_t lz4_misses; ///< Количество подряд неудачных попыток сжатия.
+    uint64_t frame_no; ///< Номер текущего пакета.
+};
+
+#endif // WIRE_CODEC_H
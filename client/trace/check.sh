@@ -0,0 +1,41 @@
+#!/bin/sh
+# Проверки точек трассировки: с -DVCLIENT_NO_PROBES модули собираются без записей .note.stapsdt,
+# а сценарии bpftrace ссылаются только на существующие точки провайдера vclient.
+# Переменные окружения CXX и CXXFLAGS задают компилятор и флаги (например, пути к заголовкам).
+set -e
+TRACE_DIR="$(cd "$(dirname "$0")" && pwd)"
+MODULES_DIR="$TRACE_DIR/../source/modules"
+CXX="${CXX:-g++}"
+WORK="$(mktemp -d)"
+trap 'rm -rf "$WORK"' EXIT
+
+fail() {
+    echo "CHECK FAILED: $1"
+    exit 1
+}
+
+# Модули с точками трассировки
+SOURCES=$(grep -l '#include "probes.h"' "$MODULES_DIR"/*.cpp)
+
+for src in $SOURCES; do
+    name=$(basename "$src" .cpp)
+    # Отключенные точки раскрываются в пустые операторы и не оставляют записей в объектном файле
+    $CXX -std=c++11 $CXXFLAGS -DVCLIENT_NO_PROBES -c "$src" -o "$WORK/$name.off.o" ||
+        fail "$name.cpp does not compile with -DVCLIENT_NO_PROBES"
+    if readelf -n "$WORK/$name.off.o" | grep -q stapsdt; then
+        fail "$name.cpp emits probes with -DVCLIENT_NO_PROBES"
+    fi
+    # Включенные точки проверяются, если доступен <sys/sdt.h>
+    $CXX -std=c++11 $CXXFLAGS -c "$src" -o "$WORK/$name.on.o" || fail "$name.cpp does not compile"
+    if echo '#include <sys/sdt.h>' | $CXX $CXXFLAGS -x c++ -fsyntax-only - 2> /dev/null &&
+        ! readelf -n "$WORK/$name.on.o" | grep -q stapsdt; then
+        fail "$name.cpp emits no probes with <sys/sdt.h>"
+    fi
+done
+
+# Каждая точка, используемая сценариями, объявлена в модулях клиента
+for probe in $(grep -ho 'usdt::vclient:[a-z_]*' "$TRACE_DIR"/*.bt | sort -u | sed 's/.*://'); do
+    grep -qE "VCLIENT_PROBE[0-3]\\($probe[,)]" $SOURCES || fail "unknown probe $probe in trace scripts"
+done
+
+echo "CHECK SUCCESS!!!"
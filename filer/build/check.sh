@@ -0,0 +1,61 @@
+#!/bin/sh
+# Проверки convert и stats: круговое преобразование txt <-> bin (и в сжатые файлы),
+# статистика известного файла и просмотр файла с устаревшим индексом
+set -e
+FILER="$(cd "$(dirname "$0")" && pwd)/filer"
+WORK="$(mktemp -d)"
+trap 'rm -rf "$WORK"' EXIT
+cd "$WORK"
+
+fail() {
+    echo "CHECK FAILED: $1"
+    exit 1
+}
+
+# Статистика файла с известными значениями
+printf '3\n2\n1 -2\n3\n30000 30000 5\n1\n-7\n' > known.txt
+"$FILER" stats known.txt -j 2 | grep -v '^Scanned' > stats.out
+cat > stats.expected <<EOF
+Vectors: 3
+Values: 6
+Vector size: min 1, max 3, mean 2
+Size histogram:
+  1: 1
+  2-3: 2
+Value min: -7, max: 30000, mean: 9999.5
+Values outside int16: 0
+Vectors with int16 sum overflow: 1 (33.3333%)
+EOF
+cmp -s stats.out stats.expected || fail "stats of known.txt"
+
+# Суммы векторов double во всем диапазоне не переполняются: среднее конечно
+printf '2\n2\n1e308 1e308\n2\n-1e308 -1e308\n' > known_double.txt
+"$FILER" stats known_double.txt -dt double | grep -q '^Value min: -1e+308, max: 1e+308, mean: 0$' ||
+    fail "stats of known_double.txt"
+"$FILER" -dt double -ft bin -n 1000 -s 8 -p full_double.bin > /dev/null
+"$FILER" stats full_double.bin -dt double | grep '^Value min' | grep -qv 'nan' || fail "stats of full-range double data"
+
+# Круговое преобразование txt -> bin -> txt -> bin сохраняет векторы
+"$FILER" -dt int16_t -ft txt -n 200 -s 7 -p round.txt > /dev/null
+"$FILER" convert round.txt -p round.bin -j 3 > /dev/null
+"$FILER" convert round.bin -p round2.txt -j 3 > /dev/null
+"$FILER" convert round2.txt -p round2.bin -j 1 > /dev/null
+cmp -s round.bin round2.bin || fail "txt <-> bin round trip"
+
+# Сжатый результат преобразования распаковывается в тот же двоичный файл
+for tool in zstd:zst lz4:lz4; do
+    codec="${tool#*:}"
+    tool="${tool%:*}"
+    "$FILER" convert round.txt -p "round.bin.$codec" > /dev/null
+    if command -v "$tool" > /dev/null 2>&1; then
+        "$tool" -q -d -c "round.bin.$codec" > unpacked.bin
+        cmp -s round.bin unpacked.bin || fail "compressed $codec output"
+    fi
+done
+
+# Устаревший индекс не мешает просмотру: файл перезаписан без -x
+"$FILER" -dt int16_t -ft bin -n 10 -s 3 -p stale.bin -x > /dev/null
+"$FILER" -dt int16_t -ft bin -n 20 -s 3 -p stale.bin > /dev/null
+"$FILER" stats stale.bin | grep -q '^Vectors: 20$' || fail "stats with stale index"
+
+echo "CHECK SUCCESS!!!"
@@ -0,0 +1,558 @@
+#include "dataset.h"
+#include <algorithm>
+#include <atomic>
+#include <charconv>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <cstring>
+#include <exception>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "../../client/source/modules/compman.h"
+#include "../../client/source/modules/errors.h"
+#include "../../client/source/modules/vecindex.h"
+
+// Размер части файла, обрабатываемой одним потоком
+static const uint64_t CHUNK_BYTES = 8 << 20;
+
+// Количество значений, копируемых в выровненный буфер за один шаг свертки
+static const size_t BLOCK_VALUES = 4096;
+
+// Конструктор
+MappedFile::MappedFile(const std::string &path) : base(nullptr), length(0) {
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        throw FileNotFoundError("Failed to open input file \"" + path + "\"", "MappedFile()");
+    }
+    struct stat st;
+    if (fstat(fd, &st) < 0) {
+        ::close(fd);
+        throw FileNotFoundError("Failed to stat input file \"" + path + "\"", "MappedFile()");
+    }
+    this->length = st.st_size;
+    if (this->length > 0) {
+        this->base = mmap(nullptr, this->length, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (this->base == MAP_FAILED) {
+            this->base = nullptr;
+            ::close(fd);
+            throw FileNotFoundError("Failed to map input file \"" + path + "\"", "MappedFile()");
+        }
+        // Каждый поток читает свою часть последовательно
+        madvise(this->base, this->length, MADV_SEQUENTIAL);
+    }
+    ::close(fd);
+}
+
+// Деструктор
+MappedFile::~MappedFile() {
+    if (this->base) {
+        munmap(this->base, this->length);
+    }
+}
+
+const char *MappedFile::data() const {
+    return static_cast<const char *>(this->base);
+}
+
+size_t MappedFile::size() const {
+    return this->length;
+}
+
+// Функция для получения размера значения по имени типа (0 - тип не поддерживается)
+size_t type_size(const std::string &data_type) {
+    if (data_type == "uint16_t" || data_type == "int16_t") return 2;
+    if (data_type == "uint32_t" || data_type == "int32_t" || data_type == "float") return 4;
+    if (data_type == "uint64_t" || data_type == "int64_t" || data_type == "double") return 8;
+    return 0;
+}
+
+// Функция для вызова обработчика с пустым значением типа по его имени
+template <typename F>
+void with_type(const std::string &data_type, F &&body) {
+    if (data_type == "uint16_t") body(uint16_t());
+    else if (data_type == "int16_t") body(int16_t());
+    else if (data_type == "uint32_t") body(uint32_t());
+    else if (data_type == "int32_t") body(int32_t());
+    else if (data_type == "uint64_t") body(uint64_t());
+    else if (data_type == "int64_t") body(int64_t());
+    else if (data_type == "float") body(float());
+    else if (data_type == "double") body(double());
+    else throw InvalidDataFormatError("Unsupported data type: " + data_type, "scan_dataset()");
+}
+
+// Функция для преобразования значения с насыщением до диапазона целевого типа
+template <typename To, typename From>
+To saturate(From value) {
+    if constexpr (std::is_floating_point_v<From>) {
+        if (std::isnan(value)) {
+            return To(0);
+        }
+        if (value <= static_cast<long double>(std::numeric_limits<To>::lowest())) {
+            return std::numeric_limits<To>::lowest();
+        }
+        if (value >= static_cast<long double>(std::numeric_limits<To>::max())) {
+            return std::numeric_limits<To>::max();
+        }
+        return static_cast<To>(value);
+    } else if constexpr (std::is_floating_point_v<To>) {
+        return static_cast<To>(value);
+    } else {
+        // Отрицательные значения сравниваются как int64, неотрицательные - как uint64
+        if constexpr (std::is_signed_v<From>) {
+            if (value < 0) {
+                if constexpr (!std::is_signed_v<To>) {
+                    return To(0);
+                } else {
+                    return int64_t(value) < int64_t(std::numeric_limits<To>::min()) ? std::numeric_limits<To>::min() : To(value);
+                }
+            }
+        }
+        return uint64_t(value) > uint64_t(std::numeric_limits<To>::max()) ? std::numeric_limits<To>::max() : To(value);
+    }
+}
+
+// Функция для проверки пробельного символа текстового формата
+static inline bool is_space(char c) {
+    return c == ' ' || c == '\n' || c == '\r' || c == '\t';
+}
+
+// Функция для пропуска пробельных символов
+static inline const char *skip_space(const char *pos, const char *end) {
+    while (pos < end && is_space(*pos)) {
+        ++pos;
+    }
+    return pos;
+}
+
+// Функция для чтения числа текстового формата
+template <typename T>
+static const char *parse_token(const char *pos, const char *end, const char *base, T &value) {
+    pos = skip_space(pos, end);
+    // from_chars не принимает знак "+", который может записать printf
+    if (pos < end && *pos == '+') {
+        ++pos;
+    }
+    auto result = std::from_chars(pos, end, value);
+    if (result.ec != std::errc() || (result.ptr < end && !is_space(*result.ptr))) {
+        throw InvalidDataFormatError("Invalid value at offset " + std::to_string(pos - base), "scan_dataset()");
+    }
+    return result.ptr;
+}
+
+// Функция для деления файла на части по границам векторов
+std::vector<DataChunk> split_chunks(const MappedFile &file, const std::string &path, bool text,
+                                    size_t value_size, uint64_t &count) {
+    std::vector<DataChunk> chunks;
+    const char *base = file.data();
+    const char *end = base + file.size();
+    auto add = [&chunks](uint64_t offset) {
+        // Новая часть начинается, когда текущая превысила CHUNK_BYTES
+        if (chunks.empty() || offset - chunks.back().begin >= CHUNK_BYTES) {
+            if (!chunks.empty()) {
+                chunks.back().end = offset;
+            }
+            chunks.push_back({offset, offset, 0});
+        }
+        ++chunks.back().count;
+    };
+
+    // Готовый индекс избавляет от просмотра заголовков; устаревший или поврежденный индекс
+    // не мешает обработке, и файл просматривается заново
+    VecIndex index;
+    bool indexed = false;
+    try {
+        indexed = index.load(path);
+    } catch (const InvalidDataFormatError &) {
+        indexed = false;
+    }
+    if (indexed && index.format() == (text ? VecIndex::FORMAT_TEXT : VecIndex::FORMAT_BINARY) &&
+        index.valueSize() == value_size) {
+        count = index.count();
+        for (uint32_t i = 0; i < index.count(); ++i) {
+            add(index.offset(i));
+        }
+        if (!chunks.empty()) {
+            chunks.back().end = index.offset(index.count());
+        }
+        return chunks;
+    }
+
+    if (text) {
+        // Значения пропускаются без разбора: разбираются только количество и размеры векторов
+        uint32_t total;
+        const char *pos = parse_token(base, end, base, total);
+        count = total;
+        for (uint32_t i = 0; i < total; ++i) {
+            pos = skip_space(pos, end);
+            add(pos - base);
+            uint32_t size;
+            pos = parse_token(pos, end, base, size);
+            for (uint32_t j = 0; j < size; ++j) {
+                pos = skip_space(pos, end);
+                if (pos == end) {
+                    throw InvalidDataFormatError("Truncated vector " + std::to_string(i), "split_chunks()");
+                }
+                while (pos < end && !is_space(*pos)) {
+                    ++pos;
+                }
+            }
+        }
+        if (!chunks.empty()) {
+            chunks.back().end = pos - base;
+        }
+        return chunks;
+    }
+
+    uint32_t total;
+    if (file.size() < sizeof(total)) {
+        throw InvalidDataFormatError("Missing vector count", "split_chunks()");
+    }
+    std::memcpy(&total, base, sizeof(total));
+    count = total;
+    uint64_t pos = sizeof(total);
+    for (uint32_t i = 0; i < total; ++i) {
+        uint32_t size;
+        if (file.size() - pos < sizeof(size)) {
+            throw InvalidDataFormatError("Truncated vector " + std::to_string(i), "split_chunks()");
+        }
+        std::memcpy(&size, base + pos, sizeof(size));
+        uint64_t bytes = sizeof(size) + uint64_t(size) * value_size;
+        if (file.size() - pos < bytes) {
+            throw InvalidDataFormatError("Truncated vector " + std::to_string(i), "split_chunks()");
+        }
+        add(pos);
+        pos += bytes;
+    }
+    if (!chunks.empty()) {
+        chunks.back().end = pos;
+    }
+    return chunks;
+}
+
+// Функция для получения номера корзины гистограммы размеров: 0, 1, 2-3, 4-7, ...
+static size_t size_bucket(uint64_t size) {
+    size_t bucket = 0;
+    while (size) {
+        ++bucket;
+        size >>= 1;
+    }
+    return bucket;
+}
+
+// Функция для записи значения в текстовом формате (как оператор << в генераторе)
+template <typename T>
+static void put_text(std::string &out, T value) {
+    char buf[64];
+    std::to_chars_result result;
+    if constexpr (std::is_floating_point_v<T>) {
+        result = std::to_chars(buf, buf + sizeof(buf), value, std::chars_format::general, 6);
+    } else {
+        result = std::to_chars(buf, buf + sizeof(buf), value);
+    }
+    out.append(buf, result.ptr);
+}
+
+// Функция для обработки части файла: свертка значений и запись преобразованных векторов
+template <typename T, typename Out>
+static void scan_chunk(const MappedFile &file, const DataChunk &chunk, bool text, std::string *out, bool out_text,
+                       DatasetStats &stats) {
+    // Суммы целых до 32 бит точны в int64, 64-битных целых - считаются в double; суммы значений
+    // с плавающей точкой считаются в long double, иначе суммы векторов double во всем диапазоне
+    // переполняются до +-inf, а их общая сумма дает NaN
+    using Sum = std::conditional_t<std::is_floating_point_v<T>, long double,
+                                   std::conditional_t<sizeof(T) == 8, double, int64_t>>;
+    const char *base = file.data();
+    const char *pos = base + chunk.begin;
+    const char *end = base + chunk.end;
+    std::vector<T> values;
+    std::vector<Out> converted;
+    T lo = std::numeric_limits<T>::max();
+    T hi = std::numeric_limits<T>::lowest();
+    uint64_t outside = 0;
+    long double total = 0;
+
+    for (uint64_t i = 0; i < chunk.count; ++i) {
+        uint32_t size;
+        if (text) {
+            pos = parse_token(pos, end, base, size);
+        } else {
+            std::memcpy(&size, pos, sizeof(size));
+            pos += sizeof(size);
+        }
+
+        Sum sum = 0;
+        for (uint32_t done = 0; done < size;) {
+            // Значения копируются блоками в выровненный буфер, чтобы свертка векторизовалась
+            size_t n = std::min<size_t>(BLOCK_VALUES, size - done);
+            values.resize(n);
+            if (text) {
+                for (size_t j = 0; j < n; ++j) {
+                    pos = parse_token(pos, end, base, values[j]);
+                }
+            } else {
+                std::memcpy(values.data(), pos, n * sizeof(T));
+                pos += n * sizeof(T);
+            }
+            const T *v = values.data();
+            T block_lo = lo;
+            T block_hi = hi;
+            Sum block_sum = 0;
+            uint64_t block_outside = 0;
+            for (size_t j = 0; j < n; ++j) {
+                block_lo = v[j] < block_lo ? v[j] : block_lo;
+                block_hi = v[j] > block_hi ? v[j] : block_hi;
+                block_sum += Sum(v[j]);
+                block_outside += (Sum(v[j]) < Sum(-32768)) | (Sum(v[j]) > Sum(32767));
+            }
+            lo = block_lo;
+            hi = block_hi;
+            sum += block_sum;
+            outside += block_outside;
+
+            if (out) {
+                converted.resize(n);
+                for (size_t j = 0; j < n; ++j) {
+                    converted[j] = saturate<Out>(v[j]);
+                }
+                if (out_text) {
+                    if (done == 0) {
+                        put_text(*out, size);
+                        out->push_back('\n');
+                    }
+                    for (size_t j = 0; j < n; ++j) {
+                        put_text(*out, converted[j]);
+                        out->push_back(' ');
+                    }
+                } else {
+                    if (done == 0) {
+                        out->append(reinterpret_cast<const char *>(&size), sizeof(size));
+                    }
+                    out->append(reinterpret_cast<const char *>(converted.data()), n * sizeof(Out));
+                }
+            }
+            done += n;
+        }
+
+        if (out && size == 0) {
+            if (out_text) {
+                out->append("0\n");
+            } else {
+                out->append(reinterpret_cast<const char *>(&size), sizeof(size));
+            }
+        }
+        if (out && out_text) {
+            out->push_back('\n');
+        }
+
+        ++stats.vectors;
+        stats.values += size;
+        stats.min_size = std::min<uint64_t>(stats.min_size, size);
+        stats.max_size = std::max<uint64_t>(stats.max_size, size);
+        ++stats.size_hist[size_bucket(size)];
+        total += sum;
+        if (sum < Sum(-32768) || sum > Sum(32767)) {
+            ++stats.overflow_vectors;
+        }
+    }
+
+    stats.outside_int16 += outside;
+    stats.sum += total;
+    if (stats.values > 0) {
+        stats.min = lo;
+        stats.max = hi;
+    }
+}
+
+// Метод для объединения со статистикой другой части файла
+void DatasetStats::merge(const DatasetStats &other) {
+    if (other.values > 0) {
+        this->min = this->values > 0 ? std::min(this->min, other.min) : other.min;
+        this->max = this->values > 0 ? std::max(this->max, other.max) : other.max;
+    }
+    this->vectors += other.vectors;
+    this->values += other.values;
+    this->min_size = std::min(this->min_size, other.min_size);
+    this->max_size = std::max(this->max_size, other.max_size);
+    for (size_t i = 0; i < sizeof(this->size_hist) / sizeof(this->size_hist[0]); ++i) {
+        this->size_hist[i] += other.size_hist[i];
+    }
+    this->sum += other.sum;
+    this->outside_int16 += other.outside_int16;
+    this->overflow_vectors += other.overflow_vectors;
+}
+
+// Метод для вывода отчета
+void DatasetStats::report(std::ostream &out) const {
+    out << "Vectors: " << this->vectors << "\n"
+        << "Values: " << this->values << "\n";
+    if (this->vectors > 0) {
+        out << "Vector size: min " << this->min_size << ", max " << this->max_size << ", mean "
+            << double(this->values) / this->vectors << "\n";
+        out << "Size histogram:\n";
+        for (size_t i = 0; i < sizeof(this->size_hist) / sizeof(this->size_hist[0]); ++i) {
+            if (this->size_hist[i] == 0) {
+                continue;
+            }
+            uint64_t low = i == 0 ? 0 : uint64_t(1) << (i - 1);
+            uint64_t high = i == 0 ? 0 : (uint64_t(1) << i) - 1;
+            out << "  " << low;
+            if (high > low) {
+                out << "-" << high;
+            }
+            out << ": " << this->size_hist[i] << "\n";
+        }
+    }
+    if (this->values > 0) {
+        out << "Value min: " << this->min << ", max: " << this->max << ", mean: "
+            << double(this->sum / this->values) << "\n";
+    }
+    out << "Values outside int16: " << this->outside_int16 << "\n"
+        << "Vectors with int16 sum overflow: " << this->overflow_vectors;
+    if (this->vectors > 0) {
+        out << " (" << 100.0 * this->overflow_vectors / this->vectors << "%)";
+    }
+    out << "\n";
+}
+
+// Функция для параллельной обработки частей с записью результатов по порядку
+template <typename T, typename Out>
+static DatasetStats run_scan(const MappedFile &file, const std::vector<DataChunk> &chunks, bool text, size_t threads,
+                             std::ostream *output, bool out_text) {
+    threads = std::max<size_t>(1, std::min(threads, chunks.size()));
+    std::vector<DatasetStats> partial(threads);
+    std::vector<std::string> outputs(chunks.size());
+    std::vector<char> ready(chunks.size(), 0);
+    size_t next = 0;
+    size_t written = 0;
+    // Без записи части не ждут записи предыдущих
+    size_t window = output ? 2 * threads : chunks.size();
+    std::exception_ptr error;
+    std::mutex mutex;
+    std::condition_variable cv;
+
+    auto work = [&](size_t id) {
+        for (;;) {
+            size_t index;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                cv.wait(lock, [&]() { return error || next >= chunks.size() || next < written + window; });
+                if (error || next >= chunks.size()) {
+                    return;
+                }
+                index = next++;
+            }
+            DatasetStats stats;
+            try {
+                scan_chunk<T, Out>(file, chunks[index], text, output ? &outputs[index] : nullptr, out_text, stats);
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(mutex);
+                if (!error) {
+                    error = std::current_exception();
+                }
+                cv.notify_all();
+                return;
+            }
+            partial[id].merge(stats);
+            std::lock_guard<std::mutex> lock(mutex);
+            ready[index] = 1;
+            cv.notify_all();
+        }
+    };
+
+    std::vector<std::thread> workers;
+    for (size_t id = 0; id < threads; ++id) {
+        workers.emplace_back(work, id);
+    }
+    if (output) {
+        for (size_t index = 0; index < chunks.size(); ++index) {
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                cv.wait(lock, [&]() { return error || ready[index]; });
+                if (error) {
+                    break;
+                }
+            }
+            output->write(outputs[index].data(), outputs[index].size());
+            std::string().swap(outputs[index]);
+            std::lock_guard<std::mutex> lock(mutex);
+            written = index + 1;
+            cv.notify_all();
+        }
+    }
+    for (auto &worker : workers) {
+        worker.join();
+    }
+    if (error) {
+        std::rethrow_exception(error);
+    }
+
+    DatasetStats stats;
+    for (const auto &part : partial) {
+        stats.merge(part);
+    }
+    return stats;
+}
+
+// Функция для просмотра файла со сбором статистики и необязательным преобразованием
+DatasetStats scan_dataset(const std::string &path, bool text, const std::string &data_type, size_t threads,
+                          const std::string &out_path, bool out_text, const std::string &out_type) {
+    if (!CompMan::codec(path).empty()) {
+        throw InvalidDataFormatError("Compressed input cannot be mapped: " + path, "scan_dataset()");
+    }
+    size_t value_size = type_size(data_type);
+    if (value_size == 0) {
+        throw InvalidDataFormatError("Unsupported data type: " + data_type, "scan_dataset()");
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    MappedFile file(path);
+    uint64_t count = 0;
+    std::vector<DataChunk> chunks = split_chunks(file, path, text, value_size, count);
+
+    std::unique_ptr<std::ostream> output;
+    if (!out_path.empty()) {
+        output.reset(CompMan::openOutput(out_path));
+        if (!output) {
+            throw FileNotFoundError("Failed to open output file \"" + out_path + "\"", "scan_dataset()");
+        }
+        uint32_t total = count;
+        if (out_text) {
+            *output << total << "\n";
+        } else {
+            output->write(reinterpret_cast<const char *>(&total), sizeof(total));
+        }
+    }
+
+    DatasetStats stats;
+    with_type(data_type, [&](auto in_value) {
+        using T = decltype(in_value);
+        if (!output) {
+            stats = run_scan<T, T>(file, chunks, text, threads, nullptr, false);
+            return;
+        }
+        with_type(out_type, [&](auto out_value) {
+            using Out = decltype(out_value);
+            stats = run_scan<T, Out>(file, chunks, text, threads, output.get(), out_text);
+        });
+    });
+
+    if (output) {
+        CompMan::finish(*output);
+        if (!*output) {
+            throw FileNotFoundError("Failed to write output file \"" + out_path + "\"", "scan_dataset()");
+        }
+    }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    std::cout << "Scanned " << file.size() / 1e6 << " MB in " << elapsed.count() << " s ("
+              << file.size() / 1e6 / std::max(elapsed.count(), 1e-9) << " MB/s) with " << threads << " threads" << std::endl;
+    return stats;
+}
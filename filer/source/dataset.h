@@ -0,0 +1,139 @@
+#ifndef DATASET_H
+#define DATASET_H
+
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+/**
+* @file dataset.h
+* @brief Определение функций преобразования и статистики файлов векторов.
+* @details Этот файл содержит многопоточный просмотр текстовых и двоичных файлов, которые записывает
+* filer: входной файл отображается в память, делится на части по границам векторов, и части
+* обрабатываются параллельно. Значения вектора копируются в выровненный буфер, и циклы свертки
+* (минимум, максимум, сумма) векторизуются компилятором.
+* @date 19.10.2026
+* @version 1.0
+* @authorsa Ягольницкий Р. С.
+*/
+
+/**
+* @brief Часть файла, обрабатываемая одним потоком.
+*/
+struct DataChunk {
+    uint64_t begin; ///< Смещение первого вектора части.
+    uint64_t end; ///< Смещение за последним вектором части.
+    uint64_t count; ///< Количество векторов части.
+};
+
+/**
+* @brief Статистика файла векторов.
+*/
+struct DatasetStats {
+    uint64_t vectors = 0; ///< Количество векторов.
+    uint64_t values = 0; ///< Количество значений.
+    uint64_t min_size = UINT64_MAX; ///< Наименьший размер вектора.
+    uint64_t max_size = 0; ///< Наибольший размер вектора.
+    uint64_t size_hist[34] = {}; ///< Гистограмма размеров: 0, 1, 2-3, 4-7, ..., 2^31 и больше.
+    long double min = 0; ///< Наименьшее значение.
+    long double max = 0; ///< Наибольшее значение.
+    long double sum = 0; ///< Сумма значений.
+    uint64_t outside_int16 = 0; ///< Количество значений вне диапазона int16.
+    uint64_t overflow_vectors = 0; ///< Количество векторов, сумма которых выходит за диапазон int16.
+
+    /**
+    * @brief Метод для объединения со статистикой другой части файла.
+    * @param other Статистика части.
+    */
+    void merge(const DatasetStats &other);
+
+    /**
+    * @brief Метод для вывода отчета.
+    * @param out Поток вывода.
+    */
+    void report(std::ostream &out) const;
+};
+
+/**
+* @brief Класс входного файла, отображенного в память.
+*/
+class MappedFile {
+public:
+    /**
+    * @brief Конструктор класса MappedFile.
+    * @param path Путь к файлу.
+    * @throw FileNotFoundError Если файл не удалось открыть или отобразить.
+    */
+    explicit MappedFile(const std::string &path);
+
+    /**
+    * @brief Деструктор класса MappedFile. Снимает отображение.
+    */
+    ~MappedFile();
+
+    MappedFile(const MappedFile &) = delete;
+    MappedFile &operator=(const MappedFile &) = delete;
+
+    /**
+    * @brief Метод для получения содержимого файла.
+    * @return Указатель на начало отображения.
+    */
+    const char *data() const;
+
+    /**
+    * @brief Метод для получения размера файла.
+    * @return Размер в байтах.
+    */
+    size_t size() const;
+
+private:
+    void *base; ///< Начало отображения (nullptr для пустого файла).
+    size_t length; ///< Размер файла.
+};
+
+/**
+* @brief Функция для получения размера значения по имени типа.
+* @param data_type Имя типа (uint16_t, int16_t, ..., float, double).
+* @return Размер в байтах (0 - тип не поддерживается).
+*/
+size_t type_size(const std::string &data_type);
+
+/**
+* @brief Функция для деления файла на части по границам векторов.
+* @details Границы берутся из индекса PATH.idx, если он построен для того же формата и размера
+* значения и соответствует размеру файла; иначе (в том числе для устаревшего индекса) заголовки
+* векторов просматриваются последовательно без разбора значений.
+* @param file Отображенный файл.
+* @param path Путь к файлу (для поиска индекса).
+* @param text Текстовый формат.
+* @param value_size Размер значения в байтах.
+* @param count Количество векторов файла.
+* @return Части файла по порядку.
+* @throw InvalidDataFormatError Если файл обрывается посреди вектора или содержит некорректные данные.
+*/
+std::vector<DataChunk> split_chunks(const MappedFile &file, const std::string &path, bool text,
+                                    size_t value_size, uint64_t &count);
+
+/**
+* @brief Функция для просмотра файла со сбором статистики и необязательным преобразованием.
+* @details Потоки обрабатывают части по очереди; результаты преобразования частей записываются
+* в порядке файла, при этом в памяти одновременно находится не более 2 * threads частей.
+* Сужение типа выполняется с насыщением (NaN преобразуется в 0).
+* @param path Путь к входному файлу (сжатые файлы не поддерживаются).
+* @param text Текстовый входной формат.
+* @param data_type Тип значений входного файла.
+* @param threads Количество потоков.
+* @param out_path Путь к выходному файлу (пустая строка - только статистика; .zst/.lz4 сжимаются).
+* @param out_text Текстовый выходной формат.
+* @param out_type Тип значений выходного файла.
+* @return Статистика входного файла.
+* @throw FileNotFoundError Если файл не удалось открыть или записать.
+* @throw InvalidDataFormatError Если файл поврежден или тип не поддерживается.
+*/
+DatasetStats scan_dataset(const std::string &path, bool text, const std::string &data_type, size_t threads,
+                          const std::string &out_path = "", bool out_text = false,
+                          const std::string &out_type = "");
+
+#endif // DATASET_H
@@ -1,57 +1,55 @@
 #include <iostream>
 #include <fstream>
 #include <vector>
-#include <random>
 #include <iomanip>
 #include <cstring>
-#include <type_traits>
+#include <algorithm>
+#include <memory>
+#include <thread>
+#include "dataset.h"
+#include "../../client/source/modules/compman.h"
+#include "../../client/source/modules/vecindex.h"
+#include "../../client/source/modules/vecgen.h"
 
 // Функция для печати справки
 void print_help() {
-    std::cout << "Usage: filer -dt DATA_TYPE -ft FILE_TYPE -n COUNT -s SIZE -p PATH\n"
+    std::cout << "Usage: filer -dt DATA_TYPE -ft FILE_TYPE -n COUNT -s SIZE -p PATH [-z CODEC] [-x]\n"
+              << "       filer index PATH [-ft FILE_TYPE] [-dt DATA_TYPE]\n"
+              << "       filer convert PATH -p OUT [-ft FILE_TYPE] [-dt DATA_TYPE] [-oft FILE_TYPE] [-odt DATA_TYPE] [-j THREADS]\n"
+              << "       filer stats PATH [-ft FILE_TYPE] [-dt DATA_TYPE] [-j THREADS]\n"
               << "Options:\n"
               << "  -dt DATA_TYPE   Type of data (e.g., uint16_t, int16_t, uint32_t, int32_t, uint64_t, int64_t, float, double)\n"
               << "  -ft FILE_TYPE   File type: 'bin' or 'txt' (default: bin)\n"
               << "  -n COUNT        Number of vectors (default: 3)\n"
               << "  -s SIZE         Size of each vector (default: 3)\n"
               << "  -p PATH         Path to the output file (default: input.[file_type])\n"
+              << "  -z CODEC        Compress output: 'zst' or 'lz4' (adds the extension to PATH)\n"
+              << "  -x              Write the vector offset index PATH.idx (uncompressed output only)\n"
+              << "  index PATH      Build PATH.idx for an existing uncompressed file in one pass\n"
+              << "  convert PATH    Convert an uncompressed file to OUT (txt <-> bin, narrowing saturates)\n"
+              << "  stats PATH      Print vector count, size histogram, value range and int16 overflow counts\n"
+              << "  -oft, -odt      Output file and data type for convert (default: same as input)\n"
+              << "  -j THREADS      Worker threads for convert and stats (default: all cores)\n"
               << "  -h              Show this help message and exit\n";
 }
 
-// Функция для генерации случайного значения в диапазоне типа данных
-template <typename T>
-T generate_value() {
-    std::random_device rd;
-    std::mt19937 gen(rd());
-    std::uniform_int_distribution<int64_t> dis(std::numeric_limits<int64_t>::min(), std::numeric_limits<int64_t>::max());
-    T value;
-    do {
-        int64_t val = dis(gen);
-        if (std::is_integral<T>::value) {
-            value = static_cast<T>(val);
-        } else {
-            std::uniform_real_distribution<double> dis_double(std::numeric_limits<double>::min(), std::numeric_limits<double>::max());
-            value = static_cast<T>(dis_double(gen));
-        }
-    } while (value < std::numeric_limits<T>::min() || value > std::numeric_limits<T>::max());
-    return value;
-}
-
 // Функция для генерации случайного вектора
 template <typename T>
 std::vector<T> generate_vector(uint32_t size) {
+    static VecGen gen;
     std::vector<T> vec(size);
-    for (auto &v : vec) {
-        v = generate_value<T>();
-    }
+    gen.fill(vec);
     return vec;
 }
 
-// Функция для записи в бинарный файл
+// Функция для записи в бинарный файл (index - индекс смещений или nullptr)
 template <typename T>
-void write_binary(std::ofstream &outfile, uint32_t count, uint32_t size) {
+void write_binary(std::ostream &outfile, uint32_t count, uint32_t size, VecIndex *index) {
     outfile.write(reinterpret_cast<const char *>(&count), sizeof(count));
     for (uint32_t i = 0; i < count; ++i) {
+        if (index) {
+            index->add(outfile.tellp());
+        }
         auto vec = generate_vector<T>(size);
         uint32_t vec_size = vec.size();
         outfile.write(reinterpret_cast<const char *>(&vec_size), sizeof(vec_size));
@@ -59,11 +57,14 @@ void write_binary(std::ofstream &outfile, uint32_t count, uint32_t size) {
     }
 }
 
-// Функция для записи в текстовый файл
+// Функция для записи в текстовый файл (index - индекс смещений или nullptr)
 template <typename T>
-void write_text(std::ofstream &outfile, uint32_t count, uint32_t size) {
+void write_text(std::ostream &outfile, uint32_t count, uint32_t size, VecIndex *index) {
     outfile << count << "\n";
     for (uint32_t i = 0; i < count; ++i) {
+        if (index) {
+            index->add(outfile.tellp());
+        }
         auto vec = generate_vector<T>(size);
         uint32_t vec_size = vec.size();
         outfile << vec_size << "\n"; // Записываем размер вектора перед каждым вектором
@@ -74,12 +75,122 @@ void write_text(std::ofstream &outfile, uint32_t count, uint32_t size) {
     }
 }
 
+// Функция для построения индекса существующего файла: filer index PATH [-ft FILE_TYPE] [-dt DATA_TYPE]
+int build_index(int argc, char *argv[]) {
+    std::string file_path;
+    std::string file_type = "bin";
+    std::string data_type = "int16_t";
+    for (int i = 2; i < argc; ++i) {
+        if (std::strcmp(argv[i], "-ft") == 0 && i + 1 < argc) {
+            file_type = argv[++i];
+        } else if (std::strcmp(argv[i], "-dt") == 0 && i + 1 < argc) {
+            data_type = argv[++i];
+        } else if (file_path.empty() && argv[i][0] != '-') {
+            file_path = argv[i];
+        } else {
+            print_help();
+            return 1;
+        }
+    }
+    if (file_path.empty() || (file_type != "bin" && file_type != "txt") || type_size(data_type) == 0) {
+        print_help();
+        return 1;
+    }
+
+    try {
+        uint8_t format = file_type == "bin" ? VecIndex::FORMAT_BINARY : VecIndex::FORMAT_TEXT;
+        VecIndex index = VecIndex::build(file_path, format, type_size(data_type));
+        index.save(VecIndex::path(file_path));
+        std::cout << "Index built: " << VecIndex::path(file_path) << " (" << index.count() << " vectors)" << std::endl;
+    } catch (const BasicClientError &e) {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
+
+// Функция для определения формата файла по расширению (сжатые файлы - по расширению до кодека)
+std::string file_type_of(const std::string &path) {
+    std::string name = path.substr(0, path.size() - CompMan::codec(path).size());
+    return name.size() >= 4 && name.compare(name.size() - 4, 4, ".txt") == 0 ? "txt" : "bin";
+}
+
+// Функция для преобразования и статистики: filer convert|stats PATH [-p OUT] [-ft/-dt/-oft/-odt TYPE] [-j N]
+int scan_file(int argc, char *argv[]) {
+    bool convert = std::strcmp(argv[1], "convert") == 0;
+    std::string file_path;
+    std::string out_path;
+    std::string file_type;
+    std::string data_type = "int16_t";
+    std::string out_file_type;
+    std::string out_data_type;
+    size_t threads = std::max(1u, std::thread::hardware_concurrency());
+    for (int i = 2; i < argc; ++i) {
+        if (std::strcmp(argv[i], "-ft") == 0 && i + 1 < argc) {
+            file_type = argv[++i];
+        } else if (std::strcmp(argv[i], "-dt") == 0 && i + 1 < argc) {
+            data_type = argv[++i];
+        } else if (convert && std::strcmp(argv[i], "-oft") == 0 && i + 1 < argc) {
+            out_file_type = argv[++i];
+        } else if (convert && std::strcmp(argv[i], "-odt") == 0 && i + 1 < argc) {
+            out_data_type = argv[++i];
+        } else if (convert && std::strcmp(argv[i], "-p") == 0 && i + 1 < argc) {
+            out_path = argv[++i];
+        } else if (std::strcmp(argv[i], "-j") == 0 && i + 1 < argc) {
+            threads = std::stoul(argv[++i]);
+        } else if (file_path.empty() && argv[i][0] != '-') {
+            file_path = argv[i];
+        } else {
+            print_help();
+            return 1;
+        }
+    }
+    if (file_type.empty()) {
+        file_type = file_type_of(file_path);
+    }
+    if (out_file_type.empty()) {
+        out_file_type = file_type_of(out_path);
+    }
+    if (out_data_type.empty()) {
+        out_data_type = data_type;
+    }
+    if (file_path.empty() || (convert && out_path.empty()) || threads == 0 ||
+        (file_type != "bin" && file_type != "txt") || (out_file_type != "bin" && out_file_type != "txt") ||
+        type_size(data_type) == 0 || type_size(out_data_type) == 0) {
+        print_help();
+        return 1;
+    }
+
+    try {
+        DatasetStats stats = scan_dataset(file_path, file_type == "txt", data_type, threads, out_path,
+                                          out_file_type == "txt", out_data_type);
+        if (convert) {
+            std::cout << "File converted: " << out_path << " (" << stats.vectors << " vectors)" << std::endl;
+        } else {
+            stats.report(std::cout);
+        }
+    } catch (const BasicClientError &e) {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
+
 int main(int argc, char *argv[]) {
+    if (argc > 1 && std::strcmp(argv[1], "index") == 0) {
+        return build_index(argc, argv);
+    }
+    if (argc > 1 && (std::strcmp(argv[1], "convert") == 0 || std::strcmp(argv[1], "stats") == 0)) {
+        return scan_file(argc, argv);
+    }
+
     std::string data_type;
     std::string file_type = "bin"; // Значение по умолчанию
     uint32_t count = 3;            // Значение по умолчанию
     uint32_t size = 3;             // Значение по умолчанию
     std::string file_path;
+    std::string codec;
+    bool with_index = false;
 
     for (int i = 1; i < argc; ++i) {
         if (std::strcmp(argv[i], "-dt") == 0 && i + 1 < argc) {
@@ -92,6 +203,10 @@ int main(int argc, char *argv[]) {
             size = std::stoul(argv[++i]);
         } else if (std::strcmp(argv[i], "-p") == 0 && i + 1 < argc) {
             file_path = argv[++i];
+        } else if (std::strcmp(argv[i], "-z") == 0 && i + 1 < argc) {
+            codec = argv[++i];
+        } else if (std::strcmp(argv[i], "-x") == 0) {
+            with_index = true;
         } else if (std::strcmp(argv[i], "-h") == 0) {
             print_help();
             return 0;
@@ -111,56 +226,70 @@ int main(int argc, char *argv[]) {
         return 1;
     }
 
-    std::ofstream outfile;
-    if (file_type == "bin") {
-        outfile.open(file_path, std::ios::binary);
-    } else if (file_type == "txt") {
-        outfile.open(file_path);
+    // Добавление расширения кодека, по которому клиент распознает сжатый файл
+    if (!codec.empty()) {
+        if (codec != "zst" && codec != "lz4") {
+            std::cerr << "Unsupported codec: " << codec << std::endl;
+            return 1;
+        }
+        if (CompMan::codec(file_path) != codec) {
+            file_path += "." + codec;
+        }
+    }
+
+    // Смещения в сжатом файле не позволяют переходить к векторам, поэтому индекс строится только для несжатого
+    if (with_index && !CompMan::codec(file_path).empty()) {
+        std::cerr << "Index requires uncompressed output: " << file_path << std::endl;
+        return 1;
     }
+    VecIndex index(file_type == "bin" ? VecIndex::FORMAT_BINARY : VecIndex::FORMAT_TEXT, type_size(data_type));
+    VecIndex *index_ptr = with_index ? &index : nullptr;
 
-    if (!outfile.is_open()) {
+    std::unique_ptr<std::ostream> output(CompMan::openOutput(file_path));
+    if (!output) {
         std::cerr << "Error opening file: " << file_path << std::endl;
         return 1;
     }
+    std::ostream &outfile = *output;
 
     if (file_type == "bin") {
         if (data_type == "uint16_t") {
-            write_binary<uint16_t>(outfile, count, size);
+            write_binary<uint16_t>(outfile, count, size, index_ptr);
         } else if (data_type == "int16_t") {
-            write_binary<int16_t>(outfile, count, size);
+            write_binary<int16_t>(outfile, count, size, index_ptr);
         } else if (data_type == "uint32_t") {
-            write_binary<uint32_t>(outfile, count, size);
+            write_binary<uint32_t>(outfile, count, size, index_ptr);
         } else if (data_type == "int32_t") {
-            write_binary<int32_t>(outfile, count, size);
+            write_binary<int32_t>(outfile, count, size, index_ptr);
         } else if (data_type == "uint64_t") {
-            write_binary<uint64_t>(outfile, count, size);
+            write_binary<uint64_t>(outfile, count, size, index_ptr);
         } else if (data_type == "int64_t") {
-            write_binary<int64_t>(outfile, count, size);
+            write_binary<int64_t>(outfile, count, size, index_ptr);
         } else if (data_type == "float") {
-            write_binary<float>(outfile, count, size);
+            write_binary<float>(outfile, count, size, index_ptr);
         } else if (data_type == "double") {
-            write_binary<double>(outfile, count, size);
+            write_binary<double>(outfile, count, size, index_ptr);
         } else {
             std::cerr << "Unsupported data type: " << data_type << std::endl;
             return 1;
         }
     } else if (file_type == "txt") {
         if (data_type == "uint16_t") {
-            write_text<uint16_t>(outfile, count, size);
+            write_text<uint16_t>(outfile, count, size, index_ptr);
         } else if (data_type == "int16_t") {
-            write_text<int16_t>(outfile, count, size);
+            write_text<int16_t>(outfile, count, size, index_ptr);
         } else if (data_type == "uint32_t") {
-            write_text<uint32_t>(outfile, count, size);
+            write_text<uint32_t>(outfile, count, size, index_ptr);
         } else if (data_type == "int32_t") {
-            write_text<int32_t>(outfile, count, size);
+            write_text<int32_t>(outfile, count, size, index_ptr);
         } else if (data_type == "uint64_t") {
-            write_text<uint64_t>(outfile, count, size);
+            write_text<uint64_t>(outfile, count, size, index_ptr);
         } else if (data_type == "int64_t") {
-            write_text<int64_t>(outfile, count, size);
+            write_text<int64_t>(outfile, count, size, index_ptr);
         } else if (data_type == "float") {
-            write_text<float>(outfile, count, size);
+            write_text<float>(outfile, count, size, index_ptr);
         } else if (data_type == "double") {
-            write_text<double>(outfile, count, size);
+            write_text<double>(outfile, count, size, index_ptr);
         } else {
             std::cerr << "Unsupported data type: " << data_type << std::endl;
             return 1;
@@ -170,7 +299,17 @@ int main(int argc, char *argv[]) {
         return 1;
     }
 
-    outfile.close();
+    try {
+        CompMan::finish(outfile);
+        if (with_index) {
+            index.finish(outfile.tellp());
+            index.stamp(file_path);
+            index.save(VecIndex::path(file_path));
+        }
+    } catch (const BasicClientError &e) {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
     std::cout << "File generated successfully: " << file_path << std::endl;
     return 0;
 }
@@ -12,12 +12,449 @@
 #include "../../client/source/modules/netman.h"
 #include "../../client/source/modules/ioman.h"
 #include "../../client/source/modules/ui.h"
+#include "../../client/source/modules/compman.h"
+#include "../../client/source/modules/wirecodec.h"
+#include "../../client/source/modules/window.h"
+#include "../../client/source/modules/sockopts.h"
+#include "../../client/source/modules/uring.h"
+#include "../../client/source/modules/shmring.h"
+#include "../../client/source/modules/batchman.h"
+#include "../../client/source/modules/vecindex.h"
+#include "../../client/source/modules/spscring.h"
+#include "../../client/source/modules/pipeline.h"
+#include "../../client/source/modules/vclient.h"
+#include "../../client/source/modules/latency.h"
+#include "../../client/source/modules/loadgen.h"
+#include "../../client/source/modules/vecgen.h"
+#include "../../client/source/modules/affinity.h"
+#include "../../client/source/modules/hugemem.h"
+#include "../../client/source/modules/resultcache.h"
+#include "../../client/source/modules/balancer.h"
+#include "../../client/source/modules/hedger.h"
+#include "../../client/source/modules/loopback.h"
+#include "../../client/source/modules/progress.h"
+#include "../../client/source/modules/stride.h"
+#include "../../client/source/modules/probes.h"
+#include <netinet/tcp.h>
+#include <chrono>
+#include <memory>
+#include <thread>
+#include <future>
+#include <cstring>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/stat.h>
+#include <sched.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <unistd.h>
 #include <iostream>
 #include <fstream>
+#include <sstream>
 #include <stdexcept>
+#include <cstdlib>
+#include <new>
 
 using namespace std;
 
+// Счетчик выделений памяти: учитываются только выделения потока, включившего подсчет,
+// чтобы не считать выделения потоков заменителя сервера
+static thread_local bool alloc_counting = false;
+static thread_local size_t alloc_count = 0;
+
+/**
+ * @brief Замена глобального operator new с подсчетом выделений.
+ * @param size Размер блока.
+ * @return Указатель на блок.
+ */
+void *operator new(size_t size)
+{
+    if (alloc_counting)
+        ++alloc_count;
+    void *ptr = malloc(size ? size : 1);
+    if (ptr == nullptr)
+        throw bad_alloc();
+    return ptr;
+}
+
+/**
+ * @brief Замена глобального operator delete в пару к operator new.
+ * @param ptr Указатель на блок.
+ */
+void operator delete(void *ptr) noexcept
+{
+    free(ptr);
+}
+
+/**
+ * @brief Вспомогательный класс для подсчета выделений памяти в текущем потоке.
+ */
+class AllocCounter
+{
+public:
+    AllocCounter()
+    {
+        alloc_count = 0;
+        alloc_counting = true;
+    }
+    ~AllocCounter()
+    {
+        alloc_counting = false;
+    }
+    size_t count() const
+    {
+        return alloc_count;
+    }
+};
+
+/**
+ * @brief Вспомогательная функция для получения буфера заданного размера.
+ * @param fd Сокет.
+ * @param buf Буфер для данных.
+ * @param size Размер данных в байтах.
+ * @return true, если все данные получены.
+ */
+static bool recvExact(int fd, void *buf, size_t size)
+{
+    char *pos = static_cast<char *>(buf);
+    while (size > 0)
+    {
+        ssize_t n = recv(fd, pos, size, 0);
+        if (n <= 0)
+            return false;
+        pos += n;
+        size -= n;
+    }
+    return true;
+}
+
+/**
+ * @brief Вспомогательная функция для вычисления суммы вектора с насыщением.
+ * @param vec Вектор.
+ * @return Сумма значений вектора.
+ */
+static int16_t saturatedSum(const vector<int16_t> &vec)
+{
+    int32_t sum = 0;
+    for (int16_t val : vec)
+        sum = max(-32768, min(32767, sum + val));
+    return sum;
+}
+
+/**
+ * @brief Вспомогательная функция для обслуживания одного подключения заменителем сервера.
+ * @param fd Сокет подключения.
+ * @param compact Флаг компактного режима.
+ * @param drop_after Количество векторов, после которого подключение разрывается (0 - не разрывать).
+ * @param shm Флаг транспорта через общую память (только для Unix-сокета).
+ */
+static void serveStandIn(int fd, bool compact, size_t drop_after, bool shm = false)
+{
+    char auth[1024];
+    recv(fd, auth, sizeof(auth), 0);
+    send(fd, "OK", 2, 0);
+
+    if (compact)
+    {
+        uint8_t request[5];
+        uint8_t accepted = 1;
+        if (!recvExact(fd, request, sizeof(request)))
+            return;
+        send(fd, &accepted, sizeof(accepted), 0);
+    }
+
+    // После согласования общей памяти данные передаются через кольцевые буферы
+    unique_ptr<ShmTransport> transport;
+    if (shm)
+    {
+        uint32_t request[2];
+        int memfd = ShmTransport::recvFd(fd, request, sizeof(request));
+        if (memfd < 0 || request[0] != ShmTransport::MAGIC)
+            return;
+        transport.reset(new ShmTransport(memfd, request[1], true));
+        uint8_t accepted = transport->ready() ? 1 : 0;
+        send(fd, &accepted, sizeof(accepted), 0);
+        if (!accepted)
+            transport.reset();
+    }
+    auto recvExact = [fd, &transport](void *buf, size_t size)
+    { return transport ? transport->recvAll(buf, size, fd) : ::recvExact(fd, buf, size); };
+    auto sendExact = [fd, &transport](const void *buf, size_t size)
+    { return transport ? transport->sendAll(buf, size, fd) : send(fd, buf, size, MSG_NOSIGNAL) == ssize_t(size); };
+
+    size_t served = 0;
+    for (;;)
+    {
+        vector<vector<int16_t>> batch;
+        if (compact)
+        {
+            // Заголовок пакета: флаг и два varint
+            vector<uint8_t> frame(1);
+            if (!recvExact(frame.data(), 1))
+                return;
+            uint32_t payload_size = 0;
+            for (int field = 0; field < 2; ++field)
+            {
+                uint8_t byte;
+                int shift = 0;
+                payload_size = 0;
+                do
+                {
+                    if (!recvExact(&byte, 1))
+                        return;
+                    frame.push_back(byte);
+                    payload_size |= uint32_t(byte & 0x7F) << shift;
+                    shift += 7;
+                } while (byte & 0x80);
+            }
+            size_t header = frame.size();
+            frame.resize(header + payload_size);
+            if (!recvExact(frame.data() + header, payload_size))
+                return;
+            batch = WireCodec::decode(frame.data(), frame.size());
+        }
+        else
+        {
+            // Сырой режим: количество векторов, затем размер и значения каждого вектора
+            uint32_t count;
+            if (!recvExact(&count, sizeof(count)))
+                return;
+            for (uint32_t i = 0; i < count; ++i)
+            {
+                uint32_t size;
+                vector<int16_t> vec;
+                if (!recvExact(&size, sizeof(size)))
+                    return;
+                vec.resize(size);
+                if (!recvExact(vec.data(), size * sizeof(int16_t)))
+                    return;
+                int16_t sum = saturatedSum(vec);
+                sendExact(&sum, sizeof(sum));
+                if (drop_after && ++served >= drop_after)
+                    return;
+            }
+            continue;
+        }
+
+        vector<int16_t> sums;
+        for (const auto &vec : batch)
+            sums.push_back(saturatedSum(vec));
+        sendExact(sums.data(), sums.size() * sizeof(int16_t));
+        served += batch.size();
+        if (drop_after && served >= drop_after)
+            return;
+    }
+}
+
+/**
+ * @brief Локальный заменитель сервера.
+ * @details Принимает заданное количество подключений, подтверждает аутентификацию (и компактный режим),
+ * возвращает сумму каждого вектора с насыщением. Первое подключение может разрываться после
+ * заданного количества векторов для проверки повторных попыток.
+ * @param port Порт для прослушивания на 127.0.0.1.
+ * @param compact Флаг компактного режима.
+ * @param connections Количество обслуживаемых подключений.
+ * @param drop_after Количество векторов, после которого разрывается первое подключение (0 - не разрывать).
+ * @return Поток сервера.
+ */
+static thread startStandInServer(uint16_t port, bool compact, int connections = 1, size_t drop_after = 0)
+{
+    int listener = socket(AF_INET, SOCK_STREAM, 0);
+    int yes = 1;
+    setsockopt(listener, SOL_SOCKET, SO_REUSEADDR, &yes, sizeof(yes));
+    sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    bind(listener, (sockaddr *)&addr, sizeof(addr));
+    listen(listener, connections);
+
+    return thread([listener, compact, connections, drop_after]()
+                  {
+        // Подключения обслуживаются параллельно, как у настоящего сервера
+        vector<thread> sessions;
+        for (int i = 0; i < connections; ++i)
+        {
+            int fd = accept(listener, nullptr, nullptr);
+            sessions.emplace_back([fd, compact, i, drop_after]()
+                                  {
+                serveStandIn(fd, compact, i == 0 ? drop_after : 0);
+                close(fd); });
+        }
+        for (auto &session : sessions)
+            session.join();
+        close(listener); });
+}
+
+/**
+ * @brief Локальный заменитель зависшего сервера.
+ * @details Подтверждает аутентификацию заданного количества подключений, затем принимает данные
+ * и никогда не отвечает, пока клиент не закроет подключение.
+ * @param port Порт для прослушивания на 127.0.0.1.
+ * @param connections Количество обслуживаемых подключений.
+ * @return Поток сервера.
+ */
+static thread startHungStandInServer(uint16_t port, int connections)
+{
+    int listener = socket(AF_INET, SOCK_STREAM, 0);
+    int yes = 1;
+    setsockopt(listener, SOL_SOCKET, SO_REUSEADDR, &yes, sizeof(yes));
+    sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    bind(listener, (sockaddr *)&addr, sizeof(addr));
+    listen(listener, connections);
+
+    return thread([listener, connections]()
+                  {
+        vector<thread> sessions;
+        for (int i = 0; i < connections; ++i)
+        {
+            int fd = accept(listener, nullptr, nullptr);
+            sessions.emplace_back([fd]()
+                                  {
+                char buf[4096];
+                recv(fd, buf, sizeof(buf), 0);
+                send(fd, "OK", 2, 0);
+                while (recv(fd, buf, sizeof(buf), 0) > 0)
+                {
+                }
+                close(fd); });
+        }
+        for (auto &session : sessions)
+            session.join();
+        close(listener); });
+}
+
+/**
+ * @brief Локальный заменитель сервера с однократной задержкой ответа.
+ * @details Обслуживает одно подключение в сыром режиме, как startStandInServer(), но перед ответом
+ * на вектор с заданным номером приостанавливается, имитируя медленный экземпляр сервера.
+ * @param port Порт для прослушивания на 127.0.0.1.
+ * @param stall_at Номер вектора, перед ответом на который сервер приостанавливается.
+ * @param stall_ms Длительность приостановки в миллисекундах.
+ * @return Поток сервера.
+ */
+static thread startStallingStandInServer(uint16_t port, size_t stall_at, int stall_ms)
+{
+    int listener = socket(AF_INET, SOCK_STREAM, 0);
+    int yes = 1;
+    setsockopt(listener, SOL_SOCKET, SO_REUSEADDR, &yes, sizeof(yes));
+    sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    bind(listener, (sockaddr *)&addr, sizeof(addr));
+    listen(listener, 1);
+
+    return thread([listener, stall_at, stall_ms]()
+                  {
+        int fd = accept(listener, nullptr, nullptr);
+        char auth[1024];
+        recv(fd, auth, sizeof(auth), 0);
+        send(fd, "OK", 2, 0);
+        size_t served = 0;
+        uint32_t count;
+        while (recvExact(fd, &count, sizeof(count)))
+        {
+            for (uint32_t i = 0; i < count; ++i)
+            {
+                uint32_t size;
+                vector<int16_t> vec;
+                if (!recvExact(fd, &size, sizeof(size)))
+                    break;
+                vec.resize(size);
+                if (!recvExact(fd, vec.data(), size * sizeof(int16_t)))
+                    break;
+                if (served++ == stall_at)
+                    this_thread::sleep_for(chrono::milliseconds(stall_ms));
+                int16_t sum = saturatedSum(vec);
+                send(fd, &sum, sizeof(sum), MSG_NOSIGNAL);
+            }
+        }
+        close(fd);
+        close(listener); });
+}
+
+/**
+ * @brief Локальный заменитель сервера на Unix-сокете.
+ * @details Обслуживает подключения по очереди так же, как startStandInServer(), и может принимать
+ * транспорт через общую память.
+ * @param path Путь к Unix-сокету.
+ * @param compact Флаг компактного режима.
+ * @param shm Флаг транспорта через общую память.
+ * @param connections Количество обслуживаемых подключений.
+ * @return Поток сервера.
+ */
+static thread startStandInUnixServer(const string &path, bool compact, bool shm, int connections = 1)
+{
+    unlink(path.c_str());
+    int listener = socket(AF_UNIX, SOCK_STREAM, 0);
+    sockaddr_un addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    strncpy(addr.sun_path, path.c_str(), sizeof(addr.sun_path) - 1);
+    bind(listener, (sockaddr *)&addr, sizeof(addr));
+    listen(listener, 1);
+
+    return thread([listener, compact, shm, path, connections]()
+                  {
+        for (int i = 0; i < connections; ++i)
+        {
+            int fd = accept(listener, nullptr, nullptr);
+            serveStandIn(fd, compact, 0, shm);
+            close(fd);
+        }
+        close(listener);
+        unlink(path.c_str()); });
+}
+
+/**
+ * @brief Локальный заменитель зависшего сервера на Unix-сокете с общей памятью.
+ * @details Подтверждает аутентификацию и транспорт через общую память, затем не читает кольцевые
+ * буферы и удерживает сокет открытым, пока клиент не закроет подключение.
+ * @param path Путь к Unix-сокету.
+ * @param connections Количество обслуживаемых подключений.
+ * @return Поток сервера.
+ */
+static thread startHungStandInShmServer(const string &path, int connections)
+{
+    unlink(path.c_str());
+    int listener = socket(AF_UNIX, SOCK_STREAM, 0);
+    sockaddr_un addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    strncpy(addr.sun_path, path.c_str(), sizeof(addr.sun_path) - 1);
+    bind(listener, (sockaddr *)&addr, sizeof(addr));
+    listen(listener, 1);
+
+    return thread([listener, path, connections]()
+                  {
+        for (int i = 0; i < connections; ++i)
+        {
+            int fd = accept(listener, nullptr, nullptr);
+            char auth[1024];
+            recv(fd, auth, sizeof(auth), 0);
+            send(fd, "OK", 2, 0);
+            uint32_t request[2];
+            int memfd = ShmTransport::recvFd(fd, request, sizeof(request));
+            unique_ptr<ShmTransport> transport(new ShmTransport(memfd, request[1], true));
+            uint8_t accepted = 1;
+            send(fd, &accepted, sizeof(accepted), 0);
+            // В режиме общей памяти клиент не пишет в сокет: recv() возвращается только при закрытии
+            char byte;
+            while (recv(fd, &byte, 1, 0) > 0)
+                ;
+            close(fd);
+        }
+        close(listener);
+        unlink(path.c_str()); });
+}
+
 /**
  * @brief Тест для генерации соли.
  */
@@ -152,6 +589,103 @@ TEST(IOManWriteFileNotFound)
     CHECK_THROW(ioMan.write({1, 2, 3, 4, 5}), FileNotFoundError);
 }
 
+/**
+ * @brief Тест для чтения сжатых входных файлов (zstd и lz4).
+ */
+TEST(IOManReadCompressed)
+{
+    const char *paths[] = {"./input_test.txt.zst", "./input_test.txt.lz4"};
+    for (const char *path : paths)
+    {
+        unique_ptr<ostream> out(CompMan::openOutput(path));
+        CHECK(out != nullptr);
+        *out << "2\n3\n1 -2 3 \n2\n-32768 32767 \n";
+        CompMan::finish(*out);
+        out.reset();
+
+        IOMan ioMan("./config/vclient.conf", path, "./output.bin");
+        vector<vector<int16_t>> data = ioMan.read();
+
+        CHECK_EQUAL(2, data.size());
+        CHECK(data[0] == vector<int16_t>({1, -2, 3}));
+        CHECK(data[1] == vector<int16_t>({-32768, 32767}));
+
+        remove(path);
+    }
+}
+
+/**
+ * @brief Тест для ошибки распаковки поврежденного входного файла.
+ */
+TEST(IOManReadCompressedCorrupted)
+{
+    const string path = "./corrupted.txt.zst";
+    ofstream file(path, ios::binary);
+    file << "definitely not a zstd frame";
+    file.close();
+
+    IOMan ioMan("./config/vclient.conf", path, "./output.bin");
+    CHECK_THROW(ioMan.read(), InvalidDataFormatError);
+
+    remove(path.c_str());
+}
+
+/**
+ * @brief Тест для чтения хорошо сжимаемого и обрезанного сжатого входного файла.
+ */
+TEST(IOManReadCompressedTail)
+{
+    const char *paths[] = {"./input_tail.txt.zst", "./input_tail.txt.lz4"};
+    for (const char *path : paths)
+    {
+        // Несколько мегабайт одинаковых строк сжимаются в один входной блок распаковщика
+        const int count = 300000;
+        {
+            unique_ptr<ostream> out(CompMan::openOutput(path));
+            *out << count << "\n";
+            for (int i = 0; i < count; ++i)
+                *out << "4\n1 2 3 4 \n";
+            CompMan::finish(*out);
+        }
+        IOMan ioMan("./config/vclient.conf", path, "./output.bin");
+        ioMan.setVerbose(false);
+        vector<vector<int16_t>> data = ioMan.read();
+        CHECK_EQUAL(count, data.size());
+        CHECK(data.back() == vector<int16_t>({1, 2, 3, 4}));
+
+        // Кадр без окончания считается ошибкой, а не концом данных
+        struct stat st;
+        stat(path, &st);
+        CHECK_EQUAL(0, truncate(path, st.st_size - 8));
+        CHECK_THROW(ioMan.read(), InvalidDataFormatError);
+        remove(path);
+    }
+}
+
+/**
+ * @brief Тест для записи сжатого выходного файла.
+ */
+TEST(IOManWriteCompressed)
+{
+    const string path = "./output_test.bin.zst";
+    IOMan ioMan("./config/vclient.conf", "./input.txt", path);
+    ioMan.write({6, 7, 8});
+
+    unique_ptr<istream> in(CompMan::openInput(path));
+    CHECK(in != nullptr);
+    uint32_t count = 0;
+    int16_t values[3] = {0, 0, 0};
+    in->read(reinterpret_cast<char *>(&count), sizeof(count));
+    in->read(reinterpret_cast<char *>(values), sizeof(values));
+
+    CHECK_EQUAL(3, count);
+    CHECK_EQUAL(6, values[0]);
+    CHECK_EQUAL(8, values[2]);
+
+    in.reset();
+    remove(path.c_str());
+}
+
 /**
  * @brief Тест для инициализации соединения.
  */
@@ -174,76 +708,1933 @@ TEST(NetManConnError)
 }
 
 /**
- * @brief Тест для проверки корректной обработки параметров.
+ * @brief Тест для аутентификации и передачи данных через встроенный сервер.
+ * @details Транспорт без сокета: результаты и счетчики не зависят от планировщика и сети.
  */
-TEST(UserInterfaceParseArgsCorrect)
+TEST(NetManLoopbackCalc)
 {
-    const char *argv[] = {"vclient", "-a", "192.168.0.1", "-p", "33333", "-i", "input.bin", "-o", "output.bin", "-c", "config.conf"};
-    int argc = sizeof(argv) / sizeof(argv[0]);
+    for (const char *mode : {"raw", "compact"})
+    {
+        LoopbackTransport *link = nullptr;
+        NetMan netManager("loopback", 0);
+        netManager.setConnector([&link]()
+                                { return link = new LoopbackTransport(); });
+        netManager.setWireMode(mode);
+        netManager.setVerbose(false);
+        netManager.conn();
+        netManager.auth("user", "P@ssW0rd");
 
-    UserInterface ui(argc, const_cast<char **>(argv));
+        // Ответы на 5000 векторов не помещаются в начальный кольцевой буфер
+        vector<vector<int16_t>> data;
+        for (int i = 0; i < 5000; ++i)
+            data.push_back({int16_t(i), 1, 2});
+        data.push_back({30000, 30000});
+        data.push_back({});
+        vector<int16_t> results = netManager.calc(data);
 
-    // Проверяем корректность распарсенных параметров
-    CHECK_EQUAL(string("192.168.0.1"), ui.getAddress());
-    CHECK_EQUAL((uint16_t)33333, ui.getPort());
-    CHECK_EQUAL(string("input.bin"), ui.getInputFilePath());
-    CHECK_EQUAL(string("output.bin"), ui.getOutputFilePath());
-    CHECK_EQUAL(string("config.conf"), ui.getConfigFilePath());
+        CHECK_EQUAL(data.size(), results.size());
+        CHECK_EQUAL(3, results[0]);
+        CHECK_EQUAL(5002, results[4999]);
+        CHECK_EQUAL(32767, results[5000]);
+        CHECK_EQUAL(0, results[5001]);
+        CHECK_EQUAL(data.size(), link->getVectors());
+        CHECK_EQUAL(data.size() * sizeof(int16_t) + 2 + (string(mode) == "compact"), link->getBytesOut());
+        CHECK(!netManager.canSendFile());
+        netManager.close();
+    }
 }
 
 /**
- * @brief Тест для проверки отсутствия обязательного параметра input.
+ * @brief Тест для отклонения аутентификации встроенным сервером.
  */
-TEST(UserInterfaceParseArgsMissingInput)
+TEST(NetManLoopbackAuthRejected)
 {
-    const char *argv[] = {"vclient", "-a", "192.168.0.1", "-p", "33333", "-o", "output.bin", "-c", "config.conf"};
-    int argc = sizeof(argv) / sizeof(argv[0]);
+    NetMan netManager("loopback", 0);
+    netManager.setConnector([]()
+                            { return new LoopbackTransport(LoopbackScript(false)); });
+    netManager.conn();
+    CHECK_THROW(netManager.auth("user", "P@ssW0rd"), AuthError);
 
-    CHECK_THROW(UserInterface ui(argc, const_cast<char **>(argv)), ArgsDecodeError);
+    // Без подключения аутентификация невозможна
+    NetMan unconnected("loopback", 0);
+    CHECK_THROW(unconnected.auth("user", "P@ssW0rd"), AuthError);
 }
 
 /**
- * @brief Тест для проверки отсутствия обязательного параметра output.
+ * @brief Тест для повторной передачи после разрыва подключения встроенным сервером.
  */
-TEST(UserInterfaceParseArgsMissingOutput)
+TEST(NetManLoopbackRetry)
 {
-    const char *argv[] = {"vclient", "-a", "192.168.0.1", "-p", "33333", "-i", "input.bin", "-c", "config.conf"};
-    int argc = sizeof(argv) / sizeof(argv[0]);
+    // Первое подключение разрывается после 300 векторов, компактный режим отклоняется
+    int connections = 0;
+    NetMan netManager("loopback", 0);
+    netManager.setConnector([&connections]()
+                            { return new LoopbackTransport(LoopbackScript(true, false, connections++ == 0 ? 300 : 0)); });
+    netManager.setWireMode("compact");
+    netManager.setRetries(1);
+    netManager.setVerbose(false);
+    netManager.conn();
+    netManager.auth("user", "P@ssW0rd");
 
-    CHECK_THROW(UserInterface ui(argc, const_cast<char **>(argv)), ArgsDecodeError);
+    vector<vector<int16_t>> data;
+    for (int i = 0; i < 1000; ++i)
+        data.push_back({int16_t(i), 1});
+    vector<int16_t> results(data.size());
+    size_t committed = 0;
+    netManager.calc(data, results, 0, [&committed](size_t begin, size_t end)
+                    {
+        CHECK_EQUAL(committed, begin);
+        committed = end; });
+    netManager.close();
+
+    CHECK_EQUAL(2, connections);
+    CHECK_EQUAL(data.size(), committed);
+    CHECK_EQUAL(1, results[0]);
+    CHECK_EQUAL(300, results[299]);
+    CHECK_EQUAL(1000, results[999]);
 }
 
 /**
- * @brief Тест для проверки отсутствия значения для параметра address.
+ * @brief Тест для кодирования чисел в формате varint.
  */
-TEST(UserInterfaceParseArgsMissingAddressValue)
+TEST(WireCodecVarint)
 {
-    const char *argv[] = {"vclient", "-a"};
-    int argc = sizeof(argv) / sizeof(argv[0]);
+    vector<uint8_t> buf;
+    WireCodec::putVarint(buf, 0);
+    WireCodec::putVarint(buf, 127);
+    WireCodec::putVarint(buf, 128);
+    WireCodec::putVarint(buf, 0xFFFFFFFF);
 
-    CHECK_THROW(UserInterface ui(argc, const_cast<char **>(argv)), ArgsDecodeError);
+    // 1 + 1 + 2 + 5 байт
+    CHECK_EQUAL(9, buf.size());
+
+    const uint8_t *pos = buf.data();
+    const uint8_t *end = buf.data() + buf.size();
+    CHECK_EQUAL(0, WireCodec::getVarint(pos, end));
+    CHECK_EQUAL(127, WireCodec::getVarint(pos, end));
+    CHECK_EQUAL(128, WireCodec::getVarint(pos, end));
+    CHECK_EQUAL(0xFFFFFFFF, WireCodec::getVarint(pos, end));
+    CHECK_THROW(WireCodec::getVarint(pos, end), InvalidDataFormatError);
 }
 
 /**
- * @brief Тест для проверки отсутствия значения для параметра port.
+ * @brief Тест для кодирования и декодирования пакета векторов.
  */
-TEST(UserInterfaceParseArgsMissingPortValue)
+TEST(WireCodecRoundTrip)
 {
-    const char *argv[] = {"vclient", "-p"};
-    int argc = sizeof(argv) / sizeof(argv[0]);
+    vector<vector<int16_t>> data = {{1, 2, 3}, {-32768, 32767, -32768}, {}, {5}};
+    for (int i = 0; i < 1000; ++i)
+        data.push_back({100, 101, 102});
 
-    CHECK_THROW(UserInterface ui(argc, const_cast<char **>(argv)), ArgsDecodeError);
+    WireCodec codec;
+    vector<uint8_t> frame;
+    codec.encode(data, 0, data.size(), frame);
+
+    // Повторяющиеся векторы должны сжаться LZ4
+    CHECK_EQUAL(1, codec.getLz4Frames());
+    CHECK(codec.getWireBytes() < codec.getRawBytes() / 10);
+    CHECK(WireCodec::decode(frame.data(), frame.size()) == data);
+
+    codec.encode(data, 1, 2, frame);
+    vector<vector<int16_t>> part = WireCodec::decode(frame.data(), frame.size());
+    CHECK_EQUAL(1, part.size());
+    CHECK(part[0] == data[1]);
+
+    // Векторы выбираются по списку номеров в указанном порядке
+    vector<size_t> order = {3, 1, 0};
+    codec.encode(data, 1, 3, frame, &order);
+    CHECK(WireCodec::decode(frame.data(), frame.size()) == vector<vector<int16_t>>({data[1], data[0]}));
 }
 
 /**
- * @brief Тест для проверки отсутствия значения для параметра config.
+ * @brief Тест для сериализации, разбора и свертки векторов одинаковой длины.
  */
-TEST(UserInterfaceParseArgsMissingConfigValue)
+TEST(FixedStridePackUnpack)
 {
-    const char *argv[] = {"vclient", "-c"};
-    int argc = sizeof(argv) / sizeof(argv[0]);
+    // Размер 5 обрабатывается специализацией, 20 и векторы разной длины - общим путем
+    for (size_t size : {5, 20, 0})
+    {
+        vector<vector<int16_t>> data;
+        for (int i = 0; i < 100; ++i)
+            data.push_back(vector<int16_t>(size ? size : 1 + i % 7, int16_t(i - 50)));
+        CHECK_EQUAL(size == 5 ? 5 : 0, FixedStride::fixedSize(data, 0, data.size()));
 
-    CHECK_THROW(UserInterface ui(argc, const_cast<char **>(argv)), ArgsDecodeError);
+        vector<uint8_t> expected;
+        for (size_t i = 10; i < 60; ++i)
+        {
+            uint32_t vec_size = data[i].size();
+            const uint8_t *size_ptr = reinterpret_cast<const uint8_t *>(&vec_size);
+            const uint8_t *data_ptr = reinterpret_cast<const uint8_t *>(data[i].data());
+            expected.insert(expected.end(), size_ptr, size_ptr + sizeof(vec_size));
+            expected.insert(expected.end(), data_ptr, data_ptr + vec_size * sizeof(int16_t));
+        }
+        vector<uint8_t> frame(3, 0xFF);
+        FixedStride::pack(data, 10, 60, frame);
+        CHECK(frame == expected);
+
+        if (size)
+        {
+            vector<vector<int16_t>> back(60);
+            CHECK(FixedStride::unpack(frame.data(), 50, size, back, 10));
+            CHECK(back[10] == data[10]);
+            CHECK(back[59] == data[59]);
+            CHECK(back[0].empty());
+
+            // Запись другой длины не разбирается
+            frame[sizeof(uint32_t) + size * sizeof(int16_t)] = 3;
+            CHECK(!FixedStride::unpack(frame.data(), 50, size, back, 10));
+        }
+
+        // Диапазон по списку номеров сериализуется так же, как скопированные подряд векторы
+        vector<size_t> order;
+        vector<vector<int16_t>> gathered;
+        for (size_t i = 2; i < data.size(); i += 7)
+        {
+            order.push_back(data.size() - 1 - i);
+            gathered.push_back(data[order.back()]);
+        }
+        // Среди векторов разной длины выбраны векторы длины 7
+        CHECK_EQUAL(size == 20 ? 0 : size ? size : 7, FixedStride::fixedSize(data, 0, order.size(), &order));
+        FixedStride::pack(gathered, 1, gathered.size(), expected);
+        FixedStride::pack(data, 1, order.size(), frame, &order);
+        CHECK(frame == expected);
+    }
+
+    // Насыщение применяется после каждого сложения
+    int16_t values[20] = {32767, 1, -2};
+    for (int i = 3; i < 20; ++i)
+        values[i] = 1;
+    const uint8_t *bytes = reinterpret_cast<const uint8_t *>(values);
+    CHECK_EQUAL(32765, FixedStride::sum(bytes, 3));
+    CHECK_EQUAL(32767, FixedStride::sum(bytes, 20));
+    CHECK_EQUAL(32767, FixedStride::sum(bytes, 1));
+    CHECK_EQUAL(0, FixedStride::sum(bytes, 0));
+}
+
+/**
+ * @brief Тест для ошибки декодирования поврежденного пакета.
+ */
+TEST(WireCodecCorrupted)
+{
+    vector<vector<int16_t>> data = {{1, 2, 3}};
+    WireCodec codec;
+    vector<uint8_t> frame;
+    codec.encode(data, 0, data.size(), frame);
+
+    CHECK_THROW(WireCodec::decode(frame.data(), frame.size() - 1), InvalidDataFormatError);
+    frame[0] = 7;
+    CHECK_THROW(WireCodec::decode(frame.data(), frame.size()), InvalidDataFormatError);
+}
+
+/**
+ * @brief Тест для передачи данных в компактном режиме через локальный заменитель сервера.
+ */
+TEST(NetManCalcCompact)
+{
+    thread server = startStandInServer(33334, true);
+
+    NetMan netManager("127.0.0.1", 33334);
+    netManager.setWireMode("compact");
+    netManager.conn();
+    netManager.auth("user", "P@ssW0rd");
+
+    vector<vector<int16_t>> data;
+    for (int i = 0; i < 600; ++i)
+        data.push_back({int16_t(i), 1, 2});
+    data.push_back({30000, 30000});
+    vector<int16_t> results = netManager.calc(data);
+    netManager.close();
+    server.join();
+
+    CHECK_EQUAL(data.size(), results.size());
+    CHECK_EQUAL(3, results[0]);
+    CHECK_EQUAL(602, results[599]);
+    CHECK_EQUAL(32767, results[600]);
+}
+
+/**
+ * @brief Тест для перехода в сырой режим, если сервер не отвечает на запрос компактного режима.
+ */
+TEST(NetManCalcCompactLegacyServer)
+{
+    // Сервер без компактного режима принимает запрос за количество векторов; второе подключение сырое
+    thread server = startStandInServer(33351, false, 2);
+
+    NetMan netManager("127.0.0.1", 33351);
+    netManager.setWireMode("compact");
+    netManager.setVerbose(false);
+    netManager.conn();
+    netManager.auth("user", "P@ssW0rd");
+    CHECK(netManager.canSendFile());
+
+    vector<vector<int16_t>> data(100, vector<int16_t>({1, 2, 3}));
+    vector<int16_t> results = netManager.calc(data);
+    netManager.close();
+    server.join();
+
+    CHECK_EQUAL(100, results.size());
+    CHECK_EQUAL(6, results[99]);
+}
+
+/**
+ * @brief Тест для переподключения и повторной передачи только неподтвержденных векторов.
+ */
+TEST(NetManCalcRetry)
+{
+    // Первое подключение разрывается после 300 векторов
+    thread server = startStandInServer(33335, false, 2, 300);
+
+    NetMan netManager("127.0.0.1", 33335);
+    netManager.setRetries(2);
+    netManager.conn();
+    netManager.auth("user", "P@ssW0rd");
+
+    vector<vector<int16_t>> data;
+    for (int i = 0; i < 1000; ++i)
+        data.push_back({int16_t(i), 1});
+    vector<int16_t> results(data.size());
+    size_t committed = 0;
+    netManager.calc(data, results, 0, [&committed](size_t begin, size_t end)
+                    {
+        // Пакеты подтверждаются строго по порядку и без повторов
+        CHECK_EQUAL(committed, begin);
+        committed = end; });
+    netManager.close();
+    server.join();
+
+    CHECK_EQUAL(data.size(), committed);
+    CHECK_EQUAL(1, results[0]);
+    CHECK_EQUAL(300, results[299]);
+    CHECK_EQUAL(1000, results[999]);
+}
+
+/**
+ * @brief Тест для ошибки после исчерпания повторных попыток.
+ */
+TEST(NetManCalcRetryExhausted)
+{
+    thread server = startStandInServer(33336, false, 1, 10);
+
+    NetMan netManager("127.0.0.1", 33336);
+    netManager.setRetries(0);
+    netManager.conn();
+    netManager.auth("user", "P@ssW0rd");
+
+    vector<vector<int16_t>> data(100, vector<int16_t>({1, 2}));
+    CHECK_THROW(netManager.calc(data), NetworkError);
+    netManager.close();
+    server.join();
+}
+
+/**
+ * @brief Тест для сходимости адаптивного окна на модели канала.
+ * @details Время оборота окна моделируется как задержка канала плюс время передачи
+ * на заданной пропускной способности; окно должно выйти на насыщение канала.
+ */
+TEST(WindowControlConverges)
+{
+    vector<vector<int16_t>> data(1000000, vector<int16_t>(3));
+    const size_t vec_bytes = sizeof(uint32_t) + 3 * sizeof(int16_t) + sizeof(int16_t);
+    const double delays[] = {0.00005, 0.02};
+    const double bandwidths[] = {1e9, 12.5e6};
+
+    for (int link = 0; link < 2; ++link)
+    {
+        WindowControl ctl;
+        size_t begin = 0;
+        for (int i = 0; i < 200; ++i)
+        {
+            size_t end = ctl.next(data, begin);
+            size_t bytes = (end - begin) * vec_bytes;
+            ctl.update(end - begin, bytes, delays[link] + bytes / bandwidths[link]);
+            begin = end % data.size();
+        }
+
+        // Окно должно покрывать произведение задержки на пропускную способность
+        double bdp_vectors = delays[link] * bandwidths[link] / vec_bytes;
+        CHECK(ctl.getWindow() >= bdp_vectors);
+        CHECK(ctl.getBestRate() > bandwidths[link] * 0.5);
+        CHECK(ctl.getWindow() <= 32768);
+    }
+}
+
+/**
+ * @brief Тест для ограничений окна по объему данных и фиксированного окна.
+ */
+TEST(WindowControlLimits)
+{
+    vector<vector<int16_t>> data(100, vector<int16_t>(1000));
+    WindowControl ctl(32768, 10000);
+
+    // В ограничение 10000 байт помещаются 4 вектора по 2004 байта
+    CHECK_EQUAL(4, ctl.next(data, 0));
+    CHECK_EQUAL(100, ctl.next(data, 99));
+
+    // Окна, ограниченные объемом, тоже учитываются: при падении скорости окно уменьшается
+    // ниже ограничения, а после восстановления скорости возвращается к нему
+    for (int i = 0; i < 20; ++i)
+    {
+        size_t end = ctl.next(data, 0);
+        ctl.update(end, end * 2006, 0.001);
+    }
+    ctl.update(4, 4 * 2006, 0.01);
+    CHECK(ctl.next(data, 0) < 4);
+    for (int i = 0; i < 40; ++i)
+    {
+        size_t end = ctl.next(data, 0);
+        ctl.update(end, end * 2006, 0.0001);
+    }
+    CHECK_EQUAL(4, ctl.next(data, 0));
+
+    ctl.setFixed(40);
+    ctl.update(40, 80000, 0.001);
+    CHECK_EQUAL(40, ctl.getWindow());
+    CHECK_EQUAL(90, ctl.next(data, 50));
+}
+
+/**
+ * @brief Тест для возобновления задания по контрольной точке.
+ */
+TEST(IOManResume)
+{
+    const string out_path = "./output_resume.bin";
+    vector<int16_t> results = {1, 2, 3, 4, 5};
+    {
+        IOMan ioMan("./config/vclient.conf", "./input.txt", out_path);
+        CHECK_EQUAL(0, ioMan.resume(results));
+        ioMan.writePart(results, 0, 3);
+        // Задание прерывается без вызова finish()
+    }
+
+    vector<int16_t> resumed(5, 0);
+    IOMan ioMan("./config/vclient.conf", "./input.txt", out_path);
+    CHECK_EQUAL(3, ioMan.resume(resumed));
+    CHECK_EQUAL(3, resumed[2]);
+    ioMan.writePart(results, 3, 5);
+    ioMan.finish();
+
+    ifstream out_file(out_path, ios::binary);
+    uint32_t count = 0;
+    int16_t values[5];
+    out_file.read(reinterpret_cast<char *>(&count), sizeof(count));
+    out_file.read(reinterpret_cast<char *>(values), sizeof(values));
+    CHECK_EQUAL(5, count);
+    CHECK_EQUAL(1, values[0]);
+    CHECK_EQUAL(5, values[4]);
+    CHECK(!ifstream(out_path + ".ckpt").is_open());
+
+    // Контрольная точка другого задания не используется
+    vector<int16_t> other(7, 0);
+    IOMan ioManOther("./config/vclient.conf", "./input.txt", out_path);
+    CHECK_EQUAL(0, ioManOther.resume(other));
+    ioManOther.finish();
+    remove(out_path.c_str());
+}
+
+/**
+ * @brief Тест для индекса смещений двоичного файла с векторами разной длины.
+ */
+TEST(VecIndexBinary)
+{
+    const string path = "./input_indexed.bin";
+    vector<vector<int16_t>> source = {{1, 2}, {}, {3, 4, 5}, {-6}};
+    {
+        ofstream bin_file(path, ios::binary);
+        uint32_t count = source.size();
+        bin_file.write(reinterpret_cast<const char *>(&count), sizeof(count));
+        for (const auto &vec : source)
+        {
+            uint32_t size = vec.size();
+            bin_file.write(reinterpret_cast<const char *>(&size), sizeof(size));
+            bin_file.write(reinterpret_cast<const char *>(vec.data()), size * sizeof(int16_t));
+        }
+    }
+
+    IOMan ioMan("./config/vclient.conf", path, "./output.bin");
+    CHECK(!ioMan.loadIndex());
+    VecIndex::build(path, VecIndex::FORMAT_BINARY).save(VecIndex::path(path));
+    CHECK(ioMan.loadIndex());
+    CHECK_EQUAL(4, ioMan.getIndex().count());
+    CHECK_EQUAL(4 + 8, ioMan.getIndex().offset(1));
+
+    // Чтение диапазона начинается сразу с нужного вектора
+    // Буфер размечается заранее: параллельные читатели не изменяют его размер
+    vector<vector<int16_t>> data;
+    CHECK_THROW(ioMan.readRange(data, 2, 4), InvalidDataFormatError);
+    data.resize(4);
+    ioMan.readRange(data, 2, 4);
+    CHECK_EQUAL(4, data.size());
+    CHECK(data[0].empty());
+    CHECK_EQUAL(3, data[2].size());
+    CHECK_EQUAL(-6, data[3][0]);
+
+    ioMan.setVerbose(false);
+    CHECK_EQUAL(2, ioMan.read()[0][1]);
+
+    // Индекс перезаписанного файла считается устаревшим, в том числе при прежнем размере:
+    // векторы {1, 2}, {} заменяются на {1}, {2} той же длины
+    this_thread::sleep_for(chrono::milliseconds(20));
+    {
+        fstream bin_file(path, ios::binary | ios::in | ios::out);
+        uint32_t sizes[2] = {1, 1};
+        int16_t values[2] = {1, 2};
+        bin_file.seekp(4);
+        bin_file.write(reinterpret_cast<const char *>(&sizes[0]), sizeof(uint32_t));
+        bin_file.write(reinterpret_cast<const char *>(&values[0]), sizeof(int16_t));
+        bin_file.write(reinterpret_cast<const char *>(&sizes[1]), sizeof(uint32_t));
+        bin_file.write(reinterpret_cast<const char *>(&values[1]), sizeof(int16_t));
+    }
+    CHECK_THROW(ioMan.loadIndex(), InvalidDataFormatError);
+    VecIndex::build(path, VecIndex::FORMAT_BINARY).save(VecIndex::path(path));
+    CHECK(ioMan.loadIndex());
+    CHECK_EQUAL(4 + 6, ioMan.getIndex().offset(1));
+    ofstream(path, ios::binary | ios::app) << 'x';
+    CHECK_THROW(ioMan.loadIndex(), InvalidDataFormatError);
+    remove(path.c_str());
+    remove(VecIndex::path(path).c_str());
+}
+
+/**
+ * @brief Тест для компактного индекса файла с векторами одинаковой длины и индекса текстового файла.
+ */
+TEST(VecIndexStrideAndText)
+{
+    const string bin_path = "./input_stride.bin";
+    {
+        ofstream bin_file(bin_path, ios::binary);
+        uint32_t count = 1000;
+        uint32_t size = 3;
+        bin_file.write(reinterpret_cast<const char *>(&count), sizeof(count));
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            int16_t vec[3] = {int16_t(i), 1, 2};
+            bin_file.write(reinterpret_cast<const char *>(&size), sizeof(size));
+            bin_file.write(reinterpret_cast<const char *>(vec), sizeof(vec));
+        }
+    }
+    VecIndex stride = VecIndex::build(bin_path, VecIndex::FORMAT_BINARY);
+    stride.save(VecIndex::path(bin_path));
+    CHECK_EQUAL(4 + 999 * 10, stride.offset(999));
+    struct stat st;
+    stat(VecIndex::path(bin_path).c_str(), &st);
+    CHECK(st.st_size < 64);
+
+    IOMan binMan("./config/vclient.conf", bin_path, "./output.bin");
+    CHECK(binMan.loadIndex());
+    vector<vector<int16_t>> data(1000);
+    binMan.readRange(data, 998, 999);
+    CHECK_EQUAL(998, data[998][0]);
+    remove(bin_path.c_str());
+    remove(VecIndex::path(bin_path).c_str());
+
+    const string txt_path = "./input_indexed.txt";
+    ofstream(txt_path) << "3\n2\n1 2\n3\n10 20 30\n1\n-7\n";
+    VecIndex::build(txt_path, VecIndex::FORMAT_TEXT).save(VecIndex::path(txt_path));
+    IOMan txtMan("./config/vclient.conf", txt_path, "./output.bin");
+    CHECK(txtMan.loadIndex());
+    vector<vector<int16_t>> text_data(3);
+    txtMan.readRange(text_data, 1, 3);
+    CHECK_EQUAL(30, text_data[1][2]);
+    CHECK_EQUAL(-7, text_data[2][0]);
+    remove(txt_path.c_str());
+    remove(VecIndex::path(txt_path).c_str());
+}
+
+/**
+ * @brief Тест для индекса текстового файла со значениями double и uint64_t.
+ */
+TEST(VecIndexTextWideValues)
+{
+    // Значения пропускаются без разбора как int64_t: дробные, с порядком и больше INT64_MAX
+    const string path = "./input_double.txt";
+    const string text = "3\n2\n1.5 -2.75e+300 \n1\n18446744073709551615\n3\n-0.001 inf 4e-310 \n";
+    ofstream(path) << text;
+    VecIndex::build(path, VecIndex::FORMAT_TEXT, sizeof(double)).save(VecIndex::path(path));
+
+    VecIndex index;
+    CHECK(index.load(path));
+    CHECK_EQUAL(3, index.count());
+    CHECK_EQUAL(sizeof(double), index.valueSize());
+    CHECK_EQUAL(text.find("1\n1844"), index.offset(1));
+    CHECK_EQUAL(text.find("3\n-0.001"), index.offset(2));
+    CHECK_EQUAL(text.size(), index.offset(3));
+
+    // Обрыв посреди вектора по-прежнему обнаруживается
+    ofstream(path) << "2\n2\n1.5 2.5\n3\n0.5 1e10\n";
+    CHECK_THROW(VecIndex::build(path, VecIndex::FORMAT_TEXT, sizeof(double)), InvalidDataFormatError);
+    remove(path.c_str());
+    remove(VecIndex::path(path).c_str());
+}
+
+/**
+ * @brief Тест для передачи двоичного файла из файла в сокет с переподключением.
+ */
+TEST(NetManCalcFile)
+{
+    const string path = "./input_sendfile.bin";
+    vector<vector<int16_t>> source;
+    for (int i = 0; i < 1000; ++i)
+        source.push_back(vector<int16_t>(1 + i % 5, int16_t(i)));
+    {
+        ofstream bin_file(path, ios::binary);
+        uint32_t count = source.size();
+        bin_file.write(reinterpret_cast<const char *>(&count), sizeof(count));
+        for (const auto &vec : source)
+        {
+            uint32_t size = vec.size();
+            bin_file.write(reinterpret_cast<const char *>(&size), sizeof(size));
+            bin_file.write(reinterpret_cast<const char *>(vec.data()), size * sizeof(int16_t));
+        }
+    }
+    VecIndex index = VecIndex::build(path, VecIndex::FORMAT_BINARY);
+
+    // Первое подключение разрывается после 300 векторов, передача продолжается с подтвержденного окна
+    thread server = startStandInServer(33341, false, 2, 300);
+    NetMan netManager("127.0.0.1", 33341);
+    netManager.setRetries(2);
+    netManager.setVerbose(false);
+    netManager.conn();
+    netManager.auth("user", "P@ssW0rd");
+    CHECK(netManager.canSendFile());
+
+    vector<int16_t> results(index.count());
+    size_t committed = 0;
+    netManager.calcFile(path, index, results, 0, [&committed](size_t begin, size_t end)
+                        {
+        CHECK_EQUAL(committed, begin);
+        committed = end; });
+    netManager.close();
+    server.join();
+    remove(path.c_str());
+
+    CHECK_EQUAL(source.size(), committed);
+    for (size_t i = 0; i < source.size(); ++i)
+        CHECK_EQUAL(saturatedSum(source[i]), results[i]);
+}
+
+/**
+ * @brief Тест для точек трассировки: аргументы вычисляются один раз, результаты не меняются.
+ */
+TEST(ProbesCallSites)
+{
+    // Точка трассировки ведет себя как один оператор и в сборке с <sys/sdt.h>, и без нее
+    int first = 0, second = 0, third = 0;
+    VCLIENT_PROBE0(unit_test);
+    VCLIENT_PROBE1(unit_test, ++first);
+    VCLIENT_PROBE3(unit_test, ++first, ++second, ++third);
+    if (first == 2)
+        VCLIENT_PROBE2(unit_test, ++second, ++third);
+    else
+        first = -1;
+    CHECK_EQUAL(2, first);
+    CHECK_EQUAL(2, second);
+    CHECK_EQUAL(2, third);
+
+    // Чтение, передача и запись проходят через точки IOMan и NetMan без изменения результатов
+    const string in_path = "./probes_input.txt";
+    const string out_path = "./probes_output.bin";
+    vector<vector<int16_t>> source;
+    for (int i = 0; i < 300; ++i)
+        source.push_back({int16_t(i * 97), int16_t(-i), 30000, int16_t(i % 5)});
+    {
+        ofstream input(in_path);
+        input << source.size() << "\n";
+        for (const auto &vec : source)
+        {
+            input << vec.size();
+            for (int16_t value : vec)
+                input << " " << value;
+            input << "\n";
+        }
+    }
+
+    thread server = startStandInServer(33353, false);
+    IOMan io_man("./config/vclient.conf", in_path, out_path);
+    io_man.setVerbose(false);
+    vector<vector<int16_t>> data;
+    io_man.read(data);
+    NetMan net_man("127.0.0.1", 33353);
+    net_man.setVerbose(false);
+    net_man.conn();
+    net_man.auth("user", "P@ssW0rd");
+    vector<int16_t> results = net_man.calc(data);
+    net_man.close();
+    server.join();
+    io_man.write(results);
+
+    CHECK(data == source);
+    ifstream out_file(out_path, ios::binary);
+    uint32_t count = 0;
+    out_file.read(reinterpret_cast<char *>(&count), sizeof(count));
+    vector<int16_t> written(count);
+    out_file.read(reinterpret_cast<char *>(written.data()), count * sizeof(int16_t));
+    CHECK_EQUAL(source.size(), count);
+    bool matches = written.size() == source.size();
+    for (size_t i = 0; matches && i < source.size(); ++i)
+        matches = written[i] == saturatedSum(source[i]);
+    CHECK(matches);
+    remove(in_path.c_str());
+    remove(out_path.c_str());
+}
+
+/**
+ * @brief Тест для очереди с одним писателем и одним читателем.
+ */
+TEST(SpscRingOrder)
+{
+    SpscRing<uint32_t> ring(3);
+    CHECK_EQUAL(4, ring.capacity());
+    for (uint32_t i = 0; i < 4; ++i)
+        CHECK(ring.push(i));
+    CHECK(!ring.push(4));
+    uint32_t item = 0;
+    CHECK(ring.pop(item));
+    CHECK_EQUAL(0, item);
+    CHECK_EQUAL(3, ring.size());
+
+    // Элементы из другого потока приходят по порядку и без потерь
+    const uint32_t total = 100000;
+    thread producer([&ring]()
+                    {
+        for (uint32_t i = 5; i < total; ++i)
+            while (!ring.push(i))
+                this_thread::yield(); });
+    uint32_t expected = 1;
+    bool ordered = true;
+    while (expected < total)
+    {
+        if (!ring.pop(item))
+        {
+            this_thread::yield();
+            continue;
+        }
+        ordered = ordered && item == expected;
+        expected = expected == 3 ? 5 : expected + 1;
+    }
+    producer.join();
+    CHECK(ordered);
+    CHECK_EQUAL(0, ring.size());
+}
+
+/**
+ * @brief Тест для конвейерной обработки задания.
+ */
+TEST(PipelineRun)
+{
+    const string in_path = "./input_pipeline.txt";
+    const string out_path = "./output_pipeline.bin";
+    vector<vector<int16_t>> source;
+    {
+        ofstream in_file(in_path);
+        in_file << 2500 << "\n";
+        for (int i = 0; i < 2500; ++i)
+        {
+            source.push_back(vector<int16_t>(1 + i % 4, int16_t(i * 7)));
+            in_file << source.back().size();
+            for (int16_t value : source.back())
+                in_file << " " << value;
+            in_file << "\n";
+        }
+    }
+
+    thread server = startStandInServer(33342, false);
+    NetMan netManager("127.0.0.1", 33342);
+    netManager.conn();
+    netManager.auth("user", "P@ssW0rd");
+
+    IOMan ioMan("./config/vclient.conf", in_path, out_path);
+    vector<int16_t> results(ioMan.openStream());
+    CHECK_EQUAL(0, ioMan.resume(results));
+    Pipeline pipeline(ioMan, netManager, 100, 4);
+    pipeline.run(results, 0);
+    ioMan.finish();
+    netManager.close();
+    server.join();
+
+    for (const auto &stage : pipeline.getStages())
+        CHECK_EQUAL(25, stage.batches);
+    CHECK(!pipeline.getBottleneck().empty());
+
+    ifstream out_file(out_path, ios::binary);
+    uint32_t count = 0;
+    vector<int16_t> written(source.size());
+    out_file.read(reinterpret_cast<char *>(&count), sizeof(count));
+    out_file.read(reinterpret_cast<char *>(written.data()), written.size() * sizeof(int16_t));
+    CHECK_EQUAL(source.size(), count);
+    bool matches = bool(out_file);
+    for (size_t i = 0; i < source.size(); ++i)
+        matches = matches && written[i] == saturatedSum(source[i]);
+    CHECK(matches);
+    remove(in_path.c_str());
+    remove(out_path.c_str());
+}
+
+/**
+ * @brief Тест для асинхронного интерфейса встраиваемой библиотеки.
+ */
+TEST(VClientSubmit)
+{
+    thread server = startStandInServer(33343, false);
+    {
+        VClient client("127.0.0.1", 33343, "user", "P@ssW0rd");
+
+        // Запросы выполняются по одному подключению, установленному при первом запросе
+        vector<future<vector<int16_t>>> futures;
+        for (int i = 0; i < 5; ++i)
+            futures.push_back(client.submit(vector<vector<int16_t>>(100 + i, vector<int16_t>({int16_t(i), 1}))));
+
+        vector<vector<int16_t>> data = {{1, 2, 3}, {32767, 1}};
+        promise<vector<int16_t>> done;
+        client.submit(data, [&done](vector<int16_t> &results, exception_ptr error)
+                      {
+            CHECK(!error);
+            done.set_value(results); });
+
+        for (int i = 0; i < 5; ++i)
+        {
+            vector<int16_t> results = futures[i].get();
+            CHECK_EQUAL(100 + i, results.size());
+            CHECK_EQUAL(i + 1, results.back());
+        }
+        vector<int16_t> results = done.get_future().get();
+        CHECK_EQUAL(6, results[0]);
+        CHECK_EQUAL(32767, results[1]);
+        CHECK_EQUAL(4, client.calc({{2, 2}})[0]);
+    }
+    server.join();
+
+    // Ошибка подключения передается через future
+    VClient unreachable("127.0.0.1", 1, "user", "P@ssW0rd", 1, [](NetMan &net_man)
+                        { net_man.setRetries(0); });
+    CHECK_THROW(unreachable.submit(vector<vector<int16_t>>(1, vector<int16_t>({1}))).get(), NetworkError);
+}
+
+/**
+ * @brief Тест для генератора нагрузки в замкнутом и открытом цикле.
+ */
+TEST(LoadGenRun)
+{
+    // Одинаковое начальное значение дает одинаковые векторы
+    vector<int16_t> first(16), second(16);
+    VecGen(7).fill(first);
+    VecGen(7).fill(second);
+    CHECK(first == second);
+
+    CHECK(LoadGen::isLocal("127.0.0.1"));
+    CHECK(LoadGen::isLocal("127.1.2.3"));
+    CHECK(LoadGen::isLocal("unix:/tmp/vserver.sock"));
+    CHECK(!LoadGen::isLocal("10.0.0.1"));
+    CHECK(!LoadGen::isLocal("example.com"));
+
+    // Каждый виртуальный клиент открывает собственное подключение
+    thread server = startStandInServer(33344, false, 4);
+    auto make_net = []()
+    { return new NetMan("127.0.0.1", 33344); };
+
+    LatencyStats::reset();
+    LoadGen closed("./config/vclient.conf", 2, 0, 0.2, 50, 8);
+    CHECK_EQUAL(0, closed.run(make_net));
+    CHECK(closed.getRequests() > 0);
+
+    LoadGen open("./config/vclient.conf", 2, 100, 0.2, 50, 8);
+    CHECK_EQUAL(0, open.run(make_net));
+    CHECK(open.getRequests() > 0 && open.getRequests() <= 22);
+    server.join();
+
+    LatencyStats stats = LatencyStats::collect();
+    CHECK_EQUAL(closed.getRequests() + open.getRequests(), stats.get(LatencyStats::JOB).getCount());
+}
+
+/**
+ * @brief Тест для разбора списка процессоров и привязки потока.
+ */
+TEST(AffinityPin)
+{
+    vector<int> cpus = Affinity::parse("0-2,5,7-7");
+    CHECK(cpus == vector<int>({0, 1, 2, 5, 7}));
+    CHECK_THROW(Affinity::parse(""), ArgsDecodeError);
+    CHECK_THROW(Affinity::parse("3-1"), ArgsDecodeError);
+    CHECK_THROW(Affinity::parse("0,,1"), ArgsDecodeError);
+    CHECK_THROW(Affinity::parse("x"), ArgsDecodeError);
+
+    // Поток привязывается к последнему доступному процессору
+    int cpu = -1;
+    for (int i = 0; i < CPU_SETSIZE; ++i)
+        if (Affinity::available(i))
+            cpu = i;
+    CHECK(cpu >= 0);
+    thread([cpu]()
+           {
+        CHECK_EQUAL(cpu, Affinity::pin(vector<int>({cpu}), 3));
+        CHECK_EQUAL(cpu, sched_getcpu()); })
+        .join();
+    CHECK_EQUAL(-1, Affinity::pin(vector<int>(), 0));
+}
+
+/**
+ * @brief Тест для буферов на больших страницах.
+ */
+TEST(HugeMemBuffers)
+{
+    // Без пула hugetlbfs и поддержки THP выделение все равно должно работать
+    HugeMem::Mode modes[] = {HugeMem::OFF, HugeMem::THP, HugeMem::HUGETLB};
+    for (HugeMem::Mode mode : modes)
+    {
+        HugeMem::setMode(mode);
+        vector<int16_t, HugeAllocator<int16_t>> buffer(3 << 20);
+        buffer[0] = 1;
+        buffer.back() = 2;
+        CHECK_EQUAL(3, buffer[0] + buffer.back());
+        vector<char, HugeAllocator<char>> small(100, 'x');
+        CHECK_EQUAL('x', small[99]);
+
+        vector<int16_t> results(10, 7);
+        HugeMem::resize(results, 2 << 20);
+        CHECK_EQUAL(7, results[9]);
+        CHECK_EQUAL(0, results.back());
+    }
+    HugeMem::setMode(HugeMem::OFF);
+}
+
+/**
+ * @brief Тест для кэша результатов: отправляются только промахи, записи сохраняются в файл.
+ */
+TEST(ResultCacheCalc)
+{
+    string path = "/tmp/vclient_unit_cache.vrc";
+    remove(path.c_str());
+
+    CHECK(ResultCache::key({1, 2, 3}) == ResultCache::key({1, 2, 3}));
+    CHECK(!(ResultCache::key({1, 2, 3}) == ResultCache::key({1, 2, 3, 0})));
+    CHECK(!(ResultCache::key({1, 2}) == ResultCache::key({2, 1})));
+
+    thread server = startStandInServer(33345, false);
+    {
+        ResultCache cache(path);
+        NetMan net_man("127.0.0.1", 33345);
+        net_man.setVerbose(false);
+        net_man.setCache(&cache);
+        CHECK(!net_man.canSendFile());
+        net_man.conn();
+        net_man.auth("user", "P@ssW0rd");
+
+        vector<vector<int16_t>> data = {{1, 2}, {3, 4}, {1, 2}, {5}};
+        vector<int16_t> results(data.size());
+        net_man.calc(data, results, 0, std::function<void(size_t, size_t)>());
+        CHECK(results == vector<int16_t>({3, 7, 3, 5}));
+        CHECK_EQUAL(0, cache.getHits());
+        CHECK_EQUAL(4, cache.getMisses());
+        CHECK_EQUAL(3, cache.size());
+
+        // Повторные векторы не отправляются, подтвержденные диапазоны идут подряд до конца
+        vector<vector<int16_t>> again = {{3, 4}, {9, 9}, {1, 2}, {5}, {8}};
+        vector<int16_t> again_results(again.size());
+        size_t covered = 1;
+        net_man.calc(again, again_results, 1, [&covered](size_t begin, size_t end)
+                     {
+            CHECK_EQUAL(covered, begin);
+            covered = end; });
+        CHECK_EQUAL(again.size(), covered);
+        CHECK(vector<int16_t>(again_results.begin() + 1, again_results.end()) == vector<int16_t>({18, 3, 5, 8}));
+        CHECK_EQUAL(2, cache.getHits());
+        cache.save();
+        net_man.close();
+    }
+    server.join();
+
+    // Сохраненные записи отвечают без подключения к серверу
+    ResultCache loaded(path);
+    CHECK_EQUAL(5, loaded.size());
+    NetMan offline("127.0.0.1", 1);
+    offline.setVerbose(false);
+    offline.setCache(&loaded);
+    vector<vector<int16_t>> data = {{9, 9}, {1, 2}, {8}};
+    CHECK(offline.calc(data) == vector<int16_t>({18, 3, 8}));
+    CHECK_EQUAL(3, loaded.getHits());
+
+    ofstream(path, ios::binary) << "garbage";
+    CHECK_THROW(ResultCache bad(path), InvalidDataFormatError);
+    remove(path.c_str());
+}
+
+/**
+ * @brief Тест для распределения векторов между несколькими серверами.
+ */
+TEST(BalancerCalc)
+{
+    vector<Endpoint> parsed = Balancer::parse("10.0.0.1,10.0.0.2:4000,unix:/tmp/s", 33333);
+    CHECK_EQUAL(3, parsed.size());
+    CHECK_EQUAL(33333, parsed[0].port);
+    CHECK_EQUAL("10.0.0.2", parsed[1].address);
+    CHECK_EQUAL(4000, parsed[1].port);
+    CHECK_EQUAL("unix:/tmp/s", parsed[2].address);
+    CHECK_THROW(Balancer::parse("10.0.0.1:x", 33333), ArgsDecodeError);
+    CHECK_THROW(Balancer::parse("10.0.0.1,", 33333), ArgsDecodeError);
+
+    vector<vector<int16_t>> data;
+    vector<int16_t> expected;
+    for (int i = 0; i < 1000; ++i)
+    {
+        data.push_back({int16_t(i), int16_t(i % 7), 1});
+        expected.push_back(int16_t(i + i % 7 + 1));
+    }
+    auto make_net = [](const Endpoint &endpoint)
+    { return new NetMan(endpoint.address, endpoint.port); };
+
+    // Оба сервера получают части, подтверждения идут подряд с первого необработанного вектора
+    thread first_server = startStandInServer(33346, false);
+    thread second_server = startStandInServer(33347, false);
+    {
+        Balancer balancer({{"127.0.0.1", 33346}, {"127.0.0.1", 33347}}, make_net, "user", "P@ssW0rd", 3, 64);
+        vector<int16_t> results(data.size());
+        size_t covered = 10;
+        balancer.calc(data, results, 10, [&covered](size_t begin, size_t end)
+                      {
+            CHECK_EQUAL(covered, begin);
+            covered = end; });
+        CHECK_EQUAL(data.size(), covered);
+        CHECK(vector<int16_t>(results.begin() + 10, results.end()) == vector<int16_t>(expected.begin() + 10, expected.end()));
+        CHECK(balancer.getStats()[0].vectors > 0);
+        CHECK(balancer.getStats()[1].vectors > 0);
+        CHECK_EQUAL(data.size() - 10, balancer.getStats()[0].vectors + balancer.getStats()[1].vectors);
+    }
+    first_server.join();
+    second_server.join();
+
+    // Части недоступного сервера переносятся на рабочий, а сам сервер исключается из пула
+    thread server = startStandInServer(33346, false);
+    {
+        Balancer balancer({{"127.0.0.1", 1}, {"127.0.0.1", 33346}}, make_net, "user", "P@ssW0rd", 3, 64);
+        vector<int16_t> results(data.size());
+        balancer.calc(data, results, 0, std::function<void(size_t, size_t)>());
+        CHECK(results == expected);
+        CHECK(balancer.getStats()[0].errors > 0);
+        CHECK(balancer.getStats()[0].ejections > 0);
+        CHECK_EQUAL(0, balancer.getStats()[0].vectors);
+        CHECK_EQUAL(data.size(), balancer.getStats()[1].vectors);
+    }
+    server.join();
+
+    // Если ни один сервер не отвечает, задание завершается ошибкой
+    Balancer dead({{"127.0.0.1", 1}}, make_net, "user", "P@ssW0rd", 0, 64);
+    vector<int16_t> results(data.size());
+    CHECK_THROW(dead.calc(data, results, 0, std::function<void(size_t, size_t)>()), NetworkError);
+}
+
+/**
+ * @brief Тест для таймаутов, сроков и отмены сетевых операций.
+ */
+TEST(NetManDeadlines)
+{
+    vector<vector<int16_t>> data(100, vector<int16_t>{1, 2, 3});
+    thread server = startHungStandInServer(33350, 4);
+
+    // Таймаут операции: прием без единого байта прерывается, попытки исчерпываются
+    {
+        NetMan net_man("127.0.0.1", 33350);
+        net_man.setVerbose(false);
+        net_man.setRetries(0);
+        net_man.setTimeout(200);
+        net_man.conn();
+        net_man.auth("user", "P@ssW0rd");
+        auto start = chrono::steady_clock::now();
+        CHECK_THROW(net_man.calc(data), TimeoutError);
+        CHECK(chrono::steady_clock::now() - start < chrono::seconds(2));
+        net_man.close();
+    }
+
+    // Срок задания: повторные попытки после срока не выполняются
+    {
+        NetMan net_man("127.0.0.1", 33350);
+        net_man.setVerbose(false);
+        net_man.setRetries(3);
+        net_man.setDeadline(chrono::steady_clock::now() + chrono::milliseconds(300));
+        net_man.conn();
+        net_man.auth("user", "P@ssW0rd");
+        auto start = chrono::steady_clock::now();
+        CHECK_THROW(net_man.calc(data), DeadlineError);
+        CHECK(chrono::steady_clock::now() - start < chrono::seconds(2));
+        CHECK_THROW(net_man.conn(), DeadlineError);
+        net_man.close();
+    }
+
+    // Отмена из другого потока прерывает ожидание ответа и все последующие операции
+    {
+        NetMan net_man("127.0.0.1", 33350);
+        net_man.setVerbose(false);
+        net_man.conn();
+        net_man.auth("user", "P@ssW0rd");
+        thread canceller([&net_man]()
+                         {
+            this_thread::sleep_for(chrono::milliseconds(200));
+            net_man.cancel(); });
+        CHECK_THROW(net_man.calc(data), CancelledError);
+        canceller.join();
+        CHECK(net_man.isCancelled());
+        CHECK_THROW(net_man.conn(), CancelledError);
+        net_man.close();
+    }
+
+    // Срок каждого файла пакета освобождает рабочий поток
+    {
+        string dir = "/tmp/vclient_unit_deadline";
+        mkdir(dir.c_str(), 0755);
+        ofstream(dir + "/a.txt") << "1\n3 1 2 3\n";
+        BatchMan batch_man("./config/vclient.conf", "blocking");
+        batch_man.setDeadline(0.3);
+        batch_man.collect(dir + "/*.txt", dir);
+        auto start = chrono::steady_clock::now();
+        CHECK_EQUAL(1, batch_man.run(1, []()
+                                     { return new NetMan("127.0.0.1", 33350); }));
+        CHECK(chrono::steady_clock::now() - start < chrono::seconds(2));
+        remove((dir + "/a.txt").c_str());
+        rmdir(dir.c_str());
+    }
+    server.join();
+}
+
+/**
+ * @brief Тест для дублирования медленных пакетов по второму подключению.
+ */
+TEST(HedgerCalc)
+{
+    vector<vector<int16_t>> data;
+    vector<int16_t> expected;
+    for (int i = 0; i < 1280; ++i)
+    {
+        data.push_back({int16_t(i), 2});
+        expected.push_back(int16_t(i + 2));
+    }
+
+    // Первое подключение зависает на пакете после накопления измерений, копия уходит второму
+    thread slow_server = startStallingStandInServer(33348, 16 * 32, 2000);
+    thread fast_server = startStandInServer(33349, false);
+    {
+        Hedger hedger([](size_t id)
+                      { return new NetMan("127.0.0.1", id == 0 ? 33348 : 33349); },
+                      "user", "P@ssW0rd", 90, 0.5, 3, 32);
+        vector<int16_t> results(data.size());
+        size_t covered = 0;
+        hedger.calc(data, results, 0, [&covered](size_t begin, size_t end)
+                    {
+            CHECK_EQUAL(covered, begin);
+            covered = end; });
+        CHECK_EQUAL(data.size(), covered);
+        CHECK(results == expected);
+        CHECK_EQUAL(40, hedger.getBatches());
+        CHECK(hedger.getHedged() >= 1);
+        CHECK(hedger.getWins() >= 1);
+        CHECK(hedger.getHedged() <= hedger.getBatches() / 2);
+        CHECK(hedger.getHedgedLatency().getMax() < 2000000000ULL);
+        CHECK_EQUAL(40, hedger.getPrimaryLatency().getCount());
+    }
+    slow_server.join();
+    fast_server.join();
+}
+
+/**
+ * @brief Тест для счетчиков хода задания и файла состояния.
+ */
+TEST(ProgressReport)
+{
+    const string path = "/tmp/vclient_progress_test.status";
+    remove(path.c_str());
+
+    // Счетчики увеличиваются подключением NetMan, поток таймера перезаписывает файл состояния
+    Progress progress(0.05, path);
+    NetMan netManager("loopback", 0);
+    netManager.setConnector([]()
+                            { return new LoopbackTransport(); });
+    netManager.setProgress(&progress);
+    netManager.setVerbose(false);
+    vector<vector<int16_t>> data(4000, vector<int16_t>({1, 2, 3}));
+    progress.setTotal(2 * data.size());
+    progress.start();
+    netManager.conn();
+    netManager.auth("user", "P@ssW0rd");
+    netManager.calc(data);
+    this_thread::sleep_for(chrono::milliseconds(150));
+
+    ifstream running(path);
+    string first_line;
+    getline(running, first_line);
+    CHECK_EQUAL(string("state=running"), first_line);
+
+    ProgressSample sample = progress.sample();
+    CHECK_EQUAL(2 * data.size(), sample.total);
+    CHECK_EQUAL(data.size(), sample.sent);
+    CHECK_EQUAL(data.size(), sample.acked);
+    CHECK_EQUAL(data.size() * (sizeof(uint32_t) + 3 * sizeof(int16_t)), sample.bytes_sent);
+    CHECK_EQUAL(data.size() * sizeof(int16_t), sample.bytes_received);
+    CHECK(sample.eta > 0);
+
+    ostringstream line;
+    Progress::line(line, sample);
+    CHECK(line.str().find("Progress: 4000/8000 vectors (50%)") == 0);
+
+    progress.stop(true);
+    ifstream done(path);
+    stringstream text;
+    text << done.rdbuf();
+    CHECK(text.str().find("state=done\ntotal=8000\nsent=4000\nacked=4000\n") == 0);
+    netManager.close();
+    remove(path.c_str());
+
+    // Интервал вывода должен быть положительным, файл состояния включает вывод без интервала
+    const char *argv[] = {"vclient", "-i", "in.txt", "-o", "out.bin", "--progress-file", "/tmp/p.status"};
+    UserInterface ui(sizeof(argv) / sizeof(argv[0]), const_cast<char **>(argv));
+    CHECK_EQUAL(string("/tmp/p.status"), ui.getProgressPath());
+    CHECK_EQUAL(0.0, ui.getProgressInterval());
+    const char *bad_argv[] = {"vclient", "-i", "in.txt", "-o", "out.bin", "--progress", "0"};
+    CHECK_THROW(UserInterface bad_ui(sizeof(bad_argv) / sizeof(bad_argv[0]), const_cast<char **>(bad_argv)), ArgsDecodeError);
+}
+
+/**
+ * @brief Тест для процентилей гистограммы задержек и ее сохранения.
+ */
+TEST(LatencyHistPercentiles)
+{
+    LatencyHist hist;
+    for (uint64_t us = 1; us <= 10000; ++us)
+        hist.record(us * 1000);
+    CHECK_EQUAL(10000, hist.getCount());
+    CHECK_EQUAL(1000, hist.getMin());
+    CHECK_EQUAL(10000000, hist.getMax());
+
+    // Погрешность логарифмических корзин не превышает 1/64 значения
+    CHECK_CLOSE(5000000.0, double(hist.percentile(50)), 5000000.0 / 64);
+    CHECK_CLOSE(9900000.0, double(hist.percentile(99)), 9900000.0 / 64);
+    CHECK_CLOSE(9990000.0, double(hist.percentile(99.9)), 9990000.0 / 64);
+    CHECK_EQUAL(hist.getMax(), hist.percentile(100));
+
+    // Малые значения хранятся точно, слишком большие учитываются в последней корзине
+    LatencyHist small;
+    small.record(0);
+    small.record(127);
+    small.record(LatencyHist::LIMIT * 4);
+    CHECK_EQUAL(0, small.percentile(10));
+    CHECK_EQUAL(127, small.percentile(60));
+    CHECK_EQUAL(LatencyHist::LIMIT * 4, small.percentile(100));
+
+    // Гистограммы разных запусков объединяются при чтении
+    ostringstream saved;
+    hist.save(saved);
+    LatencyHist merged;
+    CHECK(merged.load(saved.str()));
+    CHECK(merged.load(saved.str()));
+    CHECK_EQUAL(20000, merged.getCount());
+    CHECK_EQUAL(hist.percentile(90), merged.percentile(90));
+    CHECK(!merged.load("3 1 2 3 5:1"));
+}
+
+/**
+ * @brief Тест для объединения гистограмм потоков и файлов.
+ */
+TEST(LatencyStatsMerge)
+{
+    LatencyStats::reset();
+    vector<thread> threads;
+    for (int t = 0; t < 4; ++t)
+        threads.emplace_back([t]()
+                             {
+            for (int i = 0; i < 1000; ++i)
+                LatencyStats::record(LatencyStats::BATCH, chrono::microseconds(100 * (t + 1))); });
+    for (auto &worker : threads)
+        worker.join();
+    LatencyStats stats = LatencyStats::collect();
+    CHECK_EQUAL(4000, stats.get(LatencyStats::BATCH).getCount());
+    CHECK_EQUAL(400000, stats.get(LatencyStats::BATCH).getMax());
+    CHECK_EQUAL(0, stats.get(LatencyStats::CONNECT).getCount());
+
+    const string path = "./latency.hist";
+    stats.save(path);
+    LatencyStats loaded;
+    CHECK(loaded.load(path));
+    CHECK(loaded.load(path));
+    CHECK_EQUAL(8000, loaded.get(LatencyStats::BATCH).getCount());
+    ostringstream json;
+    loaded.json(json);
+    CHECK(json.str().find("\"p99_9_ns\": 400000") != string::npos);
+    remove(path.c_str());
+    LatencyStats::reset();
+}
+
+/**
+ * @brief Тест для профилей параметров сокета.
+ */
+TEST(SocketOptionsProfiles)
+{
+    SocketOptions latency = SocketOptions::profile("latency");
+    SocketOptions throughput = SocketOptions::profile("throughput");
+    CHECK(latency.nodelay);
+    CHECK(!latency.cork);
+    CHECK(throughput.cork);
+    CHECK(throughput.sndbuf > 0 && throughput.rcvbuf > 0);
+    CHECK_THROW(SocketOptions::profile("fastest"), ArgsDecodeError);
+
+    // Проверка применения TCP_NODELAY к сокету
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    latency.apply(fd);
+    int value = 0;
+    socklen_t len = sizeof(value);
+    getsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &value, &len);
+    CHECK(value != 0);
+    close(fd);
+}
+
+/**
+ * @brief Тест для таймаута подключения.
+ */
+TEST(NetManConnTimeout)
+{
+    // Немаршрутизируемый адрес: подключение не завершается и прерывается таймаутом
+    NetMan netManager("10.255.255.1", 33333);
+    SocketOptions options;
+    options.connect_timeout_ms = 200;
+    netManager.setOptions(options);
+
+    auto start = chrono::steady_clock::now();
+    CHECK_THROW(netManager.conn(), NetworkError);
+    CHECK(chrono::steady_clock::now() - start < chrono::seconds(2));
+    netManager.close();
+}
+
+/**
+ * @brief Тест для передачи данных с профилем пропускной способности (TCP_CORK).
+ */
+TEST(NetManCalcThroughputProfile)
+{
+    thread server = startStandInServer(33337, false);
+
+    NetMan netManager("127.0.0.1", 33337);
+    netManager.setOptions(SocketOptions::profile("throughput"));
+    netManager.conn();
+    netManager.auth("user", "P@ssW0rd");
+
+    vector<vector<int16_t>> data(5000, vector<int16_t>({1, 2, 3}));
+    vector<int16_t> results = netManager.calc(data);
+    netManager.close();
+    server.join();
+
+    CHECK_EQUAL(data.size(), results.size());
+    CHECK_EQUAL(6, results[4999]);
+}
+
+/**
+ * @brief Тест для чтения и записи файлов через io_uring.
+ * @details При отсутствии поддержки io_uring в ядре проверяется блокирующий резервный режим.
+ */
+TEST(IOManURing)
+{
+    // Файл больше нескольких блоков чтения с опережением
+    const string in_path = "./input_uring.txt";
+    const string out_path = "./output_uring.bin";
+    ofstream in_file(in_path);
+    in_file << 100000 << "\n";
+    for (int i = 0; i < 100000; ++i)
+        in_file << 2 << "\n" << i % 1000 << " " << -(i % 7) << " \n";
+    in_file.close();
+
+    IOMan ioMan("./config/vclient.conf", in_path, out_path);
+    ioMan.setBackend("uring");
+    vector<vector<int16_t>> data = ioMan.read();
+    CHECK_EQUAL(100000, data.size());
+    CHECK(data[99999] == vector<int16_t>({999, -(99999 % 7)}));
+
+    ioMan.write({6, 7, 8});
+    ifstream out_file(out_path, ios::binary);
+    uint32_t count = 0;
+    int16_t values[3];
+    out_file.read(reinterpret_cast<char *>(&count), sizeof(count));
+    out_file.read(reinterpret_cast<char *>(values), sizeof(values));
+    CHECK_EQUAL(3, count);
+    CHECK_EQUAL(8, values[2]);
+
+    IOMan ioManMissing("./config/vclient.conf", "./non_exists_path.txt", out_path);
+    ioManMissing.setBackend("uring");
+    CHECK_THROW(ioManMissing.read(), runtime_error);
+
+    remove(in_path.c_str());
+    remove(out_path.c_str());
+}
+
+/**
+ * @brief Тест для передачи данных через io_uring.
+ */
+TEST(NetManCalcURing)
+{
+    const bool compact_modes[] = {false, true};
+    for (bool compact : compact_modes)
+    {
+        thread server = startStandInServer(33338, compact);
+
+        NetMan netManager("127.0.0.1", 33338);
+        netManager.setBackend("uring");
+        netManager.setWireMode(compact ? "compact" : "raw");
+        netManager.conn();
+        netManager.auth("user", "P@ssW0rd");
+
+        vector<vector<int16_t>> data;
+        for (int i = 0; i < 3000; ++i)
+            data.push_back({int16_t(i), int16_t(-1)});
+        vector<int16_t> results = netManager.calc(data);
+        netManager.close();
+        server.join();
+
+        CHECK_EQUAL(data.size(), results.size());
+        CHECK_EQUAL(-1, results[0]);
+        CHECK_EQUAL(2998, results[2999]);
+    }
+}
+
+/**
+ * @brief Тест для передачи данных через Unix-сокет и через общую память.
+ */
+TEST(NetManCalcUnixShm)
+{
+    const char *transports[] = {"socket", "shm"};
+    const bool compact_modes[] = {false, true};
+    for (const char *transport : transports)
+        for (bool compact : compact_modes)
+        {
+            bool shm = string(transport) == "shm";
+            thread server = startStandInUnixServer("/tmp/vclient_test.sock", compact, shm);
+
+            NetMan netManager("unix:/tmp/vclient_test.sock", 0);
+            netManager.setTransport(transport);
+            netManager.setWireMode(compact ? "compact" : "raw");
+            netManager.conn();
+            netManager.auth("user", "P@ssW0rd");
+            CHECK_EQUAL(shm, netManager.usesShm());
+
+            // Окна крупнее кольцевого буфера проверяют ожидание свободного места
+            vector<vector<int16_t>> data;
+            for (int i = 0; i < 20000; ++i)
+                data.push_back(vector<int16_t>(40, int16_t(i % 7)));
+            data.push_back({32767, 1});
+            vector<int16_t> results = netManager.calc(data);
+            netManager.close();
+            server.join();
+
+            CHECK_EQUAL(data.size(), results.size());
+            CHECK_EQUAL(0, results[0]);
+            CHECK_EQUAL(240, results[6]);
+            CHECK_EQUAL(32767, results[20000]);
+        }
+}
+
+/**
+ * @brief Тест для таймаута и срока при ожидании зависшего сервера через общую память.
+ */
+TEST(NetManUnixShmDeadlines)
+{
+    vector<vector<int16_t>> data(100, vector<int16_t>{1, 2, 3});
+    thread server = startHungStandInShmServer("/tmp/vclient_hung.sock", 2);
+
+    // Сокет сервера открыт, поэтому ожидание результатов прерывается только таймаутом
+    {
+        NetMan net_man("unix:/tmp/vclient_hung.sock", 0);
+        net_man.setTransport("shm");
+        net_man.setVerbose(false);
+        net_man.setRetries(0);
+        net_man.setTimeout(200);
+        net_man.conn();
+        net_man.auth("user", "P@ssW0rd");
+        CHECK(net_man.usesShm());
+        auto start = chrono::steady_clock::now();
+        CHECK_THROW(net_man.calc(data), TimeoutError);
+        CHECK(chrono::steady_clock::now() - start < chrono::seconds(2));
+        net_man.close();
+    }
+
+    // Срок задания прерывает ожидание и без таймаута
+    {
+        NetMan net_man("unix:/tmp/vclient_hung.sock", 0);
+        net_man.setTransport("shm");
+        net_man.setVerbose(false);
+        net_man.setRetries(3);
+        net_man.setDeadline(chrono::steady_clock::now() + chrono::milliseconds(300));
+        net_man.conn();
+        net_man.auth("user", "P@ssW0rd");
+        CHECK(net_man.usesShm());
+        auto start = chrono::steady_clock::now();
+        CHECK_THROW(net_man.calc(data), DeadlineError);
+        CHECK(chrono::steady_clock::now() - start < chrono::seconds(2));
+        net_man.close();
+    }
+    server.join();
+}
+
+/**
+ * @brief Тест для перехода на сокет, если сервер не отвечает на запрос общей памяти.
+ */
+TEST(NetManCalcUnixShmLegacyServer)
+{
+    // Сервер без общей памяти принимает запрос за данные; второе подключение передает данные через сокет
+    thread server = startStandInUnixServer("/tmp/vclient_legacy.sock", false, false, 2);
+
+    NetMan netManager("unix:/tmp/vclient_legacy.sock", 0);
+    netManager.setTransport("shm");
+    netManager.setVerbose(false);
+    netManager.conn();
+    netManager.auth("user", "P@ssW0rd");
+    CHECK(!netManager.usesShm());
+
+    vector<vector<int16_t>> data(100, vector<int16_t>({4, 5}));
+    vector<int16_t> results = netManager.calc(data);
+    netManager.close();
+    server.join();
+
+    CHECK_EQUAL(100, results.size());
+    CHECK_EQUAL(9, results[99]);
+}
+
+/**
+ * @brief Тест для проверки отсутствия выделений памяти на каждый вектор в цепочке read, calc, write.
+ * @details После первого задания буферы переиспользуются, поэтому количество выделений на задание
+ * не должно зависеть от количества векторов.
+ */
+TEST(SteadyStateAllocations)
+{
+    const string small_path = "./alloc_small.txt";
+    const string large_path = "./alloc_large.txt";
+    const string out_path = "./alloc_output.bin";
+    for (int n : {500, 2000})
+    {
+        ofstream input(n == 500 ? small_path : large_path);
+        input << n << "\n";
+        for (int i = 0; i < n; ++i)
+            input << "8 1 2 3 4 5 6 7 " << i % 100 << "\n";
+    }
+
+    thread server = startStandInServer(33340, false);
+    NetMan netManager("127.0.0.1", 33340);
+    netManager.setVerbose(false);
+    netManager.setWindow(256);
+    netManager.conn();
+    netManager.auth("user", "P@ssW0rd");
+
+    vector<vector<int16_t>> data;
+    vector<int16_t> results;
+    auto job = [&](const string &path)
+    {
+        IOMan ioMan("./config/vclient.conf", path, out_path);
+        ioMan.setVerbose(false);
+        ioMan.read(data);
+        results.resize(data.size());
+        netManager.calc(data, results, 0, function<void(size_t, size_t)>());
+        ioMan.write(results);
+    };
+
+    // Первые задания выделяют буферы под наибольший размер; затем размеры чередуются
+    // (малое, большое, малое), и внутренние векторы большого задания не освобождаются
+    job(large_path);
+    job(small_path);
+    size_t allocs[3];
+    const string *paths[3] = {&small_path, &large_path, &small_path};
+    for (int i = 0; i < 3; ++i)
+    {
+        AllocCounter counter;
+        job(*paths[i]);
+        allocs[i] = counter.count();
+    }
+    netManager.close();
+    server.join();
+
+    CHECK_EQUAL(500, data.size());
+    CHECK_EQUAL(28 + 99, results[499]);
+    CHECK_EQUAL(allocs[0], allocs[1]);
+    CHECK_EQUAL(allocs[0], allocs[2]);
+    CHECK(allocs[1] < 32);
+    remove(small_path.c_str());
+    remove(large_path.c_str());
+
+    // Двоичный файл с постоянным шагом читается пакетами без выделений памяти на пакет
+    const string stride_path = "./alloc_stride.bin";
+    {
+        ofstream bin_file(stride_path, ios::binary);
+        uint32_t count = 2000;
+        uint32_t size = 8;
+        bin_file.write(reinterpret_cast<const char *>(&count), sizeof(count));
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            int16_t vec[8] = {1, 2, 3, 4, 5, 6, 7, int16_t(i % 100)};
+            bin_file.write(reinterpret_cast<const char *>(&size), sizeof(size));
+            bin_file.write(reinterpret_cast<const char *>(vec), sizeof(vec));
+        }
+    }
+    VecIndex::build(stride_path, VecIndex::FORMAT_BINARY).save(VecIndex::path(stride_path));
+    IOMan streamMan("./config/vclient.conf", stride_path, out_path);
+    CHECK_EQUAL(2000, streamMan.openStream());
+    vector<vector<int16_t>> batch;
+    streamMan.readBatch(batch, 100);
+    size_t batch_allocs;
+    {
+        AllocCounter counter;
+        for (int i = 1; i < 20; ++i)
+            streamMan.readBatch(batch, 100);
+        batch_allocs = counter.count();
+    }
+    CHECK_EQUAL(0, batch_allocs);
+    CHECK_EQUAL(99, batch[99][7]);
+    remove(stride_path.c_str());
+    remove(VecIndex::path(stride_path).c_str());
+    remove(out_path.c_str());
+}
+
+/**
+ * @brief Тест для составления списка заданий пакетного режима.
+ */
+TEST(BatchManCollect)
+{
+    const string manifest_path = "./batch_manifest.txt";
+    {
+        ofstream manifest(manifest_path);
+        manifest << "# input output\n\n./a.txt ./a.bin\n./b.txt\t./b.bin\n";
+    }
+    BatchMan batchMan("./config/vclient.conf", "blocking");
+    batchMan.collect(manifest_path, "");
+    CHECK_EQUAL(2, batchMan.getJobs().size());
+    CHECK_EQUAL(string("./b.txt"), batchMan.getJobs()[1].input);
+    CHECK_EQUAL(string("./b.bin"), batchMan.getJobs()[1].output);
+
+    // Строка без выходного пути считается ошибкой
+    {
+        ofstream manifest(manifest_path);
+        manifest << "./a.txt\n";
+    }
+    CHECK_THROW(batchMan.collect(manifest_path, ""), ArgsDecodeError);
+    CHECK_THROW(batchMan.collect("./missing_manifest.txt", ""), FileNotFoundError);
+    CHECK_THROW(batchMan.collect("./*.txt", ""), ArgsDecodeError);
+
+    // Индексы и контрольные точки рядом с входными файлами не становятся заданиями
+    mkdir("./batch_sidecar", 0755);
+    ofstream("./batch_sidecar/x.bin") << "data";
+    ofstream("./batch_sidecar/x.bin.idx") << "index";
+    ofstream("./batch_sidecar/x.bin.out.ckpt") << "checkpoint";
+    batchMan.collect("./batch_sidecar", "./batch_out");
+    CHECK_EQUAL(1, batchMan.getJobs().size());
+    CHECK_EQUAL(string("./batch_sidecar/x.bin"), batchMan.getJobs()[0].input);
+    remove("./batch_sidecar/x.bin");
+    remove("./batch_sidecar/x.bin.idx");
+    remove("./batch_sidecar/x.bin.out.ckpt");
+    rmdir("./batch_sidecar");
+    remove(manifest_path.c_str());
+
+    // Одинаковые имена файлов из разных каталогов дали бы один выходной файл
+    mkdir("./batch_dup_a", 0755);
+    mkdir("./batch_dup_b", 0755);
+    ofstream("./batch_dup_a/x.txt") << "1\n1 1\n";
+    ofstream("./batch_dup_b/x.txt") << "1\n1 2\n";
+    CHECK_THROW(batchMan.collect("./batch_dup_*/x.txt", "./batch_out"), ArgsDecodeError);
+    {
+        ofstream manifest(manifest_path);
+        manifest << "./a.txt ./same.bin\n./b.txt ./same.bin\n";
+    }
+    CHECK_THROW(batchMan.collect(manifest_path, ""), ArgsDecodeError);
+    remove(manifest_path.c_str());
+    remove("./batch_dup_a/x.txt");
+    remove("./batch_dup_b/x.txt");
+    rmdir("./batch_dup_a");
+    rmdir("./batch_dup_b");
+}
+
+/**
+ * @brief Тест для пакетной обработки каталога несколькими подключениями.
+ */
+TEST(BatchManRun)
+{
+    const string in_dir = "./batch_in";
+    const string out_dir = "./batch_out";
+    mkdir(in_dir.c_str(), 0755);
+    mkdir(out_dir.c_str(), 0755);
+    for (int i = 0; i < 6; ++i)
+    {
+        ofstream input(in_dir + "/part" + to_string(i) + ".txt");
+        input << "2\n2 " << i << " 1\n1 " << -i << "\n";
+    }
+
+    thread server = startStandInServer(33339, false, 3);
+    BatchMan batchMan("./config/vclient.conf", "blocking");
+    batchMan.collect(in_dir, out_dir);
+    CHECK_EQUAL(6, batchMan.getJobs().size());
+    CHECK_EQUAL(0, batchMan.run(3, []()
+                                { return new NetMan("127.0.0.1", 33339); }));
+    server.join();
+    CHECK_EQUAL(6, batchMan.getCompleted());
+    CHECK_EQUAL(12, batchMan.getVectors());
+
+    for (int i = 0; i < 6; ++i)
+    {
+        string out_path = out_dir + "/part" + to_string(i) + ".txt.out";
+        ifstream out_file(out_path, ios::binary);
+        uint32_t count = 0;
+        int16_t values[2] = {0, 0};
+        out_file.read(reinterpret_cast<char *>(&count), sizeof(count));
+        out_file.read(reinterpret_cast<char *>(values), sizeof(values));
+        CHECK_EQUAL(2, count);
+        CHECK_EQUAL(i + 1, values[0]);
+        CHECK_EQUAL(-i, values[1]);
+        remove(out_path.c_str());
+        remove((in_dir + "/part" + to_string(i) + ".txt").c_str());
+    }
+    rmdir(in_dir.c_str());
+    rmdir(out_dir.c_str());
+}
+
+/**
+ * @brief Тест для пакета, в котором не удалось создать подключение.
+ */
+TEST(BatchManRunMakeNetError)
+{
+    BatchMan batchMan("./config/vclient.conf", "blocking");
+    batchMan.getJobs() = {{"./a.txt", "./a.bin"}, {"./b.txt", "./b.bin"}, {"./c.txt", "./c.bin"}};
+    // Исключение из make_net не покидает рабочий поток, задания отмечаются ошибкой
+    CHECK_EQUAL(3, batchMan.run(2, []() -> NetMan *
+                                { throw NetworkError("Connection refused", "test"); }));
+    CHECK_EQUAL(0, batchMan.getCompleted());
+}
+
+/**
+ * @brief Тест для кэша результатов в пакетном режиме.
+ */
+TEST(BatchManRunCache)
+{
+    const string in_dir = "./batch_cache_in";
+    const string out_dir = "./batch_cache_out";
+    string path = "/tmp/vclient_unit_batch_cache.vrc";
+    remove(path.c_str());
+    mkdir(in_dir.c_str(), 0755);
+    mkdir(out_dir.c_str(), 0755);
+    for (int i = 0; i < 2; ++i)
+    {
+        ofstream input(in_dir + "/part" + to_string(i) + ".txt");
+        input << "2\n2 1 1\n1 " << i << "\n";
+    }
+
+    thread server = startStandInServer(33352, false);
+    {
+        ResultCache cache(path);
+        BatchMan batchMan("./config/vclient.conf", "blocking");
+        batchMan.collect(in_dir, out_dir);
+        CHECK_EQUAL(0, batchMan.run(1, [&cache]()
+                                    {
+            NetMan *net_man = new NetMan("127.0.0.1", 33352);
+            net_man->setCache(&cache);
+            return net_man; }));
+        // Вектор {1, 1} второго файла берется из кэша, заполненного первым
+        CHECK_EQUAL(1, cache.getHits());
+        CHECK_EQUAL(3, cache.getMisses());
+    }
+    server.join();
+
+    for (int i = 0; i < 2; ++i)
+    {
+        remove((out_dir + "/part" + to_string(i) + ".txt.out").c_str());
+        remove((in_dir + "/part" + to_string(i) + ".txt").c_str());
+    }
+    rmdir(in_dir.c_str());
+    rmdir(out_dir.c_str());
+    remove(path.c_str());
+}
+
+/**
+ * @brief Тест для сохранения кэша результатов, если часть пакета завершилась ошибкой.
+ */
+TEST(UserInterfaceCacheSavedOnFailure)
+{
+    const string in_dir = "./cache_fail_in";
+    const string out_dir = "./cache_fail_out";
+    const string path = "/tmp/vclient_unit_fail_cache.vrc";
+    remove(path.c_str());
+    mkdir(in_dir.c_str(), 0755);
+    mkdir(out_dir.c_str(), 0755);
+    // Поврежденный сжатый файл завершается ошибкой распаковки
+    ofstream(in_dir + "/bad.txt.zst") << "not a zstd frame";
+    ofstream(in_dir + "/good.txt") << "2\n2 1 1\n1 5\n";
+
+    thread server = startStandInServer(33354, false);
+    {
+        const char *argv[] = {"vclient", "--batch", "./cache_fail_in", "-o", "./cache_fail_out", "-a", "127.0.0.1",
+                              "-p", "33354", "-c", "./config/vclient.conf", "-j", "1", "--cache", path.c_str()};
+        UserInterface ui(sizeof(argv) / sizeof(argv[0]), const_cast<char **>(argv));
+        CHECK_THROW(ui.run(), BatchError);
+    }
+    server.join();
+
+    // Результаты успешного файла сохранены, несмотря на ошибку пакета
+    ResultCache cache(path);
+    CHECK_EQUAL(2, cache.size());
+
+    remove((in_dir + "/bad.txt.zst").c_str());
+    remove((in_dir + "/good.txt").c_str());
+    remove((out_dir + "/good.txt.out").c_str());
+    remove((out_dir + "/bad.txt.zst.out").c_str());
+    rmdir(in_dir.c_str());
+    rmdir(out_dir.c_str());
+    remove(path.c_str());
+}
+
+/**
+ * @brief Тест для проверки корректной обработки параметров.
+ */
+TEST(UserInterfaceParseArgsCorrect)
+{
+    const char *argv[] = {"vclient", "-a", "192.168.0.1", "-p", "33333", "-i", "input.bin", "-o", "output.bin", "-c", "config.conf"};
+    int argc = sizeof(argv) / sizeof(argv[0]);
+
+    UserInterface ui(argc, const_cast<char **>(argv));
+
+    // Проверяем корректность распарсенных параметров
+    CHECK_EQUAL(string("192.168.0.1"), ui.getAddress());
+    CHECK_EQUAL((uint16_t)33333, ui.getPort());
+    CHECK_EQUAL(string("input.bin"), ui.getInputFilePath());
+    CHECK_EQUAL(string("output.bin"), ui.getOutputFilePath());
+    CHECK_EQUAL(string("config.conf"), ui.getConfigFilePath());
+}
+
+/**
+ * @brief Тест для проверки отсутствия обязательного параметра input.
+ */
+TEST(UserInterfaceParseArgsMissingInput)
+{
+    const char *argv[] = {"vclient", "-a", "192.168.0.1", "-p", "33333", "-o", "output.bin", "-c", "config.conf"};
+    int argc = sizeof(argv) / sizeof(argv[0]);
+
+    CHECK_THROW(UserInterface ui(argc, const_cast<char **>(argv)), ArgsDecodeError);
+}
+
+/**
+ * @brief Тест для проверки отсутствия обязательного параметра output.
+ */
+TEST(UserInterfaceParseArgsMissingOutput)
+{
+    const char *argv[] = {"vclient", "-a", "192.168.0.1", "-p", "33333", "-i", "input.bin", "-c", "config.conf"};
+    int argc = sizeof(argv) / sizeof(argv[0]);
+
+    CHECK_THROW(UserInterface ui(argc, const_cast<char **>(argv)), ArgsDecodeError);
+}
+
+/**
+ * @brief Тест для проверки отсутствия значения для параметра address.
+ */
+TEST(UserInterfaceParseArgsMissingAddressValue)
+{
+    const char *argv[] = {"vclient", "-a"};
+    int argc = sizeof(argv) / sizeof(argv[0]);
+
+    CHECK_THROW(UserInterface ui(argc, const_cast<char **>(argv)), ArgsDecodeError);
+}
+
+/**
+ * @brief Тест для проверки отсутствия значения для параметра port.
+ */
+TEST(UserInterfaceParseArgsMissingPortValue)
+{
+    const char *argv[] = {"vclient", "-p"};
+    int argc = sizeof(argv) / sizeof(argv[0]);
+
+    CHECK_THROW(UserInterface ui(argc, const_cast<char **>(argv)), ArgsDecodeError);
+}
+
+/**
+ * @brief Тест для проверки отсутствия значения для параметра config.
+ */
+TEST(UserInterfaceParseArgsMissingConfigValue)
+{
+    const char *argv[] = {"vclient", "-c"};
+    int argc = sizeof(argv) / sizeof(argv[0]);
+
+    CHECK_THROW(UserInterface ui(argc, const_cast<char **>(argv)), ArgsDecodeError);
+}
+
+/**
+ * @brief Тест для проверки неизвестного режима кодирования.
+ */
+TEST(UserInterfaceParseArgsUnknownWireMode)
+{
+    const char *argv[] = {"vclient", "-i", "input.bin", "-o", "output.bin", "-w", "gzip"};
+    int argc = sizeof(argv) / sizeof(argv[0]);
+
+    CHECK_THROW(UserInterface ui(argc, const_cast<char **>(argv)), ArgsDecodeError);
+}
+
+/**
+ * @brief Тест для проверки параметра профиля сокета в форме --net-profile=VALUE.
+ */
+TEST(UserInterfaceParseArgsNetProfile)
+{
+    const char *argv[] = {"vclient", "-i", "input.bin", "-o", "output.bin", "--net-profile=latency"};
+    int argc = sizeof(argv) / sizeof(argv[0]);
+
+    UserInterface ui(argc, const_cast<char **>(argv));
+    CHECK_EQUAL(string("latency"), ui.getNetProfile());
+
+    const char *bad_argv[] = {"vclient", "-i", "input.bin", "-o", "output.bin", "--net-profile", "fastest"};
+    int bad_argc = sizeof(bad_argv) / sizeof(bad_argv[0]);
+    CHECK_THROW(UserInterface bad_ui(bad_argc, const_cast<char **>(bad_argv)), ArgsDecodeError);
+}
+
+/**
+ * @brief Тест для проверки транспорта через общую память.
+ */
+TEST(UserInterfaceParseArgsTransport)
+{
+    const char *argv[] = {"vclient", "-a", "unix:/tmp/vserver.sock", "--transport", "shm", "-i", "input.bin", "-o", "output.bin"};
+    int argc = sizeof(argv) / sizeof(argv[0]);
+
+    UserInterface ui(argc, const_cast<char **>(argv));
+    CHECK_EQUAL(string("shm"), ui.getTransport());
+
+    const char *tcp_argv[] = {"vclient", "--transport", "shm", "-i", "input.bin", "-o", "output.bin"};
+    int tcp_argc = sizeof(tcp_argv) / sizeof(tcp_argv[0]);
+    CHECK_THROW(UserInterface tcp_ui(tcp_argc, const_cast<char **>(tcp_argv)), ArgsDecodeError);
+}
+
+/**
+ * @brief Тест для проверки параметров привязки потоков и больших страниц.
+ */
+TEST(UserInterfaceParseArgsCpus)
+{
+    const char *argv[] = {"vclient", "--cpus", "0", "--huge-pages", "thp", "-i", "input.bin", "-o", "output.bin"};
+    int argc = sizeof(argv) / sizeof(argv[0]);
+
+    UserInterface ui(argc, const_cast<char **>(argv));
+    CHECK_EQUAL(1, ui.getCpus().size());
+    CHECK_EQUAL(string("thp"), ui.getHugePages());
+    CHECK_EQUAL(HugeMem::THP, HugeMem::getMode());
+
+    const char *bad_argv[] = {"vclient", "--huge-pages", "1g", "-i", "input.bin", "-o", "output.bin"};
+    int bad_argc = sizeof(bad_argv) / sizeof(bad_argv[0]);
+    CHECK_THROW(UserInterface bad_ui(bad_argc, const_cast<char **>(bad_argv)), ArgsDecodeError);
+
+    const char *cpu_argv[] = {"vclient", "--cpus", "1023", "-i", "input.bin", "-o", "output.bin"};
+    int cpu_argc = sizeof(cpu_argv) / sizeof(cpu_argv[0]);
+    CHECK_THROW(UserInterface cpu_ui(cpu_argc, const_cast<char **>(cpu_argv)), ArgsDecodeError);
+    HugeMem::setMode(HugeMem::OFF);
+}
+
+/**
+ * @brief Тест для проверки параметров пакетного режима.
+ */
+TEST(UserInterfaceParseArgsBatch)
+{
+    const char *argv[] = {"vclient", "--batch", "./inputs", "-o", "./outputs", "-j", "8"};
+    int argc = sizeof(argv) / sizeof(argv[0]);
+
+    UserInterface ui(argc, const_cast<char **>(argv));
+    CHECK_EQUAL(string("./inputs"), ui.getBatchSpec());
+    CHECK_EQUAL(8, ui.getJobs());
+
+    const char *bad_argv[] = {"vclient", "--batch", "./inputs", "-o", "./outputs", "-j", "0"};
+    int bad_argc = sizeof(bad_argv) / sizeof(bad_argv[0]);
+    CHECK_THROW(UserInterface bad_ui(bad_argc, const_cast<char **>(bad_argv)), ArgsDecodeError);
+
+    // Возобновление и конвейер в пакетном режиме отклоняются, а не игнорируются
+    const char *resume_argv[] = {"vclient", "--batch", "./inputs", "-o", "./outputs", "--resume"};
+    CHECK_THROW(UserInterface resume_ui(6, const_cast<char **>(resume_argv)), ArgsDecodeError);
+    const char *pipeline_argv[] = {"vclient", "--batch", "./inputs", "-o", "./outputs", "--pipeline"};
+    CHECK_THROW(UserInterface pipeline_ui(6, const_cast<char **>(pipeline_argv)), ArgsDecodeError);
 }
 
 /**